@@ -10,56 +10,72 @@ namespace elephant_detail {
 
 inline float hash1(float n) { return fract(sin(n) * 43758.5453123f); }
 
-inline float eleph_smin(float a, float b, float k) {
-    float h = clamp(0.5f + 0.5f * (b - a) / k, 0.0f, 1.0f);
+template <class T>
+inline T eleph_smin(T a, T b, sdf::detail::identity_t<T> k) {
+    T h = clamp(0.5f + 0.5f * (b - a) / k, T(0.0f), T(1.0f));
     return mix(b, a, h) - k * h * (1.0f - h);
 }
 
-inline vec2 eleph_smin2(const vec2& a, const vec2& b, float k) {
-    float h = clamp(0.5f + 0.5f * (b.x - a.x) / k, 0.0f, 1.0f);
-    return vec2(mix(b.x, a.x, h) - k * h * (1.0f - h), mix(b.y, a.y, h));
+template <class V2>
+inline V2 eleph_smin2(const V2& a, const V2& b, float k) {
+    using T = scalar_t<V2>;
+    T h = clamp(0.5f + 0.5f * (b.x - a.x) / k, T(0.0f), T(1.0f));
+    return V2(mix(b.x, a.x, h) - k * h * (1.0f - h), mix(b.y, a.y, h));
 }
 
-inline float eleph_smax(float a, float b, float k) {
-    float h = clamp(0.5f + 0.5f * (b - a) / k, 0.0f, 1.0f);
+template <class T>
+inline T eleph_smax(T a, T b, float k) {
+    T h = clamp(0.5f + 0.5f * (b - a) / k, T(0.0f), T(1.0f));
     return mix(a, b, h) + k * h * (1.0f - h);
 }
 
-inline vec2 sdSegment(const vec3& p, const vec3& a, const vec3& b) {
-    vec3 pa = p - a, ba = b - a;
-    float h = clamp(dot(pa, ba) / dot(ba, ba), 0.0f, 1.0f);
-    return vec2(length(pa - ba * h), h);
+template <class V>
+inline vec2_t<scalar_t<V>> sdSegment(const V& p, const vec3& a, const vec3& b) {
+    using T = scalar_t<V>;
+    vec3 ba = b - a;
+    V pa = p - V(a.x, a.y, a.z);
+    T h = clamp(dot(pa, ba) / dot(ba, ba), T(0.0f), T(1.0f));
+    return vec2_t<T>(length(pa - V(ba.x, ba.y, ba.z) * h), h);
 }
 
-inline float sdSphere(const vec3& p, const vec3& c, float r) {
-    return length(p - c) - r;
+template <class V>
+inline scalar_t<V> sdSphere(const V& p, const vec3& c, float r) {
+    return length(p - V(c.x, c.y, c.z)) - r;
 }
 
-inline float sdEllipsoid(const vec3& p, const vec3& c, const vec3& r) {
-    return (length((p - c) / r) - 1.0f) * glm::min(glm::min(r.x, r.y), r.z);
+template <class V>
+inline scalar_t<V> sdEllipsoid(const V& p, const vec3& c, const vec3& r) {
+    return (length((p - V(c.x, c.y, c.z)) / V(r.x, r.y, r.z)) - 1.0f) * glm::min(glm::min(r.x, r.y), r.z);
 }
 
-inline float det2(const vec2& a, const vec2& b) { return a.x * b.y - b.x * a.y; }
-
-inline vec3 getClosest(const vec2& b0, const vec2& b1, const vec2& b2) {
-    float a = det2(b0, b2);
-    float b = 2.0f * det2(b1, b0);
-    float d = 2.0f * det2(b2, b1);
-    float f = b * d - a * a;
-    vec2 d21 = b2 - b1;
-    vec2 d10 = b1 - b0;
-    vec2 d20 = b2 - b0;
-    vec2 gf = 2.0f * (b * d21 + d * d10 + a * d20);
-    gf = vec2(gf.y, -gf.x);
-    vec2 pp = -f * gf / dot(gf, gf);
-    vec2 d0p = b0 - pp;
-    float ap = det2(d0p, d20);
-    float bp = 2.0f * det2(d10, d0p);
-    float t = clamp((ap + bp) / (2.0f * a + b + d), 0.0f, 1.0f);
-    return vec3(mix(mix(b0, b1, t), mix(b1, b2, t), t), t);
+template <class V2>
+inline scalar_t<V2> det2(const V2& a, const V2& b) { return a.x * b.y - b.x * a.y; }
+
+template <class V2>
+inline vec3_t<scalar_t<V2>> getClosest(const V2& b0, const V2& b1, const V2& b2) {
+    using T = scalar_t<V2>;
+    T a = det2(b0, b2);
+    T b = 2.0f * det2(b1, b0);
+    T d = 2.0f * det2(b2, b1);
+    T f = b * d - a * a;
+    V2 d21 = b2 - b1;
+    V2 d10 = b1 - b0;
+    V2 d20 = b2 - b0;
+    V2 gf = 2.0f * (b * d21 + d * d10 + a * d20);
+    gf = V2(gf.y, -gf.x);
+    V2 pp = -f * gf / dot(gf, gf);
+    V2 d0p = b0 - pp;
+    T ap = det2(d0p, d20);
+    T bp = 2.0f * det2(d10, d0p);
+    T t = clamp((ap + bp) / (2.0f * a + b + d), T(0.0f), T(1.0f));
+    V2 m = mix(mix(b0, b1, t), mix(b1, b2, t), t);
+    return vec3_t<T>(m.x, m.y, t);
 }
 
-inline vec2 sdBezier(const vec3& a, const vec3& b, const vec3& c, const vec3& p, vec2& pos) {
+template <class V>
+inline vec2_t<scalar_t<V>> sdBezier(const vec3& a, const vec3& b, const vec3& c, const V& p,
+                                     vec2_t<scalar_t<V>>& pos) {
+    using V2 = vec2_t<scalar_t<V>>;
     vec3 w = normalize(cross(c - b, a - b));
     vec3 u = normalize(c - b);
     vec3 v = normalize(cross(w, u));
@@ -67,12 +83,14 @@ inline vec2 sdBezier(const vec3& a, const vec3& b, const vec3& c, const vec3& p,
     vec2 a2 = vec2(dot(a - b, u), dot(a - b, v));
     vec2 b2 = vec2(0.0f);
     vec2 c2 = vec2(dot(c - b, u), dot(c - b, v));
-    vec3 p3 = vec3(dot(p - b, u), dot(p - b, v), dot(p - b, w));
+    V pb = p - V(b.x, b.y, b.z);
+    V p3 = V(dot(pb, u), dot(pb, v), dot(pb, w));
+    V2 p2 = V2(p3.x, p3.y);
 
-    vec3 cp = getClosest(a2 - vec2(p3.x, p3.y), b2 - vec2(p3.x, p3.y), c2 - vec2(p3.x, p3.y));
-    pos = vec2(cp.x, cp.y);
+    V cp = getClosest(V2(a2.x, a2.y) - p2, V2(b2.x, b2.y) - p2, V2(c2.x, c2.y) - p2);
+    pos = V2(cp.x, cp.y);
 
-    return vec2(sqrt(dot(vec2(cp.x, cp.y), vec2(cp.x, cp.y)) + p3.z * p3.z), cp.z);
+    return V2(sqrt(dot(V2(cp.x, cp.y), V2(cp.x, cp.y)) + p3.z * p3.z), cp.z);
 }
 
 inline mat3 base(const vec3& ww) {
@@ -81,10 +99,13 @@ inline mat3 base(const vec3& ww) {
     return mat3(uu.x, ww.x, vv.x, uu.y, ww.y, vv.y, uu.z, ww.z, vv.z);
 }
 
-inline float leg(const vec3& p, const vec3& pa, const vec3& pb, const vec3& pc, float m, float h) {
-    vec2 b = sdSegment(p, pa, pb);
-    float tr = 0.35f - 0.16f * smoothstep(0.0f, 1.0f, b.y);
-    float d3 = b.x - tr;
+template <class V>
+inline scalar_t<V> leg(const V& p, const vec3& pa, const vec3& pb, const vec3& pc, float m, float h) {
+    using T = scalar_t<V>;
+    using V2 = vec2_t<T>;
+    V2 b = sdSegment(p, pa, pb);
+    T tr = 0.35f - 0.16f * smoothstep(T(0.0f), T(1.0f), b.y);
+    T d3 = b.x - tr;
 
     b = sdSegment(p, pb, pc);
     tr = 0.18f;
@@ -93,84 +114,84 @@ inline float leg(const vec3& p, const vec3& pa, const vec3& pb, const vec3& pc,
     // paw
     vec3 ww = normalize(mix(normalize(pc - pb), vec3(0.0f, 1.0f, 0.0f), h));
     mat3 pr = base(ww);
-    vec3 fc = pr * (p - pc) - vec3(0.02f, 0.0f, 0.0f) * (-1.0f + 2.0f * h);
-    float d4 = sdEllipsoid(fc, vec3(0.0f), vec3(0.2f, 0.15f, 0.2f));
+    V fc = pr * (p - V(pc.x, pc.y, pc.z)) - V(0.02f, 0.0f, 0.0f) * (-1.0f + 2.0f * h);
+    T d4 = sdEllipsoid(fc, vec3(0.0f), vec3(0.2f, 0.15f, 0.2f));
 
     d3 = eleph_smin(d3, d4, 0.1f);
 
     // nails
-    float d6 = sdEllipsoid(fc, vec3(0.14f, -0.06f, 0.0f) * (-1.0f + 2.0f * h), vec3(0.1f, 0.16f, 0.1f));
-    d6 = glm::min(d6, sdEllipsoid(vec3(fc.x, fc.y, abs(fc.z)),
-                           vec3(0.13f * (-1.0f + 2.0f * h), -0.08f * (-1.0f + 2.0f * h), 0.13f),
-                           vec3(0.09f, 0.14f, 0.1f)));
+    T d6 = sdEllipsoid(fc, vec3(0.14f, -0.06f, 0.0f) * (-1.0f + 2.0f * h), vec3(0.1f, 0.16f, 0.1f));
+    d6 = min(d6, sdEllipsoid(V(fc.x, fc.y, abs(fc.z)),
+                             vec3(0.13f * (-1.0f + 2.0f * h), -0.08f * (-1.0f + 2.0f * h), 0.13f),
+                             vec3(0.09f, 0.14f, 0.1f)));
     d3 = eleph_smin(d3, d6, 0.001f);
     return d3;
 }
 
-inline float mapElephant(vec3 p, vec3& matInfo) {
-    matInfo = vec3(0.0f);
+template <class V>
+inline scalar_t<V> mapElephant(V p, V& matInfo) {
+    using T = scalar_t<V>;
+    using V2 = vec2_t<T>;
+    matInfo = V(0.0f, 0.0f, 0.0f);
 
     p.x -= -0.5f;
     p.y -= 2.4f;
 
-    vec3 ph = p;
+    V ph = p;
     float cc = 0.995f;
     float ss = 0.0998745f;
     mat2 rot1 = mat2(cc, -ss, ss, cc);
-    vec2 phyz = rot1 * vec2(ph.y, ph.z);
+    V2 phyz = rot1 * V2(ph.y, ph.z);
     ph.y = phyz.x; ph.z = phyz.y;
-    vec2 phxy = rot1 * vec2(ph.x, ph.y);
+    V2 phxy = rot1 * V2(ph.x, ph.y);
     ph.x = phxy.x; ph.y = phxy.y;
 
     // head
-    float d1 = sdEllipsoid(ph, vec3(0.0f, 0.05f, 0.0f), vec3(0.45f, 0.5f, 0.3f));
+    T d1 = sdEllipsoid(ph, vec3(0.0f, 0.05f, 0.0f), vec3(0.45f, 0.5f, 0.3f));
     d1 = eleph_smin(d1, sdEllipsoid(ph, vec3(-0.3f, 0.15f, 0.0f), vec3(0.2f, 0.2f, 0.2f)), 0.1f);
 
     // nose (trunk)
-    vec2 kk;
-    vec2 b1 = sdBezier(vec3(-0.15f, -0.05f, 0.0f), vec3(-0.7f, 0.0f, 0.0f),
-                       vec3(-0.7f, -0.8f, 0.0f), ph, kk);
-    float tr1 = 0.30f - 0.17f * smoothstep(0.0f, 1.0f, b1.y);
-    vec2 b2 = sdBezier(vec3(-0.7f, -0.8f, 0.0f), vec3(-0.7f, -1.5f, 0.0f),
-                       vec3(-0.4f, -1.6f, 0.2f), ph, kk);
-    float tr2 = 0.30f - 0.17f - 0.05f * smoothstep(0.0f, 1.0f, b2.y);
-    float bd1 = b1.x - tr1;
-    float bd2 = b2.x - tr2;
-    float nl = b1.y * 0.5f;
-    float bd = bd1;
-    if (bd2 < bd1) {
-        nl = 0.5f + 0.5f * b2.y;
-        bd = bd2;
-    }
-    matInfo.x = clamp(nl * (1.0f - smoothstep(0.0f, 0.2f, bd)), 0.0f, 1.0f);
-    float d2 = bd;
-    float xx = nl * 120.0f;
-    float ff = sin(xx + sin(xx + sin(xx + sin(xx))));
-    d2 += 0.003f * ff * (1.0f - nl) * (1.0f - nl) * smoothstep(0.0f, 0.1f, nl);
-
-    float d = eleph_smin(d1, d2, 0.2f);
+    V2 kk;
+    V2 b1 = sdBezier(vec3(-0.15f, -0.05f, 0.0f), vec3(-0.7f, 0.0f, 0.0f),
+                     vec3(-0.7f, -0.8f, 0.0f), ph, kk);
+    T tr1 = 0.30f - 0.17f * smoothstep(T(0.0f), T(1.0f), b1.y);
+    V2 b2 = sdBezier(vec3(-0.7f, -0.8f, 0.0f), vec3(-0.7f, -1.5f, 0.0f),
+                     vec3(-0.4f, -1.6f, 0.2f), ph, kk);
+    T tr2 = 0.30f - 0.17f - 0.05f * smoothstep(T(0.0f), T(1.0f), b2.y);
+    T bd1 = b1.x - tr1;
+    T bd2 = b2.x - tr2;
+    auto second = bd2 < bd1;
+    T nl = select(second, 0.5f + 0.5f * b2.y, b1.y * 0.5f);
+    T bd = select(second, bd2, bd1);
+    matInfo.x = clamp(nl * (1.0f - smoothstep(T(0.0f), T(0.2f), bd)), T(0.0f), T(1.0f));
+    T d2 = bd;
+    T xx = nl * 120.0f;
+    T ff = sin(xx + sin(xx + sin(xx + sin(xx))));
+    d2 += 0.003f * ff * (1.0f - nl) * (1.0f - nl) * smoothstep(T(0.0f), T(0.1f), nl);
+
+    T d = eleph_smin(d1, d2, 0.2f);
 
     // teeth (tusks)
-    vec3 q = vec3(p.x, p.y, abs(p.z));
-    vec3 qh = vec3(ph.x, ph.y, abs(ph.z));
+    V q = V(p.x, p.y, abs(p.z));
+    V qh = V(ph.x, ph.y, abs(ph.z));
     {
-        vec2 s1 = sdSegment(qh, vec3(-0.4f, -0.1f, 0.1f), vec3(-0.5f, -0.4f, 0.28f));
-        float d3 = s1.x - 0.18f * (1.0f - 0.3f * smoothstep(0.0f, 1.0f, s1.y));
+        V2 s1 = sdSegment(qh, vec3(-0.4f, -0.1f, 0.1f), vec3(-0.5f, -0.4f, 0.28f));
+        T d3 = s1.x - 0.18f * (1.0f - 0.3f * smoothstep(T(0.0f), T(1.0f), s1.y));
         d = eleph_smin(d, d3, 0.1f);
     }
 
     // eyes
     {
-        vec2 s1 = sdSegment(qh, vec3(-0.2f, 0.2f, 0.11f), vec3(-0.3f, -0.0f, 0.26f));
-        float d3 = s1.x - 0.19f * (1.0f - 0.3f * smoothstep(0.0f, 1.0f, s1.y));
+        V2 s1 = sdSegment(qh, vec3(-0.2f, 0.2f, 0.11f), vec3(-0.3f, -0.0f, 0.26f));
+        T d3 = s1.x - 0.19f * (1.0f - 0.3f * smoothstep(T(0.0f), T(1.0f), s1.y));
         d = eleph_smin(d, d3, 0.03f);
 
-        float st = length(vec2(qh.x, qh.y) - vec2(-0.31f, -0.02f));
-        d += 0.0015f * sin(250.0f * st) * (1.0f - smoothstep(0.0f, 0.2f, st));
+        T st = length(V2(qh.x, qh.y) - V2(-0.31f, -0.02f));
+        d += 0.0015f * sin(250.0f * st) * (1.0f - smoothstep(T(0.0f), T(0.2f), st));
 
         mat3 rot3 = mat3(0.8f, -0.6f, 0.0f, 0.6f, 0.8f, 0.0f, 0.0f, 0.0f, 1.0f);
-        float d4 = sdEllipsoid(rot3 * (qh - vec3(-0.31f, -0.02f, 0.34f)), vec3(0.0f),
-                               vec3(0.1f, 0.08f, 0.07f) * 0.7f);
+        T d4 = sdEllipsoid(rot3 * (qh - V(-0.31f, -0.02f, 0.34f)), vec3(0.0f),
+                           vec3(0.1f, 0.08f, 0.07f) * 0.7f);
         d = eleph_smax(d, -d4, 0.02f);
     }
 
@@ -178,12 +199,12 @@ inline float mapElephant(vec3 p, vec3& matInfo) {
     {
         float co = cos(0.4f);
         float si = sin(0.4f);
-        vec3 w = p;
+        V w = p;
         mat2 rotw = mat2(co, si, -si, co);
-        vec2 wxy = rotw * vec2(w.x, w.y);
+        V2 wxy = rotw * V2(w.x, w.y);
         w.x = wxy.x; w.y = wxy.y;
 
-        float d4 = sdEllipsoid(w, vec3(0.6f, 0.3f, 0.0f), vec3(0.6f, 0.6f, 0.6f));
+        T d4 = sdEllipsoid(w, vec3(0.6f, 0.3f, 0.0f), vec3(0.6f, 0.6f, 0.6f));
         d = eleph_smin(d, d4, 0.1f);
 
         d4 = sdEllipsoid(w, vec3(1.8f, 0.3f, 0.0f), vec3(1.2f, 0.9f, 0.7f));
@@ -198,24 +219,24 @@ inline float mapElephant(vec3 p, vec3& matInfo) {
 
     // back-left leg
     {
-        float d3 = leg(q, vec3(2.6f, -0.5f, 0.3f), vec3(2.65f, -1.45f, 0.3f),
-                       vec3(2.6f, -2.1f, 0.25f), 1.0f, 0.0f);
+        T d3 = leg(q, vec3(2.6f, -0.5f, 0.3f), vec3(2.65f, -1.45f, 0.3f),
+                   vec3(2.6f, -2.1f, 0.25f), 1.0f, 0.0f);
         d = eleph_smin(d, d3, 0.1f);
     }
 
     // tail
     {
-        vec2 b = sdBezier(vec3(2.8f, 0.2f, 0.0f), vec3(3.4f, -0.6f, 0.0f),
-                          vec3(3.1f, -1.6f, 0.0f), p, kk);
-        float tr = 0.10f - 0.07f * b.y;
-        float d_tail = b.x - tr;
+        V2 b = sdBezier(vec3(2.8f, 0.2f, 0.0f), vec3(3.4f, -0.6f, 0.0f),
+                        vec3(3.1f, -1.6f, 0.0f), p, kk);
+        T tr = 0.10f - 0.07f * b.y;
+        T d_tail = b.x - tr;
         d = eleph_smin(d, d_tail, 0.05f);
     }
 
     // front legs
     {
-        float d3 = leg(p, vec3(0.8f, -0.4f, 0.3f), vec3(0.7f, -1.55f, 0.3f),
-                       vec3(0.8f, -2.1f, 0.3f), 1.0f, 0.0f);
+        T d3 = leg(p, vec3(0.8f, -0.4f, 0.3f), vec3(0.7f, -1.55f, 0.3f),
+                   vec3(0.8f, -2.1f, 0.3f), 1.0f, 0.0f);
         d = eleph_smin(d, d3, 0.15f);
         d3 = leg(p, vec3(0.8f, -0.4f, -0.3f), vec3(0.4f, -1.55f, -0.3f),
                  vec3(0.4f, -2.1f, -0.3f), 1.0f, 0.0f);
@@ -225,65 +246,68 @@ inline float mapElephant(vec3 p, vec3& matInfo) {
     // ear
     float co = cos(0.5f);
     float si = sin(0.5f);
-    vec3 w = qh;
+    V w = qh;
     mat2 rotw = mat2(co, si, -si, co);
-    vec2 wxz = rotw * vec2(w.x, w.z);
+    V2 wxz = rotw * V2(w.x, w.z);
     w.x = wxz.x; w.z = wxz.y;
 
-    vec2 ep = vec2(w.z, w.y) - vec2(0.5f, 0.4f);
-    float aa = atan(ep.x, ep.y);
-    w.x += 0.003f * sin(24.0f * aa) * smoothstep(0.0f, 0.5f, dot(ep, ep));
+    V2 ep = V2(w.z, w.y) - V2(0.5f, 0.4f);
+    T aa = atan2(ep.x, ep.y);
+    w.x += 0.003f * sin(24.0f * aa) * smoothstep(T(0.0f), T(0.5f), dot(ep, ep));
 
-    float r = 0.02f * sin(24.0f * atan(ep.x, ep.y)) * clamp(-w.y * 1000.0f, 0.0f, 1.0f);
+    T r = 0.02f * sin(24.0f * atan2(ep.x, ep.y)) * clamp(-w.y * 1000.0f, T(0.0f), T(1.0f));
     r += 0.01f * sin(15.0f * w.z);
     
-    float d4 = length(vec2(w.z, w.y) - vec2(0.5f, -0.2f + 0.03f)) - 0.8f + r;
-    float d5 = length(vec2(w.z, w.y) - vec2(-0.1f, 0.6f + 0.03f)) - 1.5f + r;
-    float d6 = length(vec2(w.z, w.y) - vec2(1.8f, 0.1f + 0.03f)) - 1.6f + r;
+    T d4 = length(V2(w.z, w.y) - V2(0.5f, -0.2f + 0.03f)) - 0.8f + r;
+    T d5 = length(V2(w.z, w.y) - V2(-0.1f, 0.6f + 0.03f)) - 1.5f + r;
+    T d6 = length(V2(w.z, w.y) - V2(1.8f, 0.1f + 0.03f)) - 1.6f + r;
     d4 = eleph_smax(d4, d5, 0.1f);
     d4 = eleph_smax(d4, d6, 0.1f);
 
-    float wi = 0.02f + 0.1f * pow(clamp(1.0f - 0.7f * w.z + 0.3f * w.y, 0.0f, 1.0f), 2.0f);
+    // Squared by hand: the float build folds pow(x, 2.0f) to x * x
+    T wc = clamp(1.0f - 0.7f * w.z + 0.3f * w.y, T(0.0f), T(1.0f));
+    T wi = 0.02f + 0.1f * (wc * wc);
     w.x += 0.05f * cos(6.0f * w.y);
 
     d4 = eleph_smax(d4, -w.x, 0.03f);
     d4 = eleph_smax(d4, w.x - wi, 0.03f);
 
-    matInfo.y = clamp(length(ep), 0.0f, 1.0f) * (1.0f - smoothstep(-0.1f, 0.05f, d4));
+    matInfo.y = clamp(length(ep), T(0.0f), T(1.0f)) * (1.0f - smoothstep(T(-0.1f), T(0.05f), d4));
 
-    d = eleph_smin(d, d4, 0.3f * glm::max(qh.y, 0.0f));
+    d = eleph_smin(d, d4, 0.3f * max(qh.y, T(0.0f)));
 
     // connection ear/head
-    vec2 s1 = sdBezier(vec3(-0.15f, 0.3f, 0.0f), vec3(0.1f, 0.6f, 0.2f),
-                       vec3(0.35f, 0.6f, 0.5f), qh, kk);
-    float d3 = s1.x - 0.08f * (1.0f - 0.95f * s1.y * s1.y);
+    V2 s1 = sdBezier(vec3(-0.15f, 0.3f, 0.0f), vec3(0.1f, 0.6f, 0.2f),
+                     vec3(0.35f, 0.6f, 0.5f), qh, kk);
+    T d3 = s1.x - 0.08f * (1.0f - 0.95f * s1.y * s1.y);
     d = eleph_smin(d, d3, 0.05f);
 
     // tusks
-    vec2 b = sdBezier(vec3(-0.5f, -0.4f, 0.28f), vec3(-0.5f, -0.7f, 0.32f),
-                      vec3(-1.0f, -0.8f, 0.45f), qh, kk);
-    float tr = 0.10f - 0.08f * b.y;
+    V2 b = sdBezier(vec3(-0.5f, -0.4f, 0.28f), vec3(-0.5f, -0.7f, 0.32f),
+                    vec3(-1.0f, -0.8f, 0.45f), qh, kk);
+    T tr = 0.10f - 0.08f * b.y;
     d2 = b.x - tr;
     
     // eyeball
     mat3 rot3 = mat3(0.8f, -0.6f, 0.0f, 0.6f, 0.8f, 0.0f, 0.0f, 0.0f, 1.0f);
-    d4 = sdEllipsoid(rot3 * (qh - vec3(-0.31f, -0.02f, 0.33f)), vec3(0.0f),
+    d4 = sdEllipsoid(rot3 * (qh - V(-0.31f, -0.02f, 0.33f)), vec3(0.0f),
                      vec3(0.1f, 0.08f, 0.07f) * 0.7f);
 
-    d = glm::min(d4, glm::min(d, d2));
+    d = min(d4, min(d, d2));
 
     return d;
 }
 
 } // namespace elephant_detail
 
-inline float Elephant(const vec3& p_in, float /*time*/, uint32_t /*seed*/) {
-    vec3 p = p_in;
+template <class V>
+inline scalar_t<V> Elephant(const V& p_in, float /*time*/, uint32_t /*seed*/) {
+    V p = p_in;
     p = p * rotationMatrix(vec3(0.0f, 1.0f, 0.0f), -pi / 2.0f);
-    p += vec3(0.2f, 0.4f, 0.0f);
+    p += V(0.2f, 0.4f, 0.0f);
     const float scale = 0.3f;
     p *= 1.0f / scale;
-    vec3 matInfo = vec3(0.0f);
+    V matInfo = V(0.0f, 0.0f, 0.0f);
     return elephant_detail::mapElephant(p, matInfo) * scale * 0.9f;
 }
 
@@ -18,89 +18,120 @@ inline mat3 alignMatrix(const vec3& right, const vec3& up) {
     return mat3(right, up, cross(right, up));
 }
 
-inline float opUnion(float d1, float d2, float k) {
-    float h = clamp(0.5f + 0.5f * (d2 - d1) / k, 0.0f, 1.0f);
+template <class T>
+inline T opUnion(T d1, T d2, float k) {
+    T h = clamp(0.5f + 0.5f * (d2 - d1) / k, T(0.0f), T(1.0f));
     return mix(d2, d1, h) - k * h * (1.0f - h);
 }
 
-inline float opDiff(float d1, float d2, float k) {
-    float h = clamp(0.5f - 0.5f * (d2 + d1) / k, 0.0f, 1.0f);
+template <class T>
+inline T opDiff(T d1, T d2, float k) {
+    T h = clamp(0.5f - 0.5f * (d2 + d1) / k, T(0.0f), T(1.0f));
     return mix(d1, -d2, h) + k * h * (1.0f - h);
 }
 
-inline float opUnion(float d1, float d2) { return opUnion(d1, d2, 0.5f); }
-inline float opDiff(float d1, float d2) { return opDiff(d1, d2, 0.0f); }
+template <class T>
+inline T opUnion(T d1, T d2) { return opUnion(d1, d2, 0.5f); }
+template <class T>
+inline T opDiff(T d1, T d2) { return opDiff(d1, d2, 0.0f); }
 
+template <class V>
 struct SDF {
-    vec3 pos;
-    float dist;
-    int mat;
+    V pos;
+    scalar_t<V> dist;
+    scalar_t<V> mat;
 };
 
-inline float sdSphere(const SDF& s, const vec3& a, float r) {
-    return length(s.pos - a) - r;
+// Takes d with material mat where it is closer than s.dist
+template <class V>
+inline void closest(SDF<V>& s, scalar_t<V> d, float mat) {
+    auto c = d < s.dist;
+    s.dist = select(c, d, s.dist);
+    s.mat = select(c, scalar_t<V>(mat), s.mat);
 }
 
-inline float sdPlane(const SDF& s, const vec3& a, const vec3& n) {
-    return dot(n, s.pos - a);
+template <class V>
+inline scalar_t<V> sdSphere(const SDF<V>& s, const vec3& a, float r) {
+    return length(s.pos - V(a.x, a.y, a.z)) - r;
 }
 
-inline float sdPlane(const SDF& s, const vec3& n) {
-    return dot(n, s.pos);
+template <class V>
+inline scalar_t<V> sdPlane(const SDF<V>& s, const vec3& a, const vec3& n) {
+    return dot(s.pos - V(a.x, a.y, a.z), n);
 }
 
-inline float sdBox(const SDF& s, const vec3& a, const vec3& b, float r) {
-    vec3 q = abs(s.pos - a) - (b - r);
-    return length(max(q, vec3(0.0f))) + glm::min(glm::max(q.x, glm::max(q.y, q.z)), 0.0f) - r;
+template <class V>
+inline scalar_t<V> sdPlane(const SDF<V>& s, const vec3& n) {
+    return dot(s.pos, n);
 }
 
-inline float sdBox(const SDF& s, const vec3& a, const vec3& right, const vec3& up, const vec3& dim, float r) {
-    SDF ss = s;
-    ss.pos -= a;
+template <class V>
+inline scalar_t<V> sdBox(const SDF<V>& s, const vec3& a, const vec3& b, float r) {
+    vec3 br = b - r;
+    V q = abs(s.pos - V(a.x, a.y, a.z)) - V(br.x, br.y, br.z);
+    return length(max(q, V(0.0f))) + min(max(q.x, max(q.y, q.z)), 0.0f) - r;
+}
+
+template <class V>
+inline scalar_t<V> sdBox(const SDF<V>& s, const vec3& a, const vec3& right, const vec3& up, const vec3& dim, float r) {
+    SDF<V> ss = s;
+    ss.pos -= V(a.x, a.y, a.z);
     ss.pos = alignMatrix(right, up) * ss.pos;
     return sdBox(ss, v0, dim, r);
 }
 
-inline float sdEllipsoid(const SDF& s, const vec3& a, const vec3& r) {
-    vec3 p = s.pos - a;
-    float k0 = length(p / r);
-    float k1 = length(p / (r * r));
+template <class V>
+inline scalar_t<V> sdEllipsoid(const SDF<V>& s, const vec3& a, const vec3& r) {
+    using T = scalar_t<V>;
+    vec3 rr = r * r;
+    V p = s.pos - V(a.x, a.y, a.z);
+    T k0 = length(p / V(r.x, r.y, r.z));
+    T k1 = length(p / V(rr.x, rr.y, rr.z));
     return k0 * (k0 - 1.0f) / k1;
 }
 
-inline float sdCone(const SDF& s, const vec3& a, float r1, float r2, float h) {
-    vec3 p = s.pos - a;
-    vec2 q = vec2(length(vec2(p.x, p.z)), p.y);
+template <class V>
+inline scalar_t<V> sdCone(const SDF<V>& s, const vec3& a, float r1, float r2, float h) {
+    using T = scalar_t<V>;
+    using V2 = vec2_t<T>;
+    V p = s.pos - V(a.x, a.y, a.z);
+    V2 q = V2(length(V2(p.x, p.z)), p.y);
     float b = (r1 - r2) / h;
     float c = sqrt(1.0f - b * b);
-    float k = dot(q, vec2(-b, c));
-    if (k < 0.0f) return length(q) - r1;
-    if (k > c * h) return length(q - vec2(0.0f, h)) - r2;
-    return dot(q, vec2(c, b)) - r1;
+    T k = dot(q, vec2(-b, c));
+    return select(k < 0.0f, length(q) - r1,
+                  select(k > c * h, length(q - V2(0.0f, h)) - r2, dot(q, vec2(c, b)) - r1));
 }
 
-inline float sdCapsule(const SDF& s, const vec3& a, const vec3& b, float r) {
+template <class V>
+inline scalar_t<V> sdCapsule(const SDF<V>& s, const vec3& a, const vec3& b, float r) {
+    using T = scalar_t<V>;
     vec3 ab = b - a;
-    vec3 ap = s.pos - a;
-    float t = dot(ab, ap) / dot(ab, ab);
-    t = clamp(t, 0.0f, 1.0f);
-    vec3 c = a + t * ab;
+    V ap = s.pos - V(a.x, a.y, a.z);
+    T t = dot(ap, ab) / dot(ab, ab);
+    t = clamp(t, T(0.0f), T(1.0f));
+    V c = V(a.x, a.y, a.z) + t * V(ab.x, ab.y, ab.z);
     return length(s.pos - c) - r;
 }
 
-inline void skull(SDF& s) {
+template <class V>
+inline void skull(SDF<V>& s) {
+    using T = scalar_t<V>;
     s.pos.x = abs(s.pos.x);
     s.pos.y -= 0.15f;
     s.pos = alignMatrix(vx, normalize(vec3(0.0f, 1.0f, -0.5f))) * s.pos;
 
-    float d, h;
+    T d, h;
 
     d = sdEllipsoid(s, vy, vec3(5.5f, 5.5f, 5.0f)); // frontal
 
-    if (d > 15.0f) {
-        s.dist = glm::min(s.dist, d);
+    auto far = d > 15.0f;
+    T farDist = min(s.dist, d);
+    if (all(far)) {
+        s.dist = farDist;
         return;
     }
+    const T mat = s.mat;
 
     d = opUnion(d, sdSphere(s, 2.0f * vy - 2.0f * vz, 6.0f), 1.0f);            // parietal
     d = opDiff(d, sdPlane(s, -vy, vy), 1.5f);                                   // cranial cutoff
@@ -116,27 +147,29 @@ inline void skull(SDF& s) {
     h = opUnion(h, sdCapsule(s, vy - 2.0f * vz, vy - 0.5f * vz, 3.6f));
     d = opDiff(d, h, 1.0f);
 
-    if (d < s.dist) {
-        s.dist = d;
-        s.mat = 0;
-    }
+    closest(s, d, 0.0f);
 
     // teeth
-    float td;
+    T td;
     td = sdBox(s, 0.47f * vx - 2.8f * vy + 6.1f * vz, normalize(vec3(1.0f, 0.0f, -0.2f)), vy, vec3(0.50f, 0.70f, 0.3f), 0.3f);
-    if (td < s.dist) { s.dist = td; s.mat = 1; }
+    closest(s, td, 1.0f);
     td = sdBox(s, 1.29f * vx - 2.8f * vy + 5.7f * vz, normalize(vec3(1.0f, 0.0f, -0.8f)), vy, vec3(0.47f, 0.65f, 0.3f), 0.3f);
-    if (td < s.dist) { s.dist = td; s.mat = 1; }
+    closest(s, td, 1.0f);
     td = sdBox(s, 1.80f * vx - 2.8f * vy + 5.0f * vz, normalize(vec3(0.4f, 0.0f, -1.0f)), vy, vec3(0.47f, 0.65f, 0.3f), 0.3f);
-    if (td < s.dist) { s.dist = td; s.mat = 1; }
+    closest(s, td, 1.0f);
     td = sdBox(s, 2.00f * vx - 2.8f * vy + 4.1f * vz, normalize(vec3(0.0f, 0.0f, -1.0f)), vy, vec3(0.47f, 0.65f, 0.3f), 0.3f);
-    if (td < s.dist) { s.dist = td; s.mat = 1; }
+    closest(s, td, 1.0f);
+
+    s.dist = select(far, farDist, s.dist);
+    s.mat = select(far, mat, s.mat);
 }
 
-inline void bone(SDF& s) {
+template <class V>
+inline void bone(SDF<V>& s) {
+    using T = scalar_t<V>;
     s.pos.x = abs(s.pos.x);
 
-    float d;
+    T d;
     vec3 ctr = 5.0f * vz - 1.8f * vy;
     vec3 rgt = 7.0f * vx + ctr + 3.0f * vz;
     d = sdCapsule(s, ctr, rgt, 0.9f);
@@ -145,21 +178,19 @@ inline void bone(SDF& s) {
 
     rgt -= 6.0f * vz;
     rgt += (rgt - ctr) * 0.3f;
-    d = glm::min(d, sdCapsule(s, ctr, rgt, 0.9f));
+    d = min(d, sdCapsule(s, ctr, rgt, 0.9f));
     d = opUnion(d, sdSphere(s, rgt - vz, 1.7f), 0.5f);
     d = opUnion(d, sdSphere(s, rgt + vz - vx, 1.5f), 0.5f);
 
-    if (d < s.dist) {
-        s.dist = d;
-        s.mat = 2;
-    }
+    closest(s, d, 2.0f);
 }
 
-inline float map(const vec3& p) {
-    SDF s;
+template <class V>
+inline scalar_t<V> map(const V& p) {
+    SDF<V> s;
     s.dist = 10.0f;
     s.pos = p;
-    s.mat = -1;
+    s.mat = -1.0f;
 
     bone(s);
     skull(s);
@@ -169,8 +200,9 @@ inline float map(const vec3& p) {
 
 } // namespace humanskull_detail
 
-inline float HumanSkull(const vec3& p_in, float /*time*/, uint32_t /*seed*/) {
-    vec3 p = p_in + vec3(0.0f, 0.0f, 0.15f);
+template <class V>
+inline scalar_t<V> HumanSkull(const V& p_in, float /*time*/, uint32_t /*seed*/) {
+    V p = p_in + V(0.0f, 0.0f, 0.15f);
     const float scale = 0.075f;
     p *= 1.0f / scale;
     return humanskull_detail::map(p) * scale;
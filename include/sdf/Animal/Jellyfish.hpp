@@ -23,85 +23,110 @@ inline vec3 N31(float p) {
     return fract(vec3((p3.x + p3.y) * p3.z, (p3.x + p3.z) * p3.y, (p3.y + p3.z) * p3.x));
 }
 
-inline float jelly_smin(float a, float b, float k) {
-    float h = clamp(0.5f + 0.5f * (b - a) / k, 0.0f, 1.0f);
+template <class T>
+inline T jelly_smin(T a, T b, float k) {
+    T h = clamp(0.5f + 0.5f * (b - a) / k, T(0.0f), T(1.0f));
     return mix(b, a, h) - k * h * (1.0f - h);
 }
 
-inline float jelly_smax(float a, float b, float k) {
-    float h = clamp(0.5f + 0.5f * (b - a) / k, 0.0f, 1.0f);
+template <class T>
+inline T jelly_smax(T a, T b, float k) {
+    T h = clamp(0.5f + 0.5f * (b - a) / k, T(0.0f), T(1.0f));
     return mix(a, b, h) + k * h * (1.0f - h);
 }
 
-inline float sdSphere(const vec3& p, const vec3& pos, float s) {
-    return length(p - pos) - s;
+template <class V>
+inline scalar_t<V> sdSphere(const V& p, const vec3& pos, float s) {
+    return length(p - V(pos.x, pos.y, pos.z)) - s;
 }
 
-inline vec2 pModPolar(vec2& p, float repetitions, float fix) {
+template <class V2>
+inline V2 pModPolar(V2& p, float repetitions, float fix) {
+    using T = scalar_t<V2>;
     float angle = pi * 2.0f / repetitions;
-    float a = atan(p.y, p.x) + angle / 2.0f;
-    float r = length(p);
-    float c = floor(a / angle);
+    T a = atan2(p.y, p.x) + angle / 2.0f;
+    T r = length(p);
     a = mod(a, angle) - (angle / 2.0f) * fix;
-    p = vec2(cos(a), sin(a)) * r;
+    p = V2(cos(a), sin(a)) * r;
     return p;
 }
 
-inline float remap(float a, float b, float c, float d, float t) {
+template <class T>
+inline T remap(float a, float b, float c, float d, T t) {
     return ((t - a) / (b - a)) * (d - c) + c;
 }
 
-inline float jelly_map(const vec3& p_in, const vec3& id, float time) {
-    float t = time * 2.0f;
-    
-    float N = N3(id);
+// Quantities of jelly_map() that depend only on the jellyfish and time
+struct Frame {
+    float t;     // Animation phase
+    float N;     // Per-jellyfish random value
+    float bob;   // Vertical offset of the bell
+};
+
+inline Frame frame(const vec3& id, float time) {
+    Frame f;
+    f.t = time * 2.0f;
+    f.N = N3(id);
+    float x = f.t + f.N * pi * 2.0f;
+    f.bob = (cos(x + cos(x)) + sin(2.0f * x) * 0.2f) * 0.6f;
+    return f;
+}
+
+template <class V>
+inline scalar_t<V> jelly_map(const V& p_in, const Frame& frame) {
+    using T = scalar_t<V>;
+    using V2 = vec2_t<T>;
+    const float t = frame.t;
+    const float N = frame.N;
     
-    float x = (p_in.y + N * pi * 2.0f) * 1.0f + t;
+    T x = (p_in.y + N * pi * 2.0f) * 1.0f + t;
     float r = 1.0f;
     
-    float pump = cos(x + cos(x)) + sin(2.0f * x) * 0.2f + sin(4.0f * x) * 0.02f;
+    T pump = cos(x + cos(x)) + sin(2.0f * x) * 0.2f + sin(4.0f * x) * 0.02f;
     
-    x = t + N * pi * 2.0f;
-    vec3 p = p_in;
-    p.y -= (cos(x + cos(x)) + sin(2.0f * x) * 0.2f) * 0.6f;
+    V p = p_in;
+    p.y -= frame.bob;
     p.x *= 1.0f + pump * 0.2f;
     p.z *= 1.0f + pump * 0.2f;
     
-    float d1 = sdSphere(p, vec3(0.0f, 0.0f, 0.0f), r);
-    float d2 = sdSphere(p, vec3(0.0f, -0.5f, 0.0f), r);
+    T d1 = sdSphere(p, vec3(0.0f, 0.0f, 0.0f), r);
+    T d2 = sdSphere(p, vec3(0.0f, -0.5f, 0.0f), r);
     
-    float d = jelly_smax(d1, -d2, 0.1f);
+    T d = jelly_smax(d1, -d2, 0.1f);
     
-    if (p.y < 0.5f) {
-        float sway = sin(t + p.y + N * pi * 2.0f) * smoothstep(0.5f, -3.0f, p.y) * N * 0.3f;
-        vec3 mp = p;
+    auto below = p.y < 0.5f;
+    if (any(below)) {
+        T sway = sin(t + p.y + N * pi * 2.0f) * smoothstep(0.5f, -3.0f, p.y) * N * 0.3f;
+        V mp = p;
         mp.x += sway * N;
         mp.z += sway * (1.0f - N);
         
-        vec2 mpxz = vec2(mp.x, mp.z);
+        V2 mpxz = V2(mp.x, mp.z);
         pModPolar(mpxz, 6.0f, 0.0f);
         mp.x = mpxz.x;
         mp.z = mpxz.y;
         
-        float d3 = length(vec2(mp.x, mp.z) - vec2(0.2f, 0.1f)) - remap(0.5f, -3.5f, 0.1f, 0.01f, mp.y);
+        T d3 = length(V2(mp.x, mp.z) - V2(0.2f, 0.1f)) - remap(0.5f, -3.5f, 0.1f, 0.01f, mp.y);
         d3 += (sin(mp.y * 10.0f) + sin(mp.y * 23.0f)) * 0.03f;
         
-        float d32 = length(vec2(mp.x, mp.z) - vec2(0.2f, 0.1f)) - remap(0.5f, -3.5f, 0.1f, 0.04f, mp.y) * 0.5f;
-        d3 = glm::min(d3, d32);
-        d = jelly_smin(d, d3, 0.5f);
+        T d32 = length(V2(mp.x, mp.z) - V2(0.2f, 0.1f)) - remap(0.5f, -3.5f, 0.1f, 0.04f, mp.y) * 0.5f;
+        d3 = min(d3, d32);
+        T dt = jelly_smin(d, d3, 0.5f);
         
-        if (p.y < 0.2f) {
-            vec3 op = p;
+        auto tentacles = p.y < 0.2f;
+        if (any(tentacles)) {
+            V op = p;
             op.x += sway * N;
             op.z += sway * (1.0f - N);
-            vec2 opxz = vec2(op.x, op.z);
+            V2 opxz = V2(op.x, op.z);
             pModPolar(opxz, 13.0f, 1.0f);
             op.x = opxz.x;
             op.z = opxz.y;
             
-            float d4 = length(vec2(op.x, op.z) - vec2(0.85f, 0.0f)) - remap(0.5f, -3.0f, 0.04f, 0.0f, op.y);
-            d = jelly_smin(d, d4, 0.15f);
+            T d4 = length(V2(op.x, op.z) - V2(0.85f, 0.0f)) - remap(0.5f, -3.0f, 0.04f, 0.0f, op.y);
+            dt = select(tentacles, jelly_smin(dt, d4, 0.15f), dt);
         }
+        d = select(below, dt, d);
     }
     
     d *= 0.8f;
@@ -110,11 +135,26 @@ inline float jelly_map(const vec3& p_in, const vec3& id, float time) {
 
 } // namespace jellyfish_detail
 
-inline float Jellyfish(const vec3& p_in, float time, uint32_t /*seed*/) {
-    vec3 p = p_in + vec3(0.0f, -0.6f, 0.0f);
+// Per-frame constants of Jellyfish
+struct JellyfishFrame {
+    jellyfish_detail::Frame map;
+};
+
+inline JellyfishFrame prepareJellyfish(float time, uint32_t /*seed*/) {
+    return JellyfishFrame{jellyfish_detail::frame(vec3(0.0f), time)};
+}
+
+template <class V>
+inline scalar_t<V> Jellyfish(const V& p_in, const JellyfishFrame& frame) {
+    V p = p_in + V(0.0f, -0.6f, 0.0f);
     const float scale = 0.26f;
     p *= 1.0f / scale;
-    return jellyfish_detail::jelly_map(p, vec3(0.0f), time) * scale;
+    return jellyfish_detail::jelly_map(p, frame.map) * scale;
+}
+
+template <class V>
+inline scalar_t<V> Jellyfish(const V& p_in, float time, uint32_t seed) {
+    return Jellyfish(p_in, prepareJellyfish(time, seed));
 }
 
 } // namespace sdf::animal
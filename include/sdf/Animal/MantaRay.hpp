@@ -8,104 +8,149 @@ namespace sdf::animal {
 
 namespace mantaray_detail {
 
-inline float softMin(float a, float b, float k) {
-    float h = clamp(0.5f + 0.5f * (b - a) / k, 0.0f, 1.0f);
+template <class T>
+inline T softMin(T a, T b, float k) {
+    T h = clamp(0.5f + 0.5f * (b - a) / k, T(0.0f), T(1.0f));
     return mix(b, a, h) - k * h * (1.0f - h);
 }
 
-inline float sphere(const vec3& p, float r) {
+template <class V>
+inline scalar_t<V> sphere(const V& p, float r) {
     return length(p) - r;
 }
 
-inline float sdEllipsoid(const vec3& p, const vec3& r) {
+template <class V>
+inline scalar_t<V> sdEllipsoid(const V& p, const vec3& r) {
+    using T = scalar_t<V>;
     float smallestSize = glm::min(glm::min(r.x, r.y), r.z);
-    vec3 deformedP = p / r;
-    float d = length(deformedP) - 1.0f;
+    V deformedP = p / V(r.x, r.y, r.z);
+    T d = length(deformedP) - 1.0f;
     return d * smallestSize;
 }
 
-inline float sdBox(const vec3& p, const vec3& b) {
-    vec3 d = abs(p) - b;
-    return glm::min(glm::max(d.x, glm::max(d.y, d.z)), 0.0f) + length(max(d, vec3(0.0f)));
+template <class V>
+inline scalar_t<V> sdBox(const V& p, const V& b) {
+    V d = abs(p) - b;
+    return min(max(d.x, max(d.y, d.z)), 0.0f) + length(max(d, V(0.0f)));
 }
 
-inline float wings(const vec3& p) {
+template <class V>
+inline scalar_t<V> wings(const V& p) {
+    using T = scalar_t<V>;
     vec3 r = vec3(1.5f, 0.15f, 0.55f);
     float smallestSize = glm::min(glm::min(r.x, r.y), r.z);
     
-    vec3 dp = p / r;
+    V dp = p / V(r.x, r.y, r.z);
     dp.z -= dp.x * dp.x * 0.8f;
     dp.z -= (dp.x - 0.6f) * (dp.x - 0.5f);
     dp.y -= 0.6f;
     
-    float d = (dp.y * dp.y + dp.z * dp.z);
+    T d = (dp.y * dp.y + dp.z * dp.z);
     d += abs(dp.x);
     d -= 1.0f;
     
     return d * smallestSize;
 }
 
-inline float mantabody(const vec3& p_in) {
-    vec3 p = p_in;
+template <class V>
+inline scalar_t<V> mantabody(const V& p_in) {
+    using T = scalar_t<V>;
+    V p = p_in;
     
-    float d = sdEllipsoid(p, vec3(0.4f, 0.3f, 0.8f));
+    T d = sdEllipsoid(p, vec3(0.4f, 0.3f, 0.8f));
     
-    if (p.z < 1.0f && p.z > -1.4f && p.y < 1.0f && p.y > -0.2f) {
-        d = softMin(d, wings(p), 0.4f);
+    auto inWings = (p.z < 1.0f) & (p.z > -1.4f) & (p.y < 1.0f) & (p.y > -0.2f);
+    if (any(inWings)) {
+        d = select(inWings, softMin(d, wings(p), 0.4f), d);
     }
     
-    vec3 flapsP;
+    V flapsP;
     vec3 flapsScale;
     
-    if (p.x < 1.0f && p.z < -0.2f && p.z > -1.4f && p.y < 0.2f && p.y > -0.2f) {
+    auto inFlaps = (p.x < 1.0f) & (p.z < -0.2f) & (p.z > -1.4f) & (p.y < 0.2f) & (p.y > -0.2f);
+    if (any(inFlaps)) {
         flapsP = p;
-        flapsP += vec3(-0.5f - p.z * 0.2f, 0.3f - p.x * 0.5f, 1.0f - p.x * 0.2f);
+        flapsP += V(-0.5f - p.z * 0.2f, 0.3f - p.x * 0.5f, 1.0f - p.x * 0.2f);
         flapsScale = vec3(0.09f, 0.08f, 0.25f);
-        d = softMin(d, sdEllipsoid(flapsP, flapsScale), 0.2f);
+        d = select(inFlaps, softMin(d, sdEllipsoid(flapsP, flapsScale), 0.2f), d);
     }
     
-    if (p.x < 0.2f && p.z > 0.3f && p.z < 1.0f && p.y > 0.1f && p.y < 0.5f) {
+    auto inHorns = (p.x < 0.2f) & (p.z > 0.3f) & (p.z < 1.0f) & (p.y > 0.1f) & (p.y < 0.5f);
+    if (any(inHorns)) {
         flapsP = p;
-        flapsP += vec3(0.0f, -0.15f - 0.2f * p.z, -0.7f);
+        flapsP += V(0.0f, -0.15f - 0.2f * p.z, -0.7f);
         flapsScale = vec3(0.03f, 0.1f, 0.2f);
-        d = softMin(d, sdEllipsoid(flapsP, flapsScale), 0.15f);
+        d = select(inHorns, softMin(d, sdEllipsoid(flapsP, flapsScale), 0.15f), d);
     }
     
-    float taild = glm::max(length(vec2(p.x, p.y)), -sdBox(p + vec3(0.0f, 0.0f, 1.0f), vec3(1.0f)));
+    T taild = max(length(vec2_t<T>(p.x, p.y)), -sdBox(p + V(0.0f, 0.0f, 1.0f), V(1.0f)));
     d = softMin(d, taild, 0.1f);
     
     return d;
 }
 
-inline float animatedManta(const vec3& p_in, float time) {
+// Quantities of animatedManta() that depend only on time
+struct Frame {
+    float timeloop;   // Phase of the wing beat
+    float heave;      // Vertical offsets, applied in this order
+    float drift;
+};
+
+inline Frame frame(float time) {
+    const float size = 1.0f;
+    Frame f;
+    f.timeloop = time * 2.5f / (size - 0.25f);
+    f.heave = -sin(f.timeloop - 0.5f) * 0.25f * size;
+    f.drift = sin(time * 0.5f) * 0.1f;
+    return f;
+}
+
+template <class V>
+inline scalar_t<V> animatedManta(const V& p_in, const Frame& frame) {
+    using T = scalar_t<V>;
     float size = 1.0f;
     
-    float timeloop = time * 2.5f / (size - 0.25f);
-    vec3 p = p_in;
-    p.y += -sin(timeloop - 0.5f) * 0.25f * size;
-    p.y += sin(time * 0.5f) * 0.1f;
+    float timeloop = frame.timeloop;
+    V p = p_in;
+    p.y += frame.heave;
+    p.y += frame.drift;
     
-    vec3 mantap = p / size;
+    V mantap = p / size;
     mantap.x = abs(mantap.x);
     
-    float animation = sin(timeloop - 3.0f - 1.3f * mantap.z);
-    float animationAmount = pow(mantap.x, 1.5f);
-    animationAmount = glm::min(animationAmount, 2.5f);
+    T animation = sin(timeloop - 3.0f - 1.3f * mantap.z);
+    T animationAmount = pow(mantap.x, 1.5f);
+    animationAmount = min(animationAmount, 2.5f);
     mantap.y += animation * (0.3f * animationAmount + 0.15f);
     
-    float d = mantabody(mantap);
+    T d = mantabody(mantap);
     
     return d * size;
 }
 
 } // namespace mantaray_detail
 
-inline float MantaRay(const vec3& p_in, float time, uint32_t /*seed*/) {
-    vec3 p = p_in;
+// Per-frame constants of MantaRay
+struct MantaRayFrame {
+    mantaray_detail::Frame manta;
+};
+
+inline MantaRayFrame prepareMantaRay(float time, uint32_t /*seed*/) {
+    return MantaRayFrame{mantaray_detail::frame(time)};
+}
+
+template <class V>
+inline scalar_t<V> MantaRay(const V& p_in, const MantaRayFrame& frame) {
+    V p = p_in;
     p = p * rotationMatrix(vec3(0.0f, 1.0f, 0.0f), pi);
     const float scale = 0.5f;
     p *= 1.0f / scale;
-    return mantaray_detail::animatedManta(p, time) * 0.3f * scale;
+    return mantaray_detail::animatedManta(p, frame.manta) * 0.3f * scale;
+}
+
+template <class V>
+inline scalar_t<V> MantaRay(const V& p_in, float time, uint32_t seed) {
+    return MantaRay(p_in, prepareMantaRay(time, seed));
 }
 
 } // namespace sdf::animal
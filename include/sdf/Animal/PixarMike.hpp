@@ -9,147 +9,162 @@ namespace sdf::animal {
 
 namespace pixarmike_detail {
 
-inline vec2 sdSegment(const vec3& a, const vec3& b, const vec3& p) {
-    vec3 pa = p - a, ba = b - a;
-    float h = clamp(dot(pa, ba) / dot(ba, ba), 0.0f, 1.0f);
-    return vec2(length(pa - ba * h), h);
+template <class V>
+inline vec2_t<scalar_t<V>> sdSegment(const V& a, const V& b, const V& p) {
+    using T = scalar_t<V>;
+    V pa = p - a, ba = b - a;
+    T h = clamp(dot(pa, ba) / dot(ba, ba), T(0.0f), T(1.0f));
+    return vec2_t<T>(length(pa - ba * h), h);
 }
 
-inline float sdEllipsoid(const vec3& p, const vec3& r) {
-    return (length(p / r) - 1.0f) * glm::min(glm::min(r.x, r.y), r.z);
+template <class V>
+inline scalar_t<V> sdEllipsoid(const V& p, const vec3& r) {
+    return (length(p / V(r.x, r.y, r.z)) - 1.0f) * glm::min(glm::min(r.x, r.y), r.z);
 }
 
-inline float mike_smin(float a, float b, float k) {
-    float h = clamp(0.5f + 0.5f * (b - a) / k, 0.0f, 1.0f);
+template <class T>
+inline T mike_smin(T a, T b, float k) {
+    T h = clamp(0.5f + 0.5f * (b - a) / k, T(0.0f), T(1.0f));
     return mix(b, a, h) - k * h * (1.0f - h);
 }
 
-inline float opS(float d1, float d2) { return glm::max(-d1, d2); }
+template <class T>
+inline T opS(T d1, T d2) { return max(-d1, d2); }
 
-inline vec2 map(const vec3& p_in) {
-    vec3 p = p_in;
+template <class V>
+inline vec2_t<scalar_t<V>> map(const V& p_in) {
+    using T = scalar_t<V>;
+    using V2 = vec2_t<T>;
+    V p = p_in;
     p.y -= 1.8f;
     p.x = abs(p.x);
 
-    vec3 q = p;
-    q.y -= 0.3f * pow(1.0f - length(vec2(p.x, p.z)), 1.0f) * smoothstep(0.0f, 0.2f, p.y);
+    V q = p;
+    q.y -= 0.3f * pow(1.0f - length(V2(p.x, p.z)), 1.0f) * smoothstep(0.0f, 0.2f, p.y);
     q.y *= 1.05f;
     q.z *= 1.0f + 0.1f * smoothstep(0.0f, 0.5f, q.z) * smoothstep(-0.5f, 0.5f, p.y);
-    float dd = length((p - vec3(0.0f, 0.65f, 0.8f)) * vec3(1.0f, 0.75f, 1.0f));
-    float am = clamp(4.0f * abs(p.y - 0.45f), 0.0f, 1.0f);
-    float fo = -0.03f * (1.0f - smoothstep(0.0f, 0.04f * am, abs(dd - 0.42f))) * am;
-    float dd2 = length((p - vec3(0.0f, 0.65f, 0.8f)) * vec3(1.0f, 0.25f, 1.0f));
-    float am2 = clamp(1.5f * (p.y - 0.45f), 0.0f, 1.0f);
-    float fo2 = -0.085f * (1.0f - smoothstep(0.0f, 0.08f * am2, abs(dd2 - 0.42f))) * am2;
-    q.y += -0.05f + 0.05f * length(q.x);
+    T dd = length((p - V(0.0f, 0.65f, 0.8f)) * V(1.0f, 0.75f, 1.0f));
+    T am = clamp(4.0f * abs(p.y - 0.45f), T(0.0f), T(1.0f));
+    T fo = -0.03f * (1.0f - smoothstep(0.0f, 0.04f * am, abs(dd - 0.42f))) * am;
+    T dd2 = length((p - V(0.0f, 0.65f, 0.8f)) * V(1.0f, 0.25f, 1.0f));
+    T am2 = clamp(1.5f * (p.y - 0.45f), T(0.0f), T(1.0f));
+    T fo2 = -0.085f * (1.0f - smoothstep(0.0f, 0.08f * am2, abs(dd2 - 0.42f))) * am2;
+    q.y += -0.05f + 0.05f * abs(q.x);
 
-    float d1 = length(q) - 0.9f + fo + fo2;
-    vec2 res = vec2(d1, 1.0f);
+    T d1 = length(q) - 0.9f + fo + fo2;
+    V2 res = V2(d1, 1.0f);
 
     // arms
-    vec2 h = sdSegment(vec3(0.83f, 0.15f, 0.0f), vec3(1.02f, -0.6f, -0.1f), p);
-    float d2 = h.x - 0.07f;
+    V2 h = sdSegment(V(0.83f, 0.15f, 0.0f), V(1.02f, -0.6f, -0.1f), p);
+    T d2 = h.x - 0.07f;
     res.x = mike_smin(res.x, d2, 0.03f);
-    h = sdSegment(vec3(1.02f, -0.6f, -0.1f), vec3(0.95f, -1.2f, 0.1f), p);
+    h = sdSegment(V(1.02f, -0.6f, -0.1f), V(0.95f, -1.2f, 0.1f), p);
     d2 = h.x - 0.07f + h.y * 0.02f;
     res.x = mike_smin(res.x, d2, 0.06f);
 
     // hands
-    if (p.y < -1.0f) {
+    auto hands = p.y < -1.0f;
+    if (any(hands)) {
+        T rx = res.x;
         float fa = sin(3.0f);
-        h = sdSegment(vec3(0.95f, -1.2f, 0.1f), vec3(0.97f, -1.5f, 0.0f), p);
+        h = sdSegment(V(0.95f, -1.2f, 0.1f), V(0.97f, -1.5f, 0.0f), p);
         d2 = h.x - 0.03f;
-        res.x = mike_smin(res.x, d2, 0.01f);
-        h = sdSegment(vec3(0.97f, -1.5f, 0.0f), vec3(0.95f, -1.7f, 0.0f) - 0.01f * fa, p);
+        rx = mike_smin(rx, d2, 0.01f);
+        h = sdSegment(V(0.97f, -1.5f, 0.0f), V(0.95f, -1.7f, 0.0f) - 0.01f * fa, p);
         d2 = h.x - 0.03f + 0.01f * h.y;
-        res.x = mike_smin(res.x, d2, 0.02f);
-        h = sdSegment(vec3(0.95f, -1.2f, 0.1f), vec3(1.05f, -1.5f, 0.1f), p);
+        rx = mike_smin(rx, d2, 0.02f);
+        h = sdSegment(V(0.95f, -1.2f, 0.1f), V(1.05f, -1.5f, 0.1f), p);
         d2 = h.x - 0.03f;
-        res.x = mike_smin(res.x, d2, 0.02f);
-        h = sdSegment(vec3(1.05f, -1.5f, 0.1f), vec3(1.0f, -1.75f, 0.1f) - 0.01f * fa, p);
+        rx = mike_smin(rx, d2, 0.02f);
+        h = sdSegment(V(1.05f, -1.5f, 0.1f), V(1.0f, -1.75f, 0.1f) - 0.01f * fa, p);
         d2 = h.x - 0.03f + 0.01f * h.y;
-        res.x = mike_smin(res.x, d2, 0.02f);
-        h = sdSegment(vec3(0.95f, -1.2f, 0.1f), vec3(0.98f, -1.5f, 0.2f), p);
+        rx = mike_smin(rx, d2, 0.02f);
+        h = sdSegment(V(0.95f, -1.2f, 0.1f), V(0.98f, -1.5f, 0.2f), p);
         d2 = h.x - 0.03f;
-        res.x = mike_smin(res.x, d2, 0.03f);
-        h = sdSegment(vec3(0.98f, -1.5f, 0.2f), vec3(0.95f, -1.7f, 0.15f) - 0.01f * fa, p);
+        rx = mike_smin(rx, d2, 0.03f);
+        h = sdSegment(V(0.98f, -1.5f, 0.2f), V(0.95f, -1.7f, 0.15f) - 0.01f * fa, p);
         d2 = h.x - 0.03f + 0.01f * h.y;
-        res.x = mike_smin(res.x, d2, 0.03f);
-        h = sdSegment(vec3(0.95f, -1.2f, 0.1f), vec3(0.85f, -1.4f, 0.2f), p);
+        rx = mike_smin(rx, d2, 0.03f);
+        h = sdSegment(V(0.95f, -1.2f, 0.1f), V(0.85f, -1.4f, 0.2f), p);
         d2 = h.x - 0.04f + 0.01f * h.y;
-        res.x = mike_smin(res.x, d2, 0.05f);
-        h = sdSegment(vec3(0.85f, -1.4f, 0.2f), vec3(0.85f, -1.63f, 0.15f) + 0.01f * fa, p);
+        rx = mike_smin(rx, d2, 0.05f);
+        h = sdSegment(V(0.85f, -1.4f, 0.2f), V(0.85f, -1.63f, 0.15f) + 0.01f * fa, p);
         d2 = h.x - 0.03f + 0.01f * h.y;
-        res.x = mike_smin(res.x, d2, 0.03f);
+        rx = mike_smin(rx, d2, 0.03f);
+        res.x = select(hands, rx, res.x);
     }
 
     // legs
-    if (p.y < 0.0f) {
-        h = sdSegment(vec3(0.5f, -0.5f, 0.0f), vec3(0.6f, -1.2f, 0.1f), p);
+    auto legs = p.y < 0.0f;
+    if (any(legs)) {
+        T rx = res.x;
+        h = sdSegment(V(0.5f, -0.5f, 0.0f), V(0.6f, -1.2f, 0.1f), p);
         d2 = h.x - 0.14f + h.y * 0.08f;
-        res.x = mike_smin(res.x, d2, 0.06f);
-        h = sdSegment(vec3(0.6f, -1.2f, 0.1f), vec3(0.5f, -1.8f, 0.0f), p);
+        rx = mike_smin(rx, d2, 0.06f);
+        h = sdSegment(V(0.6f, -1.2f, 0.1f), V(0.5f, -1.8f, 0.0f), p);
         d2 = h.x - 0.06f;
-        res.x = mike_smin(res.x, d2, 0.06f);
+        rx = mike_smin(rx, d2, 0.06f);
+        res.x = select(legs, rx, res.x);
     }
 
     // feet
-    if (p.y < -1.5f) {
-        h = sdSegment(vec3(0.5f, -1.8f, 0.0f), vec3(0.6f, -1.8f, 0.4f), p);
+    auto feet = p.y < -1.5f;
+    if (any(feet)) {
+        T rx = res.x;
+        h = sdSegment(V(0.5f, -1.8f, 0.0f), V(0.6f, -1.8f, 0.4f), p);
         d2 = h.x - 0.09f + 0.02f * h.y;
-        res.x = mike_smin(res.x, d2, 0.06f);
-        h = sdSegment(vec3(0.5f, -1.8f, 0.0f), vec3(0.77f, -1.8f, 0.35f), p);
+        rx = mike_smin(rx, d2, 0.06f);
+        h = sdSegment(V(0.5f, -1.8f, 0.0f), V(0.77f, -1.8f, 0.35f), p);
         d2 = h.x - 0.08f + 0.02f * h.y;
-        res.x = mike_smin(res.x, d2, 0.06f);
-        h = sdSegment(vec3(0.5f, -1.8f, 0.0f), vec3(0.9f, -1.8f, 0.2f), p);
+        rx = mike_smin(rx, d2, 0.06f);
+        h = sdSegment(V(0.5f, -1.8f, 0.0f), V(0.9f, -1.8f, 0.2f), p);
         d2 = h.x - 0.07f + 0.02f * h.y;
-        res.x = mike_smin(res.x, d2, 0.06f);
+        rx = mike_smin(rx, d2, 0.06f);
+        res.x = select(feet, rx, res.x);
     }
 
     // horns
-    vec3 hp = p - vec3(0.25f, 0.7f, 0.0f);
+    V hp = p - V(0.25f, 0.7f, 0.0f);
     mat2 rm = mat2(0.6f, 0.8f, -0.8f, 0.6f);
-    vec2 hpxy = rm * vec2(hp.x, hp.y);
+    V2 hpxy = rm * V2(hp.x, hp.y);
     hp.x = hpxy.x; hp.y = hpxy.y;
     hp.x += 0.8f * hp.y * hp.y;
-    float d4 = sdEllipsoid(hp, vec3(0.13f, 0.5f, 0.16f));
-    if (d4 < res.x)
-        res = vec2(d4, 3.0f);
+    T d4 = sdEllipsoid(hp, vec3(0.13f, 0.5f, 0.16f));
+    res = select(d4 < res.x, V2(d4, 3.0f), res);
 
     // eyes
-    float d3 = length((p - vec3(0.0f, 0.25f, 0.35f)) * vec3(1.0f, 0.8f, 1.0f)) - 0.5f;
-    if (d3 < res.x)
-        res = vec2(d3, 2.0f);
+    T d3 = length((p - V(0.0f, 0.25f, 0.35f)) * V(1.0f, 0.8f, 1.0f)) - 0.5f;
+    res = select(d3 < res.x, V2(d3, 2.0f), res);
 
     // mouth
-    float mo = length((q - vec3(0.0f, -0.35f, 1.0f)) * vec3(1.0f, 1.2f, 0.25f) / 1.2f) - 0.3f / 1.2f;
-    float of = 0.1f * pow(smoothstep(0.0f, 0.2f, abs(p.x - 0.3f)), 0.5f);
-    mo = glm::max(mo, -q.y - 0.35f - of);
+    T mo = length((q - V(0.0f, -0.35f, 1.0f)) * V(1.0f, 1.2f, 0.25f) / 1.2f) - 0.3f / 1.2f;
+    T of = 0.1f * pow(smoothstep(0.0f, 0.2f, abs(p.x - 0.3f)), 0.5f);
+    mo = max(mo, -q.y - 0.35f - of);
 
-    float li = smoothstep(0.0f, 0.05f, mo + 0.02f) - smoothstep(0.05f, 0.10f, mo + 0.02f);
-    res.x -= 0.03f * li * clamp((-q.y - 0.4f) * 10.0f, 0.0f, 1.0f);
+    T li = smoothstep(0.0f, 0.05f, mo + 0.02f) - smoothstep(0.05f, 0.10f, mo + 0.02f);
+    res.x -= 0.03f * li * clamp((-q.y - 0.4f) * 10.0f, T(0.0f), T(1.0f));
 
-    if (-mo > res.x)
-        res = vec2(-mo, 4.0f);
+    res = select(-mo > res.x, V2(-mo, 4.0f), res);
 
     res.x += 0.01f * (smoothstep(0.0f, 0.05f, mo + 0.062f) -
                       smoothstep(0.05f, 0.10f, mo + 0.062f));
 
     // teeth
-    if (p.x < 0.3f) {
-        float px = mod(p.x, 0.16f) - 0.08f;
-        float d5 = length((vec3(px, p.y, p.z) - vec3(0.0f, -0.37f, 0.65f)) * vec3(1.0f, 2.0f, 1.0f)) - 0.08f;
-        if (d5 < res.x)
-            res = vec2(d5, 2.0f);
+    auto teeth = p.x < 0.3f;
+    if (any(teeth)) {
+        T px = mod(p.x, 0.16f) - 0.08f;
+        T d5 = length((V(px, p.y, p.z) - V(0.0f, -0.37f, 0.65f)) * V(1.0f, 2.0f, 1.0f)) - 0.08f;
+        res = select(teeth & (d5 < res.x), V2(d5, 2.0f), res);
     }
 
-    return vec2(res.x * 0.8f, res.y);
+    return V2(res.x * 0.8f, res.y);
 }
 
 } // namespace pixarmike_detail
 
-inline float PixarMike(const vec3& p_in, float /*time*/, uint32_t /*seed*/) {
-    vec3 p = p_in + vec3(0.0f, 0.5f, 0.0f);
+template <class V>
+inline scalar_t<V> PixarMike(const V& p_in, float /*time*/, uint32_t /*seed*/) {
+    V p = p_in + V(0.0f, 0.5f, 0.0f);
     const float scale = 0.4f;
     p *= 1.0f / scale;
     return pixarmike_detail::map(p).x * scale;
@@ -14,17 +14,21 @@ inline float sdCapsule(const vec3& p, const vec3& a, const vec3& b, float r) {
     return length(pa - ba * h) - r;
 }
 
-inline float sdTorus(const vec3& p, const vec2& t) {
-    return length(vec2(length(vec2(p.x, p.z)) - t.x, p.y)) - t.y;
+template <class V>
+inline scalar_t<V> sdTorus(const V& p, const vec2& t) {
+    using V2 = vec2_t<scalar_t<V>>;
+    return length(V2(length(V2(p.x, p.z)) - t.x, p.y)) - t.y;
 }
 
-inline float snail_smin(float a, float b, float k) {
-    float h = clamp(0.5f + 0.5f * (b - a) / k, 0.0f, 1.0f);
+template <class T>
+inline T snail_smin(T a, T b, float k) {
+    T h = clamp(0.5f + 0.5f * (b - a) / k, T(0.0f), T(1.0f));
     return mix(b, a, h) - k * h * (1.0f - h);
 }
 
-inline float snail_smax(float a, float b, float k) {
-    float h = clamp(0.5f + 0.5f * (b - a) / k, 0.0f, 1.0f);
+template <class T>
+inline T snail_smax(T a, T b, float k) {
+    T h = clamp(0.5f + 0.5f * (b - a) / k, T(0.0f), T(1.0f));
     return mix(a, b, h) + k * h * (1.0f - h);
 }
 
@@ -33,41 +37,53 @@ inline vec3 snail_smax3(const vec3& a, const vec3& b, float k) {
     return mix(a, b, h) + k * h * (vec3(1.0f) - h);
 }
 
-inline float sdSphere(const vec3& p, const vec4& s) {
-    return length(p - vec3(s.x, s.y, s.z)) - s.w;
+template <class V>
+inline scalar_t<V> sdSphere(const V& p, const vec4& s) {
+    return length(p - V(s.x, s.y, s.z)) - s.w;
 }
 
-inline float snail_sdEllipsoid(const vec3& p, const vec3& c, const vec3& r) {
-    return (length((p - c) / r) - 1.0f) * glm::min(glm::min(r.x, r.y), r.z);
+template <class V>
+inline scalar_t<V> snail_sdEllipsoid(const V& p, const vec3& c, const vec3& r) {
+    return (length((p - V(c.x, c.y, c.z)) / V(r.x, r.y, r.z)) - 1.0f) * glm::min(glm::min(r.x, r.y), r.z);
 }
 
-inline vec2 udSegment(const vec3& p, const vec3& a, const vec3& b) {
-    vec3 pa = p - a, ba = b - a;
-    float h = clamp(dot(pa, ba) / dot(ba, ba), 0.0f, 1.0f);
-    return vec2(length(pa - ba * h), h);
-}
-
-inline float det2(const vec2& a, const vec2& b) { return a.x * b.y - b.x * a.y; }
-
-inline vec3 getClosest(const vec2& b0, const vec2& b1, const vec2& b2) {
-    float a = det2(b0, b2);
-    float b = 2.0f * det2(b1, b0);
-    float d = 2.0f * det2(b2, b1);
-    float f = b * d - a * a;
-    vec2 d21 = b2 - b1;
-    vec2 d10 = b1 - b0;
-    vec2 d20 = b2 - b0;
-    vec2 gf = 2.0f * (b * d21 + d * d10 + a * d20);
-    gf = vec2(gf.y, -gf.x);
-    vec2 pp = -f * gf / dot(gf, gf);
-    vec2 d0p = b0 - pp;
-    float ap = det2(d0p, d20);
-    float bp = 2.0f * det2(d10, d0p);
-    float t = clamp((ap + bp) / (2.0f * a + b + d), 0.0f, 1.0f);
-    return vec3(mix(mix(b0, b1, t), mix(b1, b2, t), t), t);
-}
-
-inline vec4 sdBezier(const vec3& a, const vec3& b, const vec3& c, const vec3& p) {
+template <class V>
+inline vec2_t<scalar_t<V>> udSegment(const V& p, const vec3& a, const vec3& b) {
+    using T = scalar_t<V>;
+    vec3 ba = b - a;
+    V pa = p - V(a.x, a.y, a.z);
+    T h = clamp(dot(pa, ba) / dot(ba, ba), T(0.0f), T(1.0f));
+    return vec2_t<T>(length(pa - V(ba.x, ba.y, ba.z) * h), h);
+}
+
+template <class V2>
+inline scalar_t<V2> det2(const V2& a, const V2& b) { return a.x * b.y - b.x * a.y; }
+
+template <class V2>
+inline vec3_t<scalar_t<V2>> getClosest(const V2& b0, const V2& b1, const V2& b2) {
+    using T = scalar_t<V2>;
+    T a = det2(b0, b2);
+    T b = 2.0f * det2(b1, b0);
+    T d = 2.0f * det2(b2, b1);
+    T f = b * d - a * a;
+    V2 d21 = b2 - b1;
+    V2 d10 = b1 - b0;
+    V2 d20 = b2 - b0;
+    V2 gf = 2.0f * (b * d21 + d * d10 + a * d20);
+    gf = V2(gf.y, -gf.x);
+    V2 pp = -f * gf / dot(gf, gf);
+    V2 d0p = b0 - pp;
+    T ap = det2(d0p, d20);
+    T bp = 2.0f * det2(d10, d0p);
+    T t = clamp((ap + bp) / (2.0f * a + b + d), T(0.0f), T(1.0f));
+    V2 m = mix(mix(b0, b1, t), mix(b1, b2, t), t);
+    return vec3_t<T>(m.x, m.y, t);
+}
+
+template <class V>
+inline vec4_t<scalar_t<V>> sdBezier(const vec3& a, const vec3& b, const vec3& c, const V& p) {
+    using T = scalar_t<V>;
+    using V2 = vec2_t<T>;
     vec3 w = normalize(cross(c - b, a - b));
     vec3 u = normalize(c - b);
     vec3 v = cross(w, u);
@@ -75,52 +91,58 @@ inline vec4 sdBezier(const vec3& a, const vec3& b, const vec3& c, const vec3& p)
     vec2 a2 = vec2(dot(a - b, u), dot(a - b, v));
     vec2 b2 = vec2(0.0f);
     vec2 c2 = vec2(dot(c - b, u), dot(c - b, v));
-    vec3 p3 = vec3(dot(p - b, u), dot(p - b, v), dot(p - b, w));
+    V pb = p - V(b.x, b.y, b.z);
+    V p3 = V(dot(pb, u), dot(pb, v), dot(pb, w));
+    V2 p2 = V2(p3.x, p3.y);
     
-    vec3 cp = getClosest(a2 - vec2(p3.x, p3.y), b2 - vec2(p3.x, p3.y), c2 - vec2(p3.x, p3.y));
+    V cp = getClosest(V2(a2.x, a2.y) - p2, V2(b2.x, b2.y) - p2, V2(c2.x, c2.y) - p2);
     
-    return vec4(sqrt(dot(vec2(cp.x, cp.y), vec2(cp.x, cp.y)) + p3.z * p3.z), cp.z, length(vec2(cp.x, cp.y)), p3.z);
+    return vec4_t<T>(sqrt(dot(V2(cp.x, cp.y), V2(cp.x, cp.y)) + p3.z * p3.z), cp.z, length(V2(cp.x, cp.y)), p3.z);
 }
 
-inline float mapShell(const vec3& p_in, vec4& matInfo) {
+template <class V>
+inline scalar_t<V> mapShell(const V& p_in, vec4_t<scalar_t<V>>& matInfo) {
+    using T = scalar_t<V>;
+    using V2 = vec2_t<T>;
     const float sc = 1.0f;
-    vec3 p = p_in - vec3(0.05f, 0.12f, -0.09f);
+    V p = p_in - V(0.05f, 0.12f, -0.09f);
     p *= sc;
     
     mat3 m = mat3(-0.6333234236f, -0.7332753384f, 0.2474039592f,
                    0.7738444477f, -0.6034162289f, 0.1924931824f,
                    0.0081370606f,  0.3133626215f, 0.9495986813f);
-    vec3 q = m * p;
+    V q = m * p;
     
     const float b = 0.1759f;
     
-    float r = length(vec2(q.x, q.y));
-    float t = atan(q.y, q.x);
+    T r = length(V2(q.x, q.y));
+    T t = atan2(q.y, q.x);
     
-    float n = (log(r) / b - t) / (2.0f * pi);
-    float nm = (log(0.11f) / b - t) / (2.0f * pi);
-    n = glm::min(n, nm);
+    T n = (log(r) / b - t) / (2.0f * pi);
+    T nm = (log(0.11f) / b - t) / (2.0f * pi);
+    n = min(n, nm);
     
-    float ni = floor(n);
+    T ni = floor(n);
     
-    float r1 = exp(b * (t + 2.0f * pi * ni));
-    float r2 = r1 * 3.019863f;
+    T r1 = exp(b * (t + 2.0f * pi * ni));
+    T r2 = r1 * 3.019863f;
     
-    float h1 = q.z + 1.5f * r1 - 0.5f;
-    float d1 = sqrt((r1 - r) * (r1 - r) + h1 * h1) - r1;
-    float h2 = q.z + 1.5f * r2 - 0.5f;
-    float d2 = sqrt((r2 - r) * (r2 - r) + h2 * h2) - r2;
+    T h1 = q.z + 1.5f * r1 - 0.5f;
+    T d1 = sqrt((r1 - r) * (r1 - r) + h1 * h1) - r1;
+    T h2 = q.z + 1.5f * r2 - 0.5f;
+    T d2 = sqrt((r2 - r) * (r2 - r) + h2 * h2) - r2;
     
-    float d, dx, dy;
-    if (d1 < d2) { d = d1; dx = r1 - r; dy = h1; }
-    else         { d = d2; dx = r2 - r; dy = h2; }
+    auto inner = d1 < d2;
+    T d = select(inner, d1, d2);
+    T dx = select(inner, r1 - r, r2 - r);
+    T dy = select(inner, h1, h2);
     
-    matInfo = vec4(dx, dy, r / 0.4f, t / pi);
+    matInfo = vec4_t<T>(dx, dy, r / 0.4f, t / pi);
     
-    vec3 s = q;
-    q = q - vec3(0.34f, -0.1f, 0.03f);
+    V s = q;
+    q = q - V(0.34f, -0.1f, 0.03f);
     mat2 rot2d = mat2(0.8f, 0.6f, -0.6f, 0.8f);
-    vec2 qxy = rot2d * vec2(q.x, q.y);
+    V2 qxy = rot2d * V2(q.x, q.y);
     q.x = qxy.x;
     q.y = qxy.y;
     d = snail_smin(d, sdTorus(q, vec2(0.28f, 0.05f)), 0.06f);
@@ -130,16 +152,57 @@ inline float mapShell(const vec3& p_in, vec4& matInfo) {
     return d / sc;
 }
 
-inline vec2 mapSnail(const vec3& p, vec4& matInfo, float time) {
+// Quantities of mapSnail() that depend only on time
+struct Frame {
+    vec3 topAntenna[3];      // Tip offsets for sign(q.z) = -1, 0 and 1
+    vec3 bottomAntenna[3];
+};
+
+inline Frame frame(float time) {
+    Frame f;
+    for (int s = -1; s <= 1; ++s) {
+        f.topAntenna[s + 1] = 0.05f * sin(0.5f * time + vec3(0.0f, 1.0f, 3.0f) + vec3(2.0f, 1.0f, 0.0f) * float(s));
+        f.bottomAntenna[s + 1] = 0.02f * sin(0.3f * time + vec3(4.0f, 1.0f, 2.0f) + vec3(3.0f, 0.0f, 1.0f) * float(s));
+    }
+    return f;
+}
+
+// Antennas on one side, sq.z being mirrored; af and bf are that side's tips
+template <class V>
+inline scalar_t<V> antennas(const V& sq, scalar_t<V> d1, const vec3& af, const vec3& bf) {
+    using T = scalar_t<V>;
+    using V2 = vec2_t<T>;
+    
+    // top antenas
+    vec4_t<T> b2 = sdBezier(vec3(0.0f), vec3(-0.1f, 0.2f, 0.2f), vec3(-0.3f, 0.2f, 0.3f) + af, sq);
+    T d3 = b2.x;
+    d3 -= 0.03f - 0.025f * b2.y;
+    d1 = snail_smin(d1, d3, 0.04f);
+    d3 = sdSphere(sq, vec4(-0.3f, 0.2f, 0.3f, 0.016f) + vec4(af, 0.0f));
+    d1 = snail_smin(d1, d3, 0.01f);
+    
+    // bottom antenas
+    V2 b3 = udSegment(sq, vec3(0.06f, -0.05f, 0.0f), vec3(-0.04f, -0.2f, 0.18f) + bf);
+    d3 = b3.x;
+    d3 -= 0.025f - 0.02f * b3.y;
+    d1 = snail_smin(d1, d3, 0.06f);
+    d3 = sdSphere(sq, vec4(-0.04f, -0.2f, 0.18f, 0.008f) + vec4(bf, 0.0f));
+    return snail_smin(d1, d3, 0.02f);
+}
+
+template <class V>
+inline vec2_t<scalar_t<V>> mapSnail(const V& p, vec4_t<scalar_t<V>>& matInfo, const Frame& frame) {
+    using T = scalar_t<V>;
+    using V2 = vec2_t<T>;
     vec3 head = vec3(-0.76f, 0.6f, -0.3f);
-    vec3 q = p - head;
+    V q = p - V(head.x, head.y, head.z);
     
     // body
-    vec4 b1 = sdBezier(vec3(-0.13f, -0.65f, 0.0f), vec3(0.24f, 1.0f, 0.0f), head + vec3(0.04f, 0.01f, 0.0f), p);
-    float d1 = b1.x;
-    d1 -= smoothstep(0.0f, 0.2f, b1.y) * (0.16f - 0.07f * smoothstep(0.5f, 1.0f, b1.y));
+    vec4_t<T> b1 = sdBezier(vec3(-0.13f, -0.65f, 0.0f), vec3(0.24f, 1.0f, 0.0f), head + vec3(0.04f, 0.01f, 0.0f), p);
+    T d1 = b1.x;
+    d1 -= smoothstep(T(0.0f), T(0.2f), b1.y) * (0.16f - 0.07f * smoothstep(T(0.5f), T(1.0f), b1.y));
     b1 = sdBezier(vec3(-0.085f, 0.0f, 0.0f), vec3(-0.1f, 0.85f, 0.0f), head + vec3(0.06f, -0.08f, 0.0f), p);
-    float d2 = b1.x;
+    T d2 = b1.x;
     d2 -= 0.1f - 0.06f * b1.y;
     d1 = snail_smin(d1, d2, 0.03f);
     matInfo.x = b1.y;
@@ -152,69 +215,82 @@ inline vec2 mapSnail(const vec3& p, vec4& matInfo, float time) {
     d1 = snail_smin(d1, sdSphere(p, vec4(0.05f, 0.52f, 0.0f, 0.13f)), 0.07f);
     
     mat2 rot2d = mat2(0.8f, 0.6f, -0.6f, 0.8f);
-    vec2 qxz = rot2d * vec2(q.x, q.z);
+    V2 qxz = rot2d * V2(q.x, q.z);
     q.x = qxz.x;
     q.z = qxz.y;
     
-    vec3 sq = vec3(q.x, q.y, abs(q.z));
-    
-    // top antenas
-    vec3 af = 0.05f * sin(0.5f * time + vec3(0.0f, 1.0f, 3.0f) + vec3(2.0f, 1.0f, 0.0f) * sign(q.z));
-    vec4 b2 = sdBezier(vec3(0.0f), vec3(-0.1f, 0.2f, 0.2f), vec3(-0.3f, 0.2f, 0.3f) + af, sq);
-    float d3 = b2.x;
-    d3 -= 0.03f - 0.025f * b2.y;
-    d1 = snail_smin(d1, d3, 0.04f);
-    d3 = sdSphere(sq, vec4(-0.3f, 0.2f, 0.3f, 0.016f) + vec4(af, 0.0f));
-    d1 = snail_smin(d1, d3, 0.01f);
+    V sq = V(q.x, q.y, abs(q.z));
     
-    // bottom antenas
-    vec3 bf = 0.02f * sin(0.3f * time + vec3(4.0f, 1.0f, 2.0f) + vec3(3.0f, 0.0f, 1.0f) * sign(q.z));
-    vec2 b3 = udSegment(sq, vec3(0.06f, -0.05f, 0.0f), vec3(-0.04f, -0.2f, 0.18f) + bf);
-    d3 = b3.x;
-    d3 -= 0.025f - 0.02f * b3.y;
-    d1 = snail_smin(d1, d3, 0.06f);
-    d3 = sdSphere(sq, vec4(-0.04f, -0.2f, 0.18f, 0.008f) + vec4(bf, 0.0f));
-    d1 = snail_smin(d1, d3, 0.02f);
+    // antennas, whose tips move with sign(q.z); only the sides present
+    // among the lanes are evaluated
+    auto neg = q.z < 0.0f;
+    auto pos = q.z > 0.0f;
+    T dn = d1, dz = d1, dp = d1;
+    if (any(neg)) dn = antennas(sq, d1, frame.topAntenna[0], frame.bottomAntenna[0]);
+    if (!all(neg | pos)) dz = antennas(sq, d1, frame.topAntenna[1], frame.bottomAntenna[1]);
+    if (any(pos)) dp = antennas(sq, d1, frame.topAntenna[2], frame.bottomAntenna[2]);
+    d1 = select(neg, dn, select(pos, dp, dz));
     
     // bottom
-    vec3 pp = p - vec3(-0.17f, 0.15f, 0.0f);
+    V pp = p - V(-0.17f, 0.15f, 0.0f);
     float co = 0.988771078f;
     float si = 0.149438132f;
     mat2 rot2d2 = mat2(co, -si, si, co);
-    vec2 ppxy = rot2d2 * vec2(pp.x, pp.y);
+    V2 ppxy = rot2d2 * V2(pp.x, pp.y);
     pp.x = ppxy.x;
     pp.y = ppxy.y;
     d1 = snail_smin(d1, snail_sdEllipsoid(pp, vec3(0.0f), vec3(0.084f, 0.3f, 0.15f)), 0.05f);
     d1 = snail_smax(d1, -snail_sdEllipsoid(pp, vec3(-0.08f, 0.0f, 0.0f), vec3(0.06f, 0.55f, 0.1f)), 0.02f);
     
-    return vec2(d1, 1.0f);
+    return V2(d1, T(1.0f));
 }
 
-inline vec2 mapOpaque(const vec3& p, vec4& matInfo, float time) {
-    matInfo = vec4(0.0f);
+template <class V>
+inline vec2_t<scalar_t<V>> mapOpaque(const V& p, vec4_t<scalar_t<V>>& matInfo, const Frame& frame) {
+    using T = scalar_t<V>;
+    using V2 = vec2_t<T>;
+    matInfo = vec4_t<T>(T(0.0f));
     
-    vec2 res = mapSnail(p, matInfo, time);
+    V2 res = mapSnail(p, matInfo, frame);
     
-    vec4 tmpMatInfo;
-    float d4 = mapShell(p, tmpMatInfo);
-    if (d4 < res.x) { res = vec2(d4, 2.0f); matInfo = tmpMatInfo; }
+    vec4_t<T> tmpMatInfo;
+    T d4 = mapShell(p, tmpMatInfo);
+    auto shell = d4 < res.x;
+    res = select(shell, V2(d4, T(2.0f)), res);
+    matInfo = select(shell, tmpMatInfo, matInfo);
     
     // plant
-    vec4 b3 = sdBezier(vec3(-0.15f, -1.5f, 0.0f), vec3(-0.1f, 0.5f, 0.0f), vec3(-0.6f, 1.5f, 0.0f), p);
+    vec4_t<T> b3 = sdBezier(vec3(-0.15f, -1.5f, 0.0f), vec3(-0.1f, 0.5f, 0.0f), vec3(-0.6f, 1.5f, 0.0f), p);
     d4 = b3.x;
     d4 -= 0.04f - 0.02f * b3.y;
-    if (d4 < res.x) { res = vec2(d4, 3.0f); }
+    res = select(d4 < res.x, V2(d4, T(3.0f)), res);
     
     return res;
 }
 
 } // namespace snail_detail
 
-inline float Snail(const vec3& p_in, float time, uint32_t /*seed*/) {
+// Per-frame constants of Snail
+struct SnailFrame {
+    snail_detail::Frame map;
+};
+
+inline SnailFrame prepareSnail(float time, uint32_t /*seed*/) {
+    return SnailFrame{snail_detail::frame(time)};
+}
+
+template <class V>
+inline scalar_t<V> Snail(const V& p_in, const SnailFrame& frame) {
+    using T = scalar_t<V>;
     const float scale = 0.8f;
-    vec3 p = p_in * (1.0f / scale);
-    vec4 temp = vec4(0.0f);
-    return snail_detail::mapOpaque(p, temp, time).x * scale;
+    V p = p_in * (1.0f / scale);
+    vec4_t<T> temp = vec4_t<T>(T(0.0f));
+    return snail_detail::mapOpaque(p, temp, frame.map).x * scale;
+}
+
+template <class V>
+inline scalar_t<V> Snail(const V& p_in, float time, uint32_t seed) {
+    return Snail(p_in, prepareSnail(time, seed));
 }
 
 } // namespace sdf::animal
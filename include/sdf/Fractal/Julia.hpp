@@ -7,49 +7,105 @@
 namespace sdf::fractal {
 
 namespace detail {
-    inline float lengthSquared(const vec4& v) {
+    template <class V4>
+    inline scalar_t<V4> lengthSquared(const V4& v) {
         return dot(v, v);
     }
     
-    inline vec4 qSquare(const vec4& a) {
-        return vec4(a.x * a.x - dot(vec3(a.y, a.z, a.w), vec3(a.y, a.z, a.w)), 
-                    2.0f * a.x * vec3(a.y, a.z, a.w));
+    template <class V4>
+    inline V4 qSquare(const V4& a) {
+        const scalar_t<V4> a2 = 2.0f * a.x;
+        return V4(a.x * a.x - (a.y * a.y + a.z * a.z + a.w * a.w), a2 * a.y, a2 * a.z, a2 * a.w);
     }
     
-    inline vec4 qCube(const vec4& a) {
-        return a * (4.0f * a.x * a.x - dot(a, a) * vec4(3.0f, 1.0f, 1.0f, 1.0f));
+    template <class V4>
+    inline V4 qCube(const V4& a) {
+        using T = scalar_t<V4>;
+        const T s = 4.0f * a.x * a.x;
+        const T d = dot(a, a);
+        return V4(a.x * (s - d * 3.0f), a.y * (s - d * 1.0f), a.z * (s - d * 1.0f), a.w * (s - d * 1.0f));
     }
     
-    inline vec3 julia_map(const vec3& p, const vec4& c) {
-        vec4 z = vec4(p, 0.2f);
+    constexpr int juliaIterations = 10;
+    
+    // Largest full-detail value of a point whose orbit has not escaped after
+    // the given number of iterations, i.e. the width of the band that is left
+    // unresolved by stopping there. Measured at 6M points in [-1.3, 1.3]^3
+    // and doubled; the value for 0 iterations is unbounded. The widths are
+    // empirical rather than derived: the distance estimate of an orbit that
+    // escapes late can be far larger, so a few points exceed them.
+    constexpr float juliaUnresolved[juliaIterations + 1] = {
+        1e30f, 2.4f, 0.9f, 0.3f, 0.13f, 0.09f, 0.09f, 0.09f, 0.09f, 0.09f, 0.0f
+    };
+    
+    // The distance in x, the orbit trap in y and z, and 0 in x if the orbit
+    // has not escaped after the given number of iterations (fewer than the
+    // full count). Lanes whose orbit escapes are frozen with a mask; the loop
+    // ends once every lane has escaped.
+    template <class V>
+    inline vec3_t<scalar_t<V>> julia_map(const V& p, const vec4& c, int iterations = juliaIterations) {
+        using T = scalar_t<V>;
+        using V2 = vec2_t<T>;
+        using V4 = vec4_t<T>;
+        V4 z = V4(p.x, p.y, p.z, T(0.2f));
         
-        float m2 = 0.0f;
-        vec2 t = vec2(1e10f);
+        T m2 = 0.0f;
+        V2 t = V2(T(1e10f));
         
-        float dz2 = 1.0f;
-        for (int i = 0; i < 10; i++) {
-            dz2 *= 9.0f * lengthSquared(qSquare(z));
-            z = qCube(z) + c;
+        T dz2 = 1.0f;
+        auto escaped = m2 > 10000.0f;
+        for (int i = 0; i < iterations; i++) {
+            const T dz2n = dz2 * (9.0f * lengthSquared(qSquare(z)));
+            const V4 zc = qCube(z);
+            const V4 zn = V4(zc.x + c.x, zc.y + c.y, zc.z + c.z, zc.w + c.w);
+            const T m2n = dot(zn, zn);
+            dz2 = select(escaped, dz2, dz2n);
+            z = select(escaped, z, zn);
+            m2 = select(escaped, m2, m2n);
             
-            m2 = dot(z, z);
-            if (m2 > 10000.0f) break;
+            escaped = escaped | (m2n > 10000.0f);
+            if (all(escaped)) break;
             
-            t = min(t, vec2(m2, std::abs(z.x)));
+            t = select(escaped, t, min(t, V2(m2n, abs(zn.x))));
         }
         
-        float d = 0.25f * std::log(m2) * std::sqrt(m2 / dz2);
-        return vec3(d, t);
+        T d = 0.25f * log(m2) * sqrt(m2 / dz2);
+        if (iterations < juliaIterations) {
+            d = select(m2 <= 10000.0f, T(0.0f), d);
+        }
+        return vec3_t<T>(d, t.x, t.y);
+    }
+    
+    // Julia constant c, fixed at t = 10
+    inline vec4 juliaConstant() {
+        const float t = 10.0f;
+        return vec4(-0.1f, 0.6f, 0.9f, -0.3f) + 
+               0.1f * sin(vec4(3.0f, 0.0f, 1.0f, 2.0f) + 0.5f * vec4(1.0f, 1.3f, 1.7f, 2.1f) * t);
     }
 }
 
-inline float Julia(const vec3& p, float /*time*/, uint32_t /*seed*/) {
-    const float t = 10.0f;
-    const vec4 c = vec4(-0.1f, 0.6f, 0.9f, -0.3f) + 
-                   0.1f * sin(vec4(3.0f, 0.0f, 1.0f, 2.0f) + 0.5f * vec4(1.0f, 1.3f, 1.7f, 2.1f) * t);
+template <class V>
+inline scalar_t<V> Julia(const V& p, float /*time*/, uint32_t /*seed*/) {
+    static const vec4 c = detail::juliaConstant();
     const float scale = 0.8f;
     return detail::julia_map(p * (1.0f / scale), c).x * scale;
 }
 
+/// Julia() with iteration stopped once the points still iterating are
+/// measured to be within featureSize of the surface; those return 0. Points
+/// whose orbit escapes in time keep their full value. The band is empirical:
+/// rare points left unresolved lie much farther out, and return 0 there.
+/// A featureSize of 0 or less runs every iteration.
+inline float JuliaLOD(const vec3& p, float featureSize, float /*time*/, uint32_t /*seed*/) {
+    int iterations = 1;
+    while (iterations < detail::juliaIterations && detail::juliaUnresolved[iterations] > featureSize) {
+        ++iterations;
+    }
+    static const vec4 c = detail::juliaConstant();
+    const float scale = 0.8f;
+    return detail::julia_map(p * (1.0f / scale), c, iterations).x * scale;
+}
+
 } // namespace sdf::fractal
 
 
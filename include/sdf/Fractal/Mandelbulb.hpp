@@ -10,53 +10,189 @@ namespace detail {
     constexpr float minimumDistanceToSurface = 0.0003f;
     constexpr int ITERATIONS = 16;
     constexpr float power = 8.0f;
+    constexpr float internalBoundingRadius = 0.72f;
     
-    inline float distanceToSurface(const vec3& P, float& AO) {
+    // Largest full-detail value of a point outside the inner bounding sphere
+    // whose orbit has not escaped after the given number of iterations, i.e.
+    // the width of the band that is left unresolved by stopping there.
+    // Measured at 6M points in [-1.3, 1.3]^3 and doubled; the value for 0
+    // iterations is unbounded. The widths are empirical, not derived, so a
+    // rare point may exceed them.
+    constexpr float unresolvedBand[ITERATIONS + 1] = {
+        1e30f, 0.9f, 0.1f, 0.03f, 0.013f, 0.007f, 0.005f, 0.005f, 0.004f,
+        0.004f, 0.003f, 0.002f, 0.002f, 0.002f, 0.002f, 0.002f, 0.0f
+    };
+    
+    // Fewest iterations measured to resolve everything farther than
+    // featureSize from the surface; every iteration for a featureSize of 0 or
+    // less
+    inline int lodIterations(float featureSize) {
+        int iterations = 1;
+        while (iterations < ITERATIONS && unresolvedBand[iterations] > featureSize) ++iterations;
+        return iterations;
+    }
+    
+    // Orbits that have not escaped after `iterations` return `unresolved`.
+    // Lanes that escape (or start far outside) are retired with a mask; the
+    // loop ends as soon as no lane is still iterating.
+    template <class V>
+    inline scalar_t<V> distanceToSurface(const V& P, scalar_t<V>& AO, int iterations = ITERATIONS,
+                                         float unresolved = minimumDistanceToSurface) {
+        using T = scalar_t<V>;
         AO = 1.0f;
         
-        vec3 Q = P;
+        V Q = P;
         
         // Bounding sphere check
-        {
-            const float externalBoundingRadius = 1.2f;
-            float r = length(P) - externalBoundingRadius;
-            if (r > 1.0f) { return r; }
+        const float externalBoundingRadius = 1.2f;
+        const T outside = length(P) - externalBoundingRadius;
+        auto done = outside > 1.0f;
+        if (all(done)) return outside;
+        T result = select(done, outside, T(unresolved));
+        
+        T derivative = 1.0f;
+        
+        for (int i = 0; i < iterations; ++i) {
+            AO = select(done, AO, AO * 0.725f);
+            T r = length(Q);
+            
+            const auto escaped = (r > 2.0f) & !done;
+            if (any(escaped)) {
+                AO = select(escaped, min((AO + 0.075f) * 4.1f, T(1.0f)), AO);
+                result = select(escaped, min(length(P) - internalBoundingRadius, 0.5f * log(r) * r / derivative),
+                                result);
+                done = done | escaped;
+                if (all(done)) break;
+            }
+            
+            T theta = acos(Q.z / r) * power;
+            T phi = atan2(Q.y, Q.x) * power;
+            
+            derivative = pow(r, T(power - 1.0f)) * power * derivative + 1.0f;
+            
+            T sinTheta = sin(theta);
+            
+            Q = V(sinTheta * cos(phi),
+                  sinTheta * sin(phi),
+                  cos(theta)) * pow(r, T(power)) + P;
         }
         
-        const float internalBoundingRadius = 0.72f;
-        float derivative = 1.0f;
+        return result;
+    }
+    
+    // Q^8 as computed by the spherical formula above, expanded into
+    // polynomials in the coordinates (after Inigo Quilez). The expansion
+    // takes the polar axis as its second coordinate, hence the relabeling.
+    // The in-plane terms are written in the unit direction (u, v) so that
+    // nothing over- or underflows near the polar axis.
+    template <class V>
+    inline V power8(const V& Q) {
+        using T = scalar_t<V>;
+        const T x = Q.y, y = Q.z, z = Q.x;
+        const T x2 = x * x, y2 = y * y, z2 = z * z;
+        const T x4 = x2 * x2, y4 = y2 * y2, z4 = z2 * z2;
+        
+        const T k3 = x2 + z2;
+        const T k1 = x4 + y4 + z4 - 6.0f * y2 * z2 - 6.0f * x2 * y2 + 2.0f * z2 * x2;
+        const T k4 = x2 - y2 + z2;
+        
+        const T s = sqrt(k3);
+        const T inv = select(k3 > 0.0f, 1.0f / s, T(0.0f));
+        const T u = x * inv, v = z * inv;
+        const T u2 = u * u, v2 = v * v;
+        const T u4 = u2 * u2, v4 = v2 * v2;
+        
+        const T sk = s * k1 * k4 * y;
+        return V(
+            -8.0f * sk * (u4 * u4 - 28.0f * u4 * u2 * v2 + 70.0f * u4 * v4 - 28.0f * u2 * v2 * v4 + v4 * v4),
+            64.0f * sk * u * v * (u2 - v2) * (u4 - 6.0f * u2 * v2 + v4),
+            k1 * k1 - 16.0f * y2 * k3 * k4 * k4);
+    }
+    
+    // distanceToSurface() without trigonometry, for float and lane types.
+    // Lanes that escape (or start far outside) are retired with a mask; the
+    // loop ends as soon as no lane is still iterating.
+    template <class V>
+    inline scalar_t<V> distanceToSurfacePolynomial(const V& P, int iterations = ITERATIONS,
+                                                   float unresolved = minimumDistanceToSurface) {
+        using T = scalar_t<V>;
         
-        for (int i = 0; i < ITERATIONS; ++i) {
-            AO *= 0.725f;
-            float r = length(Q);
+        // Bounding sphere check
+        const T outside = length(P) - 1.2f;
+        auto done = outside > 1.0f;
+        T result = select(done, outside, T(unresolved));
+        
+        T derivative = 1.0f;
+        V Q = P;
+        
+        for (int i = 0; i < iterations && any(!done); ++i) {
+            const T r2 = dot(Q, Q);
+            const T r = sqrt(r2);
             
-            if (r > 2.0f) {
-                AO = std::min((AO + 0.075f) * 4.1f, 1.0f);
-                return std::min(length(P) - internalBoundingRadius, 0.5f * std::log(r) * r / derivative);
-            } else {
-                float theta = std::acos(Q.z / r) * power;
-                float phi = std::atan2(Q.y, Q.x) * power;
-                
-                derivative = std::pow(r, power - 1.0f) * power * derivative + 1.0f;
-                
-                float sinTheta = std::sin(theta);
-                
-                Q = vec3(sinTheta * std::cos(phi),
-                        sinTheta * std::sin(phi),
-                        std::cos(theta)) * std::pow(r, power) + P;
+            const auto escaped = (r > 2.0f) & !done;
+            if (any(escaped)) {
+                const T bound = min(length(P) - internalBoundingRadius, 0.5f * log(r) * r / derivative);
+                result = select(escaped, bound, result);
+                done = done | escaped;
             }
+            
+            // r^7 and r^8 by multiplication instead of pow
+            const T r6 = r2 * r2 * r2;
+            derivative = r6 * r * power * derivative + 1.0f;
+            Q = power8(Q) + P;
         }
         
-        return minimumDistanceToSurface;
+        return result;
     }
 }
 
-inline float Mandelbulb(const vec3& p, float /*time*/, uint32_t /*seed*/) {
+template <class V>
+inline scalar_t<V> Mandelbulb(const V& p, float /*time*/, uint32_t /*seed*/) {
     const float scale = 0.6f;
-    float ignore;
+    scalar_t<V> ignore;
     return detail::distanceToSurface(p * (1.0f / scale), ignore) * scale;
 }
 
+/// Mandelbulb without trigonometry: the same fractal as Mandelbulb(), with
+/// the power-8 step expanded into polynomials. Instantiable with lane types,
+/// so it also has a SIMD kernel.
+template <class V>
+inline scalar_t<V> MandelbulbPolynomial(const V& p, float /*time*/, uint32_t /*seed*/) {
+    const float scale = 0.6f;
+    return detail::distanceToSurfacePolynomial(p * (1.0f / scale)) * scale;
+}
+
+/// Mandelbulb() with iteration stopped once the points still iterating are
+/// measured to be within featureSize of the surface; those return 0. Points
+/// whose orbit escapes in time keep their full value. The band is empirical,
+/// so a rare unresolved point may lie farther out.
+inline float MandelbulbLOD(const vec3& p, float featureSize, float /*time*/, uint32_t /*seed*/) {
+    const float scale = 0.6f;
+    const vec3 P = p * (1.0f / scale);
+    float ignore;
+    // Inside the inner bounding sphere an escaping orbit gives a negative
+    // distance, which 0 would not bound, so refinement runs to full depth
+    if (length(P) < detail::internalBoundingRadius) {
+        return detail::distanceToSurface(P, ignore) * scale;
+    }
+    const int iterations = detail::lodIterations(featureSize);
+    const float unresolved = iterations < detail::ITERATIONS ? 0.0f : detail::minimumDistanceToSurface;
+    return detail::distanceToSurface(P, ignore, iterations, unresolved) * scale;
+}
+
+/// MandelbulbPolynomial() with refinement stopped at featureSize, as in
+/// MandelbulbLOD().
+inline float MandelbulbPolynomialLOD(const vec3& p, float featureSize, float /*time*/, uint32_t /*seed*/) {
+    const float scale = 0.6f;
+    const vec3 P = p * (1.0f / scale);
+    if (length(P) < detail::internalBoundingRadius) {
+        return detail::distanceToSurfacePolynomial(P) * scale;
+    }
+    const int iterations = detail::lodIterations(featureSize);
+    const float unresolved = iterations < detail::ITERATIONS ? 0.0f : detail::minimumDistanceToSurface;
+    return detail::distanceToSurfacePolynomial(P, iterations, unresolved) * scale;
+}
+
 } // namespace sdf::fractal
 
 
@@ -7,36 +7,61 @@
 namespace sdf::fractal {
 
 namespace detail {
-    inline float maxcomp(const vec3& p) { 
-        return std::max(p.x, std::max(p.y, p.z)); 
+    template <class V>
+    inline scalar_t<V> maxcomp(const V& p) { 
+        return max(p.x, max(p.y, p.z)); 
     }
     
-    inline float sdBox(const vec3& p, const vec3& b) {
-        vec3 di = abs(p) - b;
-        float mc = maxcomp(di);
-        return std::min(mc, length(max(di, vec3(0.0f))));
+    template <class V>
+    inline scalar_t<V> sdBox(const V& p, const vec3& b) {
+        using T = scalar_t<V>;
+        V di = abs(p) - V(b.x, b.y, b.z);
+        T mc = maxcomp(di);
+        return min(mc, length(max(di, V(0.0f, 0.0f, 0.0f))));
     }
 }
 
-inline float Menger(const vec3& p_in, float /*time*/, uint32_t /*seed*/) {
-    vec3 p = p_in;
-    float d = detail::sdBox(p, vec3(1.0f));
-    
-    float s = 1.0f;
-    for (int m = 0; m < 7; ++m) {
-        vec3 a = mod(p * s, 2.0f) - 1.0f;
-        s *= 3.0f;
-        vec3 r = abs(vec3(1.0f) - 3.0f * abs(a));
+namespace detail {
+    // Refines until the remaining levels cannot move the distance by more
+    // than featureSize. Level m only raises d, and to at most 1 / s for its
+    // scale s = 3^(m+1), so once d + featureSize reaches that bound the
+    // remaining levels raise d by at most featureSize (by nothing if d alone
+    // reaches it). Lanes stop one by one; the loop ends when all have.
+    template <class V>
+    inline scalar_t<V> menger(const V& p, float featureSize) {
+        using T = scalar_t<V>;
+        T d = sdBox(p, vec3(1.0f));
         
-        float da = std::max(r.x, r.y);
-        float db = std::max(r.y, r.z);
-        float dc = std::max(r.z, r.x);
-        float c = (std::min(da, std::min(db, dc)) - 1.0f) / s;
+        float s = 1.0f;
+        for (int m = 0; m < 7; ++m) {
+            const auto stop = d + featureSize >= 1.0f / (3.0f * s);
+            if (all(stop)) break;
+            
+            V a = mod(p * s, 2.0f) - 1.0f;
+            s *= 3.0f;
+            V r = abs(V(1.0f, 1.0f, 1.0f) - 3.0f * abs(a));
+            
+            T da = max(r.x, r.y);
+            T db = max(r.y, r.z);
+            T dc = max(r.z, r.x);
+            T c = (min(da, min(db, dc)) - 1.0f) / s;
+            
+            d = select(stop, d, max(d, c));
+        }
         
-        d = std::max(d, c);
+        return d;
     }
-    
-    return d;
+}
+
+template <class V>
+inline scalar_t<V> Menger(const V& p, float /*time*/, uint32_t /*seed*/) {
+    return detail::menger(p, 0.0f);
+}
+
+/// Menger() with refinement stopped at featureSize. Never above the full
+/// value and at most featureSize below it.
+inline float MengerLOD(const vec3& p, float featureSize, float /*time*/, uint32_t /*seed*/) {
+    return detail::menger(p, featureSize);
 }
 
 } // namespace sdf::fractal
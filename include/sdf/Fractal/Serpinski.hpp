@@ -6,34 +6,65 @@
 
 namespace sdf::fractal {
 
-inline float Serpinski(const vec3& p_in, float /*time*/, uint32_t /*seed*/) {
-    vec3 p = p_in * 2.5f;
-    const vec3 p0 = vec3(-1, -1, -1);
-    const vec3 p1 = vec3(1, 1, -1);
-    const vec3 p2 = vec3(1, -1, 1);
-    const vec3 p3 = vec3(-1, 1, 1);
-    
-    const int maxit = 25;
-    const float scale = 2.0f;
-    const float minSize = std::pow(scale, -float(maxit - 2));
-    
-    for (int i = 0; i < maxit; ++i) {
-        float d = distance(p, p0);
-        vec3 c = p0;
+namespace detail {
+    // Folds until the remaining iterations cannot move the distance by more
+    // than featureSize. Iteration i moves length(p) * 2^-i by at most
+    // |corner| * 2^-i = sqrt(3) * 2^-i, so stopping after i iterations leaves
+    // the estimate within tail = sqrt(3) * 2^(1-i) / 2.5 of the full one;
+    // subtracting the tail keeps it below.
+    template <class V>
+    inline scalar_t<V> serpinski(const V& p_in, float featureSize) {
+        using T = scalar_t<V>;
+        V p = p_in * 2.5f;
+        const vec3 p0 = vec3(-1, -1, -1);
+        const vec3 p1 = vec3(1, 1, -1);
+        const vec3 p2 = vec3(1, -1, 1);
+        const vec3 p3 = vec3(-1, 1, 1);
         
-        float t = distance(p, p1);
-        if (t < d) { d = t; c = p1; }
+        const int maxit = 25;
+        const float scale = 2.0f;
+        const float minSize = pow(scale, -float(maxit - 2));
+        const float corner = 1.7320508f;
         
-        t = distance(p, p2);
-        if (t < d) { d = t; c = p2; }
+        int i = 0;
+        for (; i < maxit; ++i) {
+            if (2.0f * corner * std::ldexp(2.0f, -i) * (1.0f / 2.5f) <= featureSize) break;
+            
+            T d = distance(p, V(p0.x, p0.y, p0.z));
+            V c = V(p0.x, p0.y, p0.z);
+            
+            T t = distance(p, V(p1.x, p1.y, p1.z));
+            auto closer = t < d;
+            d = select(closer, t, d);
+            c = select(closer, V(p1.x, p1.y, p1.z), c);
+            
+            t = distance(p, V(p2.x, p2.y, p2.z));
+            closer = t < d;
+            d = select(closer, t, d);
+            c = select(closer, V(p2.x, p2.y, p2.z), c);
+            
+            t = distance(p, V(p3.x, p3.y, p3.z));
+            closer = t < d;
+            d = select(closer, t, d);
+            c = select(closer, V(p3.x, p3.y, p3.z), c);
+            
+            p = (p - c) * scale;
+        }
         
-        t = distance(p, p3);
-        if (t < d) { d = t; c = p3; }
-        
-        p = (p - c) * scale;
+        const float tail = i < maxit ? corner * std::ldexp(2.0f, -i) * (1.0f / 2.5f) : 0.0f;
+        return (1.0f / 2.5f) * (length(p) * pow(scale, float(-i)) - minSize) - tail;
     }
-    
-    return (1.0f / 2.5f) * (length(p) * std::pow(scale, float(-maxit)) - minSize);
+}
+
+template <class V>
+inline scalar_t<V> Serpinski(const V& p, float /*time*/, uint32_t /*seed*/) {
+    return detail::serpinski(p, 0.0f);
+}
+
+/// Serpinski() with refinement stopped at featureSize. Never above the full
+/// value and at most featureSize below it.
+inline float SerpinskiLOD(const vec3& p, float featureSize, float /*time*/, uint32_t /*seed*/) {
+    return detail::serpinski(p, featureSize);
 }
 
 } // namespace sdf::fractal
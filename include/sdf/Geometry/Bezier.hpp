@@ -7,45 +7,55 @@
 namespace sdf::geometry {
 
 namespace bezier_detail {
-    inline float dot2(const vec3& v) { return dot(v, v); }
+    template <class V>
+    inline scalar_t<V> dot2(const V& v) { return dot(v, v); }
     
-    inline float sdBezier(const vec3& pos, const vec3& A, const vec3& B, const vec3& C) {
-        vec3 a = B - A;
-        vec3 b = A - 2.0f * B + C;
-        vec3 c = a * 2.0f;
-        vec3 d = A - pos;
-        float kk = 1.0f / dot(b, b);
-        float kx = kk * dot(a, b);
-        float ky = kk * (2.0f * dot(a, a) + dot(d, b)) / 3.0f;
-        float kz = kk * dot(d, a);
-        float res = 0.0f;
-        float p = ky - kx * kx;
-        float p3 = p * p * p;
-        float q = kx * (2.0f * kx * kx - 3.0f * ky) + kz;
-        float h = q * q + 4.0f * p3;
+    template <class V>
+    inline scalar_t<V> sdBezier(const V& pos, const V& A, const V& B, const V& C) {
+        using T = scalar_t<V>;
+        V a = B - A;
+        V b = A - 2.0f * B + C;
+        V c = a * 2.0f;
+        V d = A - pos;
+        T kk = 1.0f / dot(b, b);
+        T kx = kk * dot(a, b);
+        T ky = kk * (2.0f * dot(a, a) + dot(d, b)) / 3.0f;
+        T kz = kk * dot(d, a);
+        T p = ky - kx * kx;
+        T p3 = p * p * p;
+        T q = kx * (2.0f * kx * kx - 3.0f * ky) + kz;
+        T h = q * q + 4.0f * p3;
         
-        if (h >= 0.0f) {
-            h = std::sqrt(h);
-            vec3 x = (vec3(h, -h, h) - q) / 2.0f;
-            vec3 uv = sign(x) * pow(abs(x), vec3(1.0f / 3.0f));
-            float t = clamp(uv.x + uv.y - kx, 0.0f, 1.0f);
-            res = dot2(d + (c + b * t) * t);
-        } else {
-            float z = std::sqrt(-p);
-            float v = std::acos(q / (p * z * 2.0f)) / 3.0f;
-            float m = std::cos(v);
-            float n = std::sin(v) * 1.732050808f;
-            vec3 t = clamp(vec3(m + m, -n - m, n - m) * z - kx, 0.0f, 1.0f);
-            res = std::min(dot2(d + (c + b * t.x) * t.x),
-                          dot2(d + (c + b * t.y) * t.y));
+        // One real root or three; lane types skip a branch no lane takes
+        auto oneRoot = h >= 0.0f;
+        T res1 = 0.0f;
+        T res3 = 0.0f;
+        if (any(oneRoot)) {
+            T hs = sqrt(h);
+            T x0 = (hs - q) / 2.0f;
+            T x1 = (-hs - q) / 2.0f;
+            T uv0 = sign(x0) * pow(abs(x0), T(1.0f / 3.0f));
+            T uv1 = sign(x1) * pow(abs(x1), T(1.0f / 3.0f));
+            T t = clamp(uv0 + uv1 - kx, 0.0f, 1.0f);
+            res1 = dot2(d + (c + b * t) * t);
         }
-        return std::sqrt(res);
+        if (any(!oneRoot)) {
+            T z = sqrt(-p);
+            T v = acos(q / (p * z * 2.0f)) / 3.0f;
+            T m = cos(v);
+            T n = sin(v) * 1.732050808f;
+            V t = clamp(V(m + m, -n - m, n - m) * z - kx, 0.0f, 1.0f);
+            res3 = min(dot2(d + (c + b * t.x) * t.x),
+                       dot2(d + (c + b * t.y) * t.y));
+        }
+        return sqrt(select(oneRoot, res1, res3));
     }
 } // namespace bezier_detail
 
-inline float Bezier(const vec3& p, float /*time*/, uint32_t /*seed*/) {
+template <class V>
+inline scalar_t<V> Bezier(const V& p, float /*time*/, uint32_t /*seed*/) {
     float radius = 0.01f;
-    return bezier_detail::sdBezier(p, vec3(0.0f, 0.75f, 0.0f), vec3(0.5f, 0.8f, 0.0f), vec3(-0.75f, -0.65f, 0.0f)) - radius;
+    return bezier_detail::sdBezier(p, V(0.0f, 0.75f, 0.0f), V(0.5f, 0.8f, 0.0f), V(-0.75f, -0.65f, 0.0f)) - radius;
 }
 
 } // namespace sdf::geometry
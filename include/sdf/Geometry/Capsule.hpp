@@ -7,14 +7,16 @@
 namespace sdf::geometry {
 
 namespace detail {
-    inline float sdVerticalCapsule(vec3 p, float h, float r) {
+    template <class V>
+    inline scalar_t<V> sdVerticalCapsule(V p, float h, float r) {
         p.y -= clamp(p.y, 0.0f, h);
         return length(p) - r;
     }
 }
 
-inline float Capsule(const vec3& p, float /*time*/, uint32_t /*seed*/) {
-    return detail::sdVerticalCapsule(p + vec3(0.0f, 0.5f, 0.0f), 1.0f, 0.5f);
+template <class V>
+inline scalar_t<V> Capsule(const V& p, float /*time*/, uint32_t /*seed*/) {
+    return detail::sdVerticalCapsule(p + V(0.0f, 0.5f, 0.0f), 1.0f, 0.5f);
 }
 
 } // namespace sdf::geometry
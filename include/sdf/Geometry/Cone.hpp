@@ -7,15 +7,18 @@
 namespace sdf::geometry {
 
 namespace detail {
-    inline float sdCone(const vec3& p, const vec2& c, float h) {
-        float q = length(vec2(p.x, p.z));
-        return std::max(dot(c, vec2(q, p.y)), -h - p.y);
+    template <class V>
+    inline scalar_t<V> sdCone(const V& p, const vec2& c, float h) {
+        using V2 = vec2_t<scalar_t<V>>;
+        scalar_t<V> q = length(V2(p.x, p.z));
+        return max(dot(V2(q, p.y), c), -h - p.y);
     }
 }
 
-inline float Cone(const vec3& p, float /*time*/, uint32_t /*seed*/) {
+template <class V>
+inline scalar_t<V> Cone(const V& p, float /*time*/, uint32_t /*seed*/) {
     const float a = 1.11f;
-    return detail::sdCone(p - vec3(0.0f, 1.0f, 0.0f), vec2(sin(a), cos(a)), 2.0f);
+    return detail::sdCone(p - V(0.0f, 1.0f, 0.0f), vec2(sin(a), cos(a)), 2.0f);
 }
 
 } // namespace sdf::geometry
@@ -7,14 +7,16 @@
 namespace sdf::geometry {
 
 namespace cube_detail {
-    inline float sdBox(const vec3& p, const vec3& b) {
-        vec3 d = abs(p) - b;
-        return std::min(std::max(d.x, std::max(d.y, d.z)), 0.0f) + length(max(d, vec3(0.0f)));
+    template <class V>
+    inline scalar_t<V> sdBox(const V& p, const V& b) {
+        V d = abs(p) - b;
+        return min(max(d.x, max(d.y, d.z)), 0.0f) + length(max(d, V(0.0f)));
     }
 } // namespace cube_detail
 
-inline float Cube(const vec3& p, float /*time*/, uint32_t /*seed*/) {
-    return cube_detail::sdBox(p, vec3(0.5f));
+template <class V>
+inline scalar_t<V> Cube(const V& p, float /*time*/, uint32_t /*seed*/) {
+    return cube_detail::sdBox(p, V(0.5f));
 }
 
 } // namespace sdf::geometry
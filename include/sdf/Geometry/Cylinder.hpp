@@ -7,13 +7,16 @@
 namespace sdf::geometry {
 
 namespace detail {
-    inline float sdCappedCylinder(const vec3& p, float h, float r) {
-        vec2 d = abs(vec2(length(vec2(p.x, p.z)), p.y)) - vec2(h, r);
-        return std::min(std::max(d.x, d.y), 0.0f) + length(max(d, vec2(0.0f)));
+    template <class V>
+    inline scalar_t<V> sdCappedCylinder(const V& p, float h, float r) {
+        using V2 = vec2_t<scalar_t<V>>;
+        V2 d = abs(V2(length(V2(p.x, p.z)), p.y)) - V2(h, r);
+        return min(max(d.x, d.y), 0.0f) + length(max(d, V2(0.0f)));
     }
 }
 
-inline float Cylinder(const vec3& p, float /*time*/, uint32_t /*seed*/) {
+template <class V>
+inline scalar_t<V> Cylinder(const V& p, float /*time*/, uint32_t /*seed*/) {
     return detail::sdCappedCylinder(p, 1.0f, 1.0f);
 }
 
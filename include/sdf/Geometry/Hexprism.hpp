@@ -7,22 +7,25 @@
 namespace sdf::geometry {
 
 namespace detail {
-    inline float sdHexPrism(vec3 p, const vec2& h) {
+    template <class V>
+    inline scalar_t<V> sdHexPrism(V p, const vec2& h) {
+        using V2 = vec2_t<scalar_t<V>>;
         const vec3 k = vec3(-0.8660254f, 0.5f, 0.57735f);
         p = abs(p);
-        vec2 pxy = vec2(p.x, p.y);
-        pxy -= 2.0f * std::min(dot(vec2(k.x, k.y), pxy), 0.0f) * vec2(k.x, k.y);
+        V2 pxy = V2(p.x, p.y);
+        pxy -= 2.0f * min(dot(V2(k.x, k.y), pxy), 0.0f) * V2(k.x, k.y);
         p.x = pxy.x;
         p.y = pxy.y;
-        vec2 d = vec2(
-            length(pxy - vec2(clamp(p.x, -k.z * h.x, k.z * h.x), h.x)) * sign(p.y - h.x),
+        V2 d = V2(
+            length(pxy - V2(clamp(p.x, -k.z * h.x, k.z * h.x), h.x)) * sign(p.y - h.x),
             p.z - h.y
         );
-        return std::min(std::max(d.x, d.y), 0.0f) + length(max(d, vec2(0.0f)));
+        return min(max(d.x, d.y), 0.0f) + length(max(d, V2(0.0f)));
     }
 }
 
-inline float Hexprism(const vec3& p, float /*time*/, uint32_t /*seed*/) {
+template <class V>
+inline scalar_t<V> Hexprism(const V& p, float /*time*/, uint32_t /*seed*/) {
     return detail::sdHexPrism(p, vec2(0.5f));
 }
 
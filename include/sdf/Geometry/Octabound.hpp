@@ -7,13 +7,15 @@
 namespace sdf::geometry {
 
 namespace detail {
-    inline float sdOctahedronBound(vec3 p, float s) {
+    template <class V>
+    inline scalar_t<V> sdOctahedronBound(V p, float s) {
         p = abs(p);
         return (p.x + p.y + p.z - s) * 0.57735027f;
     }
 }
 
-inline float Octabound(const vec3& p, float /*time*/, uint32_t /*seed*/) {
+template <class V>
+inline scalar_t<V> Octabound(const V& p, float /*time*/, uint32_t /*seed*/) {
     return detail::sdOctahedronBound(p, 0.5f);
 }
 
@@ -7,21 +7,23 @@
 namespace sdf::geometry {
 
 namespace detail {
-    inline float sdOctahedron(vec3 p, float s) {
+    template <class V>
+    inline scalar_t<V> sdOctahedron(V p, float s) {
+        using T = scalar_t<V>;
         p = abs(p);
-        float m = p.x + p.y + p.z - s;
-        vec3 q;
-        if (3.0f * p.x < m) q = p;
-        else if (3.0f * p.y < m) q = vec3(p.y, p.z, p.x);
-        else if (3.0f * p.z < m) q = vec3(p.z, p.x, p.y);
-        else return m * 0.57735027f;
+        T m = p.x + p.y + p.z - s;
+        auto cx = 3.0f * p.x < m;
+        auto cy = 3.0f * p.y < m;
+        auto cz = 3.0f * p.z < m;
+        V q = select(cx, p, select(cy, V(p.y, p.z, p.x), V(p.z, p.x, p.y)));
         
-        float k = clamp(0.5f * (q.z - q.y + s), 0.0f, s);
-        return length(vec3(q.x, q.y - s + k, q.z - k));
+        T k = clamp(0.5f * (q.z - q.y + s), 0.0f, s);
+        return select(cx | cy | cz, length(V(q.x, q.y - s + k, q.z - k)), m * 0.57735027f);
     }
 }
 
-inline float Octahedron(const vec3& p, float /*time*/, uint32_t /*seed*/) {
+template <class V>
+inline scalar_t<V> Octahedron(const V& p, float /*time*/, uint32_t /*seed*/) {
     return detail::sdOctahedron(p, 0.5f);
 }
 
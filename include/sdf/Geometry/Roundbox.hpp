@@ -7,14 +7,16 @@
 namespace sdf::geometry {
 
 namespace detail {
-    inline float sdRoundBox(const vec3& p, const vec3& b, float r) {
-        vec3 q = abs(p) - b;
-        return length(max(q, vec3(0.0f))) + std::min(std::max(q.x, std::max(q.y, q.z)), 0.0f) - r;
+    template <class V>
+    inline scalar_t<V> sdRoundBox(const V& p, const V& b, float r) {
+        V q = abs(p) - b;
+        return length(max(q, V(0.0f))) + min(max(q.x, max(q.y, q.z)), 0.0f) - r;
     }
 }
 
-inline float Roundbox(const vec3& p, float /*time*/, uint32_t /*seed*/) {
-    return detail::sdRoundBox(p, vec3(0.4f), 0.25f);
+template <class V>
+inline scalar_t<V> Roundbox(const V& p, float /*time*/, uint32_t /*seed*/) {
+    return detail::sdRoundBox(p, V(0.4f), 0.25f);
 }
 
 } // namespace sdf::geometry
@@ -7,12 +7,14 @@
 namespace sdf::geometry {
 
 namespace detail {
-    inline float sdSphere(const vec3& p, float s) {
+    template <class V>
+    inline scalar_t<V> sdSphere(const V& p, float s) {
         return length(p) - s;
     }
 }
 
-inline float Sphere(const vec3& p, float /*time*/, uint32_t /*seed*/) {
+template <class V>
+inline scalar_t<V> Sphere(const V& p, float /*time*/, uint32_t /*seed*/) {
     return detail::sdSphere(p, 0.5f);
 }
 
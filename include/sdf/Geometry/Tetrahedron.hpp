@@ -6,13 +6,14 @@
 
 namespace sdf::geometry {
 
-inline float Tetrahedron(const vec3& p_in, float /*time*/, uint32_t /*seed*/) {
-    vec3 p = p_in * 0.5f;
-    return std::max(
+template <class V>
+inline scalar_t<V> Tetrahedron(const V& p_in, float /*time*/, uint32_t /*seed*/) {
+    V p = p_in * 0.5f;
+    return max(
         // Vertical bound
-        std::abs(p.y) - 0.5f,
+        abs(p.y) - 0.5f,
         // Horizontal bound
-        std::max(std::abs(p.x) * 0.866025f + p.z * 0.5f, -p.z) - 0.25f * std::abs(0.5f - p.y)
+        max(abs(p.x) * 0.866025f + p.z * 0.5f, -p.z) - 0.25f * abs(0.5f - p.y)
     ) * 2.0f;
 }
 
@@ -7,13 +7,17 @@
 namespace sdf::geometry {
 
 namespace detail {
-    inline float sdTorus(const vec3& p, const vec2& t) {
-        return length(vec2(length(vec2(p.x, p.z)) - t.x, p.y)) - t.y;
+    template <class V>
+    inline scalar_t<V> sdTorus(const V& p, const vec2& t) {
+        using V2 = vec2_t<scalar_t<V>>;
+        return length(V2(length(V2(p.x, p.z)) - t.x, p.y)) - t.y;
     }
 }
 
-inline float Torus(const vec3& p_in, float /*time*/, uint32_t /*seed*/) {
-    vec3 p = rotationMatrix(vec3(1.0f, 0.0f, 0.0f), pi / 2.0f) * p_in;
+template <class V>
+inline scalar_t<V> Torus(const V& p_in, float /*time*/, uint32_t /*seed*/) {
+    static const mat3 rot = rotationMatrix(vec3(1.0f, 0.0f, 0.0f), pi / 2.0f);
+    V p = rot * p_in;
     return detail::sdTorus(p, vec2(0.4f, 0.2f));
 }
 
@@ -7,35 +7,42 @@
 namespace sdf::geometry {
 
 namespace detail {
-    inline float PrBox2Df(const vec2& p, const vec2& b) {
-        vec2 d = abs(p) - b;
-        return std::min(std::max(d.x, d.y), 0.0f) + length(max(d, vec2(0.0f)));
+    template <class V2>
+    inline scalar_t<V2> PrBox2Df(const V2& p, const V2& b) {
+        V2 d = abs(p) - b;
+        return min(max(d.x, d.y), 0.0f) + length(max(d, V2(0.0f)));
     }
     
-    inline vec2 Rot2D(const vec2& q, float a) {
-        return q * std::cos(a) + vec2(q.y, q.x) * std::sin(a) * vec2(-1.0f, 1.0f);
+    template <class V2>
+    inline V2 Rot2D(const V2& q, scalar_t<V2> a) {
+        return q * cos(a) + V2(q.y, q.x) * sin(a) * V2(-1.0f, 1.0f);
     }
     
-    inline float ObjDf(const vec3& p, float r) {
+    template <class V>
+    inline scalar_t<V> ObjDf(const V& p, float r) {
+        using T = scalar_t<V>;
+        using V2 = vec2_t<T>;
         const float dstFar = 100.0f;
-        float dMin = dstFar;
+        T dMin = dstFar;
         
-        vec3 q = p;
-        float a = std::atan2(q.z, q.x);
-        vec2 qxz = vec2(length(vec2(q.x, q.z)) - r, q.y);
+        V q = p;
+        T a = atan2(q.z, q.x);
+        V2 qxz = V2(length(V2(q.x, q.z)) - r, q.y);
         qxz = Rot2D(qxz, 1.5f * a);
-        qxz = Rot2D(qxz, -pi * std::floor(std::atan2(qxz.y, qxz.x) / pi + 0.5f));
+        qxz = Rot2D(qxz, -pi * floor(atan2(qxz.y, qxz.x) / pi + 0.5f));
         qxz.x -= 1.0f;
         
-        float d = length(PrBox2Df(qxz, vec2(0.2f))) - 0.05f;
-        dMin = std::min(dMin, d);
+        T d = abs(PrBox2Df(qxz, V2(0.2f))) - 0.05f;
+        dMin = min(dMin, d);
         
         return 0.4f * dMin;
     }
 }
 
-inline float Trefoil(const vec3& p_in, float /*time*/, uint32_t /*seed*/) {
-    vec3 p = rotationMatrix(vec3(1.0f, 0.0f, 0.0f), pi / 2.0f) * p_in;
+template <class V>
+inline scalar_t<V> Trefoil(const V& p_in, float /*time*/, uint32_t /*seed*/) {
+    static const mat3 rot = rotationMatrix(vec3(1.0f, 0.0f, 0.0f), pi / 2.0f);
+    V p = rot * p_in;
     const float scale = 0.18f;
     return detail::ObjDf(p * (1.0f / scale), 3.5f) * scale;
 }
@@ -7,13 +7,15 @@
 namespace sdf::geometry {
 
 namespace detail {
-    inline float sdTriPrism(vec3 p, const vec2& h) {
-        vec3 q = abs(p);
-        return std::max(q.z - h.y, std::max(q.x * 0.866025f + p.y * 0.5f, -p.y) - h.x * 0.5f);
+    template <class V>
+    inline scalar_t<V> sdTriPrism(V p, const vec2& h) {
+        V q = abs(p);
+        return max(q.z - h.y, max(q.x * 0.866025f + p.y * 0.5f, -p.y) - h.x * 0.5f);
     }
 }
 
-inline float Triprismbound(const vec3& p, float /*time*/, uint32_t /*seed*/) {
+template <class V>
+inline scalar_t<V> Triprismbound(const V& p, float /*time*/, uint32_t /*seed*/) {
     return detail::sdTriPrism(p, vec2(0.5f));
 }
 
@@ -14,50 +14,86 @@ inline mat2 rotate2D(float rad) {
     return mat2(c, s, -s, c);
 }
 
-inline vec2 de(const vec3& p_in, float time) {
-    float d = 100.0f;
-    float a = 0.0f;
+constexpr int kCables = 50;
+
+// Quantities of de() that depend only on time
+struct Frame {
+    vec3 reaction;
+    float radius[kCables];
+};
+
+inline Frame frame(float time) {
+    Frame f;
+    f.reaction = vec3(cos(time), 0.0f, sin(time)) * 3.0f;
+    for (int i = 0; i < kCables; i++) {
+        float s = 0.5f + sin(float(i) * 1.618f * twopi) * 0.25f;
+        s += sin(time + float(i)) * 0.1f;
+        f.radius[i] = s;
+    }
+    return f;
+}
+
+template <class V>
+inline vec2_t<scalar_t<V>> de(const V& p_in, const Frame& frame) {
+    using T = scalar_t<V>;
+    using V2 = vec2_t<T>;
+    T d = 100.0f;
+    T a = 0.0f;
     
-    vec3 p = p_in;
+    V p = p_in;
     
     // yz rotation
     mat2 rotyz = rotate2D(pi / 5.0f);
-    vec2 pyz = rotyz * vec2(p.y, p.z);
+    V2 pyz = rotyz * V2(p.y, p.z);
     p.y = pyz.x;
     p.z = pyz.y;
     p.y -= 0.5f;
     
     // Reaction sphere
-    vec3 reaction = vec3(cos(time), 0.0f, sin(time)) * 3.0f;
+    const V reaction = V(frame.reaction.x, frame.reaction.y, frame.reaction.z);
     p += exp(-length(reaction - p) * 1.0f) * normalize(reaction - p);
     
     // Cables
-    float r = atan(p.z, p.x) * 3.0f;
-    const int ite = 50;
+    T r = atan2(p.z, p.x) * 3.0f;
+    const int ite = kCables;
     for (int i = 0; i < ite; i++) {
         r += 0.5f / float(ite) * twopi;
-        float s = 0.5f + sin(float(i) * 1.618f * twopi) * 0.25f;
-        s += sin(time + float(i)) * 0.1f;
-        vec2 q = vec2(length(vec2(p.x, p.z)) + cos(r) * s - 3.0f, p.y + sin(r) * s);
-        float dd = length(q) - 0.035f;
-        a = dd < d ? float(i) : a;
-        d = glm::min(d, dd);
+        float s = frame.radius[i];
+        V2 q = V2(length(V2(p.x, p.z)) + cos(r) * s - 3.0f, p.y + sin(r) * s);
+        T dd = length(q) - 0.035f;
+        a = select(dd < d, T(float(i)), a);
+        d = min(d, dd);
     }
     
     // Sphere
-    float dd = length(p - reaction) - 0.1f;
-    a = dd < d ? 0.0f : a;
-    d = glm::min(d, dd);
+    T dd = length(p - reaction) - 0.1f;
+    a = select(dd < d, T(0.0f), a);
+    d = min(d, dd);
     
-    return vec2(d, a);
+    return V2(d, a);
 }
 
 } // namespace cables_detail
 
-inline float Cables(const vec3& p_in, float time, uint32_t /*seed*/) {
+// Per-frame constants of Cables
+struct CablesFrame {
+    cables_detail::Frame de;
+};
+
+inline CablesFrame prepareCables(float time, uint32_t /*seed*/) {
+    return CablesFrame{cables_detail::frame(time)};
+}
+
+template <class V>
+inline scalar_t<V> Cables(const V& p_in, const CablesFrame& frame) {
     const float scale = 0.23f;
-    vec3 p = p_in * (1.0f / scale);
-    return cables_detail::de(p, time).x * scale * 0.7f;
+    V p = p_in * (1.0f / scale);
+    return cables_detail::de(p, frame.de).x * scale * 0.7f;
+}
+
+template <class V>
+inline scalar_t<V> Cables(const V& p_in, float time, uint32_t seed) {
+    return Cables(p_in, prepareCables(time, seed));
 }
 
 } // namespace sdf::manufactured
@@ -7,57 +7,65 @@
 namespace sdf::manufactured {
 
 namespace detail {
-    inline float sdBox(const vec3& p, const vec3& b) {
-        vec3 d = abs(p) - b;
-        return std::min(std::max(std::max(d.x, d.y), d.z), 0.0f) + length(max(d, vec3(0.0f)));
+    template <class V>
+    inline scalar_t<V> sdBox(const V& p, const V& b) {
+        V d = abs(p) - b;
+        return min(max(max(d.x, d.y), d.z), 0.0f) + length(max(d, V(0.0f)));
     }
     
-    inline vec3 DomainRotateSymmetry(const vec3& vPos, float fSteps) {
-        float angle = std::atan2(vPos.x, vPos.z);
+    template <class V>
+    inline V DomainRotateSymmetry(const V& vPos, float fSteps) {
+        using T = scalar_t<V>;
+        T angle = atan2(vPos.x, vPos.z);
         
         float fScale = fSteps / (pi * 2.0f);
-        float steppedAngle = std::floor(angle * fScale + 0.5f) / fScale;
+        T steppedAngle = floor(angle * fScale + 0.5f) / fScale;
         
-        float s = std::sin(-steppedAngle);
-        float c = std::cos(-steppedAngle);
+        T s = sin(-steppedAngle);
+        T c = cos(-steppedAngle);
         
-        return vec3(c * vPos.x + s * vPos.z, vPos.y, -s * vPos.x + c * vPos.z);
+        return V(c * vPos.x + s * vPos.z, vPos.y, -s * vPos.x + c * vPos.z);
     }
     
-    inline float GetDistanceGear(const vec3& vPos) {
-        float fOuterCylinder = length(vec2(vPos.x, vPos.z)) - 1.05f;
-        if (fOuterCylinder > 0.5f) {
+    template <class V>
+    inline scalar_t<V> GetDistanceGear(const V& vPos) {
+        using T = scalar_t<V>;
+        using V2 = vec2_t<T>;
+        T fOuterCylinder = length(V2(vPos.x, vPos.z)) - 1.05f;
+        auto outside = fOuterCylinder > 0.5f;
+        if (all(outside)) {
             return fOuterCylinder;
         }
         
-        vec3 vToothDomain = DomainRotateSymmetry(vPos, 16.0f);
-        vToothDomain.x = std::abs(vToothDomain.x);
-        vToothDomain.z = std::abs(vToothDomain.z);
-        float fGearDist = dot(vec2(vToothDomain.x, vToothDomain.z), normalize(vec2(1.0f, 0.55f))) - 0.55f;
-        float fSlabDist = std::abs(vPos.y + 0.1f) - 0.15f;
+        V vToothDomain = DomainRotateSymmetry(vPos, 16.0f);
+        vToothDomain.x = abs(vToothDomain.x);
+        vToothDomain.z = abs(vToothDomain.z);
+        T fGearDist = dot(V2(vToothDomain.x, vToothDomain.z), normalize(vec2(1.0f, 0.55f))) - 0.55f;
+        T fSlabDist = abs(vPos.y + 0.1f) - 0.15f;
         
-        vec3 vHoleDomain = abs(vPos);
+        V vHoleDomain = abs(vPos);
         vHoleDomain -= 0.35f;
-        float fHoleDist = length(vec2(vHoleDomain.x, vHoleDomain.z)) - 0.2f;
+        T fHoleDist = length(V2(vHoleDomain.x, vHoleDomain.z)) - 0.2f;
         
-        float fBarDist = vToothDomain.z - 0.15f;
-        fBarDist = std::max(vPos.y - 0.1f, fBarDist);
+        T fBarDist = vToothDomain.z - 0.15f;
+        fBarDist = max(vPos.y - 0.1f, fBarDist);
         
-        float fResult = fGearDist;
-        fResult = std::max(fResult, fSlabDist);
-        fResult = std::max(fResult, fOuterCylinder);
-        fResult = std::max(fResult, -fHoleDist);
+        T fResult = fGearDist;
+        fResult = max(fResult, fSlabDist);
+        fResult = max(fResult, fOuterCylinder);
+        fResult = max(fResult, -fHoleDist);
         
-        fResult = std::min(fResult, fBarDist);
-        return fResult;
+        fResult = min(fResult, fBarDist);
+        return select(outside, fOuterCylinder, fResult);
     }
 }
 
-inline float Gear(const vec3& p, float /*time*/, uint32_t /*seed*/) {
-    float boxD = detail::sdBox(p, vec3(1.0f, 1.0f, 1.0f));
-    vec3 pRot = rotationMatrix(vec3(1.0f, 0.0f, 0.0f), -pi / 2.0f) * p;
+template <class V>
+inline scalar_t<V> Gear(const V& p, float /*time*/, uint32_t /*seed*/) {
+    scalar_t<V> boxD = detail::sdBox(p, V(1.0f, 1.0f, 1.0f));
+    V pRot = rotationMatrix(vec3(1.0f, 0.0f, 0.0f), -pi / 2.0f) * p;
     const float scale = 0.8f;
-    return std::max(boxD, detail::GetDistanceGear(pRot * (1.0f / scale))) * scale;
+    return max(boxD, detail::GetDistanceGear(pRot * (1.0f / scale))) * scale;
 }
 
 } // namespace sdf::manufactured
@@ -8,66 +8,81 @@ namespace sdf {
 namespace manufactured {
 
 namespace knob_detail {
-    inline float sdSphere(const vec3& v, float r) {
+    template <class V>
+    inline scalar_t<V> sdSphere(const V& v, float r) {
         return length(v) - r;
     }
     
-    inline float sdTorus(const vec3& p, const vec2& t) {
-        vec2 q = vec2(length(vec2(p.x, p.z)) - t.x, p.y);
+    template <class V>
+    inline scalar_t<V> sdTorus(const V& p, const vec2& t) {
+        using V2 = vec2_t<scalar_t<V>>;
+        V2 q = V2(length(V2(p.x, p.z)) - t.x, p.y);
         return length(q) - t.y;
     }
     
-    inline float sdCone(const vec3& p, const vec2& c) {
-        float q = length(vec2(p.x, p.y));
-        return dot(c, vec2(q, p.z));
+    template <class V>
+    inline scalar_t<V> sdCone(const V& p, const vec2& c) {
+        using V2 = vec2_t<scalar_t<V>>;
+        scalar_t<V> q = length(V2(p.x, p.y));
+        return dot(V2(q, p.z), c);
     }
     
-    inline float sdCappedCylinder(const vec3& p, float h, float r) {
-        vec2 d = abs(vec2(length(vec2(p.x, p.z)), p.y)) - vec2(h, r);
-        return std::min(std::max(d.x, d.y), 0.0f) + length(max(d, vec2(0.0f)));
+    template <class V>
+    inline scalar_t<V> sdCappedCylinder(const V& p, float h, float r) {
+        using V2 = vec2_t<scalar_t<V>>;
+        V2 d = abs(V2(length(V2(p.x, p.z)), p.y)) - V2(h, r);
+        return min(max(d.x, d.y), 0.0f) + length(max(d, V2(0.0f)));
     }
     
-    inline float sdTriPrism(const vec3& p, const vec2& h) {
-        vec3 q = abs(p);
-        return std::max(q.z - h.y, std::max(q.x * 0.866025f + p.y * 0.5f, -p.y) - h.x * 0.5f);
+    template <class V>
+    inline scalar_t<V> sdTriPrism(const V& p, const vec2& h) {
+        V q = abs(p);
+        return max(q.z - h.y, max(q.x * 0.866025f + p.y * 0.5f, -p.y) - h.x * 0.5f);
     }
     
-    inline float opSmoothUnion(float d1, float d2, float k) {
-        float h = clamp(0.5f + 0.5f * (d2 - d1) / k, 0.0f, 1.0f);
+    template <class T>
+    inline T opSmoothUnion(T d1, T d2, float k) {
+        T h = clamp(0.5f + 0.5f * (d2 - d1) / k, T(0.0f), T(1.0f));
         return mix(d2, d1, h) - k * h * (1.0f - h);
     }
     
-    inline float ssub(float d1, float d2, float k) {
-        float h = clamp(0.5f - 0.5f * (d2 + d1) / k, 0.0f, 1.0f);
+    template <class T>
+    inline T ssub(T d1, T d2, float k) {
+        T h = clamp(0.5f - 0.5f * (d2 + d1) / k, T(0.0f), T(1.0f));
         return mix(d2, -d1, h) + k * h * (1.0f - h);
     }
     
-    inline float sdBase(vec3 p) {
-        float base = opSmoothUnion(
-            sdCone(rotationMatrix(vec3(1.0f, 0.0f, 0.0f), -pi / 2.0f) * (p + vec3(0.0f, 0.9f, 0.0f)), vec2(pi / 3.0f)),
-            sdCone(rotationMatrix(vec3(1.0f, 0.0f, 0.0f), pi / 2.0f) * (p - vec3(0.0f, 0.9f, 0.0f)), vec2(pi / 3.0f)),
+    template <class V>
+    inline scalar_t<V> sdBase(V p) {
+        using T = scalar_t<V>;
+        T base = opSmoothUnion(
+            sdCone(rotationMatrix(vec3(1.0f, 0.0f, 0.0f), -pi / 2.0f) * (p + V(0.0f, 0.9f, 0.0f)), vec2(pi / 3.0f)),
+            sdCone(rotationMatrix(vec3(1.0f, 0.0f, 0.0f), pi / 2.0f) * (p - V(0.0f, 0.9f, 0.0f)), vec2(pi / 3.0f)),
             0.02f);
-        base = std::max(base, sdCappedCylinder(p, 1.1f, 0.25f)) * 0.7f;
-        base = std::max(-sdCappedCylinder(p, 0.6f, 0.3f), base);
-        base = std::max(-sdTriPrism(rotationMatrix(vec3(1.0f, 0.0f, 0.0f), pi / 2.0f) * (p + vec3(0.0f, 0.0f, -1.0f)), vec2(1.2f, 0.3f)), base);
+        base = max(base, sdCappedCylinder(p, 1.1f, 0.25f)) * 0.7f;
+        base = max(-sdCappedCylinder(p, 0.6f, 0.3f), base);
+        base = max(-sdTriPrism(rotationMatrix(vec3(1.0f, 0.0f, 0.0f), pi / 2.0f) * (p + V(0.0f, 0.0f, -1.0f)), vec2(1.2f, 0.3f)), base);
         return base;
     }
     
-    inline float sdKnob(const vec3& p) {
-        float sphere = sdSphere(p, 1.0f);
-        float cutout = sdSphere(p - vec3(0.0f, 0.5f, 0.5f), 0.7f);
-        float cutout_etch = sdTorus(rotationMatrix(vec3(1.0f, 0.0f, 0.0f), -pi / 4.0f) * (p - vec3(0.0f, 0.2f, 0.2f)), vec2(1.0f, 0.05f));
-        float innersphere = sdSphere(p - vec3(0.0f, 0.0f, 0.0f), 0.75f);
+    template <class V>
+    inline scalar_t<V> sdKnob(const V& p) {
+        using T = scalar_t<V>;
+        T sphere = sdSphere(p, 1.0f);
+        T cutout = sdSphere(p - V(0.0f, 0.5f, 0.5f), 0.7f);
+        T cutout_etch = sdTorus(rotationMatrix(vec3(1.0f, 0.0f, 0.0f), -pi / 4.0f) * (p - V(0.0f, 0.2f, 0.2f)), vec2(1.0f, 0.05f));
+        T innersphere = sdSphere(p - V(0.0f, 0.0f, 0.0f), 0.75f);
         
-        float d = ssub(cutout, sphere, 0.1f);
-        d = std::min(d, innersphere);
-        d = std::max(-cutout_etch, d);
-        d = std::min(ssub(sphere, sdBase(p - vec3(0.0f, -0.775f, 0.0f)), 0.1f), d);
+        T d = ssub(cutout, sphere, 0.1f);
+        d = min(d, innersphere);
+        d = max(-cutout_etch, d);
+        d = min(ssub(sphere, sdBase(p - V(0.0f, -0.775f, 0.0f)), 0.1f), d);
         return d;
     }
 }
 
-inline float Knob(const vec3& p, float /*time*/, uint32_t /*seed*/) {
+template <class V>
+inline scalar_t<V> Knob(const V& p, float /*time*/, uint32_t /*seed*/) {
     const float scale = 0.8f;
     return knob_detail::sdKnob(p * (1.0f / scale)) * scale;
 }
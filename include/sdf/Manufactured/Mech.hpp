@@ -18,70 +18,91 @@ inline float remap(float f, float in1, float in2, float out1, float out2) {
     return mix(out1, out2, clamp((f - in1) / (in2 - in1), 0.0f, 1.0f));
 }
 
-inline float sdBox(const vec3& p, const vec3& b) {
-    vec3 q = abs(p) - b;
-    return length(max(q, vec3(0.0f))) + glm::min(glm::max(q.x, glm::max(q.y, q.z)), 0.0f);
+template <class V>
+inline scalar_t<V> sdBox(const V& p, const V& b) {
+    V q = abs(p) - b;
+    return length(max(q, V(0.0f))) + min(max(q.x, max(q.y, q.z)), 0.0f);
 }
 
-inline float sdChamferedCube(const vec3& p_in, const vec3& r, float c) {
-    float cube = sdBox(p_in, r);
-    vec3 p = p_in;
+template <class V>
+inline scalar_t<V> sdChamferedCube(const V& p_in, const V& r, float c) {
+    using T = scalar_t<V>;
+    using V2 = vec2_t<T>;
+    T cube = sdBox(p_in, r);
+    V p = p_in;
     mat2 rotm = rot(pi / 4.0f);
-    vec2 pxz = rotm * vec2(p.x, p.z);
+    V2 pxz = rotm * V2(p.x, p.z);
     p.x = pxz.x; p.z = pxz.y;
-    vec3 rr = r;
+    V rr = r;
     rr.x *= -c / 1.41f + 1.41f;
     rr.z *= -c / 1.41f + 1.41f;
-    return glm::max(cube, sdBox(p, rr));
+    return max(cube, sdBox(p, rr));
 }
 
-inline float sdTriPrism(const vec3& p, const vec2& h) {
-    vec3 q = abs(p);
-    return glm::max(q.z - h.y, glm::max(q.x * 0.866025f + p.y * 0.5f, -p.y) - h.x * 0.5f);
+template <class V>
+inline scalar_t<V> sdTriPrism(const V& p, const vec2& h) {
+    V q = abs(p);
+    return max(q.z - h.y, max(q.x * 0.866025f + p.y * 0.5f, -p.y) - h.x * 0.5f);
 }
 
-inline float sdCappedCone(const vec3& p, const vec3& a, const vec3& b, float ra, float rb) {
+template <class V>
+inline scalar_t<V> sdCappedCone(const V& p, const V& a, const V& b, float ra, float rb) {
+    using T = scalar_t<V>;
     float rba = rb - ra;
-    float baba = dot(b - a, b - a);
-    float papa = dot(p - a, p - a);
-    float paba = dot(p - a, b - a) / baba;
-    float x = sqrt(papa - paba * paba * baba);
-    float cax = glm::max(0.0f, x - ((paba < 0.5f) ? ra : rb));
-    float cay = abs(paba - 0.5f) - 0.5f;
-    float k = rba * rba + baba;
-    float f = clamp((rba * (x - ra) + paba * baba) / k, 0.0f, 1.0f);
-    float cbx = x - ra - f * rba;
-    float cby = paba - f;
-    float s = (cbx < 0.0f && cay < 0.0f) ? -1.0f : 1.0f;
-    return s * sqrt(glm::min(cax * cax + cay * cay * baba, cbx * cbx + cby * cby * baba));
+    T baba = dot(b - a, b - a);
+    T papa = dot(p - a, p - a);
+    T paba = dot(p - a, b - a) / baba;
+    T x = sqrt(papa - paba * paba * baba);
+    T cax = max(0.0f, x - select(paba < 0.5f, T(ra), T(rb)));
+    T cay = abs(paba - 0.5f) - 0.5f;
+    T k = rba * rba + baba;
+    T f = clamp((rba * (x - ra) + paba * baba) / k, T(0.0f), T(1.0f));
+    T cbx = x - ra - f * rba;
+    T cby = paba - f;
+    T s = select((cbx < 0.0f) & (cay < 0.0f), T(-1.0f), T(1.0f));
+    return s * sqrt(min(cax * cax + cay * cay * baba, cbx * cbx + cby * cby * baba));
 }
 
-inline float sdCappedCylinder(const vec3& p, float h, float r) {
-    vec2 d = abs(vec2(length(vec2(p.x, p.y)), p.z)) - vec2(h, r);
-    return glm::min(glm::max(d.x, d.y), 0.0f) + length(max(d, vec2(0.0f)));
+template <class V>
+inline scalar_t<V> sdCappedCylinder(const V& p, scalar_t<V> h, scalar_t<V> r) {
+    using V2 = vec2_t<scalar_t<V>>;
+    V2 d = abs(V2(length(V2(p.x, p.y)), p.z)) - V2(h, r);
+    return min(max(d.x, d.y), 0.0f) + length(max(d, V2(0.0f)));
 }
 
-inline float sdCapsule(const vec3& p, const vec3& a, const vec3& b, float r) {
-    vec3 pa = p - a, ba = b - a;
-    float h = clamp(dot(pa, ba) / dot(ba, ba), 0.0f, 1.0f);
+template <class V>
+inline scalar_t<V> sdCapsule(const V& p, const V& a, const V& b, float r) {
+    using T = scalar_t<V>;
+    V pa = p - a, ba = b - a;
+    T h = clamp(dot(pa, ba) / dot(ba, ba), T(0.0f), T(1.0f));
     return length(pa - ba * h) - r;
 }
 
+template <class T>
 struct MarchData {
-    float d;
-    vec3 mat;
-    float specPower;
+    T d;
+    vec3_t<T> mat;
+    T specPower;
 };
 
-inline MarchData minResult(const MarchData& a, const MarchData& b) {
-    return (a.d < b.d) ? a : b;
+template <class T>
+inline MarchData<T> minResult(const MarchData<T>& a, const MarchData<T>& b) {
+    auto c = a.d < b.d;
+    return {select(c, a.d, b.d), select(c, a.mat, b.mat), select(c, a.specPower, b.specPower)};
 }
 
-inline void setBodyMaterial(MarchData& mat) {
-    mat.mat = vec3(0.36f, 0.45f, 0.5f);
+template <class T>
+inline void setBodyMaterial(MarchData<T>& mat) {
+    mat.mat = vec3_t<T>(0.36f, 0.45f, 0.5f);
     mat.specPower = 30.0f;
 }
 
+// m[int(sign(x)) + 1] * v, choosing the matrix per lane
+template <class V2>
+inline V2 rotBySign(scalar_t<V2> x, const mat2 m[3], const V2& v) {
+    return select(x < 0.0f, m[0] * v, select(x > 0.0f, m[2] * v, m[1] * v));
+}
+
 inline float legWalkAngle(float f, float edWalk) {
     return sin(edWalk * pi * 6.0f * f) * 0.2f;
 }
@@ -94,294 +115,357 @@ inline float fireShock(float edShoot) {
     return abs(sin(edShoot * pi * 25.0f));
 }
 
-inline float headSphere(const vec3& p) {
-    return (length(p / vec3(1.0f, 0.8f, 1.0f)) - 1.0f) * 0.8f;
+template <class V>
+inline scalar_t<V> headSphere(const V& p) {
+    return (length(p / V(1.0f, 0.8f, 1.0f)) - 1.0f) * 0.8f;
 }
 
-inline MarchData headVisor(const vec3& p_in, float h, float bump) {
-    vec3 p = p_in;
-    bump *= sin(p.x * 150.0f) * sin(p.y * 150.0f) * 0.002f;
-    MarchData result;
-    result.d = sdBox(p, vec3(1.0f, h, 2.0f));
-    result.d = glm::max(mix(result.d, headSphere(p), 0.57f), -p.y) - bump;
-    result.mat = vec3(0.05f);
+template <class V>
+inline MarchData<scalar_t<V>> headVisor(const V& p_in, float h, float bump_in) {
+    using T = scalar_t<V>;
+    V p = p_in;
+    T bump = bump_in * (sin(p.x * 150.0f) * sin(p.y * 150.0f) * 0.002f);
+    MarchData<T> result;
+    result.d = sdBox(p, V(1.0f, h, 2.0f));
+    result.d = max(mix(result.d, headSphere(p), T(0.57f)), -p.y) - bump;
+    result.mat = V(0.05f);
     result.specPower = 30.0f;
     return result;
 }
 
-inline MarchData headLower(const vec3& p_in, float gunsUp) {
-    vec3 op = p_in;
-    vec3 p = p_in;
-    MarchData r = headVisor(p * vec3(0.95f, -1.4f, 0.95f), 1.0f, 0.0f);
+template <class V>
+inline MarchData<scalar_t<V>> headLower(const V& p_in, const mat2 wings[3]) {
+    using T = scalar_t<V>;
+    using V2 = vec2_t<T>;
+    V op = p_in;
+    V p = p_in;
+    MarchData<T> r = headVisor(p * V(0.95f, -1.4f, 0.95f), 1.0f, 0.0f);
     
-    float roof = glm::max(glm::max(headVisor((p + vec3(0.0f, 0.01f, 0.0f)) * vec3(0.95f), 1.0f, 0.0f).d, p.y - 0.35f), 
-                         p.y * 0.625f - p.z - 0.66f);
-    r.d = glm::min(r.d, roof);
+    T roof = max(max(headVisor((p + V(0.0f, 0.01f, 0.0f)) * V(0.95f), 1.0f, 0.0f).d, p.y - 0.35f), 
+                 p.y * 0.625f - p.z - 0.66f);
+    r.d = min(r.d, roof);
 
     // Wings
-    mat2 rotm = rot(0.075f * (gunsUp - 1.0f) * sign(p.x));
-    vec2 pxy = rotm * vec2(p.x, p.y);
+    V2 pxy = rotBySign(p.x, wings, V2(p.x, p.y));
     p.x = pxy.x; p.y = pxy.y;
     p.x = abs(p.x) - 1.33f;
     p.y -= 0.1f - p.x * 0.1f;
-    r.d = glm::min(r.d, sdBox(p, vec3(0.4f, 0.06f * (1.0f - p.x), 0.3f - (p.x * 0.2f))));
+    r.d = min(r.d, sdBox(p, V(0.4f, 0.06f * (1.0f - p.x), 0.3f - (p.x * 0.2f))));
     p = op;
 
     // Mouth grill
     p.y = abs(abs(p.y + 0.147f) - 0.1f * 0.556f) - 0.05f * 0.556f;
-    r.d = glm::max(r.d, -sdBox(p + vec3(0.0f, 0.0f, 1.5f), vec3(mix(0.25f, 0.55f, -op.y), 0.015f, 0.1f)));
+    r.d = max(r.d, -sdBox(p + V(0.0f, 0.0f, 1.5f), V(mix(T(0.25f), T(0.55f), -op.y), 0.015f, 0.1f)));
 
     // Cheeks
     p = op;
     p.y = abs(p.y + 0.16f) - 0.06f;
     p.z -= -1.1f;
-    float cheeks = glm::max(sdCappedCylinder(vec3(p.x, p.z, p.y), 1.0f, 0.03f), -sdCappedCylinder(vec3(p.x, p.z, p.y), 0.55f, 1.0f));
-    cheeks = glm::max(cheeks, p.z + 0.2f);
-    r.d = glm::max(r.d, -cheeks);
+    T cheeks = max(sdCappedCylinder(V(p.x, p.z, p.y), 1.0f, 0.03f), -sdCappedCylinder(V(p.x, p.z, p.y), 0.55f, 1.0f));
+    cheeks = max(cheeks, p.z + 0.2f);
+    r.d = max(r.d, -cheeks);
 
     setBodyMaterial(r);
     return r;
 }
 
-inline MarchData gunPod(const vec3& p_in, float edShoot, float& glow) {
-    MarchData r;
+template <class V>
+inline MarchData<scalar_t<V>> gunPod(const V& p_in, float edShoot, scalar_t<V>& glow) {
+    using T = scalar_t<V>;
+    using V2 = vec2_t<T>;
+    MarchData<T> r;
     setBodyMaterial(r);
 
-    vec3 p = p_in;
+    V p = p_in;
     p.y += 0.1f;
     p.z += 0.45f;
 
     const float rr = 0.35f, chamfer = 0.1f;
-    vec3 pp = p;
+    V pp = p;
     pp.z = abs(pp.z) - 0.5f;
-    r.d = sdCappedCone(pp, vec3(0.0f), vec3(0.0f, 0.0f, -chamfer), rr - chamfer, rr);
-    r.d = glm::min(r.d, sdCappedCylinder(p, rr, 0.4f));
+    r.d = sdCappedCone(pp, V(0.0f), V(0.0f, 0.0f, -chamfer), rr - chamfer, rr);
+    r.d = min(r.d, sdCappedCylinder(p, rr, 0.4f));
 
-    pp = vec3(p.x, 0.28f - p.y, p.z);
-    r.d = glm::min(r.d, sdTriPrism(pp, vec2(0.1f, 0.5f)));
+    pp = V(p.x, 0.28f - p.y, p.z);
+    r.d = min(r.d, sdTriPrism(pp, vec2(0.1f, 0.5f)));
 
     pp = p;
     pp.x = abs(p.x);
     mat2 rotm = rot(pi / 4.0f);
-    vec2 ppxy = rotm * vec2(pp.x, pp.y);
+    V2 ppxy = rotm * V2(pp.x, pp.y);
     pp.x = ppxy.x; pp.y = ppxy.y;
-    float bump = sign(sin(pp.z * 33.3f)) * 0.003f;
-    float d = sdBox(pp, vec3(0.1f - bump, 0.38f - bump, 0.34f)) - 0.02f;
+    T bump = sign(sin(pp.z * 33.3f)) * 0.003f;
+    T d = sdBox(pp, V(0.1f - bump, 0.38f - bump, 0.34f)) - 0.02f;
 
-    pp = p - vec3(0.0f, 0.0f, -0.6f);
+    pp = p - V(0.0f, 0.0f, -0.6f);
     pp.x = abs(pp.x) - 0.1f;
-    d = glm::min(d, sdCappedCylinder(pp, 0.06f, 0.15f));
-    d = glm::min(d, sdCappedCylinder(pp + vec3(0.0f, 0.12f, -0.05f), 0.06f, 0.05f));
-    d = glm::min(d, sdBox(p + vec3(0.0f, 0.0f, 0.54f), vec3(0.1f, 0.06f, 0.04f)));
-    if (d < r.d) {
-        d = glm::max(d, -sdCappedCylinder(pp + vec3(0.0f, 0.0f, 0.1f), 0.03f, 0.2f));
-        r.d = d;
-        r.mat = vec3(0.02f);
+    d = min(d, sdCappedCylinder(pp, 0.06f, 0.15f));
+    d = min(d, sdCappedCylinder(pp + V(0.0f, 0.12f, -0.05f), 0.06f, 0.05f));
+    d = min(d, sdBox(p + V(0.0f, 0.0f, 0.54f), V(0.1f, 0.06f, 0.04f)));
+    auto barrel = d < r.d;
+    if (any(barrel)) {
+        d = max(d, -sdCappedCylinder(pp + V(0.0f, 0.0f, 0.1f), 0.03f, 0.2f));
+        r.d = select(barrel, d, r.d);
+        r.mat = select(barrel, V(0.02f), r.mat);
     }
 
     float fs = fireShock(edShoot);
     if (fs > 0.5f) {
         d = sdCappedCylinder(pp, 0.01f + pp.z * 0.05f, fract(fs * 3322.423f) * 0.5f + 0.9f);
-        if (d < r.d) {
-            r.d = d;
-            r.mat = vec3(1.0f);
-            glow += 0.1f / (0.01f + d * d * 400.0f);
-        }
+        auto flash = d < r.d;
+        r.d = select(flash, d, r.d);
+        r.mat = select(flash, V(1.0f), r.mat);
+        glow += select(flash, 0.1f / (0.01f + d * d * 400.0f), T(0.0f));
     }
 
     return r;
 }
 
-inline MarchData arms(const vec3& p_in, float gunsUp, float gunsForward, float edShoot, float& glow) {
-    MarchData r;
+template <class V>
+inline MarchData<scalar_t<V>> arms(const V& p_in, const mat2& rotm, float gunsForward, float edShoot, scalar_t<V>& glow) {
+    using T = scalar_t<V>;
+    using V2 = vec2_t<T>;
+    MarchData<T> r;
     setBodyMaterial(r);
 
-    vec3 p = p_in;
+    V p = p_in;
     p.x = abs(p.x);
     p.y += 0.24f;
     p.z -= 0.0f;
-    mat2 rotm = rot(0.15f * (gunsUp - 1.0f));
-    vec2 pxy = rotm * vec2(p.x, p.y);
+    V2 pxy = rotm * V2(p.x, p.y);
     p.x = pxy.x; p.y = pxy.y;
 
-    const vec3 elbow = vec3(1.5f, 0.0f, 0.0f);
-    const vec3 wrist = elbow - vec3(0.0f, 0.0f, 0.3f);
-    r.d = glm::min(sdCapsule(p, vec3(0.0f), elbow, 0.2f), sdCapsule(p, elbow, wrist, 0.2f));
+    const V elbow = V(1.5f, 0.0f, 0.0f);
+    const V wrist = elbow - V(0.0f, 0.0f, 0.3f);
+    r.d = min(sdCapsule(p, V(0.0f), elbow, 0.2f), sdCapsule(p, elbow, wrist, 0.2f));
 
     p -= wrist;
     p.z -= gunsForward * 0.15f;
     return minResult(r, gunPod(p, edShoot, glow));
 }
 
-inline float toe(const vec3& p_in) {
-    vec3 p = p_in;
+template <class V>
+inline scalar_t<V> toe(const V& p_in) {
+    V p = p_in;
     p.y += 0.1f;
     p.z += 0.32f;
-    return glm::max(sdBox(p, vec3(0.3f + 0.2f * (p.z - 0.18f) - (p.y * 0.456f) * 0.5f, 
+    return max(sdBox(p, V(0.3f + 0.2f * (p.z - 0.18f) - (p.y * 0.456f) * 0.5f, 
                           0.3f + 0.2f * cos((p.z - 0.18f) * 3.69f), 0.35f)), 0.1f - p.y);
 }
 
-inline float foot(const vec3& p_in) {
-    vec3 p = p_in;
+template <class V>
+inline scalar_t<V> foot(const V& p_in) {
+    using T = scalar_t<V>;
+    using V2 = vec2_t<T>;
+    V p = p_in;
     p.z += 0.8f;
     mat2 rotm = rot(0.86f);
-    vec2 pyz = rotm * vec2(p.y, p.z);
+    V2 pyz = rotm * V2(p.y, p.z);
     p.y = pyz.x; p.z = pyz.y;
 
-    float d = toe(p);
+    T d = toe(p);
     mat2 rotm2 = rot(1.57f);
-    vec2 pxz = rotm2 * vec2(p.x, p.z);
+    V2 pxz = rotm2 * V2(p.x, p.z);
     p.x = pxz.x; p.z = pxz.y;
     p.x -= 0.43f;
     p.z = 0.25f - abs(p.z);
 
-    return glm::min(d, toe(p));
+    return min(d, toe(p));
 }
 
-inline MarchData waist(const vec3& p_in, float edWalk) {
-    MarchData r;
+template <class V>
+inline MarchData<scalar_t<V>> waist(const V& p_in, float edWalk) {
+    using T = scalar_t<V>;
+    using V2 = vec2_t<T>;
+    MarchData<T> r;
     setBodyMaterial(r);
 
-    vec3 p = p_in;
+    V p = p_in;
     p.y += 0.65f;
     mat2 rotm = rot(-0.2f);
-    vec2 pyz = rotm * vec2(p.y, p.z);
+    V2 pyz = rotm * V2(p.y, p.z);
     p.y = pyz.x; p.z = pyz.y;
     float legAngle = legWalkAngle(1.0f, edWalk);
     mat2 rotm2 = rot(legAngle * 0.3f);
-    vec2 pxy = rotm2 * vec2(p.x, p.y);
+    V2 pxy = rotm2 * V2(p.x, p.y);
     p.x = pxy.x; p.y = pxy.y;
 
-    vec3 pp = p;
+    V pp = p;
     pp.y += 0.3f;
-    r.d = glm::max(sdCappedCylinder(vec3(pp.z, pp.y, pp.x), 0.5f, 0.5f), p.y + 0.15f);
+    r.d = max(sdCappedCylinder(V(pp.z, pp.y, pp.x), 0.5f, 0.5f), p.y + 0.15f);
 
-    float bump = 0.5f - abs(sin(p.y * 40.0f)) * 0.03f;
-    float d = sdBox(p, vec3(bump, 0.15f, bump));
+    T bump = 0.5f - abs(sin(p.y * 40.0f)) * 0.03f;
+    T d = sdBox(p, V(bump, 0.15f, bump));
 
     bump = 0.3f - abs(sin(p.x * 40.0f)) * 0.03f;
     pp.y += 0.18f;
-    d = glm::min(d, sdCappedCylinder(vec3(pp.z, pp.y, pp.x), bump, 0.75f));
+    d = min(d, sdCappedCylinder(V(pp.z, pp.y, pp.x), bump, 0.75f));
 
     pp.x = abs(pp.x);
-    mat2 rotm3 = rot(0.2f - pi / 4.0f + legAngle * sign(p.x));
-    vec2 ppyz = rotm3 * vec2(pp.y, pp.z);
+    const mat2 rotm3[3] = {
+        rot(0.2f - pi / 4.0f + legAngle * -1.0f),
+        rot(0.2f - pi / 4.0f + legAngle * 0.0f),
+        rot(0.2f - pi / 4.0f + legAngle * 1.0f),
+    };
+    V2 ppyz = rotBySign(p.x, rotm3, V2(pp.y, pp.z));
     pp.y = ppyz.x; pp.z = ppyz.y;
     pp.x -= 0.98f;
-    r.d = glm::min(r.d, glm::max(sdCappedCylinder(vec3(pp.z, pp.y, pp.x), 0.4f, 0.24f), -pp.y));
-    r.d = glm::min(r.d, sdBox(pp, vec3(0.24f, 0.2f, 0.14f + 0.2f * pp.y)));
+    r.d = min(r.d, max(sdCappedCylinder(V(pp.z, pp.y, pp.x), 0.4f, 0.24f), -pp.y));
+    r.d = min(r.d, sdBox(pp, V(0.24f, 0.2f, 0.14f + 0.2f * pp.y)));
 
-    vec3 cp = pp;
     p = pp;
     pp.x = abs(pp.x) - 0.12f;
     pp.z = abs(pp.z) - 0.25f;
-    float pistons = glm::min(sdCappedCylinder(vec3(pp.x, pp.z, pp.y), 0.1f, 0.325f), 
-                            sdCappedCylinder(vec3(pp.x, pp.z, pp.y), 0.05f, 0.5f));
-    r.d = glm::min(r.d, glm::max(pistons, pp.y));
+    T pistons = min(sdCappedCylinder(V(pp.x, pp.z, pp.y), 0.1f, 0.325f), 
+                    sdCappedCylinder(V(pp.x, pp.z, pp.y), 0.05f, 0.5f));
+    r.d = min(r.d, max(pistons, pp.y));
 
     p.y += 0.68f;
-    r.d = glm::min(r.d, sdBox(p, vec3(sign(abs(p.y) - 0.04f) * 0.005f + 0.26f, 0.2f, 0.34f)));
+    r.d = min(r.d, sdBox(p, V(sign(abs(p.y) - 0.04f) * 0.005f + 0.26f, 0.2f, 0.34f)));
 
-    if (d < r.d) {
-        r.d = d;
-        r.mat = vec3(0.02f);
-    }
+    auto trim = d < r.d;
+    r.d = select(trim, d, r.d);
+    r.mat = select(trim, V(0.02f), r.mat);
 
     return r;
 }
 
-inline MarchData legs(const vec3& p_in, float edWalk) {
-    MarchData r;
+template <class V>
+inline MarchData<scalar_t<V>> legs(const V& p_in, float edWalk) {
+    using T = scalar_t<V>;
+    using V2 = vec2_t<T>;
+    MarchData<T> r;
     setBodyMaterial(r);
 
     float legAngle = legWalkAngle(1.0f, edWalk);
-    vec3 p = p_in;
+    V p = p_in;
     p.z += 0.27f;
-    mat2 rotm = rot(legAngle * sign(p.x));
-    vec2 pyz = rotm * vec2(p.y, p.z);
+    const mat2 rotm[3] = {rot(legAngle * -1.0f), rot(legAngle * 0.0f), rot(legAngle * 1.0f)};
+    V2 pyz = rotBySign(p.x, rotm, V2(p.y, p.z));
     p.y = pyz.x; p.z = pyz.y;
     p.z -= 0.27f;
 
     p.y += 0.65f;
     mat2 rotm2 = rot(-0.2f);
-    vec2 pyz2 = rotm2 * vec2(p.y, p.z);
+    V2 pyz2 = rotm2 * V2(p.y, p.z);
     p.y = pyz2.x; p.z = pyz2.y;
     mat2 rotm3 = rot(legAngle * 0.3f);
-    vec2 pxy = rotm3 * vec2(p.x, p.y);
+    V2 pxy = rotm3 * V2(p.x, p.y);
     p.x = pxy.x; p.y = pxy.y;
 
-    vec3 pp = p;
+    V pp = p;
     pp.x = abs(pp.x);
     pp.y += 0.48f;
     mat2 rotm4 = rot(0.2f - pi / 4.0f);
-    vec2 ppyz = rotm4 * vec2(pp.y, pp.z);
+    V2 ppyz = rotm4 * V2(pp.y, pp.z);
     pp.y = ppyz.x; pp.z = ppyz.y;
     pp.x -= 0.98f;
 
-    vec3 cp = pp;
+    V cp = pp;
     p = pp;
-    pp.x = abs(pp.x) - 0.12f;
-    pp.z = abs(pp.z) - 0.25f;
     p.y += 0.68f;
 
     p.x = abs(p.x) - 0.12f;
     p.y = abs(p.y) - 0.12f;
-    float silver = sdBox(p, vec3(0.07f, 0.05f, 1.2f));
+    T silver = sdBox(p, V(0.07f, 0.05f, 1.2f));
 
-    cp -= vec3(0.0f, -0.7f, 0.0f);
-    r.d = sdBox(cp - vec3(0.0f, 0.0f, 1.15f), vec3(0.17f, 0.17f, 0.07f)) - 0.04f;
+    cp -= V(0.0f, -0.7f, 0.0f);
+    r.d = sdBox(cp - V(0.0f, 0.0f, 1.15f), V(0.17f, 0.17f, 0.07f)) - 0.04f;
 
     cp.z += 1.0f;
-    r.d = glm::min(r.d, sdChamferedCube(vec3(cp.x, cp.z, cp.y), vec3(0.28f - sign(abs(cp.z) - 0.3f) * 0.01f, 0.5f, 0.28f - sign(abs(cp.z) - 0.3f) * 0.01f), 0.18f));
-    r.d = glm::min(r.d, foot(cp));
+    r.d = min(r.d, sdChamferedCube(V(cp.x, cp.z, cp.y), V(0.28f - sign(abs(cp.z) - 0.3f) * 0.01f, 0.5f, 0.28f - sign(abs(cp.z) - 0.3f) * 0.01f), 0.18f));
+    r.d = min(r.d, foot(cp));
 
-    if (silver < r.d) {
-        r.d = silver;
-        r.mat = vec3(0.8f);
-    }
+    auto trim = silver < r.d;
+    r.d = select(trim, silver, r.d);
+    r.mat = select(trim, V(0.8f), r.mat);
 
     return r;
 }
 
-inline MarchData ed209(const vec3& p_in, float stretch, float edWalk, float edDown, float edTwist, float edShoot) {
-    float glow = 0.0f;
-    vec3 p = p_in;
-    p.y += legWalkAngle(2.0f, edWalk) * 0.2f + 0.1f;
-    p.z -= edZ(edWalk);
+// Quantities of ed209() that depend only on the animation parameters
+struct Pose {
+    float edWalk;
+    float edShoot;
+    float slide;
+    float gunsForward;
+    mat2 head;       // Pitch of the head and arms
+    mat2 twist;      // Yaw of the head and arms
+    mat2 wings[3];   // Wing roll for sign(p.x) = -1, 0 and 1
+    mat2 arms;       // Arm lift
+};
 
-    MarchData r = legs(p, edWalk);
+inline Pose pose(float stretch, float edWalk, float edDown, float edTwist, float edShoot) {
+    Pose pose;
+    pose.edWalk = edWalk;
+    pose.edShoot = edShoot;
 
     float f = glm::min(stretch * 2.0f, 1.0f);
-    float slide = f < 0.5f ? smoothstep(0.0f, 0.5f, f) : (1.0f - smoothstep(0.5f, 1.0f, f) * 0.2f);
-    p.y -= slide * 0.5f;
-    p.z -= slide * 0.5f;
+    pose.slide = f < 0.5f ? smoothstep(0.0f, 0.5f, f) : (1.0f - smoothstep(0.5f, 1.0f, f) * 0.2f);
     float gunsUp = smoothstep(0.0f, 1.0f, clamp((stretch - 0.66f) * 6.0f, 0.0f, 1.0f));
-    float gunsForward = smoothstep(0.0f, 1.0f, clamp((stretch - 0.83f) * 6.0f, 0.0f, 1.0f))
-                        + fireShock(edShoot) * 0.5f;
+    pose.gunsForward = smoothstep(0.0f, 1.0f, clamp((stretch - 0.83f) * 6.0f, 0.0f, 1.0f))
+                       + fireShock(edShoot) * 0.5f;
+
+    pose.head = rot(0.1f * (-edDown + legWalkAngle(2.0f, edWalk) + smoothstep(0.0f, 1.0f, clamp((stretch - 0.5f) * 6.0f, 0.0f, 1.0f)) - 1.0f));
+    pose.twist = rot(edTwist * 0.2f);
+    for (int s = -1; s <= 1; ++s) {
+        pose.wings[s + 1] = rot(0.075f * (gunsUp - 1.0f) * float(s));
+    }
+    pose.arms = rot(0.15f * (gunsUp - 1.0f));
+    return pose;
+}
+
+template <class V>
+inline MarchData<scalar_t<V>> ed209(const V& p_in, const Pose& pose) {
+    using T = scalar_t<V>;
+    using V2 = vec2_t<T>;
+    T glow = 0.0f;
+    const float edWalk = pose.edWalk;
+    V p = p_in;
+    p.y += legWalkAngle(2.0f, edWalk) * 0.2f + 0.1f;
+    p.z -= edZ(edWalk);
+
+    MarchData<T> r = legs(p, edWalk);
+
+    p.y -= pose.slide * 0.5f;
+    p.z -= pose.slide * 0.5f;
     r = minResult(r, waist(p, edWalk));
 
-    mat2 rotm = rot(0.1f * (-edDown + legWalkAngle(2.0f, edWalk) + smoothstep(0.0f, 1.0f, clamp((stretch - 0.5f) * 6.0f, 0.0f, 1.0f)) - 1.0f));
-    vec2 pyz = rotm * vec2(p.y, p.z);
+    V2 pyz = pose.head * V2(p.y, p.z);
     p.y = pyz.x; p.z = pyz.y;
-    mat2 rotm2 = rot(edTwist * 0.2f);
-    vec2 pxz = rotm2 * vec2(p.x, p.z);
+    V2 pxz = pose.twist * V2(p.x, p.z);
     p.x = pxz.x; p.z = pxz.y;
-    r = minResult(r, headLower(p, gunsUp));
+    r = minResult(r, headLower(p, pose.wings));
     r = minResult(r, headVisor(p, 0.8f, 1.0f));
 
-    return minResult(r, arms(p, gunsUp, gunsForward, edShoot, glow));
+    return minResult(r, arms(p, pose.arms, pose.gunsForward, pose.edShoot, glow));
 }
 
 } // namespace mech_detail
 
-inline float Mech(const vec3& p_in, float time, uint32_t /*seed*/) {
-    vec3 p = p_in;
+// Per-frame constants of Mech
+struct MechFrame {
+    mech_detail::Pose pose;
+};
+
+inline MechFrame prepareMech(float time, uint32_t /*seed*/) {
+    float stretch = 2.0f * (sin(time * 2.0f) + 1.0f);
+    return MechFrame{mech_detail::pose(stretch, 0.0f, 0.0f, 0.0f, 0.0f)};
+}
+
+template <class V>
+inline scalar_t<V> Mech(const V& p_in, const MechFrame& frame) {
+    V p = p_in;
     p = p * rotationMatrix(vec3(0.0f, 1.0f, 0.0f), pi);
-    p += vec3(-0.11f, -0.25f, 2.0f);
+    p += V(-0.11f, -0.25f, 2.0f);
     const float scale = 0.4f;
     p *= 1.0f / scale;
-    float stretch = 2.0f * (sin(time * 2.0f) + 1.0f);
-    return mech_detail::ed209(p, stretch, 0.0f, 0.0f, 0.0f, 0.0f).d * scale * 0.8f;
+    return mech_detail::ed209(p, frame.pose).d * scale * 0.8f;
+}
+
+template <class V>
+inline scalar_t<V> Mech(const V& p_in, float time, uint32_t seed) {
+    return Mech(p_in, prepareMech(time, seed));
 }
 
 } // namespace sdf::manufactured
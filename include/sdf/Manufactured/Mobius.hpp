@@ -8,50 +8,56 @@ namespace sdf {
 namespace manufactured {
 
 namespace mobius_detail {
-    inline mat2 r2(float th) {
-        vec2 a = sin(vec2(1.5707963f, 0.0f) + vec2(th, th));
-        return mat2(a.x, a.y, -a.y, a.x);
+    // v times the rotation matrix mat2(a.x, a.y, -a.y, a.x), a = (cos, sin)
+    template <class V2>
+    inline V2 r2(scalar_t<V2> th, const V2& v) {
+        V2 a = sin(V2(1.5707963f, 0.0f) + V2(th, th));
+        return V2(a.x * v.x - a.y * v.y, a.y * v.x + a.x * v.y);
     }
     
-    inline float Mobius(vec3 q) {
+    template <class V>
+    inline scalar_t<V> Mobius(V q) {
+        using T = scalar_t<V>;
+        using V2 = vec2_t<T>;
         const float toroidRadius = 1.25f;
         const float polRot = 4.0f / 4.0f;
         const float ringNum = 32.0f;
         
-        vec3 p = q;
+        V p = q;
         
-        float a = std::atan2(p.z, p.x);
+        T a = atan2(p.z, p.x);
         
-        float ia = std::floor(ringNum * a / 6.2831853f);
+        T ia = floor(ringNum * a / 6.2831853f);
         ia = (ia + 0.5f) / ringNum * 6.2831853f;
         
-        vec2 pxz = r2(a) * vec2(p.x, p.z);
+        V2 pxz = r2(a, V2(p.x, p.z));
         p.x = pxz.x; p.z = pxz.y;
         p.x -= toroidRadius;
-        vec2 pxy = r2(a * polRot) * vec2(p.x, p.y);
+        V2 pxy = r2(a * polRot, V2(p.x, p.y));
         p.x = pxy.x; p.y = pxy.y;
         
-        p = abs(abs(p) - vec3(0.25f));
+        p = abs(abs(p) - V(0.25f));
         
-        float rail = std::max(std::max(p.x, p.y) - 0.07f, 
-            (std::max(p.y - p.x, p.y + p.x) * 0.7071f - 0.075f));
+        T rail = max(max(p.x, p.y) - 0.07f, 
+            (max(p.y - p.x, p.y + p.x) * 0.7071f - 0.075f));
         
         p = q;
-        pxz = r2(ia) * vec2(p.x, p.z);
+        pxz = r2(ia, V2(p.x, p.z));
         p.x = pxz.x; p.z = pxz.y;
         p.x -= toroidRadius;
-        pxy = r2(a * polRot) * vec2(p.x, p.y);
+        pxy = r2(a * polRot, V2(p.x, p.y));
         p.x = pxy.x; p.y = pxy.y;
         
         p = abs(p);
-        float ring = std::max(p.x, p.y);
-        ring = std::max(std::max(ring - 0.275f, p.z - 0.03f), -(ring - 0.2f));
+        T ring = max(p.x, p.y);
+        ring = max(max(ring - 0.275f, p.z - 0.03f), -(ring - 0.2f));
         
         return smin(ring, rail, 0.07f);
     }
 }
 
-inline float Mobius(const vec3& p, float /*time*/, uint32_t /*seed*/) {
+template <class V>
+inline scalar_t<V> Mobius(const V& p, float /*time*/, uint32_t /*seed*/) {
     const float scale = 0.5f;
     return mobius_detail::Mobius(p * (1.0f / scale)) * scale;
 }
@@ -8,56 +8,60 @@ namespace sdf::manufactured {
 
 namespace rooks_detail {
 
-inline float board(const vec2& v) {
-    if (glm::max(abs(v.x), abs(v.y)) > 4.0f) return 0.0f;
-    return 5.0f;
+// Squares off the 8x8 board hold no piece
+template <class T>
+inline auto offBoard(const T& x, const T& z) {
+    return max(abs(x), abs(z)) > 4.0f;
 }
 
-inline float DE(const vec3& p0) {
-    vec3 p = vec3(fract(p0.x) - 0.5f, p0.y, fract(p0.z) - 0.5f);
-    float id = board(vec2(p0.x, p0.z));
-    float tp = abs(id);
-    float mx = 0.65f - glm::max(abs(p.x), abs(p.z));
-    if (tp == 0.0f) return mx;
+template <class V>
+inline scalar_t<V> DE(const V& p0) {
+    using T = scalar_t<V>;
+    using V2 = vec2_t<T>;
+    V p = V(fract(p0.x) - 0.5f, p0.y, fract(p0.z) - 0.5f);
+    auto empty = offBoard(p0.x, p0.z);
+    T mx = 0.65f - max(abs(p.x), abs(p.z));
+    if (all(empty)) return mx;
     
-    float f0 = 0.46f, f1 = 2.7f, f2 = 0.0f, f3 = 0.25f, f4 = 0.66f, f5 = -1.0f, f6 = 2.0f;
-    float da = 1.0f, ds = 1.0f;
+    float f6 = 2.0f;
+    T da = 1.0f;
     
     // Rook piece
     p.y += 0.14f;
     f6 *= 1.5f;
     p *= f6;
     
-    float r = length(vec2(p.x, p.z));
-    if (p.y > 0.8f) {
-        f5 = 1.0f;
-        f0 = 0.0f;
-        // Rook head
-        f1 = 2.6f;
-        f2 = 8.0f;
-        f3 = 0.5f;
-        f4 = 1.3f;
-        ds = glm::max(-p.y + 1.0f, glm::min(r - 0.37f, glm::min(abs(p.x), abs(p.z)) - 0.09f));
-    }
+    T r = length(V2(p.x, p.z));
+    // Rook head
+    auto head = p.y > 0.8f;
+    T f0 = select(head, T(0.0f), T(0.46f));
+    T f1 = select(head, T(2.6f), T(2.7f));
+    T f2 = select(head, T(8.0f), T(0.0f));
+    T f3 = select(head, T(0.5f), T(0.25f));
+    T f4 = select(head, T(1.3f), T(0.66f));
+    T f5 = select(head, T(1.0f), T(-1.0f));
+    T ds = select(head, max(-p.y + 1.0f, min(r - 0.37f, min(abs(p.x), abs(p.z)) - 0.09f)), T(1.0f));
     
-    float d = r - f0 + sin(p.y * f1 + f2) * f3;
-    d = glm::max(d, p.y * f5 - f4);
-    da = glm::min(da, length(max(vec2(r - 0.28f, abs(p.y - 0.8f)), vec2(0.0f))) - 0.05f);
-    d = glm::max(glm::min(d, da), -ds);
+    T d = r - f0 + sin(p.y * f1 + f2) * f3;
+    d = max(d, p.y * f5 - f4);
+    da = min(da, length(max(V2(r - 0.28f, abs(p.y - 0.8f)), V2(0.0f))) - 0.05f);
+    d = max(min(d, da), -ds);
     
-    return glm::min(0.83f * d / f6, mx);
+    return select(empty, mx, min(0.83f * d / f6, mx));
 }
 
-inline float sdBox(const vec3& p, const vec3& b) {
-    vec3 d = abs(p) - b;
-    return glm::min(glm::max(glm::max(d.x, d.y), d.z), 0.0f) + length(max(d, vec3(0.0f)));
+template <class V>
+inline scalar_t<V> sdBox(const V& p, const V& b) {
+    V d = abs(p) - b;
+    return min(max(max(d.x, d.y), d.z), 0.0f) + length(max(d, V(0.0f)));
 }
 
 } // namespace rooks_detail
 
-inline float Rooks(const vec3& p_in, float /*time*/, uint32_t /*seed*/) {
-    float boxD = rooks_detail::sdBox(p_in, vec3(1.0f, 1.0f, 1.0f));
-    return glm::max(boxD, rooks_detail::DE(p_in)) * 0.5f;
+template <class V>
+inline scalar_t<V> Rooks(const V& p_in, float /*time*/, uint32_t /*seed*/) {
+    scalar_t<V> boxD = rooks_detail::sdBox(p_in, V(1.0f, 1.0f, 1.0f));
+    return max(boxD, rooks_detail::DE(p_in)) * 0.5f;
 }
 
 } // namespace sdf::manufactured
@@ -8,7 +8,11 @@ namespace sdf {
 namespace manufactured {
 
 namespace spike_detail {
-    inline float spikeball(const vec3& p) {
+    using approx::exp;
+    
+    template <class V>
+    inline scalar_t<V> spikeball(const V& p) {
+        using T = scalar_t<V>;
         const vec3 c[19] = {
             vec3(1.0f, 0.0f, 0.0f),
             vec3(0.0f, 1.0f, 0.0f),
@@ -31,24 +35,25 @@ namespace spike_detail {
             vec3(-0.851f, 0.526f, 0.0f)
         };
         
-        float MinDistance = 1e4f;
+        T MinDistance = 1e4f;
         for (int i = 3; i < 19; i++) {
-            float d = clamp(dot(p, c[i]), -1.0f, 1.0f);
-            vec3 proj = d * c[i];
-            d = std::abs(d);
+            T d = clamp(dot(p, c[i]), T(-1.0f), T(1.0f));
+            V proj = d * V(c[i].x, c[i].y, c[i].z);
+            d = abs(d);
             
-            float Distance2Spike = length(p - proj);
-            float SpikeThickness = 0.25f * std::exp(-5.0f * d) + 0.0f;
-            float Distance = Distance2Spike - SpikeThickness;
+            T Distance2Spike = length(p - proj);
+            T SpikeThickness = 0.25f * exp(-5.0f * d) + 0.0f;
+            T Distance = Distance2Spike - SpikeThickness;
             
-            MinDistance = std::min(MinDistance, Distance);
+            MinDistance = min(MinDistance, Distance);
         }
         
         return MinDistance;
     }
 }
 
-inline float Spike(const vec3& p, float /*time*/, uint32_t /*seed*/) {
+template <class V>
+inline scalar_t<V> Spike(const V& p, float /*time*/, uint32_t /*seed*/) {
     return spike_detail::spikeball(p);
 }
 
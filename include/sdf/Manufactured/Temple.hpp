@@ -12,8 +12,9 @@ inline float hash11(float p) {
     return fract(sin(p * 727.1f) * 435.545f);
 }
 
-inline float hash12(const vec2& p) {
-    float h = dot(p, vec2(127.1f, 311.7f));
+template <class V2>
+inline scalar_t<V2> hash12(const V2& p) {
+    scalar_t<V2> h = dot(p, vec2(127.1f, 311.7f));
     return fract(sin(h) * 437.545f);
 }
 
@@ -22,34 +23,39 @@ inline vec3 hash31(float p) {
     return fract(sin(h) * 435.543f);
 }
 
-inline float noise_3(const vec3& p) {
-    vec3 i = floor(p);
-    vec3 f = fract(p);
-    vec3 u = f * f * (3.0f - 2.0f * f);
-    
-    vec2 ii = vec2(i.x, i.y) + i.z * vec2(5.0f);
-    float a = hash12(ii + vec2(0.0f, 0.0f));
-    float b = hash12(ii + vec2(1.0f, 0.0f));
-    float c = hash12(ii + vec2(0.0f, 1.0f));
-    float d = hash12(ii + vec2(1.0f, 1.0f));
-    float v1 = mix(mix(a, b, u.x), mix(c, d, u.x), u.y);
-    
-    ii += vec2(5.0f);
-    a = hash12(ii + vec2(0.0f, 0.0f));
-    b = hash12(ii + vec2(1.0f, 0.0f));
-    c = hash12(ii + vec2(0.0f, 1.0f));
-    d = hash12(ii + vec2(1.0f, 1.0f));
-    float v2 = mix(mix(a, b, u.x), mix(c, d, u.x), u.y);
-    
-    return glm::max(mix(v1, v2, u.z), 0.0f);
+template <class V>
+inline scalar_t<V> noise_3(const V& p) {
+    using T = scalar_t<V>;
+    using V2 = vec2_t<T>;
+    V i = floor(p);
+    V f = fract(p);
+    V u = f * f * (3.0f - 2.0f * f);
+    
+    V2 ii = V2(i.x, i.y) + i.z * V2(5.0f);
+    T a = hash12(ii + V2(0.0f, 0.0f));
+    T b = hash12(ii + V2(1.0f, 0.0f));
+    T c = hash12(ii + V2(0.0f, 1.0f));
+    T d = hash12(ii + V2(1.0f, 1.0f));
+    T v1 = mix(mix(a, b, u.x), mix(c, d, u.x), u.y);
+    
+    ii += V2(5.0f);
+    a = hash12(ii + V2(0.0f, 0.0f));
+    b = hash12(ii + V2(1.0f, 0.0f));
+    c = hash12(ii + V2(0.0f, 1.0f));
+    d = hash12(ii + V2(1.0f, 1.0f));
+    T v2 = mix(mix(a, b, u.x), mix(c, d, u.x), u.y);
+    
+    return max(mix(v1, v2, u.z), 0.0f);
 }
 
-inline float fbm3_high(const vec3& p, float a, float f) {
-    float ret = 0.0f;
-    float amp = 1.0f;
+template <class V>
+inline scalar_t<V> fbm3_high(const V& p, float a, float f) {
+    using T = scalar_t<V>;
+    T ret = 0.0f;
+    T amp = 1.0f;
     float frq = 1.0f;
     for (int i = 0; i < 5; i++) {
-        float n = pow(noise_3(p * frq), 2.0f);
+        T n = pow(noise_3(p * frq), 2.0f);
         ret += n * amp;
         frq *= f;
         amp *= a * pow(n, 0.2f);
@@ -57,145 +63,170 @@ inline float fbm3_high(const vec3& p, float a, float f) {
     return ret;
 }
 
-inline float hash1(const vec2& p_in) {
-    vec2 p = 50.0f * fract(p_in * 0.3183099f);
+template <class V2>
+inline scalar_t<V2> hash1(const V2& p_in) {
+    V2 p = 50.0f * fract(p_in * 0.3183099f);
     return fract(p.x * p.y * (p.x + p.y));
 }
 
-inline float ndot(const vec2& a, const vec2& b) { return a.x * b.x - a.y * b.y; }
+template <class V2>
+inline scalar_t<V2> ndot(const V2& a, const vec2& b) { return a.x * b.x - a.y * b.y; }
 
-inline float sdRhombus(const vec2& p_in, const vec2& b, float r) {
-    vec2 q = abs(p_in);
-    float h = clamp((-2.0f * ndot(q, b) + ndot(b, b)) / dot(b, b), -1.0f, 1.0f);
-    float d = length(q - 0.5f * b * vec2(1.0f - h, 1.0f + h));
+template <class V2>
+inline scalar_t<V2> sdRhombus(const V2& p_in, const vec2& b, float r) {
+    using T = scalar_t<V2>;
+    V2 q = abs(p_in);
+    T h = clamp((-2.0f * ndot(q, b) + ndot(b, b)) / dot(b, b), T(-1.0f), T(1.0f));
+    T d = length(q - 0.5f * V2(b.x, b.y) * V2(1.0f - h, 1.0f + h));
     d *= sign(q.x * b.y + q.y * b.x - b.x * b.y);
     return d - r;
 }
 
-inline float usdBox(const vec3& p, const vec3& b) {
-    return length(max(abs(p) - b, vec3(0.0f)));
+template <class V>
+inline scalar_t<V> usdBox(const V& p, const vec3& b) {
+    return length(max(abs(p) - V(b.x, b.y, b.z), V(0.0f)));
 }
 
-inline float sdBox3(const vec3& p, const vec3& b) {
-    vec3 d = abs(p) - b;
-    return glm::min(glm::max(d.x, glm::max(d.y, d.z)), 0.0f) + length(max(d, vec3(0.0f)));
+template <class V>
+inline scalar_t<V> sdBox3(const V& p, const V& b) {
+    V d = abs(p) - b;
+    return min(max(d.x, max(d.y, d.z)), 0.0f) + length(max(d, V(0.0f)));
 }
 
-inline float sdBox1(float p, float b) {
+template <class T>
+inline T sdBox1(T p, float b) {
     return abs(p) - b;
 }
 
-inline vec2 opRepLim2(const vec2& p, float s, const vec2& lim) {
-    return p - s * clamp(round(p / s), -lim, lim);
+template <class V2>
+inline V2 opRepLim4(const V2& p, float s, const vec2& limmin, const vec2& limmax) {
+    V2 r = round(p / s);
+    return p - s * V2(clamp(r.x, -limmin.x, limmax.x), clamp(r.y, -limmin.y, limmax.y));
 }
 
-inline vec2 opRepLim4(const vec2& p, float s, const vec2& limmin, const vec2& limmax) {
-    return p - s * clamp(round(p / s), -limmin, limmax);
+template <class V2>
+inline V2 opRepLim2(const V2& p, float s, const vec2& lim) {
+    return opRepLim4(p, s, lim, lim);
 }
 
-inline vec3 temple(const vec3& p_in) {
-    vec3 op = p_in;
-    vec3 res = vec3(-1.0f, -1.0f, 0.5f);
+template <class V>
+inline V temple(const V& p_in) {
+    using T = scalar_t<V>;
+    using V2 = vec2_t<T>;
+    V op = p_in;
+    V res = V(-1.0f, -1.0f, 0.5f);
     
-    vec3 p = p_in;
+    V p = p_in;
     p.y += 2.0f;
     
-    float bbox = usdBox(p, vec3(15.0f, 12.0f, 15.0f) * 1.5f);
-    if (bbox > 5.0f) return vec3(bbox + 1.0f, -1.0f, 0.5f);
+    T bbox = usdBox(p, vec3(15.0f, 12.0f, 15.0f) * 1.5f);
+    auto outside = bbox > 5.0f;
+    if (all(outside)) return V(bbox + 1.0f, -1.0f, 0.5f);
     
-    vec3 q = p;
-    vec2 qxz = opRepLim2(vec2(q.x, q.z), 4.0f, vec2(4.0f, 2.0f));
+    V q = p;
+    V2 qxz = opRepLim2(V2(q.x, q.z), 4.0f, vec2(4.0f, 2.0f));
     q.x = qxz.x;
     q.z = qxz.y;
     
-    vec2 id = floor((vec2(p.x, p.z) + 2.0f) / 4.0f);
+    V2 id = floor((V2(p.x, p.z) + 2.0f) / 4.0f);
     
-    float d = length(vec2(q.x, q.z)) - 0.9f + 0.05f * p.y;
-    d = glm::max(d, p.y - 6.0f);
-    d = glm::max(d, -p.y - 5.0f);
-    d -= 0.05f * pow(0.5f + 0.5f * sin(atan(q.x, q.z) * 16.0f), 2.0f);
+    T d = length(V2(q.x, q.z)) - 0.9f + 0.05f * p.y;
+    d = max(d, p.y - 6.0f);
+    d = max(d, -p.y - 5.0f);
+    d -= 0.05f * pow(0.5f + 0.5f * sin(atan2(q.x, q.z) * 16.0f), 2.0f);
     d -= 0.15f * pow(0.5f + 0.5f * sin(q.y * 3.0f + 0.6f), 0.12f) - 0.15f;
     res.z = hash1(id + 11.0f * floor(0.25f + (q.y * 3.0f + 0.6f) / 6.2831f));
     d *= 0.85f;
     
     {
-        vec3 qq = vec3(q.x, abs(q.y - 0.3f) - 5.5f, q.z);
-        d = glm::min(d, sdBox3(qq, vec3(1.4f, 0.2f, 1.4f) + sign(q.y - 0.3f) * vec3(0.1f, 0.05f, 0.1f)) - 0.1f);
+        V qq = V(q.x, abs(q.y - 0.3f) - 5.5f, q.z);
+        d = min(d, sdBox3(qq, V(1.4f, 0.2f, 1.4f) + sign(q.y - 0.3f) * V(0.1f, 0.05f, 0.1f)) - 0.1f);
     }
     
-    d = glm::max(d, -sdBox3(p, vec3(14.0f, 10.0f, 6.0f)));
+    d = max(d, -sdBox3(p, V(14.0f, 10.0f, 6.0f)));
     
     // Floor
-    float ra = 0.15f * hash1(id + vec2(1.0f, 3.0f));
+    T ra = 0.15f * hash1(id + V2(1.0f, 3.0f));
     q = p;
-    vec2 qxz2 = opRepLim2(vec2(q.x, q.z), 4.0f, vec2(4.0f, 3.0f));
+    V2 qxz2 = opRepLim2(V2(q.x, q.z), 4.0f, vec2(4.0f, 3.0f));
     q.x = qxz2.x;
     q.z = qxz2.y;
-    float b = sdBox3(q - vec3(0.0f, -6.0f + 0.1f - ra, 0.0f), vec3(2.0f, 0.5f, 2.0f) - 0.15f - ra) - 0.15f;
+    T b = sdBox3(q - V(0.0f, -6.0f + 0.1f - ra, 0.0f), V(2.0f, 0.5f, 2.0f) - 0.15f - ra) - 0.15f;
     b *= 0.5f;
-    if (b < d) { d = b; res.z = hash1(id); }
+    auto closer = b < d;
+    d = select(closer, b, d);
+    res.z = select(closer, hash1(id), res.z);
     
-    vec3 pp = p;
+    V pp = p;
     pp.x -= 2.0f;
     pp.z -= 2.0f;
-    id = floor((vec2(pp.x, pp.z) + 2.0f) / 4.0f);
-    ra = 0.15f * hash1(id + vec2(1.0f, 3.0f) + 23.1f);
+    id = floor((V2(pp.x, pp.z) + 2.0f) / 4.0f);
+    ra = 0.15f * hash1(id + V2(1.0f, 3.0f) + 23.1f);
     q = pp;
-    vec2 qxz3 = opRepLim4(vec2(q.x, q.z), 4.0f, vec2(5.0f, 4.0f), vec2(5.0f, 3.0f));
+    V2 qxz3 = opRepLim4(V2(q.x, q.z), 4.0f, vec2(5.0f, 4.0f), vec2(5.0f, 3.0f));
     q.x = qxz3.x;
     q.z = qxz3.y;
-    b = sdBox3(q - vec3(0.0f, -7.0f - ra, 0.0f), vec3(2.0f, 0.6f, 2.0f) - 0.15f - ra) - 0.15f;
+    b = sdBox3(q - V(0.0f, -7.0f - ra, 0.0f), V(2.0f, 0.6f, 2.0f) - 0.15f - ra) - 0.15f;
     b *= 0.8f;
-    if (b < d) { d = b; res.z = hash1(id + 13.5f); }
+    closer = b < d;
+    d = select(closer, b, d);
+    res.z = select(closer, hash1(id + 13.5f), res.z);
     pp.x += 2.0f;
     pp.z += 2.0f;
     
-    id = floor((vec2(p.x, p.z) + 2.0f) / 4.0f);
-    ra = 0.15f * hash1(id + vec2(1.0f, 3.0f) + 37.7f);
+    id = floor((V2(p.x, p.z) + 2.0f) / 4.0f);
+    ra = 0.15f * hash1(id + V2(1.0f, 3.0f) + 37.7f);
     q = p;
-    vec2 qxz4 = opRepLim2(vec2(q.x, q.z), 4.0f, vec2(5.0f, 4.0f));
+    V2 qxz4 = opRepLim2(V2(q.x, q.z), 4.0f, vec2(5.0f, 4.0f));
     q.x = qxz4.x;
     q.z = qxz4.y;
-    b = sdBox3(q - vec3(0.0f, -8.0f - ra - 1.0f, 0.0f), vec3(2.0f, 0.6f + 1.0f, 2.0f) - 0.15f - ra) - 0.15f;
+    b = sdBox3(q - V(0.0f, -8.0f - ra - 1.0f, 0.0f), V(2.0f, 0.6f + 1.0f, 2.0f) - 0.15f - ra) - 0.15f;
     b *= 0.5f;
-    if (b < d) { d = b; res.z = hash1(id * 7.0f + 31.1f); }
+    closer = b < d;
+    d = select(closer, b, d);
+    res.z = select(closer, hash1(id * 7.0f + 31.1f), res.z);
     
     // Roof
-    q = vec3(mod(p.x + 2.0f, 4.0f) - 2.0f, p.y, mod(p.z, 4.0f) - 2.0f);
-    b = sdBox3(q - vec3(0.0f, 7.0f, 0.0f), vec3(1.95f, 1.0f, 1.95f) - 0.15f) - 0.15f;
-    b = glm::max(b, sdBox3(p - vec3(0.0f, 7.0f, 0.0f), vec3(18.0f, 1.0f, 10.0f)));
-    if (b < d) { d = b; res.z = hash1(floor((vec2(p.x, p.z) + vec2(2.0f, 0.0f)) / 4.0f) + 31.1f); }
-    
-    q = vec3(mod(p.x + 0.5f, 1.0f) - 0.5f, p.y, mod(p.z + 0.5f, 1.0f) - 0.5f);
-    b = sdBox3(q - vec3(0.0f, 8.0f, 0.0f), vec3(0.45f, 0.5f, 0.45f) - 0.02f) - 0.02f;
-    b = glm::max(b, sdBox3(p - vec3(0.0f, 8.0f, 0.0f), vec3(19.0f, 0.2f, 11.0f)));
-    if (b < d) { d = b; res.z = hash1(floor((vec2(p.x, p.z) + 0.5f) / 1.0f) + 7.8f); }
-    
-    b = sdRhombus(vec2(p.y, p.z) - vec2(8.2f, 0.0f), vec2(3.0f, 11.0f), 0.05f);
-    q = vec3(mod(p.x + 1.0f, 2.0f) - 1.0f, p.y, mod(p.z + 1.0f, 2.0f) - 1.0f);
-    b = glm::max(b, -sdBox3(vec3(abs(p.x) - 20.0f, p.y, q.z) - vec3(0.0f, 8.0f, 0.0f), vec3(2.0f, 5.0f, 0.1f)) - 0.02f);
-    b = glm::max(b, -p.y + 8.2f);
-    b = glm::max(b, usdBox(p - vec3(0.0f, 8.0f, 0.0f), vec3(19.0f, 12.0f, 11.0f)));
-    
-    float c = sdRhombus(vec2(p.y, p.z) - vec2(8.3f, 0.0f), vec2(2.25f, 8.5f), 0.05f);
-    c = glm::max(c, sdBox1(abs(p.x) - 19.0f, 2.0f));
-    b = glm::max(b, -c);
-    
-    d = glm::min(d, b);
-    d = glm::max(d, -sdBox3(p - vec3(0.0f, 9.5f, 0.0f), vec3(15.0f, 4.0f, 9.0f)));
-    
-    d -= 0.02f * smoothstep(0.5f, 1.0f, fbm3_high(vec3(p.z, p.x, p.y), 0.4f, 2.96f));
+    q = V(mod(p.x + 2.0f, 4.0f) - 2.0f, p.y, mod(p.z, 4.0f) - 2.0f);
+    b = sdBox3(q - V(0.0f, 7.0f, 0.0f), V(1.95f, 1.0f, 1.95f) - 0.15f) - 0.15f;
+    b = max(b, sdBox3(p - V(0.0f, 7.0f, 0.0f), V(18.0f, 1.0f, 10.0f)));
+    closer = b < d;
+    d = select(closer, b, d);
+    res.z = select(closer, hash1(floor((V2(p.x, p.z) + V2(2.0f, 0.0f)) / 4.0f) + 31.1f), res.z);
+    
+    q = V(mod(p.x + 0.5f, 1.0f) - 0.5f, p.y, mod(p.z + 0.5f, 1.0f) - 0.5f);
+    b = sdBox3(q - V(0.0f, 8.0f, 0.0f), V(0.45f, 0.5f, 0.45f) - 0.02f) - 0.02f;
+    b = max(b, sdBox3(p - V(0.0f, 8.0f, 0.0f), V(19.0f, 0.2f, 11.0f)));
+    closer = b < d;
+    d = select(closer, b, d);
+    res.z = select(closer, hash1(floor((V2(p.x, p.z) + 0.5f) / 1.0f) + 7.8f), res.z);
+    
+    b = sdRhombus(V2(p.y, p.z) - V2(8.2f, 0.0f), vec2(3.0f, 11.0f), 0.05f);
+    q = V(mod(p.x + 1.0f, 2.0f) - 1.0f, p.y, mod(p.z + 1.0f, 2.0f) - 1.0f);
+    b = max(b, -sdBox3(V(abs(p.x) - 20.0f, p.y, q.z) - V(0.0f, 8.0f, 0.0f), V(2.0f, 5.0f, 0.1f)) - 0.02f);
+    b = max(b, -p.y + 8.2f);
+    b = max(b, usdBox(p - V(0.0f, 8.0f, 0.0f), vec3(19.0f, 12.0f, 11.0f)));
+    
+    T c = sdRhombus(V2(p.y, p.z) - V2(8.3f, 0.0f), vec2(2.25f, 8.5f), 0.05f);
+    c = max(c, sdBox1(abs(p.x) - 19.0f, 2.0f));
+    b = max(b, -c);
+    
+    d = min(d, b);
+    d = max(d, -sdBox3(p - V(0.0f, 9.5f, 0.0f), V(15.0f, 4.0f, 9.0f)));
+    
+    d -= 0.02f * smoothstep(0.5f, 1.0f, fbm3_high(V(p.z, p.x, p.y), 0.4f, 2.96f));
     d -= 0.01f * smoothstep(0.4f, 0.8f, fbm3_high(op * 3.0f, 0.4f, 2.96f));
     
-    res = vec3(d, 1.0f, res.z);
+    res = V(d, 1.0f, res.z);
     
-    return res;
+    return select(outside, V(bbox + 1.0f, -1.0f, 0.5f), res);
 }
 
 } // namespace temple_detail
 
-inline float Temple(const vec3& p_in, float /*time*/, uint32_t /*seed*/) {
-    vec3 p = p_in;
+template <class V>
+inline scalar_t<V> Temple(const V& p_in, float /*time*/, uint32_t /*seed*/) {
+    V p = p_in;
     p = p * rotationMatrix(vec3(0.0f, 1.0f, 0.0f), -pi / 2.0f);
     const float scale = 0.04f;
     p *= 1.0f / scale;
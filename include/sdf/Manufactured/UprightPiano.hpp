@@ -8,112 +8,133 @@ namespace sdf::manufactured {
 
 namespace uprightpiano_detail {
 
-inline float sdCylinder(const vec3& p, const vec2& h) {
-    vec2 d = abs(vec2(length(vec2(p.x, p.z)), p.y)) - h;
-    return glm::min(glm::max(d.x, d.y), 0.0f) + length(max(d, vec2(0.0f)));
+template <class V>
+inline scalar_t<V> sdCylinder(const V& p, const vec2& h) {
+    using V2 = vec2_t<scalar_t<V>>;
+    V2 d = abs(V2(length(V2(p.x, p.z)), p.y)) - V2(h.x, h.y);
+    return min(max(d.x, d.y), 0.0f) + length(max(d, V2(0.0f)));
 }
 
-inline float sdBox(const vec3& p, const vec3& b) {
-    vec3 d = abs(p) - b;
-    return glm::min(glm::max(d.x, glm::max(d.y, d.z)), 0.0f) + length(max(d, vec3(0.0f)));
+template <class V>
+inline scalar_t<V> sdBox(const V& p, const V& b) {
+    V d = abs(p) - b;
+    return min(max(d.x, max(d.y, d.z)), 0.0f) + length(max(d, V(0.0f)));
 }
 
-inline float udRoundBox(const vec3& p, const vec3& b, const vec3& r) {
-    return length(max(abs(p) - b, vec3(0.0f))) - r.x;
+template <class V>
+inline scalar_t<V> udRoundBox(const V& p, const V& b, const vec3& r) {
+    return length(max(abs(p) - b, V(0.0f))) - r.x;
 }
 
-inline float opRepLim(float p, float s, float mi, float ma) {
-    return p - s * clamp(round(p / s), mi, ma);
+template <class T>
+inline T opRepLim(T p, float s, float mi, float ma) {
+    return p - s * clamp(round(p / s), T(mi), T(ma));
 }
 
-inline float obj1(const vec3& p) {
-    vec3 q = vec3(opRepLim(p.x + 0.1f, 0.2f, -22.0f, 23.0f), p.y - 0.1f, p.z - 0.1f);
-    return udRoundBox(q, vec3(0.091f, 0.075f, 0.6f) - 0.005f, vec3(0.01f));
+template <class V>
+inline scalar_t<V> obj1(const V& p) {
+    V q = V(opRepLim(p.x + 0.1f, 0.2f, -22.0f, 23.0f), p.y - 0.1f, p.z - 0.1f);
+    return udRoundBox(q, V(0.091f, 0.075f, 0.6f) - 0.005f, vec3(0.01f));
 }
 
-inline float obj2(const vec3& p, float d) {
-    vec3 q = vec3(opRepLim(p.x, 0.2f, -21.0f, 23.0f), p.y - 0.185f, p.z - 0.3f);
-    float k = mod(round(p.x / 0.2f), 7.0f);
-    if (k == 2.0f || k == 6.0f) return d;
-    return udRoundBox(q, vec3(0.06f, 0.075f, 0.4f) - 0.01f, vec3(0.01f, 0.01f, 0.01f));
+template <class V>
+inline scalar_t<V> obj2(const V& p, scalar_t<V> d) {
+    using T = scalar_t<V>;
+    V q = V(opRepLim(p.x, 0.2f, -21.0f, 23.0f), p.y - 0.185f, p.z - 0.3f);
+    T k = mod(round(p.x / 0.2f), 7.0f);
+    // k is a whole number, so these compare it with 2 and 6
+    auto gap = (abs(k - 2.0f) < 0.5f) | (abs(k - 6.0f) < 0.5f);
+    return select(gap, d, udRoundBox(q, V(0.06f, 0.075f, 0.4f) - 0.01f, vec3(0.01f, 0.01f, 0.01f)));
 }
 
-inline float obj3(const vec3& p) {
-    float d1 = udRoundBox(p - vec3(0.0f, 0.0f, 1.7f), vec3(5.4f, 0.6f, 1.0f), vec3(0.05f));
-    float d2 = udRoundBox(p - vec3(0.0f, -0.3f, 0.1f), vec3(5.4f, 0.3f, 0.6f), vec3(0.05f));
-    float d3 = udRoundBox(p - vec3(0.0f, -1.0f, 2.5f), vec3(5.4f, 3.0f, 1.0f), vec3(0.05f));
+template <class V>
+inline scalar_t<V> obj3(const V& p) {
+    using T = scalar_t<V>;
+    T d1 = udRoundBox(p - V(0.0f, 0.0f, 1.7f), V(5.4f, 0.6f, 1.0f), vec3(0.05f));
+    T d2 = udRoundBox(p - V(0.0f, -0.3f, 0.1f), V(5.4f, 0.3f, 0.6f), vec3(0.05f));
+    T d3 = udRoundBox(p - V(0.0f, -1.0f, 2.5f), V(5.4f, 3.0f, 1.0f), vec3(0.05f));
 
-    float d4 = sdCylinder(vec3(abs(p.x), p.y, p.z) - vec3(5.25f, -2.2f, -0.35f), vec2(0.1f, 1.85f));
+    T d4 = sdCylinder(V(abs(p.x), p.y, p.z) - V(5.25f, -2.2f, -0.35f), vec2(0.1f, 1.85f));
     d4 -= 0.03f * smoothstep(-0.7f, 0.7f, sin(18.0f * p.y)) + 0.017f * p.y + 0.025f;
 
-    float d5 = udRoundBox(vec3(abs(p.x), p.y, p.z) - vec3(5.05f, 0.0f, 0.3f), vec3(0.35f, 0.2f, 0.8f), vec3(0.05f));
+    T d5 = udRoundBox(V(abs(p.x), p.y, p.z) - V(5.05f, 0.0f, 0.3f), V(0.35f, 0.2f, 0.8f), vec3(0.05f));
 
-    return glm::min(glm::min(glm::min(glm::min(d1, d2), d3), d4), d5);
+    return min(min(min(min(d1, d2), d3), d4), d5);
 }
 
-inline float obj6(const vec3& p) {
-    vec3 q = p - vec3(0.0f, 1.3f, 1.1f);
-    float x = abs(q.x);
+template <class V>
+inline scalar_t<V> obj6(const V& p) {
+    using T = scalar_t<V>;
+    using V2 = vec2_t<T>;
+    V q = p - V(0.0f, 1.3f, 1.1f);
+    T x = abs(q.x);
     q.z += 0.15f * 4.0f * x * (1.0f - x);
     mat2 rm = mat2(0.9f, -0.43f, 0.43f, 0.9f);
-    vec2 qyz = rm * vec2(q.y, q.z);
+    V2 qyz = rm * V2(q.y, q.z);
     q.y = qyz.x; q.z = qyz.y;
-    return 0.5f * udRoundBox(q, vec3(1.0f, 0.7f, 0.0f), vec3(0.01f));
+    return 0.5f * udRoundBox(q, V(1.0f, 0.7f, 0.0f), vec3(0.01f));
 }
 
-inline float obj8(const vec3& p) {
-    vec3 q = p - vec3(-0.5f, -1.8f, -2.0f);
+template <class V>
+inline scalar_t<V> obj8(const V& p) {
+    using T = scalar_t<V>;
+    using V2 = vec2_t<T>;
+    V q = p - V(-0.5f, -1.8f, -2.0f);
     mat2 rm = mat2(0.9f, 0.44f, -0.44f, 0.9f);
-    vec2 qxz = rm * vec2(q.x, q.z);
+    V2 qxz = rm * V2(q.x, q.z);
     q.x = qxz.x; q.z = qxz.y;
 
-    float y = 0.5f + 0.5f * sin(8.0f * q.x) * sin(8.0f * q.z);
+    T y = 0.5f + 0.5f * sin(8.0f * q.x) * sin(8.0f * q.z);
     y = 0.1f * pow(y, 3.0f) * smoothstep(0.1f, 0.4f, q.y);
-    float d = udRoundBox(q, vec3(1.5f, 0.25f, 0.6f), vec3(0.3f));
+    T d = udRoundBox(q, V(1.5f, 0.25f, 0.6f), vec3(0.3f));
     d += y;
 
-    vec3 s = vec3(abs(q.x), q.y, abs(q.z));
-    float d2 = sdCylinder(s - vec3(1.4f, -1.2f, 0.6f), vec2(0.15f, 1.05f));
-    return glm::min(d, d2);
+    V s = V(abs(q.x), q.y, abs(q.z));
+    T d2 = sdCylinder(s - V(1.4f, -1.2f, 0.6f), vec2(0.15f, 1.05f));
+    return min(d, d2);
 }
 
-inline float obj7(const vec3& p) {
-    vec3 q = p - vec3(1.0f, -3.6f, 1.2f);
-    vec3 r = vec3(mod(q.x - 0.25f, 0.5f) - 0.25f, q.y, q.z);
-    return glm::max(0.5f * udRoundBox(r, vec3(0.05f, 0.0f, 0.38f), vec3(0.08f)), sdBox(q, vec3(0.75f, 1.0f, 1.0f)));
+template <class V>
+inline scalar_t<V> obj7(const V& p) {
+    V q = p - V(1.0f, -3.6f, 1.2f);
+    V r = V(mod(q.x - 0.25f, 0.5f) - 0.25f, q.y, q.z);
+    return max(0.5f * udRoundBox(r, V(0.05f, 0.0f, 0.38f), vec3(0.08f)), sdBox(q, V(0.75f, 1.0f, 1.0f)));
 }
 
-inline vec2 upright_map(const vec3& p) {
+template <class V>
+inline vec2_t<scalar_t<V>> upright_map(const V& p) {
+    using V2 = vec2_t<scalar_t<V>>;
     // white keys
-    vec2 res = vec2(obj1(p), 0.0f);
+    V2 res = V2(obj1(p), 0.0f);
 
     // black keys
-    vec2 ob2 = vec2(obj2(p, res.x), 1.0f);
-    if (ob2.x < res.x) res = ob2;
+    V2 ob2 = V2(obj2(p, res.x), 1.0f);
+    res = select(ob2.x < res.x, ob2, res);
 
     // piano body
-    vec2 ob3 = vec2(obj3(p), 2.0f);
-    if (ob3.x < res.x) res = ob3;
+    V2 ob3 = V2(obj3(p), 2.0f);
+    res = select(ob3.x < res.x, ob3, res);
 
     // paper
-    vec2 ob6 = vec2(obj6(p), 5.0f);
-    if (ob6.x < res.x) res = ob6;
+    V2 ob6 = V2(obj6(p), 5.0f);
+    res = select(ob6.x < res.x, ob6, res);
 
     // pedals
-    vec2 ob7 = vec2(obj7(p), 6.0f);
-    if (ob7.x < res.x) res = ob7;
+    V2 ob7 = V2(obj7(p), 6.0f);
+    res = select(ob7.x < res.x, ob7, res);
 
     // bench
-    vec2 ob8 = vec2(obj8(p), 7.0f);
-    if (ob8.x < res.x) res = ob8;
+    V2 ob8 = V2(obj8(p), 7.0f);
+    res = select(ob8.x < res.x, ob8, res);
 
     return res;
 }
 
 } // namespace uprightpiano_detail
 
-inline float UprightPiano(const vec3& p_in, float /*time*/, uint32_t /*seed*/) {
-    vec3 p = p_in;
+template <class V>
+inline scalar_t<V> UprightPiano(const V& p_in, float /*time*/, uint32_t /*seed*/) {
+    V p = p_in;
     p = p * rotationMatrix(vec3(0.0f, 1.0f, 0.0f), pi);
     const float scale = 0.14f;
     p *= 1.0f / scale;
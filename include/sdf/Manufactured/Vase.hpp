@@ -8,40 +8,49 @@ namespace sdf {
 namespace manufactured {
 
 namespace vase_detail {
-    inline float sdSphere(const vec3& pos, const vec3& center, float radius) {
+    template <class V>
+    inline scalar_t<V> sdSphere(const V& pos, const V& center, float radius) {
         return length(center - pos) - radius;
     }
     
-    inline float sdCappedCylinder(const vec3& p, const vec2& h) {
-        vec2 d = abs(vec2(length(vec2(p.x, p.z)), p.y)) - h;
-        return std::min(std::max(d.x, d.y), 0.0f) + length(max(d, vec2(0.0f)));
+    template <class V>
+    inline scalar_t<V> sdCappedCylinder(const V& p, const vec2& h) {
+        using V2 = vec2_t<scalar_t<V>>;
+        V2 d = abs(V2(length(V2(p.x, p.z)), p.y)) - V2(h.x, h.y);
+        return min(max(d.x, d.y), 0.0f) + length(max(d, V2(0.0f)));
     }
     
-    inline float opSmoothUnion(float d1, float d2, float k) {
-        float h = clamp(0.5f + 0.5f * (d2 - d1) / k, 0.0f, 1.0f);
+    template <class T>
+    inline T opSmoothUnion(T d1, T d2, float k) {
+        T h = clamp(0.5f + 0.5f * (d2 - d1) / k, T(0.0f), T(1.0f));
         return mix(d2, d1, h) - k * h * (1.0f - h);
     }
     
-    inline float opShell(float d, float thickness) { return std::abs(d) - thickness; }
-    inline float opSubtraction(float d1, float d2) { return std::max(-d1, d2); }
+    template <class T>
+    inline T opShell(T d, float thickness) { return abs(d) - thickness; }
+    template <class T>
+    inline T opSubtraction(T d1, T d2) { return max(-d1, d2); }
     
-    inline float map(const vec3& pos) {
-        float d1 = sdCappedCylinder(pos, vec2(0.2f, 0.75f));
-        float d2 = sdSphere(pos, vec3(0.0f, -0.25f, 0.0f), 0.45f);
-        float d3 = sdSphere(pos, vec3(0.0f, 1.0f, 0.0f), 0.4f);
-        float d4 = sdCappedCylinder(pos + vec3(0.0f, -1.75f, 0.0f), vec2(1.0f, 1.0f));
+    template <class V>
+    inline scalar_t<V> map(const V& pos) {
+        using T = scalar_t<V>;
+        T d1 = sdCappedCylinder(pos, vec2(0.2f, 0.75f));
+        T d2 = sdSphere(pos, V(0.0f, -0.25f, 0.0f), 0.45f);
+        T d3 = sdSphere(pos, V(0.0f, 1.0f, 0.0f), 0.4f);
+        T d4 = sdCappedCylinder(pos + V(0.0f, -1.75f, 0.0f), vec2(1.0f, 1.0f));
         
-        float df = opSmoothUnion(d1, d2, 0.2f);
+        T df = opSmoothUnion(d1, d2, 0.2f);
         df = opSmoothUnion(df, d3, 0.2f);
         df = opShell(df, 0.01f);
         df = opSubtraction(d4, df);
-        df += std::cos(pos.y * 100.0f) / 300.0f;
+        df += cos(pos.y * 100.0f) / 300.0f;
         
         return df;
     }
 }
 
-inline float Vase(const vec3& p, float /*time*/, uint32_t /*seed*/) {
+template <class V>
+inline scalar_t<V> Vase(const V& p, float /*time*/, uint32_t /*seed*/) {
     const float scale = 1.0f;
     return vase_detail::map(p * (1.0f / scale)) * scale;
 }
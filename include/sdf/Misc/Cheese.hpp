@@ -8,127 +8,159 @@ namespace sdf {
 namespace misc {
 
 namespace cheese_detail {
-    inline void opRotate(vec2& v, float r) {
-        float c = std::cos(r);
-        float s = std::sin(r);
-        float vx = v.x * c - v.y * s;
-        float vy = v.x * s + v.y * c;
+    template <class V2, class A>
+    inline void opRotate(V2& v, A r) {
+        A c = cos(r);
+        A s = sin(r);
+        auto vx = v.x * c - v.y * s;
+        auto vy = v.x * s + v.y * c;
         v.x = vx;
         v.y = vy;
     }
     
-    inline vec3 opRepeate(const vec3& p, const vec3& c) { return mod(p, c) - 0.5f * c; }
+    // A zero period leaves that axis alone: mod(x, 0.0) is NaN, which made
+    // the cut, and with it the cheese and plate, vanish from the scene
+    template <class T>
+    inline T opRepeate(const T& x, float c) { return c == 0.0f ? x : mod(x, c) - 0.5f * c; }
     
-    inline float opDisp(const vec3& p) {
-        return std::sin(20.0f * p.x) * std::sin(20.0f * p.y) * std::sin(20.0f * p.z);
+    template <class V>
+    inline V opRepeate(const V& p, const vec3& c) {
+        return V(opRepeate(p.x, c.x), opRepeate(p.y, c.y), opRepeate(p.z, c.z));
     }
     
-    inline float sdBox(const vec3& p, const vec3& b) {
-        vec3 d = abs(p) - b;
-        return length(max(d, vec3(0.0f))) + std::min(std::max(d.x, std::max(d.y, d.z)), 0.0f);
+    template <class V>
+    inline scalar_t<V> opDisp(const V& p) {
+        return sin(20.0f * p.x) * sin(20.0f * p.y) * sin(20.0f * p.z);
     }
     
-    inline float sdSphere(const vec3& p, float r) { return length(p) - r; }
+    template <class V>
+    inline scalar_t<V> sdBox(const V& p, const V& b) {
+        using T = scalar_t<V>;
+        V d = abs(p) - b;
+        return length(max(d, V(0.0f))) + min(max(d.x, max(d.y, d.z)), T(0.0f));
+    }
+    
+    template <class V>
+    inline scalar_t<V> sdSphere(const V& p, float r) { return length(p) - r; }
     
-    inline float sdRoundedCylinder(const vec3& p, float ra, float rb, float h) {
-        vec2 d = vec2(length(vec2(p.x, p.z)) - 2.0f * ra + rb, std::abs(p.y) - h);
-        return std::min(std::max(d.x, d.y), 0.0f) + length(max(d, vec2(0.0f))) - rb;
+    template <class V>
+    inline scalar_t<V> sdRoundedCylinder(const V& p, float ra, float rb, float h) {
+        using T = scalar_t<V>;
+        using V2 = vec2_t<T>;
+        V2 d = V2(length(V2(p.x, p.z)) - 2.0f * ra + rb, abs(p.y) - h);
+        return min(max(d.x, d.y), T(0.0f)) + length(max(d, V2(0.0f))) - rb;
     }
     
-    inline float sdTriPrism(const vec3& p, const vec2& h) {
-        vec3 q = abs(p);
-        return std::max(q.z - h.y, std::max(q.x * 0.866025f + p.y * 0.5f, -p.y) - h.x * 0.5f);
+    template <class V>
+    inline scalar_t<V> sdTriPrism(const V& p, const vec2& h) {
+        V q = abs(p);
+        return max(q.z - h.y, max(q.x * 0.866025f + p.y * 0.5f, -p.y) - h.x * 0.5f);
     }
     
-    inline float sdCappedCylinder(const vec3& p, const vec2& h) {
-        vec2 d = abs(vec2(length(vec2(p.x, p.z)), p.y)) - h;
-        return std::min(std::max(d.x, d.y), 0.0f) + length(max(d, vec2(0.0f)));
+    template <class V>
+    inline scalar_t<V> sdCappedCylinder(const V& p, const vec2& h) {
+        using T = scalar_t<V>;
+        using V2 = vec2_t<T>;
+        V2 d = abs(V2(length(V2(p.x, p.z)), p.y)) - V2(h.x, h.y);
+        return min(max(d.x, d.y), T(0.0f)) + length(max(d, V2(0.0f)));
     }
     
-    inline float mapCheese(vec3 p) {
-        float value = 0.0f;
-        vec2 pxz = vec2(p.x, p.z);
+    template <class V>
+    inline scalar_t<V> mapCheese(V p) {
+        using T = scalar_t<V>;
+        using V2 = vec2_t<T>;
+        T value = 0.0f;
+        V2 pxz = V2(p.x, p.z);
         opRotate(pxz, 0.5f);
         p.x = pxz.x; p.z = pxz.y;
         
         // base shape
-        float cyl0 = sdRoundedCylinder(p, 0.30f, 0.04f, 0.3f);
-        vec3 triP0 = p + vec3(0.0f, 0.0f, -0.2f);
-        vec2 trizy = vec2(triP0.z, triP0.y);
+        T cyl0 = sdRoundedCylinder(p, 0.30f, 0.04f, 0.3f);
+        V triP0 = p + V(0.0f, 0.0f, -0.2f);
+        V2 trizy = V2(triP0.z, triP0.y);
         opRotate(trizy, -pi / 2.0f);
         triP0.z = trizy.x; triP0.y = trizy.y;
-        float tri0 = sdTriPrism(triP0, vec2(0.8f, 0.4f)) - 0.001f;
-        value = std::max(tri0, cyl0);
+        T tri0 = sdTriPrism(triP0, vec2(0.8f, 0.4f)) - 0.001f;
+        value = max(tri0, cyl0);
         
         // holes
-        vec3 holesP = p + vec3(-0.1119641f, -0.6300012f, 0.1603024f);
+        V holesP = p + V(-0.1119641f, -0.6300012f, 0.1603024f);
         holesP = opRepeate(holesP, vec3(0.45f));
-        float sp = sdSphere(holesP, 0.12f);
+        T sp = sdSphere(holesP, 0.12f);
         sp += opDisp(p * 0.3f) * 0.15f;
-        value = std::max(-sp, value);
+        value = max(-sp, value);
         
         // cut
-        vec3 cutP = p + vec3(0.0f, 0.0f, 0.62f);
-        vec2 cutxz = vec2(cutP.x, cutP.z);
+        V cutP = p + V(0.0f, 0.0f, 0.62f);
+        V2 cutxz = V2(cutP.x, cutP.z);
         opRotate(cutxz, -0.4f);
         cutP.x = cutxz.x; cutP.z = cutxz.y;
-        vec2 cutyz = vec2(cutP.y, cutP.z);
+        V2 cutyz = V2(cutP.y, cutP.z);
         opRotate(cutyz, -0.2f);
         cutP.y = cutyz.x; cutP.z = cutyz.y;
         cutP = opRepeate(cutP, vec3(0.09f, 0.001f, 0.0f));
-        float ct = sdSphere(cutP, 0.07f);
+        T ct = sdSphere(cutP, 0.07f);
         
-        value = std::max(-ct, value);
+        value = max(-ct, value);
         
         return value;
     }
     
-    inline float mapPlate(const vec3& p) {
-        float base = sdBox(p, vec3(0.8f, -0.001f, 0.8f)) - 0.1f;
-        float handle = sdBox(p + vec3(-1.0f, 0.0f, 0.0f), vec3(0.5f, 0.0f, 0.04f * std::sin(-0.1f + -p.x * 2.0f))) - 0.1f;
-        return std::min(base, handle);
+    template <class V>
+    inline scalar_t<V> mapPlate(const V& p) {
+        using T = scalar_t<V>;
+        T base = sdBox(p, V(0.8f, -0.001f, 0.8f)) - 0.1f;
+        T handle = sdBox(p + V(-1.0f, 0.0f, 0.0f), V(T(0.5f), T(0.0f), 0.04f * sin(-0.1f + -p.x * 2.0f))) - 0.1f;
+        return min(base, handle);
     }
     
-    inline float mapKnife(vec3 p) {
+    template <class V>
+    inline scalar_t<V> mapKnife(V p) {
+        using T = scalar_t<V>;
+        using V2 = vec2_t<T>;
         p *= 0.6f;
-        vec3 handleP = p;
-        vec2 hxy = vec2(handleP.x, handleP.y);
-        opRotate(hxy, -std::sin(handleP.y) * 0.5f);
+        V handleP = p;
+        V2 hxy = V2(handleP.x, handleP.y);
+        opRotate(hxy, -sin(handleP.y) * 0.5f);
         handleP.x = hxy.x; handleP.y = hxy.y;
         opRotate(hxy, 0.14f);
         handleP.x = hxy.x; handleP.y = hxy.y;
-        float handle = sdCappedCylinder(handleP, vec2(0.0f, 0.24f)) - std::abs(0.05f * std::cos(0.3f + p.y * -4.0f));
-        float blade = sdBox(p + vec3(0.05f, -0.6f, 0.0f), vec3(0.1f * std::sqrt(std::abs(std::cos(p.y * 1.57f))), 0.4f, 0.002f));
-        return std::min(handle, blade);
+        T handle = sdCappedCylinder(handleP, vec2(0.0f, 0.24f)) - abs(0.05f * cos(0.3f + p.y * -4.0f));
+        T blade = sdBox(p + V(0.05f, -0.6f, 0.0f), V(0.1f * sqrt(abs(cos(p.y * 1.57f))), T(0.4f), T(0.002f)));
+        return min(handle, blade);
     }
     
-    inline float mapScene(vec3 p) {
-        p = p + vec3(0.2f, 0.0f, 0.0f);
-        vec3 cheeseP = p + vec3(0.3f, 0.0f, -0.1f);
-        vec3 plateP = p + vec3(0.0f, 0.456f, 0.0f);
-        vec3 knifeP = p + vec3(-0.7742586f, 0.2902968f, -0.11406922f);
+    template <class V>
+    inline scalar_t<V> mapScene(V p) {
+        using T = scalar_t<V>;
+        using V2 = vec2_t<T>;
+        p = p + V(0.2f, 0.0f, 0.0f);
+        V cheeseP = p + V(0.3f, 0.0f, -0.1f);
+        V plateP = p + V(0.0f, 0.456f, 0.0f);
+        V knifeP = p + V(-0.7742586f, 0.2902968f, -0.11406922f);
         
-        vec2 kyz = vec2(knifeP.y, knifeP.z);
+        V2 kyz = V2(knifeP.y, knifeP.z);
         opRotate(kyz, pi / 2.0f + 0.015f);
         knifeP.y = kyz.x; knifeP.z = kyz.y;
-        vec2 kxy = vec2(knifeP.x, knifeP.y);
+        V2 kxy = V2(knifeP.x, knifeP.y);
         opRotate(kxy, -pi / 4.0f);
         knifeP.x = kxy.x; knifeP.y = kxy.y;
-        vec2 kxz = vec2(knifeP.x, knifeP.z);
+        V2 kxz = V2(knifeP.x, knifeP.z);
         opRotate(kxz, -0.28f);
         knifeP.x = kxz.x; knifeP.z = kxz.y;
         
-        float cheese = mapCheese(cheeseP);
-        float plate = mapPlate(plateP);
-        float knife = mapKnife(knifeP);
+        T cheese = mapCheese(cheeseP);
+        T plate = mapPlate(plateP);
+        T knife = mapKnife(knifeP);
         
-        return std::min(knife, std::min(cheese, plate));
+        return min(knife, min(cheese, plate));
     }
 }
 
-inline float Cheese(const vec3& p, float /*time*/, uint32_t /*seed*/) {
+template <class V>
+inline scalar_t<V> Cheese(const V& p, float /*time*/, uint32_t /*seed*/) {
     const float scale = 0.5f;
-    vec3 pRot = rotationMatrix(vec3(0.0f, 1.0f, 0.0f), pi) * (p * (1.0f / scale));
+    V pRot = rotationMatrix(vec3(0.0f, 1.0f, 0.0f), pi) * (p * (1.0f / scale));
     return cheese_detail::mapScene(pRot) * scale;
 }
 
@@ -8,34 +8,41 @@ namespace sdf {
 namespace nature {
 
 namespace mountain_detail {
-    inline float sdBox(const vec3& p, const vec3& b) {
-        vec3 d = abs(p) - b;
-        return std::min(std::max(d.x, std::max(d.y, d.z)), 0.0f) + length(max(d, vec3(0.0f)));
+    template <class V>
+    inline scalar_t<V> sdBox(const V& p, const vec3& b) {
+        using T = scalar_t<V>;
+        V d = abs(p) - V(b.x, b.y, b.z);
+        return min(max(d.x, max(d.y, d.z)), T(0.0f)) + length(max(d, V(0.0f)));
     }
     
-    inline float mountain_hash(const vec2& p) {
-        return fract(1e4f * std::sin(17.0f * p.x + p.y * 0.1f) * (0.1f + std::abs(std::sin(p.y * 13.0f + p.x))));
+    template <class V2>
+    inline scalar_t<V2> mountain_hash(const V2& p) {
+        return fract(1e4f * sin(17.0f * p.x + p.y * 0.1f) * (0.1f + abs(sin(p.y * 13.0f + p.x))));
     }
     
-    inline float mountain_noise1(const vec2& x) {
-        vec2 i = floor(x);
-        vec2 f = fract(x);
+    template <class V2>
+    inline scalar_t<V2> mountain_noise1(const V2& x) {
+        using T = scalar_t<V2>;
+        V2 i = floor(x);
+        V2 f = fract(x);
         
-        float a = mountain_hash(i);
-        float b = mountain_hash(i + vec2(1.0f, 0.0f));
-        float c = mountain_hash(i + vec2(0.0f, 1.0f));
-        float d = mountain_hash(i + vec2(1.0f, 1.0f));
+        T a = mountain_hash(i);
+        T b = mountain_hash(i + V2(1.0f, 0.0f));
+        T c = mountain_hash(i + V2(0.0f, 1.0f));
+        T d = mountain_hash(i + V2(1.0f, 1.0f));
         
-        vec2 u = f * f * (vec2(3.0f) - 2.0f * f);
+        V2 u = f * f * (V2(3.0f) - 2.0f * f);
         return mix(a, b, u.x) + (c - a) * u.y * (1.0f - u.x) + (d - b) * u.x * u.y;
     }
     
-    inline float mountain_noise(vec2 x, int numOctaves) {
-        float v = 0.0f;
+    template <class V2>
+    inline scalar_t<V2> mountain_noise(V2 x, int numOctaves) {
+        using T = scalar_t<V2>;
+        T v = 0.0f;
         float a = 0.5f;
-        vec2 shift = vec2(100.0f, 50.0f);
-        float c05 = std::cos(0.5f);
-        float s05 = std::sin(0.5f);
+        V2 shift = V2(100.0f, 50.0f);
+        float c05 = cos(0.5f);
+        float s05 = sin(0.5f);
         mat2 rot = mat2(c05, s05, -s05, c05);
         for (int i = 0; i < numOctaves; ++i) {
             v += a * mountain_noise1(x);
@@ -46,25 +53,29 @@ namespace mountain_detail {
     }
 }
 
-inline float Mountain(const vec3& p, float /*time*/, uint32_t /*seed*/) {
+template <class V>
+inline scalar_t<V> Mountain(const V& p, float /*time*/, uint32_t /*seed*/) {
+    using T = scalar_t<V>;
+    using V2 = vec2_t<T>;
     // Measure distance from a conservative bounding box for speed when far away
-    float dBigBox = mountain_detail::sdBox(p, vec3(0.75f));
-    if (dBigBox > 0.25f) {
+    T dBigBox = mountain_detail::sdBox(p, vec3(0.75f));
+    auto far = dBigBox > 0.25f;
+    if (all(far)) {
         return dBigBox;
     }
     
-    float dBox = mountain_detail::sdBox(p, vec3(0.5f));
+    T dBox = mountain_detail::sdBox(p, vec3(0.5f));
     
-    vec2 offset = vec2(p.x, p.z) - vec2(0.05f, 0.07f);
-    float d = dot(offset, offset);
-    d = 0.8f * std::pow(d, 0.36987f + 0.00415f / d);
-    float terrainVertical = (p.y + d - mountain_detail::mountain_noise(vec2(p.x, p.z) * 2.0f + vec2(0.6f, 1.6f), 9) + 0.3f);
+    V2 offset = V2(p.x, p.z) - V2(0.05f, 0.07f);
+    T d = dot(offset, offset);
+    d = 0.8f * pow(d, 0.36987f + 0.00415f / d);
+    T terrainVertical = (p.y + d - mountain_detail::mountain_noise(V2(p.x, p.z) * 2.0f + V2(0.6f, 1.6f), 9) + 0.3f);
     
-    float lakeVertical = p.y + 0.48f;
+    T lakeVertical = p.y + 0.48f;
     
     const float conservativeFactor = 0.3f;
-    float terrain = std::min(terrainVertical, lakeVertical) * conservativeFactor;
-    return std::max(dBox, terrain);
+    T terrain = min(terrainVertical, lakeVertical) * conservativeFactor;
+    return select(far, dBigBox, max(dBox, terrain));
 }
 
 } // namespace nature
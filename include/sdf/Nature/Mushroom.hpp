@@ -10,166 +10,182 @@ namespace nature {
 namespace mushroom_detail {
     inline float length2(const vec3& p) { return dot(p, p); }
     
-    inline float sdEllipsoid(const vec3& pos, const vec3& cen, const vec3& rad) {
-        vec3 p = pos - cen;
-        float d = length(p / rad) - 1.0f;
+    template <class V>
+    inline scalar_t<V> sdEllipsoid(const V& pos, const V& cen, const vec3& rad) {
+        using T = scalar_t<V>;
+        V p = pos - cen;
+        T d = length(p / V(rad.x, rad.y, rad.z)) - 1.0f;
         return d * std::min(std::min(rad.x, rad.y), rad.z);
     }
     
-    inline vec2 sdLine(const vec3& pos, const vec3& a, const vec3& b) {
-        vec3 pa = pos - a;
+    template <class V>
+    inline vec2_t<scalar_t<V>> sdLine(const V& pos, const vec3& a, const vec3& b) {
+        using T = scalar_t<V>;
+        V pa = pos - V(a.x, a.y, a.z);
         vec3 ba = b - a;
-        float h = clamp(dot(pa, ba) / dot(ba, ba), 0.0f, 1.0f);
-        return vec2(length(pa - h * ba), h);
+        T h = clamp(dot(pa, ba) / dot(ba, ba), T(0.0f), T(1.0f));
+        return vec2_t<T>(length(pa - h * V(ba.x, ba.y, ba.z)), h);
     }
     
-    inline vec3 rotateX(vec3 p, float t) {
-        float co = std::cos(t);
-        float si = std::sin(t);
-        float y = p.y * co + p.z * si;
-        float z = -p.y * si + p.z * co;
-        return vec3(p.x, y, z);
+    template <class V>
+    inline V rotateX(V p, float t) {
+        float co = cos(t);
+        float si = sin(t);
+        auto y = p.y * co + p.z * si;
+        auto z = -p.y * si + p.z * co;
+        return V(p.x, y, z);
     }
     
-    inline vec3 rotateY(vec3 p, float t) {
-        float co = std::cos(t);
-        float si = std::sin(t);
-        float x = p.x * co + p.z * si;
-        float z = -p.x * si + p.z * co;
-        return vec3(x, p.y, z);
+    template <class V>
+    inline V rotateY(V p, float t) {
+        float co = cos(t);
+        float si = sin(t);
+        auto x = p.x * co + p.z * si;
+        auto z = -p.x * si + p.z * co;
+        return V(x, p.y, z);
     }
     
-    inline vec3 rotateZ(vec3 p, float t) {
-        float co = std::cos(t);
-        float si = std::sin(t);
-        float x = p.x * co + p.y * si;
-        float y = -p.x * si + p.y * co;
-        return vec3(x, y, p.z);
+    template <class V>
+    inline V rotateZ(V p, float t) {
+        float co = cos(t);
+        float si = sin(t);
+        auto x = p.x * co + p.y * si;
+        auto y = -p.x * si + p.y * co;
+        return V(x, y, p.z);
     }
     
-    inline vec3 mapLadyBug(vec3 p, float curmin) {
-        float db = length(p - vec3(0.0f, -0.35f, 0.05f)) - 1.3f;
-        if (db > curmin) return vec3(10000.0f, 0.0f, 0.0f);
+    template <class V>
+    inline V mapLadyBug(V p, scalar_t<V> curmin) {
+        using T = scalar_t<V>;
+        using V2 = vec2_t<T>;
+        T db = length(p - V(0.0f, -0.35f, 0.05f)) - 1.3f;
+        auto skip = db > curmin;
+        if (all(skip)) return V(10000.0f, 0.0f, 0.0f);
         
-        float dBody = sdEllipsoid(p, vec3(0.0f), vec3(0.8f, 0.75f, 1.0f));
-        dBody = smax(dBody, -sdEllipsoid(p, vec3(0.0f, -0.1f, 0.0f), vec3(0.75f, 0.7f, 0.95f)), 0.05f);
-        dBody = smax(dBody, -sdEllipsoid(p, vec3(0.0f, 0.0f, 0.8f), vec3(0.35f, 0.35f, 0.5f)), 0.05f);
-        dBody = smax(dBody, sdEllipsoid(p, vec3(0.0f, 1.7f, -0.1f), vec3(2.0f)), 0.05f);
-        dBody = smax(dBody, -std::abs(p.x) + 0.005f, 0.02f + 0.1f * clamp(p.z * p.z * p.z * p.z, 0.0f, 1.0f));
+        T dBody = sdEllipsoid(p, V(0.0f), vec3(0.8f, 0.75f, 1.0f));
+        dBody = smax(dBody, -sdEllipsoid(p, V(0.0f, -0.1f, 0.0f), vec3(0.75f, 0.7f, 0.95f)), 0.05f);
+        dBody = smax(dBody, -sdEllipsoid(p, V(0.0f, 0.0f, 0.8f), vec3(0.35f, 0.35f, 0.5f)), 0.05f);
+        dBody = smax(dBody, sdEllipsoid(p, V(0.0f, 1.7f, -0.1f), vec3(2.0f)), 0.05f);
+        dBody = smax(dBody, -abs(p.x) + 0.005f, 0.02f + 0.1f * clamp(p.z * p.z * p.z * p.z, T(0.0f), T(1.0f)));
         
-        vec3 res = vec3(dBody, 3.0f, 0.0f);
+        V res = V(dBody, T(3.0f), T(0.0f));
         
         // Head
-        vec3 hc = vec3(0.0f, 0.1f, 0.8f);
-        vec3 ph = rotateX(p - hc, 0.5f);
-        float dHead = sdEllipsoid(ph, vec3(0.0f), vec3(0.35f, 0.25f, 0.3f));
-        dHead = smax(dHead, -sdEllipsoid(ph, vec3(0.0f, -0.95f, 0.0f), vec3(1.0f)), 0.03f);
-        dHead = std::min(dHead, sdEllipsoid(ph, vec3(0.0f, 0.1f, 0.3f), vec3(0.15f, 0.08f, 0.15f)));
+        V hc = V(0.0f, 0.1f, 0.8f);
+        V ph = rotateX(p - hc, 0.5f);
+        T dHead = sdEllipsoid(ph, V(0.0f), vec3(0.35f, 0.25f, 0.3f));
+        dHead = smax(dHead, -sdEllipsoid(ph, V(0.0f, -0.95f, 0.0f), vec3(1.0f)), 0.03f);
+        dHead = min(dHead, sdEllipsoid(ph, V(0.0f, 0.1f, 0.3f), vec3(0.15f, 0.08f, 0.15f)));
         
-        if (dHead < res.x) res = vec3(dHead, 4.0f, 0.0f);
+        res = select(dHead < res.x, V(dHead, T(4.0f), T(0.0f)), res);
         
-        res.x += 0.0007f * std::sin(150.0f * p.x) * std::sin(150.0f * p.z) * std::sin(150.0f * p.y);
+        res.x += 0.0007f * sin(150.0f * p.x) * sin(150.0f * p.z) * sin(150.0f * p.y);
         
         // Legs
         vec3 k1 = vec3(0.42f, -0.05f, 0.92f);
         vec3 k2 = vec3(0.49f, -0.2f, 1.05f);
-        float dLegs = 10.0f;
+        T dLegs = 10.0f;
         
-        float sx = sign(p.x);
-        p.x = std::abs(p.x);
+        T sx = sign(p.x);
+        p.x = abs(p.x);
         for (int k = 0; k < 3; k++) {
-            vec3 q = p;
-            q.y -= std::min(sx, 0.0f) * 0.1f;
-            if (k == 0) q += vec3(0.0f, 0.11f, 0.0f);
-            if (k == 1) q += vec3(-0.3f, 0.1f, 0.2f);
-            if (k == 2) q += vec3(-0.3f, 0.1f, 0.6f);
+            V q = p;
+            q.y -= min(sx, T(0.0f)) * 0.1f;
+            if (k == 0) q += V(0.0f, 0.11f, 0.0f);
+            if (k == 1) q += V(-0.3f, 0.1f, 0.2f);
+            if (k == 2) q += V(-0.3f, 0.1f, 0.6f);
             
-            vec2 se = sdLine(q, vec3(0.3f, 0.1f, 0.8f), k1);
+            V2 se = sdLine(q, vec3(0.3f, 0.1f, 0.8f), k1);
             se.x -= 0.015f + 0.15f * se.y * se.y * (1.0f - se.y);
-            dLegs = std::min(dLegs, se.x);
+            dLegs = min(dLegs, se.x);
             
             se = sdLine(q, k1, k2);
             se.x -= 0.01f + 0.01f * se.y;
-            dLegs = std::min(dLegs, se.x);
+            dLegs = min(dLegs, se.x);
             
             se = sdLine(q, k2, k2 + vec3(0.1f, 0.0f, 0.1f));
             se.x -= 0.02f - 0.01f * se.y;
-            dLegs = std::min(dLegs, se.x);
+            dLegs = min(dLegs, se.x);
         }
         
-        if (dLegs < res.x) res = vec3(dLegs, 5.0f, 0.0f);
+        res = select(dLegs < res.x, V(dLegs, T(5.0f), T(0.0f)), res);
         
-        return res;
+        return select(skip, V(10000.0f, 0.0f, 0.0f), res);
     }
     
-    inline vec3 worldToMushrom(const vec3& pos) {
-        vec3 qos = pos;
+    template <class V>
+    inline V worldToMushrom(const V& pos) {
+        V qos = pos;
         // Rotation matrix equivalent
         qos.x = (60.0f * pos.x + 11.0f * pos.y) / 61.0f;
         qos.y = (-11.0f * pos.x + 60.0f * pos.y) / 61.0f;
-        qos.y += 0.03f * std::sin(3.0f * qos.z - 2.0f * std::sin(3.0f * qos.x));
+        qos.y += 0.03f * sin(3.0f * qos.z - 2.0f * sin(3.0f * qos.x));
         qos.y -= 0.4f;
         return qos;
     }
     
-    inline vec3 mapMushroom(const vec3& pos, const vec3& cur) {
-        vec3 res = cur;
+    template <class V>
+    inline V mapMushroom(const V& pos, const V& cur) {
+        using T = scalar_t<V>;
+        using V2 = vec2_t<T>;
+        V res = cur;
         
-        vec3 qos = worldToMushrom(pos);
-        float db = length(qos - vec3(0.0f, 1.2f, 0.0f)) - 1.3f;
-        if (db < cur.x) {
+        V qos = worldToMushrom(pos);
+        T db = length(qos - V(0.0f, 1.2f, 0.0f)) - 1.3f;
+        auto near = db < cur.x;
+        if (any(near)) {
             // Cap
-            float d1 = sdEllipsoid(qos, vec3(0.0f, 1.4f, 0.0f), vec3(0.8f, 1.0f, 0.8f));
-            float d2 = sdEllipsoid(qos, vec3(0.0f, 0.5f, 0.0f), vec3(1.3f, 1.2f, 1.3f));
-            float d = smax(d1, -d2, 0.1f) * 0.8f;
-            if (d < res.x) {
-                res = vec3(d, 1.0f, 0.0f);
-            }
+            T d1 = sdEllipsoid(qos, V(0.0f, 1.4f, 0.0f), vec3(0.8f, 1.0f, 0.8f));
+            T d2 = sdEllipsoid(qos, V(0.0f, 0.5f, 0.0f), vec3(1.3f, 1.2f, 1.3f));
+            T d = smax(d1, -d2, 0.1f) * 0.8f;
+            res = select(d < res.x, V(d, T(1.0f), T(0.0f)), res);
             
             // Stem
-            vec3 p = pos;
-            p.x += 0.3f * std::sin(p.y) - 0.65f;
-            float pa = std::sin(20.0f * std::atan2(p.z, p.x));
-            vec2 se = sdLine(p, vec3(0.0f, 2.0f, 0.0f), vec3(0.0f));
+            V p = pos;
+            p.x += 0.3f * sin(p.y) - 0.65f;
+            T pa = sin(20.0f * atan2(p.z, p.x));
+            V2 se = sdLine(p, vec3(0.0f, 2.0f, 0.0f), vec3(0.0f));
             
-            float tt = 0.25f - 0.1f * 4.0f * se.y * (1.0f - se.y);
-            float d3 = se.x - tt;
+            T tt = 0.25f - 0.1f * 4.0f * se.y * (1.0f - se.y);
+            T d3 = se.x - tt;
             
-            d3 = smin(d3, sdEllipsoid(p, vec3(0.0f, 1.7f - 2.0f * (p.x * p.x + p.z * p.z), 0.0f), vec3(0.3f, 0.05f, 0.3f)), 0.05f);
+            d3 = smin(d3, sdEllipsoid(p, V(T(0.0f), 1.7f - 2.0f * (p.x * p.x + p.z * p.z), T(0.0f)), vec3(0.3f, 0.05f, 0.3f)), 0.05f);
             d3 += 0.003f * pa;
             d3 *= 0.7f;
             
-            if (d3 < res.x) {
-                res = vec3(d3, 2.0f, 0.0f) * 0.7f;
-            }
+            res = select(d3 < res.x, V(d3, T(2.0f), T(0.0f)) * 0.7f, res);
+            res = select(near, res, cur);
         }
         return res;
     }
     
-    inline vec3 worldToLadyBug(const vec3& p) {
-        vec3 q = 4.0f * (p - vec3(-0.0f, 3.2f - 0.6f, -0.57f));
+    template <class V>
+    inline V worldToLadyBug(const V& p) {
+        V q = 4.0f * (p - V(-0.0f, 3.2f - 0.6f, -0.57f));
         q = rotateY(rotateZ(rotateX(q, -0.92f), 0.49f), 3.5f);
         q.y += 0.2f;
         return q;
     }
     
-    inline vec3 mapShroom(const vec3& pos) {
-        vec3 res = vec3(10.0f, 0.0f, 0.0f);
+    template <class V>
+    inline V mapShroom(const V& pos) {
+        V res = V(10.0f, 0.0f, 0.0f);
         
-        vec3 m1 = pos - vec3(0.0f, 0.1f, 0.0f);
+        V m1 = pos - V(0.0f, 0.1f, 0.0f);
         res = mapMushroom(m1, res);
         
-        vec3 q = worldToLadyBug(pos);
-        vec3 d3 = mapLadyBug(q, res.x * 4.0f);
+        V q = worldToLadyBug(pos);
+        V d3 = mapLadyBug(q, res.x * 4.0f);
         d3.x /= 4.0f;
-        if (d3.x < res.x) res = d3;
+        res = select(d3.x < res.x, d3, res);
         
         return res;
     }
 }
 
-inline float Mushroom(const vec3& p, float /*time*/, uint32_t /*seed*/) {
-    vec3 pTrans = p - vec3(0.2f, -0.7f, 0.0f);
+template <class V>
+inline scalar_t<V> Mushroom(const V& p, float /*time*/, uint32_t /*seed*/) {
+    V pTrans = p - V(0.2f, -0.7f, 0.0f);
     pTrans = rotationMatrix(vec3(0.0f, 1.0f, 0.0f), pi) * pTrans;
     const float scale = 0.55f;
     return mushroom_detail::mapShroom(pTrans * (1.0f / scale)).x * scale;
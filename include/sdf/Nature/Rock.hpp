@@ -9,12 +9,13 @@ namespace nature {
 
 namespace rock_detail {
     inline float hash11(float p) {
-        return fract(std::sin(p * 727.1f) * 435.545f);
+        return fract(sin(p * 727.1f) * 435.545f);
     }
     
-    inline float hash12(const vec2& p) {
-        float h = dot(p, vec2(127.1f, 311.7f));
-        return fract(std::sin(h) * 437.545f);
+    template <class V2>
+    inline scalar_t<V2> hash12(const V2& p) {
+        auto h = dot(p, vec2(127.1f, 311.7f));
+        return fract(sin(h) * 437.545f);
     }
     
     inline vec3 hash31(float p) {
@@ -22,65 +23,78 @@ namespace rock_detail {
         return fract(sin(h) * 435.543f);
     }
     
-    inline float noise_3(const vec3& p) {
-        vec3 i = floor(p);
-        vec3 f = fract(p);
-        vec3 u = f * f * (vec3(3.0f) - 2.0f * f);
+    template <class V>
+    inline scalar_t<V> noise_3(const V& p) {
+        using T = scalar_t<V>;
+        using V2 = vec2_t<T>;
+        V i = floor(p);
+        V f = fract(p);
+        V u = f * f * (V(3.0f) - 2.0f * f);
         
-        vec2 ii = vec2(i.x, i.y) + i.z * vec2(5.0f);
-        float a = hash12(ii + vec2(0.0f, 0.0f));
-        float b = hash12(ii + vec2(1.0f, 0.0f));
-        float c = hash12(ii + vec2(0.0f, 1.0f));
-        float d = hash12(ii + vec2(1.0f, 1.0f));
-        float v1 = mix(mix(a, b, u.x), mix(c, d, u.x), u.y);
+        V2 ii = V2(i.x, i.y) + i.z * V2(5.0f);
+        T a = hash12(ii + V2(0.0f, 0.0f));
+        T b = hash12(ii + V2(1.0f, 0.0f));
+        T c = hash12(ii + V2(0.0f, 1.0f));
+        T d = hash12(ii + V2(1.0f, 1.0f));
+        T v1 = mix(mix(a, b, u.x), mix(c, d, u.x), u.y);
         
-        ii += vec2(5.0f);
-        a = hash12(ii + vec2(0.0f, 0.0f));
-        b = hash12(ii + vec2(1.0f, 0.0f));
-        c = hash12(ii + vec2(0.0f, 1.0f));
-        d = hash12(ii + vec2(1.0f, 1.0f));
-        float v2 = mix(mix(a, b, u.x), mix(c, d, u.x), u.y);
+        ii += V2(5.0f);
+        a = hash12(ii + V2(0.0f, 0.0f));
+        b = hash12(ii + V2(1.0f, 0.0f));
+        c = hash12(ii + V2(0.0f, 1.0f));
+        d = hash12(ii + V2(1.0f, 1.0f));
+        T v2 = mix(mix(a, b, u.x), mix(c, d, u.x), u.y);
         
-        return std::max(mix(v1, v2, u.z), 0.0f);
+        return max(mix(v1, v2, u.z), T(0.0f));
     }
     
-    inline float fbm3_high(vec3 p, float a, float f) {
-        float ret = 0.0f;
-        float amp = 1.0f;
+    template <class V>
+    inline scalar_t<V> fbm3_high(V p, float a, float f) {
+        using T = scalar_t<V>;
+        T ret = 0.0f;
+        T amp = 1.0f;
         float frq = 1.0f;
         for (int i = 0; i < 5; i++) {
-            float n = std::pow(noise_3(p * frq), 2.0f);
+            // Squared by hand: the float build folds pow(x, 2.0f) to x * x
+            T n = noise_3(p * frq);
+            n = n * n;
             ret += n * amp;
             frq *= f;
-            amp *= a * std::pow(n, 0.2f);
+            amp *= a * pow(n, T(0.2f));
         }
         return ret;
     }
     
-    inline float rock_sphere(const vec3& p, float r) {
+    template <class V>
+    inline scalar_t<V> rock_sphere(const V& p, float r) {
         return length(p) - r;
     }
     
-    inline float boolSub(float a, float b) { return std::max(a, -b); }
+    template <class T>
+    inline T boolSub(const T& a, const T& b) { return max(a, -b); }
     
-    inline float rock(const vec3& p) {
-        float d = rock_sphere(p, 1.0f);
+    template <class V>
+    inline scalar_t<V> rock(const V& p) {
+        using T = scalar_t<V>;
+        T d = rock_sphere(p, 1.0f);
         for (int i = 0; i < 9; i++) {
             float ii = float(i);
             float r = 2.5f + hash11(ii);
-            vec3 v = normalize(hash31(ii) * 2.0f - 1.0f);
-            d = boolSub(d, rock_sphere(p + v * r, r * 0.8f));
+            vec3 v = normalize(hash31(ii) * 2.0f - 1.0f) * r;
+            d = boolSub(d, rock_sphere(p + V(v.x, v.y, v.z), r * 0.8f));
         }
         return d;
     }
     
-    inline float map_detailed(const vec3& p) {
+    template <class V>
+    inline scalar_t<V> map_detailed(const V& p) {
         const float DISPLACEMENT = 0.1f;
         return rock(p) + fbm3_high(p * 4.0f, 0.4f, 2.96f) * DISPLACEMENT;
     }
 }
 
-inline float Rock(const vec3& p, float /*time*/, uint32_t /*seed*/) {
+template <class V>
+inline scalar_t<V> Rock(const V& p, float /*time*/, uint32_t /*seed*/) {
     const float scale = 0.8f;
     return rock_detail::map_detailed(p * (1.0f / scale)) * scale * 0.7f;
 }
@@ -8,28 +8,38 @@ namespace sdf::vehicle {
 
 namespace boat_detail {
 
-inline float PrBoxDf(const vec3& p, const vec3& b) {
-    vec3 d = abs(p) - b;
-    return glm::min(glm::max(d.x, glm::max(d.y, d.z)), 0.0f) + length(max(d, vec3(0.0f)));
+template <class V>
+inline scalar_t<V> PrBoxDf(const V& p, const V& b) {
+    using T = scalar_t<V>;
+    V d = abs(p) - b;
+    return min(max(d.x, max(d.y, d.z)), T(0.0f)) + length(max(d, V(0.0f)));
 }
 
-inline float PrBox2Df(const vec2& p, const vec2& b) {
-    vec2 d = abs(p) - b;
-    return glm::min(glm::max(d.x, d.y), 0.0f) + length(max(d, vec2(0.0f)));
+template <class V2>
+inline scalar_t<V2> PrBox2Df(const V2& p, const V2& b) {
+    using T = scalar_t<V2>;
+    V2 d = abs(p) - b;
+    return min(max(d.x, d.y), T(0.0f)) + length(max(d, V2(0.0f)));
 }
 
-inline float PrCylDf(const vec3& p, float r, float h) {
-    return glm::max(length(vec2(p.x, p.y)) - r, abs(p.z) - h);
+template <class V>
+inline scalar_t<V> PrCylDf(const V& p, scalar_t<V> r, scalar_t<V> h) {
+    using V2 = vec2_t<scalar_t<V>>;
+    return max(length(V2(p.x, p.y)) - r, abs(p.z) - h);
 }
 
-inline float PrCapsDf(const vec3& p, float r, float h) {
-    return length(p - vec3(0.0f, 0.0f, h * clamp(p.z / h, -1.0f, 1.0f))) - r;
+template <class V>
+inline scalar_t<V> PrCapsDf(const V& p, scalar_t<V> r, scalar_t<V> h) {
+    using T = scalar_t<V>;
+    return length(p - V(T(0.0f), T(0.0f), h * clamp(p.z / h, T(-1.0f), T(1.0f)))) - r;
 }
 
-inline float PrEECapsDf(const vec3& p, const vec3& v1, const vec3& v2, float r) {
-    vec3 s = p - v1;
-    vec3 t = v2 - v1;
-    return length(s - clamp(dot(s, t) / dot(t, t), 0.0f, 1.0f) * t) - r;
+template <class V>
+inline scalar_t<V> PrEECapsDf(const V& p, const V& v1, const V& v2, float r) {
+    using T = scalar_t<V>;
+    V s = p - v1;
+    V t = v2 - v1;
+    return length(s - clamp(dot(s, t) / dot(t, t), T(0.0f), T(1.0f)) * t) - r;
 }
 
 inline vec2 Rot2D(const vec2& q, float a) {
@@ -40,14 +50,18 @@ inline vec2 Rot2Cs(const vec2& q, const vec2& cs) {
     return vec2(dot(q, vec2(cs.x, -cs.y)), dot(vec2(q.y, q.x), cs));
 }
 
+template <class V>
 struct ShipState {
-    vec3 qHit;
-    vec3 bDeck;
+    V qHit;
+    V bDeck;
     float szFac;
     float dstFar;
 };
 
-inline float ShipDf(vec3 p, ShipState& state) {
+template <class V>
+inline scalar_t<V> ShipDf(V p, ShipState<V>& state) {
+    using T = scalar_t<V>;
+    using V2 = vec2_t<T>;
     state.szFac = 0.6f;
     state.dstFar = 100.0f;
     
@@ -55,93 +69,93 @@ inline float ShipDf(vec3 p, ShipState& state) {
     float rSpar = 0.05f;
     
     // Ship configuration - static ship
-    vec3 shipConf = vec3(0.0f, 0.0f, 0.0f);
+    const vec3 shipConf = vec3(0.0f, 0.0f, 0.0f);
     
     p.y -= shipConf.x + 4.1f * state.szFac;
     p /= state.szFac;
-    float dMin = state.dstFar / state.szFac;
-    float fy = 1.0f - 0.07f * p.y;
-    float fz = 1.0f - 0.14f * step(1.0f, abs(p.z));
-    float zLim = abs(p.z) - 4.5f;
-    vec3 q = p;
-    float d = zLim;
+    T dMin = state.dstFar / state.szFac;
+    T fy = 1.0f - 0.07f * p.y;
+    T fz = 1.0f - 0.14f * step(1.0f, abs(p.z));
+    T zLim = abs(p.z) - 4.5f;
+    V q = p;
+    T d = zLim;
     q.z = mod(q.z + 1.4f, 2.8f) - 1.2f;
-    d = glm::max(d, PrCapsDf(vec3(q.x, q.z, q.y) - vec3(0.0f, 0.0f, 3.7f * (fz - 1.0f)), 0.1f * fy, 3.7f * fz));
+    d = max(d, PrCapsDf(V(q.x, q.z, q.y) - V(0.0f, 0.0f, 3.7f * (fz - 1.0f)), 0.1f * fy, 3.7f * fz));
     state.qHit = q;
     
     q = p;
-    float yLim = abs(q.y - 0.2f * fz) - 3.0f * fz;
-    vec3 qq = q;
+    T yLim = abs(q.y - 0.2f * fz) - 3.0f * fz;
+    V qq = q;
     qq.y = mod(qq.y - 3.3f * (fz - 1.0f), 2.0f * fz) - fz;
     qq.z = mod(qq.z + 1.4f, 2.8f) - 1.4f + 0.1f * fz;
-    d = glm::max(glm::max(glm::min(d, PrCylDf(vec3(qq.x, qq.z, qq.y) - vec3(0.0f, 0.1f * fz - 0.23f, 0.05f * fy * fz),
+    d = max(max(min(d, PrCylDf(V(qq.x, qq.z, qq.y) - V(0.0f, 0.1f * fz - 0.23f, 0.05f * fy * fz),
        0.15f * fy, 0.11f * fy * fz)), yLim), zLim);
     
-    d = glm::max(glm::max(PrCapsDf(vec3(qq.y, qq.z, qq.x), 0.05f, 1.23f * fy * fz), yLim), zLim);
+    d = max(max(PrCapsDf(V(qq.y, qq.z, qq.x), 0.05f, 1.23f * fy * fz), yLim), zLim);
     
     q = p;
-    d = glm::min(d, glm::min(PrEECapsDf(q, vec3(0.0f, -3.5f, 4.3f), vec3(0.0f, -2.6f, 6.7f), rSpar),
-       PrEECapsDf(q, vec3(0.0f, -4.0f, 4.1f), vec3(0.0f, -2.9f, 6.0f), rSpar)));
-    d = glm::min(d, glm::min(PrEECapsDf(q, vec3(0.0f, -1.2f, -3.0f), vec3(0.0f, -0.5f, -4.5f), rSpar),
-       PrEECapsDf(q, vec3(0.0f, -2.7f, -3.0f), vec3(0.0f, -2.7f, -4.5f), rSpar)));
+    d = min(d, min(PrEECapsDf(q, V(0.0f, -3.5f, 4.3f), V(0.0f, -2.6f, 6.7f), rSpar),
+       PrEECapsDf(q, V(0.0f, -4.0f, 4.1f), V(0.0f, -2.9f, 6.0f), rSpar)));
+    d = min(d, min(PrEECapsDf(q, V(0.0f, -1.2f, -3.0f), V(0.0f, -0.5f, -4.5f), rSpar),
+       PrEECapsDf(q, V(0.0f, -2.7f, -3.0f), V(0.0f, -2.7f, -4.5f), rSpar)));
     
     q = p;
     qq = q;
     qq.y = mod(qq.y - 3.1f * (fz - 1.0f), 2.0f * fz) - fz;
     qq.z = mod(qq.z + 1.4f, 2.8f) - 1.4f + 0.2f * (fz - abs(qq.y)) * (fz - abs(qq.y)) - 0.1f * fz;
-    d = glm::max(glm::max(glm::max(PrBoxDf(qq, vec3((1.2f - 0.07f * q.y) * fz, fz, 0.01f)),
-       glm::min(qq.y, 1.5f * fy * fz - length(vec2(qq.x, qq.y + 0.9f * fy * fz)))),
-       abs(q.y - 3.0f * (fz - 1.0f)) - 2.95f * fz), -PrBox2Df(vec2(qq.y, qq.z), vec2(0.01f * fz)));
-    d = glm::max(d, zLim);
+    d = max(max(max(PrBoxDf(qq, V((1.2f - 0.07f * q.y) * fz, fz, 0.01f)),
+       min(qq.y, 1.5f * fy * fz - length(V2(qq.x, qq.y + 0.9f * fy * fz)))),
+       abs(q.y - 3.0f * (fz - 1.0f)) - 2.95f * fz), -PrBox2Df(V2(qq.y, qq.z), V2(0.01f * fz)));
+    d = max(d, zLim);
     
     q = p;
     q.z -= -3.8f;
     q.y -= -1.75f - 0.2f * q.z;
-    d = glm::min(d, PrBoxDf(q, vec3(0.01f, 0.9f - 0.2f * q.z, 0.6f)));
+    d = min(d, PrBoxDf(q, V(0.01f, 0.9f - 0.2f * q.z, 0.6f)));
     
     q = p;
     q.y -= -1.0f;
     q.z -= 4.5f;
-    vec3 w = vec3(1.0f, q.y, q.z);
-    d = glm::min(d, glm::max(glm::max(glm::max(abs(q.x) - 0.01f, -dot(w, vec3(2.3f, 1.0f, -0.35f))),
-       -dot(w, vec3(0.68f, -0.74f, -1.0f))), -dot(w, vec3(0.41f, 0.4f, 1.0f))));
+    V w = V(1.0f, q.y, q.z);
+    d = min(d, max(max(max(abs(q.x) - 0.01f, -dot(w, V(2.3f, 1.0f, -0.35f))),
+       -dot(w, V(0.68f, -0.74f, -1.0f))), -dot(w, V(0.41f, 0.4f, 1.0f))));
     
     q = p;
-    float gz = (q.z - 0.5f) / 5.0f + 0.3f;
+    T gz = (q.z - 0.5f) / 5.0f + 0.3f;
     gz *= gz;
     gz = 1.05f * (1.0f - 0.45f * gz * gz);
     q.x = abs(q.x);
     q.z = mod(q.z + 1.4f, 2.8f) - 1.4f;
-    d = glm::max(zLim, glm::min(PrEECapsDf(q, vec3(1.05f * gz, -3.25f, -0.5f), vec3(1.4f * fz, -2.95f, -0.05f), 0.7f * rRig),
-       PrEECapsDf(vec3(q.x, q.y, abs(q.z + 0.2f) - 0.01f * (0.3f - 2.0f * q.y)), vec3(gz, -3.2f, 0.0f),
-       vec3(0.05f, -0.9f + 2.0f * (fz - 1.0f), 0.0f), rRig)));
+    d = max(zLim, min(PrEECapsDf(q, V(1.05f * gz, -3.25f, -0.5f), V(1.4f * fz, -2.95f, -0.05f), 0.7f * rRig),
+       PrEECapsDf(V(q.x, q.y, abs(q.z + 0.2f) - 0.01f * (0.3f - 2.0f * q.y)), V(gz, -3.2f, 0.0f),
+       V(0.05f, -0.9f + 2.0f * (fz - 1.0f), 0.0f), rRig)));
     
     q = p;
-    d = glm::min(d, PrEECapsDf(q, vec3(0.0f, -3.0f, -4.45f), vec3(0.0f, -2.7f, -4.5f), 0.8f * rRig));
-    d = glm::min(glm::min(d, glm::min(PrEECapsDf(q, vec3(0.0f, 2.45f, 2.65f), vec3(0.0f, -2.7f, 6.5f), rRig),
-       PrEECapsDf(q, vec3(0.0f, 2.5f, 2.65f), vec3(0.0f, -3.2f, 4.9f), rRig))),
-       PrEECapsDf(q, vec3(0.0f, 2.6f, -3.0f), vec3(0.0f, -0.5f, -4.5f), rRig));
+    d = min(d, PrEECapsDf(q, V(0.0f, -3.0f, -4.45f), V(0.0f, -2.7f, -4.5f), 0.8f * rRig));
+    d = min(min(d, min(PrEECapsDf(q, V(0.0f, 2.45f, 2.65f), V(0.0f, -2.7f, 6.5f), rRig),
+       PrEECapsDf(q, V(0.0f, 2.5f, 2.65f), V(0.0f, -3.2f, 4.9f), rRig))),
+       PrEECapsDf(q, V(0.0f, 2.6f, -3.0f), V(0.0f, -0.5f, -4.5f), rRig));
     q.x = abs(q.x);
-    d = glm::min(d, PrEECapsDf(q, vec3(0.65f, -3.5f, 3.5f), vec3(0.05f, -2.7f, 6.4f), rRig));
+    d = min(d, PrEECapsDf(q, V(0.65f, -3.5f, 3.5f), V(0.05f, -2.7f, 6.4f), rRig));
     
-    float s = step(1.8f, q.y) - step(q.y, -0.2f);
-    d = glm::min(glm::min(d, glm::min(PrEECapsDf(q, vec3(0.95f, 0.4f, 2.7f) + vec3(-0.1f, 1.7f, 0.0f) * s,
-       vec3(0.05f, 1.1f, -0.15f) + vec3(0.0f, 2.0f, 0.0f) * s, rRig),
-       PrEECapsDf(q, vec3(1.05f, 1.0f, -0.1f) + vec3(-0.1f, 2.0f, 0.0f) * s,
-       vec3(0.05f, 0.5f, -2.95f) + vec3(0.0f, 1.7f, 0.0f) * s, rRig))),
-       PrEECapsDf(q, vec3(0.95f, 0.4f, -2.9f) + vec3(-0.1f, 1.7f, 0.0f) * s,
-       vec3(0.05f, 0.9f, -0.25f) + vec3(0.0f, 2.0f, 0.0f) * s, rRig));
+    T s = step(1.8f, q.y) - step(q.y, T(-0.2f));
+    d = min(min(d, min(PrEECapsDf(q, V(0.95f, 0.4f, 2.7f) + V(-0.1f, 1.7f, 0.0f) * s,
+       V(0.05f, 1.1f, -0.15f) + V(0.0f, 2.0f, 0.0f) * s, rRig),
+       PrEECapsDf(q, V(1.05f, 1.0f, -0.1f) + V(-0.1f, 2.0f, 0.0f) * s,
+       V(0.05f, 0.5f, -2.95f) + V(0.0f, 1.7f, 0.0f) * s, rRig))),
+       PrEECapsDf(q, V(0.95f, 0.4f, -2.9f) + V(-0.1f, 1.7f, 0.0f) * s,
+       V(0.05f, 0.9f, -0.25f) + V(0.0f, 2.0f, 0.0f) * s, rRig));
     
     q = p;
     q.y -= 3.4f;
     q.z -= 0.18f;
-    d = glm::min(d, PrBoxDf(q, vec3(0.01f, 0.2f, 0.3f)));
+    d = min(d, PrBoxDf(q, V(0.01f, 0.2f, 0.3f)));
     
     q = p;
     q.z = mod(q.z + 1.4f, 2.8f) - 1.4f;
     q.y -= -3.4f;
     q.z -= -0.4f;
-    d = glm::max(zLim, PrBoxDf(q, vec3(0.3f, 0.1f, 0.5f)));
+    d = max(zLim, PrBoxDf(q, V(0.3f, 0.1f, 0.5f)));
     
     q = p;
     q.x = abs(q.x);
@@ -149,35 +163,36 @@ inline float ShipDf(vec3 p, ShipState& state) {
     q.z -= 0.5f;
     fz = q.z / 5.0f + 0.3f;
     fz *= fz;
-    fy = 1.0f - smoothstep(-1.3f, -0.1f, q.y);
-    gz = smoothstep(2.0f, 5.0f, q.z);
-    state.bDeck = vec3((1.0f - 0.45f * fz * fz) * (1.1f - 0.5f * fy * fy) *
-       (1.0f - 0.5f * smoothstep(-5.0f, -2.0f, q.y) * smoothstep(2.0f, 5.0f, q.z)),
-       0.78f - 0.8f * gz * gz - 0.2f * (1.0f - smoothstep(-5.2f, -4.0f, q.z)), 5.0f);
-    d = glm::min(d, glm::min(PrBoxDf(vec3(q.x, q.y + state.bDeck.y - 0.6f, q.z), state.bDeck),
-       glm::max(PrBoxDf(q - vec3(0.0f, 0.72f, -4.6f), vec3(state.bDeck.x, 0.12f, 0.4f)),
-       -PrBox2Df(vec2(abs(q.x) - 0.4f, q.y - 0.65f), vec2(0.2f, 0.08f)))));
-    d = glm::max(d, -PrBoxDf(vec3(q.x, q.y - 0.58f - 0.1f * fz, q.z), vec3(state.bDeck.x - 0.07f, 0.3f, state.bDeck.z - 0.1f)));
+    fy = 1.0f - smoothstep(T(-1.3f), T(-0.1f), q.y);
+    gz = smoothstep(T(2.0f), T(5.0f), q.z);
+    state.bDeck = V((1.0f - 0.45f * fz * fz) * (1.1f - 0.5f * fy * fy) *
+       (1.0f - 0.5f * smoothstep(T(-5.0f), T(-2.0f), q.y) * smoothstep(T(2.0f), T(5.0f), q.z)),
+       0.78f - 0.8f * gz * gz - 0.2f * (1.0f - smoothstep(T(-5.2f), T(-4.0f), q.z)), 5.0f);
+    d = min(d, min(PrBoxDf(V(q.x, q.y + state.bDeck.y - 0.6f, q.z), state.bDeck),
+       max(PrBoxDf(q - V(0.0f, 0.72f, -4.6f), V(state.bDeck.x, 0.12f, 0.4f)),
+       -PrBox2Df(V2(abs(q.x) - 0.4f, q.y - 0.65f), V2(0.2f, 0.08f)))));
+    d = max(d, -PrBoxDf(V(q.x, q.y - 0.58f - 0.1f * fz, q.z), V(state.bDeck.x - 0.07f, 0.3f, state.bDeck.z - 0.1f)));
     
     q = p;
-    d = glm::max(d, -glm::max(PrBox2Df(vec2(q.y + 3.35f, mod(q.z + 0.25f, 0.5f) - 0.25f), vec2(0.08f, 0.1f)),
+    d = max(d, -max(PrBox2Df(V2(q.y + 3.35f, mod(q.z + 0.25f, 0.5f) - 0.25f), V2(0.08f, 0.1f)),
        abs(q.z + 0.5f) - 3.75f));
-    dMin = glm::min(dMin, d);
+    dMin = min(dMin, d);
     
     q = p;
-    d = PrBoxDf(q + vec3(0.0f, 4.4f, 4.05f), vec3(0.03f, 0.35f, 0.5f));
-    dMin = glm::min(dMin, d);
+    d = PrBoxDf(q + V(0.0f, 4.4f, 4.05f), V(0.03f, 0.35f, 0.5f));
+    dMin = min(dMin, d);
     
     return 0.7f * dMin * state.szFac;
 }
 
 } // namespace boat_detail
 
-inline float Boat(const vec3& p_in, float /*time*/, uint32_t /*seed*/) {
-    vec3 p = p_in + vec3(0.0f, 0.5f, 0.1f);
+template <class V>
+inline scalar_t<V> Boat(const V& p_in, float /*time*/, uint32_t /*seed*/) {
+    V p = p_in + V(0.0f, 0.5f, 0.1f);
     const float scale = 0.25f;
     p *= (1.0f / scale);
-    boat_detail::ShipState state;
+    boat_detail::ShipState<V> state;
     return boat_detail::ShipDf(p, state) * scale;
 }
 
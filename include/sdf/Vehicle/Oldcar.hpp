@@ -8,9 +8,11 @@ namespace sdf::vehicle {
 
 namespace oldcar_detail {
 
-inline float sdRoundBox(const vec3& p, const vec3& b, float r) {
-    vec3 q = abs(p) - (b - r);
-    return length(max(q, vec3(0.0f))) + glm::min(glm::max(q.x, glm::max(q.y, q.z)), 0.0f) - r;
+template <class V>
+inline scalar_t<V> sdRoundBox(const V& p, const V& b, const scalar_t<V>& r) {
+    using T = scalar_t<V>;
+    V q = abs(p) - (b - r);
+    return length(max(q, V(0.0f))) + min(max(q.x, max(q.y, q.z)), T(0.0f)) - r;
 }
 
 inline float sdBox(const vec3& p, const vec3& b) {
@@ -18,14 +20,19 @@ inline float sdBox(const vec3& p, const vec3& b) {
     return length(max(q, vec3(0.0f))) + glm::min(glm::max(q.x, glm::max(q.y, q.z)), 0.0f);
 }
 
-inline float sdRoundRect(const vec2& p, const vec2& b, float r) {
-    vec2 q = abs(p) - (b - r);
-    return length(max(q, vec2(0.0f))) + glm::min(glm::max(q.x, q.y), 0.0f) - r;
+template <class V2>
+inline scalar_t<V2> sdRoundRect(const V2& p, const V2& b, const scalar_t<V2>& r) {
+    using T = scalar_t<V2>;
+    V2 q = abs(p) - (b - r);
+    return length(max(q, V2(0.0f))) + min(max(q.x, q.y), T(0.0f)) - r;
 }
 
-inline float sdRoundedCylinder(const vec3& p, float R, float r, float h) {
-    vec2 d = vec2(length(vec2(p.x, p.z)) - R, abs(p.y) - h * 0.5f);
-    return glm::min(glm::max(d.x, d.y), 0.0f) + length(max(d, vec2(0.0f))) - r;
+template <class V>
+inline scalar_t<V> sdRoundedCylinder(const V& p, const scalar_t<V>& R, float r, const scalar_t<V>& h) {
+    using T = scalar_t<V>;
+    using V2 = vec2_t<T>;
+    V2 d = V2(length(V2(p.x, p.z)) - R, abs(p.y) - h * 0.5f);
+    return min(max(d.x, d.y), T(0.0f)) + length(max(d, V2(0.0f))) - r;
 }
 
 inline float sdLine(const vec3& p, const vec3& a, const vec3& b) {
@@ -34,14 +41,20 @@ inline float sdLine(const vec3& p, const vec3& a, const vec3& b) {
     return length(pa - ba * h);
 }
 
-inline float distTorus(const vec3& p, float R, float r) {
-    return length(p - vec3(normalize(vec2(p.x, p.y)), 0.0f) * R) - r;
+template <class V>
+inline scalar_t<V> distTorus(const V& p, const scalar_t<V>& R, const scalar_t<V>& r) {
+    using T = scalar_t<V>;
+    using V2 = vec2_t<T>;
+    V2 n = normalize(V2(p.x, p.y));
+    return length(p - V(n.x, n.y, T(0.0f)) * R) - r;
 }
 
-inline float sminExp(float a, float b, float k) {
+template <class T>
+inline T sminExp(const T& a, const T& b, float k) {
+    // -log2(exp2(-k * a) + exp2(-k * b)) / k, with the smaller argument
+    // factored out so neither exp2 can overflow far from the surface
     k = 3.0f / k;
-    float res = exp2(-k * a) + exp2(-k * b);
-    return -log2(res) / k;
+    return min(a, b) - log2(1.0f + exp2(-k * abs(a - b))) / k;
 }
 
 inline float fermi(float x) {
@@ -53,49 +66,55 @@ const float ALLW = RUMPFW * 1.3f;
 const float WheelRadiusF = 0.62f;
 const float WheelRadiusR = 0.7f;
 
-inline float distTire(const vec3& p_in, float r) {
-    vec3 p = abs(p_in);
-    float d = 1000.0f;
-    d = glm::min(d, length(p) - r);
-    float ang = atan(p.z, p.y);
-    float l = length(vec2(p.z, p.y));
+template <class V>
+inline scalar_t<V> distTire(const V& p_in, const scalar_t<V>& r) {
+    using T = scalar_t<V>;
+    using V2 = vec2_t<T>;
+    V p = abs(p_in);
+    T d = T(1000.0f);
+    d = min(d, length(p) - r);
+    T ang = atan2(p.z, p.y);
+    T l = length(V2(p.z, p.y));
     p.x += cos(ang * 100.0f) * 0.005f * smoothstep(0.87f * r, 1.0f * r, l);
-    d = glm::max(d, distTorus(vec3(p.y, p.z, p.x) + vec3(0.0f, 0.0f, 0.03f), r * 0.78f, r * 0.28f));
-    d = glm::max(d, -l + r * 0.61f);
+    d = max(d, distTorus(V(p.y, p.z, p.x) + V(0.0f, 0.0f, 0.03f), r * 0.78f, r * 0.28f));
+    d = max(d, -l + r * 0.61f);
     float dx = 0.04f;
-    float xfr = mod(p.x, dx);
-    float x = p.x - xfr + dx * 0.5f;
-    d = glm::max(d, -distTorus(vec3(p.y, p.z, p.x) - vec3(0.0f, 0.0f, x), sqrt(r * r - x * x), 0.01f));
+    T xfr = mod(p.x, dx);
+    T x = p.x - xfr + dx * 0.5f;
+    d = max(d, -distTorus(V(p.y, p.z, p.x) - V(T(0.0f), T(0.0f), x), sqrt(r * r - x * x), T(0.01f)));
     return d;
 }
 
-inline float distRim(const vec3& p_in, float r) {
+template <class V>
+inline scalar_t<V> distRim(const V& p_in, scalar_t<V> r) {
+    using T = scalar_t<V>;
     r *= 0.6f;
-    vec3 p0 = p_in;
-    vec3 p = p_in;
+    V p0 = p_in;
+    V p = p_in;
     p.x = abs(p.x);
-    p = vec3(p.z, p.x, p.y);
-    float d = 1000.0f;
-    d = glm::min(d, sdRoundedCylinder(p, r, 0.01f, 0.6f * r));
-    p -= vec3(0.0f, 0.6f * r, 0.0f);
+    p = V(p.z, p.x, p.y);
+    T d = T(1000.0f);
+    d = min(d, sdRoundedCylinder(p, r, 0.01f, 0.6f * r));
+    p = p - V(T(0.0f), 0.6f * r, T(0.0f));
     d = -sminExp(-d, sdRoundedCylinder(p, 0.97f * r, 0.01f, 0.6f * r), 0.015f);
     d = -sminExp(-d, sdRoundedCylinder(p, 0.89f * r, 0.01f, 0.8f * r), 0.015f);
-    float d_i = sdRoundedCylinder(p, 0.77f * r, 0.01f, 1.9f * r);
+    T d_i = sdRoundedCylinder(p, 0.77f * r, 0.01f, 1.9f * r);
     d = -sminExp(-d, d_i, 0.015f);
     
-    float d2 = length(p0 - vec3(-r * 0.6f, 0.0f, 0.0f)) - r * 1.05f;
-    d2 = glm::max(d2, d_i);
+    T d2 = length(p0 - V(-r * 0.6f, T(0.0f), T(0.0f))) - r * 1.05f;
+    d2 = max(d2, d_i);
     d2 = -sminExp(-d2, sdRoundedCylinder(p, 0.4f * r, 0.01f, 0.8f * r), 0.1f);
     d2 = abs(d2) - 0.005f;
-    d2 = glm::max(d2, -p0.x);
+    d2 = max(d2, -p0.x);
     
-    d = glm::min(d, d2);
-    d = glm::min(d, sdRoundedCylinder(p - vec3(0.0f, -0.23f, 0.0f), 0.1f * r, 0.01f, 0.25f));
-    d = glm::min(d, sdRoundedCylinder(vec3(p0.z, p0.x, p0.y) - vec3(0.0f, -0.06f, 0.0f), 0.7f * r, 0.02f, 0.05f));
+    d = min(d, d2);
+    d = min(d, sdRoundedCylinder(p - V(0.0f, -0.23f, 0.0f), 0.1f * r, 0.01f, T(0.25f)));
+    d = min(d, sdRoundedCylinder(V(p0.z, p0.x, p0.y) - V(0.0f, -0.06f, 0.0f), 0.7f * r, 0.02f, T(0.05f)));
     return d;
 }
 
-inline float rille2(float d, float w) {
+template <class T>
+inline T rille2(const T& d, float w) {
     return w * exp2(-d * d * 2.0f / w / w);
 }
 
@@ -103,116 +122,119 @@ inline float rille(float d, float w) {
     return w * exp2(-abs(d) * 1.44f / w);
 }
 
-inline vec2 distCar(const vec3& p_in) {
-    vec3 p = p_in;
+template <class V>
+inline vec2_t<scalar_t<V>> distCar(const V& p_in) {
+    using T = scalar_t<V>;
+    using V2 = vec2_t<T>;
+    V p = p_in;
     
     // Rotation for slight tilt
     float co = cos(-0.023f);
     float si = sin(-0.023f);
-    float py = p.y * co - p.z * si;
-    float pz = p.y * si + p.z * co;
+    T py = p.y * co - p.z * si;
+    T pz = p.y * si + p.z * co;
     p.y = py; p.z = pz;
     
-    float d = 1000.0f;
+    T d = T(1000.0f);
     float mat = -1.0f;
     
-    p *= 2.0f;
-    if (p.x < 0.0f) p.x = -p.x;
-    vec3 p0 = p + vec3(0.0f, 0.0f, 0.13f);
+    p = p * 2.0f;
+    p.x = abs(p.x);
+    V p0 = p + V(0.0f, 0.0f, 0.13f);
     
     // Main body (rumpf)
-    p = p0 + vec3(0.0f, 0.1f, 0.0f);
-    float drumpf = sdRoundBox(p, vec3(RUMPFW + p.y * 0.15f - p.y * p.y * 0.04f + p.z * p.y * 0.03f,
-                                      3.2f - p.z * 0.3f + p.z * p.z * 0.1f - step(0.0f, -p.y) * p.x * 0.3f - step(0.0f, p.y) * 0.4f * p.z,
-                                      0.8f + p.y * 0.02f - p.x * p.x * 0.05f * (1.0f + 0.01f * (p.y * p.y * p.y * p.y))),
-                              glm::max(p.y * 0.04f, mix(0.25f + p.y * 0.05f, 0.07f, -p.z * 1.5f + 0.5f))) * 0.7f;
+    p = p0 + V(0.0f, 0.1f, 0.0f);
+    T drumpf = sdRoundBox(p, V(RUMPFW + p.y * 0.15f - p.y * p.y * 0.04f + p.z * p.y * 0.03f,
+                               3.2f - p.z * 0.3f + p.z * p.z * 0.1f - step(0.0f, -p.y) * p.x * 0.3f - step(0.0f, p.y) * 0.4f * p.z,
+                               0.8f + p.y * 0.02f - p.x * p.x * 0.05f * (1.0f + 0.01f * (p.y * p.y * p.y * p.y))),
+                          max(p.y * 0.04f, mix(0.25f + p.y * 0.05f, T(0.07f), -p.z * 1.5f + 0.5f))) * 0.7f;
     
     // Cabin
-    p = p0 - vec3(0.0f, 0.5f, 0.7f);
-    float dcabin = sdRoundBox(p, vec3(RUMPFW * 1.04f + p.y * 0.07f - p.y * p.y * 0.08f + p.z * 0.0f,
-                                      1.2f - p.z * (0.7f - 0.4f * step(0.0f, p.y)),
-                                      0.7f + p.y * 0.07f - p.x * p.x * 0.05f - p.y * p.y * 0.05f),
-                              0.33f + 0.15f * p.y) * 0.7f;
-    d = glm::min(d, dcabin);
+    p = p0 - V(0.0f, 0.5f, 0.7f);
+    T dcabin = sdRoundBox(p, V(RUMPFW * 1.04f + p.y * 0.07f - p.y * p.y * 0.08f + p.z * 0.0f,
+                               1.2f - p.z * (0.7f - 0.4f * step(0.0f, p.y)),
+                               0.7f + p.y * 0.07f - p.x * p.x * 0.05f - p.y * p.y * 0.05f),
+                          0.33f + 0.15f * p.y) * 0.7f;
+    d = min(d, dcabin);
     
     // Front screen
-    p = p0 - vec3(0.0f, 0.4f, 0.88f + 0.10f - 0.06f * p.x * p.x);
-    float sy = step(0.0f, p.y);
-    float dfrontscr = sdRoundRect(vec2(p.x, p.z) - vec2(0.0f, -0.12f + sy * 0.1f), 
-                                  vec2(RUMPFW * 0.4f - sy * 0.2f, 0.12f - step(0.0f, p.y) * 0.07f) * 2.0f, 
-                                  0.14f - sy * 0.04f) * 0.7f;
-    dfrontscr = glm::max(dfrontscr, -(drumpf - 0.07f));
+    p = p0 - V(T(0.0f), T(0.4f), 0.88f + 0.10f - 0.06f * p.x * p.x);
+    T sy = step(0.0f, p.y);
+    T dfrontscr = sdRoundRect(V2(p.x, p.z) - V2(T(0.0f), -0.12f + sy * 0.1f),
+                              V2(RUMPFW * 0.4f - sy * 0.2f, 0.12f - step(0.0f, p.y) * 0.07f) * 2.0f,
+                              0.14f - sy * 0.04f) * 0.7f;
+    dfrontscr = max(dfrontscr, -(drumpf - 0.07f));
     d = -sminExp(-d, dfrontscr, 0.03f);
     
     // Side screens
-    p = p0 - vec3(0.0f, 0.23f, 0.91f);
-    vec3 sidebox = vec3(2.0f, 0.35f - (p.z + 0.3f) * (0.1f + step(0.0f, p.z + 0.3f) * 0.1f), 
-                        0.065f + p.y * 0.023f - 0.05f * p.y * p.y * step(0.0f, p.z)) * 2.0f;
-    float dsidescr = sdRoundRect(vec2(p.y, p.z) - vec2(0.1f * p.z, 0.015f * p.y), vec2(sidebox.y, sidebox.z), 0.1f + 0.07f * p.y) * 0.7f;
+    p = p0 - V(0.0f, 0.23f, 0.91f);
+    V sidebox = V(T(2.0f), 0.35f - (p.z + 0.3f) * (0.1f + step(0.0f, p.z + 0.3f) * 0.1f),
+                  0.065f + p.y * 0.023f - 0.05f * p.y * p.y * step(0.0f, p.z)) * 2.0f;
+    T dsidescr = sdRoundRect(V2(p.y, p.z) - V2(0.1f * p.z, 0.015f * p.y), V2(sidebox.y, sidebox.z), 0.1f + 0.07f * p.y) * 0.7f;
     d = -sminExp(-d, dsidescr, 0.05f);
-    d -= clamp((abs(dsidescr - 0.03f) - 0.016f) * 0.2f, -0.02f, 0.0f);
+    d -= clamp((abs(dsidescr - 0.03f) - 0.016f) * 0.2f, T(-0.02f), T(0.0f));
     
     // Floor line
-    p = p0 + vec3(0.0f, 0.1f, 0.0f);
-    float dfloorline = p0.z + 0.7f - 0.5f * (0.5f - 0.5f * cos((p0.y * 1.0f - p0.y * p0.y * 0.1f) * step(0.0f, -p0.y)));
+    p = p0 + V(0.0f, 0.1f, 0.0f);
+    T dfloorline = p0.z + 0.7f - 0.5f * (0.5f - 0.5f * cos((p0.y * 1.0f - p0.y * p0.y * 0.1f) * step(0.0f, -p0.y)));
     
-    drumpf -= glm::max(-dfloorline * 0.5f - 1.3f * dfloorline * dfloorline, 0.0f) * 5.0f * 
-              clamp(((-p0.y - 1.8f) - 0.9f * (-p0.y - 1.8f) * (-p0.y - 1.8f)) * abs(-p0.y - 1.8f), 0.0f, 11.0f);
+    drumpf -= max(-dfloorline * 0.5f - 1.3f * dfloorline * dfloorline, T(0.0f)) * 5.0f *
+              clamp(((-p0.y - 1.8f) - 0.9f * (-p0.y - 1.8f) * (-p0.y - 1.8f)) * abs(-p0.y - 1.8f), T(0.0f), T(11.0f));
     
     // Side stripe
-    p = p0 + vec3(0.0f, 0.1f, 0.0f);
-    drumpf -= 0.6f * rille2(p.z - 0.4f + 0.03f * p.y - 0.1f * p.x, 0.02f) * (1.0f - smoothstep(2.4f, 2.6f, abs(p0.y + 0.3f)));
+    p = p0 + V(0.0f, 0.1f, 0.0f);
+    drumpf -= 0.6f * rille2(p.z - 0.4f + 0.03f * p.y - 0.1f * p.x, 0.02f) * (1.0f - smoothstep(T(2.4f), T(2.6f), abs(p0.y + 0.3f)));
     
     d = sminExp(d, drumpf, 0.03f);
     
     // Grill hole
-    float z = p.z + 0.2f;
-    float dgrillhole = sdRoundBox(p - vec3(0.0f, -3.0f, -0.02f), 
-                                  vec3(0.18f * 0.9f * RUMPFW - step(0.0f, -z) * z * z * 0.58f * RUMPFW, 0.5f, 0.33f) * 2.0f, 0.1f);
+    T z = p.z + 0.2f;
+    T dgrillhole = sdRoundBox(p - V(0.0f, -3.0f, -0.02f),
+                              V(0.18f * 0.9f * RUMPFW - step(0.0f, -z) * z * z * 0.58f * RUMPFW, T(0.5f), T(0.33f)) * 2.0f, T(0.1f));
     d = -sminExp(-d, dgrillhole, 0.04f);
-    float f = smoothstep(-3.0f, 0.0f, p.y);
+    T f = smoothstep(T(-3.0f), T(0.0f), p.y);
     d = -sminExp(-d, -dgrillhole + 0.1f + f * 10.0f, 0.04f);
     mat = 1.0f; // CARBODY
     
     // Grill lines
-    p = p0 - vec3(0.0f, -3.26f + 0.3f * p.z + 0.35f * p.x - 0.1f * p.z * p.z, 0.0f);
+    p = p0 - V(T(0.0f), -3.26f + 0.3f * p.z + 0.35f * p.x - 0.1f * p.z * p.z, T(0.0f));
     p.x = mod(p.x + 0.005f, 0.025f) - 0.0125f;
-    d = glm::min(d, glm::max(dgrillhole, (length(vec2(p.x, p.y)) - 0.007f) * 0.8f));
+    d = min(d, max(dgrillhole, (length(V2(p.x, p.y)) - 0.007f) * 0.8f));
     
     // Window glass cutout
-    d = glm::max(d, -dcabin - 0.06f);
+    d = max(d, -dcabin - 0.06f);
     
     // Window glass
-    d = glm::min(d, dcabin + 0.035f);
+    d = min(d, dcabin + 0.035f);
     
-    p0 -= vec3(0.0f, 0.0f, 0.13f);
+    p0 = p0 - V(0.0f, 0.0f, 0.13f);
     
     // Wheels
     const vec3 PF = vec3(ALLW * 0.78f * 0.5f, -1.43f, -0.33f) * 2.0f;
     const vec3 PR = vec3(ALLW * 0.96f * 0.5f, 1.23f, -0.35f) * 2.0f;
     
-    vec3 pf = p0 - vec3(PF.x, PF.y, PF.z);
-    vec3 pr = p0 - vec3(PR.x, PR.y, PR.z);
+    V pf = p0 - V(PF.x, PF.y, PF.z);
+    V pr = p0 - V(PR.x, PR.y, PR.z);
     
-    float rear = step(0.0f, p_in.y);
+    T rear = step(0.0f, p_in.y);
     p = mix(pf, pr, rear);
-    float siz = mix(WheelRadiusF, WheelRadiusR, rear);
+    T siz = mix(T(WheelRadiusF), T(WheelRadiusR), rear);
     
-    d = glm::min(d, distTire(p, siz));
-    d = glm::min(d, distRim(p, siz));
+    d = min(d, distTire(p, siz));
+    d = min(d, distRim(p, siz));
     
-    return vec2(d * 0.5f, mat);
+    return V2(d * 0.5f, T(mat));
 }
 
 } // namespace oldcar_detail
 
-inline float Oldcar(const vec3& p_in, float /*time*/, uint32_t /*seed*/) {
-    vec3 p = p_in + vec3(0.0f, 0.05f, 0.0f);
+template <class V>
+inline scalar_t<V> Oldcar(const V& p_in, float /*time*/, uint32_t /*seed*/) {
+    V p = p_in + V(0.0f, 0.05f, 0.0f);
     p = p * rotationMatrix(vec3(1.0f, 0.0f, 0.0f), pi / 2.0f);
     const float scale = 0.5f;
-    p *= 1.0f / scale;
+    p = p * (1.0f / scale);
     return oldcar_detail::distCar(p).x * scale;
 }
 
 } // namespace sdf::vehicle
-
@@ -0,0 +1,186 @@
+#pragma once
+
+// Precomputed distance grids for shapes that are expensive to evaluate.
+//
+// Usage:
+//   sdf::BakedGrid grid = sdf::BakedGrid::bake(sdf::resolve("HumanHead"),
+//                                              glm::uvec3(256), glm::vec3(-1.0f), glm::vec3(1.0f));
+//   grid.setNarrowBand(0.01f);
+//   float d = grid.query(glm::vec3(0.1f, 0.2f, 0.3f));
+//   grid.save("head.sdfb");
+//
+//   sdf::BakedGrid shared = sdf::BakedGrid::load("head.sdfb");  // memory-mapped
+//
+//   // Grids larger than memory go straight to disk, slab by slab
+//   sdf::BakedGrid::bakeToFile(sdf::resolve("HumanHead"), glm::uvec3(2048),
+//                              glm::vec3(-1.0f), glm::vec3(1.0f), "head2k.sdfb");
+//
+// A query interpolates the eight surrounding samples trilinearly and moves
+// the result towards zero by how far the point is from those samples. The
+// true signed distance changes by at most the distance travelled, so the
+// answer keeps the library's guarantee: it never exceeds the true distance
+// in magnitude and has the correct sign. Where that correction leaves the
+// sign undecided, or the value falls inside the narrow band, the shape is
+// evaluated exactly instead.
+//
+// Saved grids are laid out so that load() can map the file and query the
+// node values in place: the values start on a page boundary after a
+// fixed-size header. Processes that load the same file share its pages.
+
+#include "sdf.hpp"
+#include "stream.hpp"
+
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+
+namespace sdf {
+
+class BakedGrid {
+public:
+    BakedGrid() = default;
+
+    /// Sample an SDF at every node of a regular grid (see evaluateGrid()).
+    ///
+    /// Sampling runs on the configured threads and goes through the SIMD
+    /// kernel when the SDF has one.
+    ///
+    /// @param sdf       Handle returned by resolve(); kept for exact fallbacks
+    /// @param dims      Number of nodes along each axis, at least 2
+    /// @param boundLow  Position of node (0, 0, 0)
+    /// @param boundHigh Position of node (dims - 1)
+    /// @param time      Time parameter for animated SDFs (default: 0.0)
+    /// @param seed      Random seed for procedural SDFs (default: 12345)
+    /// @return          The baked grid, with a narrow band of 0
+    /// @throws          std::runtime_error if a dimension is below 2 or the
+    ///                  bounds are not increasing
+    static BakedGrid bake(
+        const Handle& sdf,
+        const glm::uvec3& dims,
+        const glm::vec3& boundLow,
+        const glm::vec3& boundHigh,
+        float time = 0.0f,
+        uint32_t seed = 12345
+    );
+
+    /// Conservative distance at a point.
+    ///
+    /// Returns the trilinear interpolation T of the surrounding nodes, moved
+    /// towards zero by E = sqrt(sum over axes of t (1 - t) h^2), where t is
+    /// the position within the cell and h the node spacing. E bounds the
+    /// weighted distance from the point to the nodes, and the true distance
+    /// is 1-Lipschitz, so T - E (or T + E inside) is a valid bound. Points
+    /// outside the grid use the nearest point on it, with E grown by the
+    /// distance to that point. Where |T| - E is at most the narrow band,
+    /// the SDF is evaluated exactly.
+    ///
+    /// @param point Query point
+    /// @return      Signed distance, no greater in magnitude than the true one
+    float query(const glm::vec3& point) const;
+
+    /// Query an array of points. Exact fallbacks are gathered into
+    /// structure-of-arrays batches. Performs no allocation.
+    ///
+    /// @param points Array of `count` query points
+    /// @param out    Output buffer with room for `count` floats
+    /// @param count  Number of points to query
+    void query(const glm::vec3* points, float* out, size_t count) const;
+
+    /// Parallel counterpart of the batch query().
+    void queryParallel(const glm::vec3* points, float* out, size_t count) const;
+
+    /// Set the width of the band around the surface in which queries are
+    /// answered exactly. 0 falls back only where the sign is undecided.
+    ///
+    /// @throws std::runtime_error if width is negative
+    void setNarrowBand(float width);
+    float narrowBand() const { return narrowBand_; }
+
+    const Handle& handle() const { return handle_; }
+    const glm::uvec3& dims() const { return dims_; }
+    const glm::vec3& boundLow() const { return boundLow_; }
+    const glm::vec3& boundHigh() const { return boundHigh_; }
+    float time() const { return time_; }
+    uint32_t seed() const { return seed_; }
+
+    /// Node values, dims.x * dims.y * dims.z of them with x varying fastest
+    /// (the layout of evaluateGrid())
+    const float* values() const { return values_; }
+    size_t valueCount() const { return static_cast<size_t>(dims_.x) * dims_.y * dims_.z; }
+
+    /// True if the values are mapped from a file rather than held in memory
+    bool mapped() const { return mapped_; }
+
+    /// Write the grid in the baked-grid file format (see src/baked.cpp).
+    ///
+    /// @throws std::runtime_error if the grid is empty or writing fails
+    void save(const std::string& path) const;
+
+    /// Write a baked-grid file without holding the grid in memory: the
+    /// values are evaluated and written slab by slab with streamGrid(). The
+    /// file is the same as bake() followed by save() would produce.
+    ///
+    /// @param path    Output file, replaced if it exists
+    /// @param options Slab depth or memory budget for the streaming
+    /// @throws        std::runtime_error for the arguments bake() rejects, or
+    ///                if writing fails
+    static void bakeToFile(
+        const Handle& sdf,
+        const glm::uvec3& dims,
+        const glm::vec3& boundLow,
+        const glm::vec3& boundHigh,
+        const std::string& path,
+        const StreamOptions& options = StreamOptions(),
+        float time = 0.0f,
+        uint32_t seed = 12345
+    );
+
+    /// Write the header of a baked-grid file to `out`. Appending the
+    /// dims.x * dims.y * dims.z values in evaluateGrid() order yields a file
+    /// that load() accepts; use this to stream a grid through a custom sink.
+    ///
+    /// @throws std::runtime_error if the SDF name does not fit the header
+    static void writeHeader(
+        std::ostream& out,
+        const Handle& sdf,
+        const glm::uvec3& dims,
+        const glm::vec3& boundLow,
+        const glm::vec3& boundHigh,
+        float time = 0.0f,
+        uint32_t seed = 12345,
+        float narrowBand = 0.0f
+    );
+
+    /// Open a file written by save(). The values are memory-mapped read-only
+    /// and used in place, without a copy; on platforms without mmap they
+    /// are read into memory. The SDF named in the file is resolved for the
+    /// exact fallbacks, and the saved narrow band is restored.
+    ///
+    /// @throws std::runtime_error if the file cannot be opened, is not a
+    ///         baked grid of a supported version, is truncated, or names an
+    ///         unknown SDF
+    static BakedGrid load(const std::string& path);
+
+    explicit operator bool() const { return values_ != nullptr; }
+
+private:
+    // Interpolated value and its error bound at a point
+    void interpolate(const glm::vec3& point, float& value, float& error) const;
+
+    Handle handle_;
+    glm::uvec3 dims_ = glm::uvec3(0);
+    glm::vec3 boundLow_ = glm::vec3(0.0f);
+    glm::vec3 boundHigh_ = glm::vec3(0.0f);
+    glm::vec3 step_ = glm::vec3(0.0f);
+    float time_ = 0.0f;
+    uint32_t seed_ = 12345;
+    float narrowBand_ = 0.0f;
+    const float* values_ = nullptr;
+    std::shared_ptr<const void> storage_;  // owns values_: a vector or a mapping, shared by copies
+    bool mapped_ = false;
+};
+
+} // namespace sdf
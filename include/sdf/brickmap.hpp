@@ -0,0 +1,147 @@
+#pragma once
+
+// Sparse narrow-band sampling of an SDF on a regular grid.
+//
+// Usage:
+//   sdf::BrickMap map = sdf::BrickMap::build(sdf::resolve("Chain"), glm::uvec3(512),
+//                                            glm::vec3(-1.0f), glm::vec3(1.0f), 0.02f);
+//   float d = map.value(100, 200, 300);
+//   map.forEachActive([](uint32_t i, uint32_t j, uint32_t k, float phi) { ... });
+//
+// The grid is split into bricks of 8^3 nodes. Only bricks that may lie
+// within the band around the surface are stored densely; a top-level index
+// maps every brick to its storage, or marks it inactive and keeps a single
+// conservative value for all its nodes. Thin shapes such as Chain or Helix
+// occupy a small fraction of their bounding box, so the map holds a small
+// fraction of the dense grid's values.
+
+#include "sdf.hpp"
+
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace sdf {
+
+class BrickMap {
+public:
+    /// Nodes per brick along each axis
+    static constexpr uint32_t kBrickSize = 8;
+
+    /// Nodes per brick
+    static constexpr uint32_t kBrickVolume = kBrickSize * kBrickSize * kBrickSize;
+
+    /// Index entry of a brick without storage
+    static constexpr uint32_t kInactive = UINT32_MAX;
+
+    BrickMap() = default;
+
+    /// Sample an SDF on the nodes of a regular grid near its surface.
+    ///
+    /// Node (i, j, k) lies where it would in evaluateGrid(). The SDF is first
+    /// evaluated at every brick center c; because every SDF here is
+    /// conservative, the ball of radius |phi(c)| holds no surface, so a brick
+    /// whose half-diagonal plus `bandWidth` is smaller than that lies outside
+    /// the band and is not stored. Its nodes read as sign(phi(c)) * (|phi(c)|
+    /// - half-diagonal), a bound no greater in magnitude than their true
+    /// distance. All other bricks are evaluated densely. Both passes run on
+    /// the configured threads and go through the SIMD kernel when the SDF
+    /// has one; the result does not depend on the thread count.
+    ///
+    /// @param sdf       Handle returned by resolve()
+    /// @param dims      Number of nodes along each axis, at least 2
+    /// @param boundLow  Position of node (0, 0, 0)
+    /// @param boundHigh Position of node (dims - 1)
+    /// @param bandWidth Nodes closer than this to the surface are always stored
+    /// @param time      Time parameter for animated SDFs (default: 0.0)
+    /// @param seed      Random seed for procedural SDFs (default: 12345)
+    /// @return          The brick map
+    /// @throws          std::runtime_error if a dimension is below 2, the
+    ///                  bounds are not increasing, or bandWidth is negative
+    static BrickMap build(
+        const Handle& sdf,
+        const glm::uvec3& dims,
+        const glm::vec3& boundLow,
+        const glm::vec3& boundHigh,
+        float bandWidth,
+        float time = 0.0f,
+        uint32_t seed = 12345
+    );
+
+    /// Value at node (i, j, k): the sampled SDF for nodes of stored bricks,
+    /// the brick's conservative bound otherwise. Constant time; indices must
+    /// be below dims().
+    float value(uint32_t i, uint32_t j, uint32_t k) const {
+        const uint32_t entry = index_[brickOf(i, j, k)];
+        if (entry == kInactive) return fill_[brickOf(i, j, k)];
+        return values_[static_cast<size_t>(entry) * kBrickVolume + localOf(i, j, k)];
+    }
+
+    /// True if node (i, j, k) belongs to a stored brick
+    bool isActive(uint32_t i, uint32_t j, uint32_t k) const {
+        return index_[brickOf(i, j, k)] != kInactive;
+    }
+
+    /// Call f(i, j, k, value) for every node of every stored brick that lies
+    /// inside the grid. Bricks are visited in storage order (x fastest over
+    /// the brick grid), nodes within a brick with x fastest.
+    template <class F>
+    void forEachActive(F&& f) const {
+        for (size_t b = 0; b < bricks_.size(); ++b) {
+            const glm::uvec3 base = bricks_[b] * kBrickSize;
+            const glm::uvec3 end = glm::min(base + kBrickSize, dims_);
+            const float* brick = values_.data() + b * kBrickVolume;
+            for (uint32_t k = base.z; k < end.z; ++k) {
+                for (uint32_t j = base.y; j < end.y; ++j) {
+                    for (uint32_t i = base.x; i < end.x; ++i) {
+                        f(i, j, k, brick[localOf(i, j, k)]);
+                    }
+                }
+            }
+        }
+    }
+
+    const glm::uvec3& dims() const { return dims_; }
+    const glm::vec3& boundLow() const { return boundLow_; }
+    const glm::vec3& boundHigh() const { return boundHigh_; }
+    float bandWidth() const { return bandWidth_; }
+
+    /// Number of bricks along each axis
+    const glm::uvec3& brickDims() const { return brickDims_; }
+
+    /// Brick coordinates of the stored bricks, in storage order
+    const std::vector<glm::uvec3>& activeBricks() const { return bricks_; }
+
+    /// Number of nodes reported by forEachActive()
+    size_t activeCount() const;
+
+    /// Bytes held by the index, the inactive-brick bounds and the bricks
+    size_t memoryBytes() const;
+
+    /// Number of SDF evaluations performed by build()
+    size_t evaluations() const { return evaluations_; }
+
+private:
+    size_t brickOf(uint32_t i, uint32_t j, uint32_t k) const {
+        return (i / kBrickSize) + brickDims_.x * (static_cast<size_t>(j / kBrickSize) +
+                                                  static_cast<size_t>(brickDims_.y) * (k / kBrickSize));
+    }
+
+    static uint32_t localOf(uint32_t i, uint32_t j, uint32_t k) {
+        return (i % kBrickSize) + kBrickSize * ((j % kBrickSize) + kBrickSize * (k % kBrickSize));
+    }
+
+    glm::uvec3 dims_ = glm::uvec3(0);
+    glm::uvec3 brickDims_ = glm::uvec3(0);
+    glm::vec3 boundLow_ = glm::vec3(0.0f);
+    glm::vec3 boundHigh_ = glm::vec3(0.0f);
+    float bandWidth_ = 0.0f;
+    std::vector<uint32_t> index_;     // Per brick: position in bricks_, or kInactive
+    std::vector<float> fill_;         // Per brick: conservative value of an inactive brick
+    std::vector<glm::uvec3> bricks_;  // Stored bricks, in storage order
+    std::vector<float> values_;       // kBrickVolume values per stored brick
+    size_t evaluations_ = 0;
+};
+
+} // namespace sdf
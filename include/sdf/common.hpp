@@ -9,9 +9,14 @@
 #include <glm/gtx/component_wise.hpp>
 #include <glm/gtx/norm.hpp>
 
+#if defined(SDF_FAST_MATH)
+#include "fastmath.hpp"
+#endif
+
 #include <algorithm>
 #include <cmath>
 #include <cstdint>
+#include <type_traits>
 
 namespace sdf {
 
@@ -35,6 +40,315 @@ using ivec3 = glm::ivec3;
 constexpr float pi = 3.14159265358979323846f;
 constexpr float twopi = 2.0f * pi;
 
+// ============================================================================
+// Scalar-generic vectors
+//
+// Shapes written as templates over their vector type compile for plain floats
+// (V = glm::vec3) and for the lane types in pack.hpp (several points at once)
+// and interval.hpp (bounds over a box). Lane types are used through the small
+// Vec2/Vec3 below. Comparing lane values yields a mask rather than a bool, so
+// generic code branches with select()/any() instead of if and ?:.
+// ============================================================================
+
+/// True for scalar types that stand in for float in generic shape code.
+template <class T>
+struct is_lane : std::false_type {};
+
+template <class T>
+struct Vec2 {
+    typedef T value_type;
+    T x, y;
+
+    Vec2() = default;
+    explicit Vec2(T s) : x(s), y(s) {}
+    Vec2(T x_, T y_) : x(x_), y(y_) {}
+
+    friend Vec2 operator+(const Vec2& a, const Vec2& b) { return Vec2(a.x + b.x, a.y + b.y); }
+    friend Vec2 operator-(const Vec2& a, const Vec2& b) { return Vec2(a.x - b.x, a.y - b.y); }
+    friend Vec2 operator*(const Vec2& a, const Vec2& b) { return Vec2(a.x * b.x, a.y * b.y); }
+    friend Vec2 operator/(const Vec2& a, const Vec2& b) { return Vec2(a.x / b.x, a.y / b.y); }
+    friend Vec2 operator+(const Vec2& a, T s) { return Vec2(a.x + s, a.y + s); }
+    friend Vec2 operator-(const Vec2& a, T s) { return Vec2(a.x - s, a.y - s); }
+    friend Vec2 operator*(const Vec2& a, T s) { return Vec2(a.x * s, a.y * s); }
+    friend Vec2 operator/(const Vec2& a, T s) { return Vec2(a.x / s, a.y / s); }
+    friend Vec2 operator+(T s, const Vec2& a) { return Vec2(s + a.x, s + a.y); }
+    friend Vec2 operator-(T s, const Vec2& a) { return Vec2(s - a.x, s - a.y); }
+    friend Vec2 operator*(T s, const Vec2& a) { return Vec2(s * a.x, s * a.y); }
+    friend Vec2 operator-(const Vec2& a) { return Vec2(-a.x, -a.y); }
+
+    Vec2& operator+=(const Vec2& b) { return *this = *this + b; }
+    Vec2& operator-=(const Vec2& b) { return *this = *this - b; }
+    Vec2& operator*=(const Vec2& b) { return *this = *this * b; }
+    Vec2& operator+=(T s) { return *this = *this + s; }
+    Vec2& operator-=(T s) { return *this = *this - s; }
+    Vec2& operator*=(T s) { return *this = *this * s; }
+    Vec2& operator/=(T s) { return *this = *this / s; }
+};
+
+template <class T>
+struct Vec3 {
+    typedef T value_type;
+    T x, y, z;
+
+    Vec3() = default;
+    explicit Vec3(T s) : x(s), y(s), z(s) {}
+    Vec3(T x_, T y_, T z_) : x(x_), y(y_), z(z_) {}
+
+    friend Vec3 operator+(const Vec3& a, const Vec3& b) { return Vec3(a.x + b.x, a.y + b.y, a.z + b.z); }
+    friend Vec3 operator-(const Vec3& a, const Vec3& b) { return Vec3(a.x - b.x, a.y - b.y, a.z - b.z); }
+    friend Vec3 operator*(const Vec3& a, const Vec3& b) { return Vec3(a.x * b.x, a.y * b.y, a.z * b.z); }
+    friend Vec3 operator/(const Vec3& a, const Vec3& b) { return Vec3(a.x / b.x, a.y / b.y, a.z / b.z); }
+    friend Vec3 operator+(const Vec3& a, T s) { return Vec3(a.x + s, a.y + s, a.z + s); }
+    friend Vec3 operator-(const Vec3& a, T s) { return Vec3(a.x - s, a.y - s, a.z - s); }
+    friend Vec3 operator*(const Vec3& a, T s) { return Vec3(a.x * s, a.y * s, a.z * s); }
+    friend Vec3 operator/(const Vec3& a, T s) { return Vec3(a.x / s, a.y / s, a.z / s); }
+    friend Vec3 operator+(T s, const Vec3& a) { return Vec3(s + a.x, s + a.y, s + a.z); }
+    friend Vec3 operator-(T s, const Vec3& a) { return Vec3(s - a.x, s - a.y, s - a.z); }
+    friend Vec3 operator*(T s, const Vec3& a) { return Vec3(s * a.x, s * a.y, s * a.z); }
+    friend Vec3 operator-(const Vec3& a) { return Vec3(-a.x, -a.y, -a.z); }
+
+    Vec3& operator+=(const Vec3& b) { return *this = *this + b; }
+    Vec3& operator-=(const Vec3& b) { return *this = *this - b; }
+    Vec3& operator*=(const Vec3& b) { return *this = *this * b; }
+    Vec3& operator+=(T s) { return *this = *this + s; }
+    Vec3& operator-=(T s) { return *this = *this - s; }
+    Vec3& operator*=(T s) { return *this = *this * s; }
+    Vec3& operator/=(T s) { return *this = *this / s; }
+};
+
+/// Holds GLSL vec4 results (distance plus material data); no arithmetic.
+template <class T>
+struct Vec4 {
+    typedef T value_type;
+    T x, y, z, w;
+
+    Vec4() = default;
+    explicit Vec4(T s) : x(s), y(s), z(s), w(s) {}
+    Vec4(T x_, T y_, T z_, T w_) : x(x_), y(y_), z(z_), w(w_) {}
+};
+
+namespace detail {
+    template <class T> struct VecTypes { using vec2 = Vec2<T>; using vec3 = Vec3<T>; using vec4 = Vec4<T>; };
+    template <> struct VecTypes<float> { using vec2 = glm::vec2; using vec3 = glm::vec3; using vec4 = glm::vec4; };
+
+    // Blocks template argument deduction so the argument converts to T
+    template <class T> struct Identity { using type = T; };
+    template <class T> using identity_t = typename Identity<T>::type;
+}
+
+/// 2-, 3- and 4-component vectors of T: glm's for float, Vec2/Vec3/Vec4 for lane types.
+template <class T> using vec2_t = typename detail::VecTypes<T>::vec2;
+template <class T> using vec3_t = typename detail::VecTypes<T>::vec3;
+template <class T> using vec4_t = typename detail::VecTypes<T>::vec4;
+
+/// Component type of a vector (float for glm vectors).
+template <class V> using scalar_t = typename V::value_type;
+
+/// Enables a helper only for lane types, leaving the float overloads alone.
+template <class T> using enable_if_lane = std::enable_if_t<is_lane<T>::value, int>;
+
+// Float counterparts of the lane mask operations, so generic code can write
+// select(c, a, b), any(c) and all(c) whatever the scalar type
+inline bool any(bool c) { return c; }
+inline bool all(bool c) { return c; }
+inline float select(bool c, float a, float b) { return c ? a : b; }
+inline vec2 select(bool c, const vec2& a, const vec2& b) { return c ? a : b; }
+inline vec3 select(bool c, const vec3& a, const vec3& b) { return c ? a : b; }
+inline vec4 select(bool c, const vec4& a, const vec4& b) { return c ? a : b; }
+
+template <class M, class T>
+inline Vec2<T> select(const M& c, const Vec2<T>& a, const Vec2<T>& b) {
+    return Vec2<T>(select(c, a.x, b.x), select(c, a.y, b.y));
+}
+
+template <class M, class T>
+inline Vec3<T> select(const M& c, const Vec3<T>& a, const Vec3<T>& b) {
+    return Vec3<T>(select(c, a.x, b.x), select(c, a.y, b.y), select(c, a.z, b.z));
+}
+
+template <class M, class T>
+inline Vec4<T> select(const M& c, const Vec4<T>& a, const Vec4<T>& b) {
+    return Vec4<T>(select(c, a.x, b.x), select(c, a.y, b.y), select(c, a.z, b.z), select(c, a.w, b.w));
+}
+
+// Componentwise functions, matching glm's operation order
+template <class T>
+inline T dot(const Vec2<T>& a, const Vec2<T>& b) {
+    return a.x * b.x + a.y * b.y;
+}
+
+template <class T>
+inline T dot(const Vec3<T>& a, const Vec3<T>& b) {
+    return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+// glm sums the four products pairwise
+template <class T>
+inline T dot(const Vec4<T>& a, const Vec4<T>& b) {
+    return (a.x * b.x + a.y * b.y) + (a.z * b.z + a.w * b.w);
+}
+
+// Against a constant float vector
+template <class T>
+inline T dot(const Vec2<T>& a, const vec2& b) {
+    return a.x * b.x + a.y * b.y;
+}
+
+template <class T>
+inline T dot(const Vec3<T>& a, const vec3& b) {
+    return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+template <class T>
+inline T length(const Vec2<T>& v) {
+    return sqrt(dot(v, v));
+}
+
+template <class T>
+inline T length(const Vec3<T>& v) {
+    return sqrt(dot(v, v));
+}
+
+template <class T>
+inline Vec3<T> normalize(const Vec3<T>& v) {
+    return v * (T(1.0f) / sqrt(dot(v, v)));
+}
+
+template <class T>
+inline Vec2<T> normalize(const Vec2<T>& v) {
+    return v * (T(1.0f) / sqrt(dot(v, v)));
+}
+
+template <class T>
+inline Vec3<T> cross(const Vec3<T>& a, const Vec3<T>& b) {
+    return Vec3<T>(a.y * b.z - b.y * a.z, a.z * b.x - b.z * a.x, a.x * b.y - b.x * a.y);
+}
+
+template <class T>
+inline T distance(const Vec2<T>& a, const Vec2<T>& b) {
+    return length(b - a);
+}
+
+template <class T>
+inline T distance(const Vec3<T>& a, const Vec3<T>& b) {
+    return length(b - a);
+}
+
+// Constant column-major float matrices times a lane vector
+template <class T>
+inline Vec2<T> operator*(const mat2& m, const Vec2<T>& v) {
+    return Vec2<T>(m[0][0] * v.x + m[1][0] * v.y, m[0][1] * v.x + m[1][1] * v.y);
+}
+
+template <class T>
+inline Vec3<T> operator*(const mat3& m, const Vec3<T>& v) {
+    return Vec3<T>(
+        m[0][0] * v.x + m[1][0] * v.y + m[2][0] * v.z,
+        m[0][1] * v.x + m[1][1] * v.y + m[2][1] * v.z,
+        m[0][2] * v.x + m[1][2] * v.y + m[2][2] * v.z
+    );
+}
+
+// Lane vector times a constant matrix (the transpose applied to v)
+template <class T>
+inline Vec3<T> operator*(const Vec3<T>& v, const mat3& m) {
+    return Vec3<T>(
+        m[0][0] * v.x + m[0][1] * v.y + m[0][2] * v.z,
+        m[1][0] * v.x + m[1][1] * v.y + m[1][2] * v.z,
+        m[2][0] * v.x + m[2][1] * v.y + m[2][2] * v.z
+    );
+}
+
+template <class T>
+inline Vec2<T> abs(const Vec2<T>& v) {
+    return Vec2<T>(abs(v.x), abs(v.y));
+}
+
+template <class T>
+inline Vec3<T> abs(const Vec3<T>& v) {
+    return Vec3<T>(abs(v.x), abs(v.y), abs(v.z));
+}
+
+template <class T>
+inline Vec2<T> min(const Vec2<T>& a, const Vec2<T>& b) {
+    return Vec2<T>(min(a.x, b.x), min(a.y, b.y));
+}
+
+template <class T>
+inline Vec3<T> min(const Vec3<T>& a, const Vec3<T>& b) {
+    return Vec3<T>(min(a.x, b.x), min(a.y, b.y), min(a.z, b.z));
+}
+
+template <class T>
+inline Vec2<T> max(const Vec2<T>& a, const Vec2<T>& b) {
+    return Vec2<T>(max(a.x, b.x), max(a.y, b.y));
+}
+
+template <class T>
+inline Vec3<T> max(const Vec3<T>& a, const Vec3<T>& b) {
+    return Vec3<T>(max(a.x, b.x), max(a.y, b.y), max(a.z, b.z));
+}
+
+template <class T>
+inline Vec3<T> clamp(const Vec3<T>& v, detail::identity_t<T> lo, detail::identity_t<T> hi) {
+    return Vec3<T>(clamp(v.x, lo, hi), clamp(v.y, lo, hi), clamp(v.z, lo, hi));
+}
+
+template <class T>
+inline Vec2<T> sign(const Vec2<T>& v) {
+    return Vec2<T>(sign(v.x), sign(v.y));
+}
+
+template <class T>
+inline Vec3<T> sign(const Vec3<T>& v) {
+    return Vec3<T>(sign(v.x), sign(v.y), sign(v.z));
+}
+
+template <class T>
+inline Vec2<T> floor(const Vec2<T>& v) {
+    return Vec2<T>(floor(v.x), floor(v.y));
+}
+
+template <class T>
+inline Vec3<T> floor(const Vec3<T>& v) {
+    return Vec3<T>(floor(v.x), floor(v.y), floor(v.z));
+}
+
+template <class T>
+inline Vec2<T> round(const Vec2<T>& v) {
+    return Vec2<T>(round(v.x), round(v.y));
+}
+
+template <class T>
+inline Vec2<T> mix(const Vec2<T>& a, const Vec2<T>& b, detail::identity_t<T> t) {
+    return a * (T(1.0f) - t) + b * t;
+}
+
+template <class T>
+inline Vec3<T> mix(const Vec3<T>& a, const Vec3<T>& b, detail::identity_t<T> t) {
+    return a * (T(1.0f) - t) + b * t;
+}
+
+template <class T>
+inline Vec2<T> sin(const Vec2<T>& v) {
+    return Vec2<T>(sin(v.x), sin(v.y));
+}
+
+template <class T>
+inline Vec3<T> sin(const Vec3<T>& v) {
+    return Vec3<T>(sin(v.x), sin(v.y), sin(v.z));
+}
+
+template <class T>
+inline Vec2<T> cos(const Vec2<T>& v) {
+    return Vec2<T>(cos(v.x), cos(v.y));
+}
+
+template <class T>
+inline Vec3<T> cos(const Vec3<T>& v) {
+    return Vec3<T>(cos(v.x), cos(v.y), cos(v.z));
+}
+
 // ============================================================================
 // GLSL built-in functions (those not directly available in glm)
 // ============================================================================
@@ -52,6 +366,21 @@ inline vec3 fract(const vec3& v) {
     return vec3(fract(v.x), fract(v.y), fract(v.z));
 }
 
+template <class T, enable_if_lane<T> = 0>
+inline T fract(const T& x) {
+    return x - floor(x);
+}
+
+template <class T>
+inline Vec2<T> fract(const Vec2<T>& v) {
+    return Vec2<T>(fract(v.x), fract(v.y));
+}
+
+template <class T>
+inline Vec3<T> fract(const Vec3<T>& v) {
+    return Vec3<T>(fract(v.x), fract(v.y), fract(v.z));
+}
+
 // mod - modulo (GLSL-style, handles negatives differently than C++ %)
 inline float mod(float x, float y) {
     return x - y * std::floor(x / y);
@@ -73,6 +402,16 @@ inline vec3 mod(const vec3& v, const vec3& y) {
     return vec3(mod(v.x, y.x), mod(v.y, y.y), mod(v.z, y.z));
 }
 
+template <class T, enable_if_lane<T> = 0>
+inline T mod(const T& x, detail::identity_t<T> y) {
+    return x - y * floor(x / y);
+}
+
+template <class T>
+inline Vec3<T> mod(const Vec3<T>& v, float y) {
+    return Vec3<T>(mod(v.x, y), mod(v.y, y), mod(v.z, y));
+}
+
 // mix - linear interpolation (glm has this but we provide convenient overloads)
 using glm::mix;
 
@@ -103,6 +442,11 @@ inline vec3 step(float edge, const vec3& x) {
     return vec3(step(edge, x.x), step(edge, x.y), step(edge, x.z));
 }
 
+template <class T, enable_if_lane<T> = 0>
+inline T step(detail::identity_t<T> edge, const T& x) {
+    return select(x < edge, T(0.0f), T(1.0f));
+}
+
 // sign
 using std::copysign;
 
@@ -176,11 +520,13 @@ inline vec3 ceil(const vec3& v) {
     return glm::ceil(v);
 }
 
-// sqrt, pow, exp, log
+// sqrt, pow, exp, log, exp2, log2
 using std::sqrt;
 using std::pow;
 using std::exp;
 using std::log;
+using std::exp2;
+using std::log2;
 
 inline vec2 sqrt(const vec2& v) {
     return glm::sqrt(v);
@@ -222,9 +568,44 @@ inline vec3 cos(const vec3& v) {
     return glm::cos(v);
 }
 
+// Approximated transcendental functions
+//
+// The polynomial approximations in fastmath.hpp in the fast-math build (the
+// SDF_FAST_MATH CMake option) and libm otherwise. A shape opts in with
+// using-declarations in its detail namespace (`using approx::exp;`) once the
+// error this introduces into its distance has been bounded in
+// src/error_bound.cpp; every other shape calls libm in both builds. Only the
+// float instantiation is affected: the lane types keep their own overloads,
+// which argument-dependent lookup still finds.
+namespace approx {
+#if defined(SDF_FAST_MATH)
+using fast::sin;
+using fast::cos;
+using fast::tan;
+using fast::asin;
+using fast::acos;
+using fast::atan;
+using fast::atan2;
+using fast::exp;
+using fast::log;
+using fast::pow;
+#else
+using std::sin;
+using std::cos;
+using std::tan;
+using std::asin;
+using std::acos;
+using std::atan;
+using std::atan2;
+using std::exp;
+using std::log;
+using std::pow;
+#endif
+} // namespace approx
+
 // atan with two arguments (GLSL-style)
 inline float atan(float y, float x) {
-    return std::atan2(y, x);
+    return atan2(y, x);
 }
 
 // ============================================================================
@@ -232,13 +613,15 @@ inline float atan(float y, float x) {
 // ============================================================================
 
 // Smooth minimum (polynomial)
-inline float smin(float a, float b, float k) {
-    float h = clamp(0.5f + 0.5f * (b - a) / k, 0.0f, 1.0f);
+template <class T>
+inline T smin(T a, T b, detail::identity_t<T> k) {
+    T h = clamp(0.5f + 0.5f * (b - a) / k, T(0.0f), T(1.0f));
     return mix(b, a, h) - k * h * (1.0f - h);
 }
 
 // Smooth maximum
-inline float smax(float a, float b, float k) {
+template <class T>
+inline T smax(T a, T b, detail::identity_t<T> k) {
     return -smin(-a, -b, k);
 }
 
@@ -271,15 +654,24 @@ inline float hash11(float p) {
     return fract(p);
 }
 
+template <class T, enable_if_lane<T> = 0>
+inline T hash11(T p) {
+    p = fract(p * 0.1031f);
+    p *= p + 33.33f;
+    p *= p + p;
+    return fract(p);
+}
+
 inline float hash12(const vec2& p) {
     vec3 p3 = fract(vec3(p.x, p.y, p.x) * 0.1031f);
     p3 += dot(p3, vec3(p3.y, p3.z, p3.x) + 33.33f);
     return fract((p3.x + p3.y) * p3.z);
 }
 
-inline float hash13(const vec3& p3) {
-    vec3 p = fract(p3 * 0.1031f);
-    p += dot(p, vec3(p.y, p.z, p.x) + 33.33f);
+template <class V>
+inline scalar_t<V> hash13(const V& p3) {
+    V p = fract(p3 * 0.1031f);
+    p += dot(p, V(p.y, p.z, p.x) + 33.33f);
     return fract((p.x + p.y) * p.z);
 }
 
@@ -329,29 +721,31 @@ inline float valueNoise2D(const vec2& p) {
 }
 
 // Value noise 3D
-inline float valueNoise3D(const vec3& p) {
-    vec3 i = floor(p);
-    vec3 f = fract(p);
+template <class V>
+inline scalar_t<V> valueNoise3D(const V& p) {
+    using T = scalar_t<V>;
+    V i = floor(p);
+    V f = fract(p);
     
     // Cubic Hermite interpolation
-    vec3 u = f * f * (3.0f - 2.0f * f);
+    V u = f * f * (3.0f - 2.0f * f);
     
-    float n000 = hash13(i);
-    float n100 = hash13(i + vec3(1.0f, 0.0f, 0.0f));
-    float n010 = hash13(i + vec3(0.0f, 1.0f, 0.0f));
-    float n110 = hash13(i + vec3(1.0f, 1.0f, 0.0f));
-    float n001 = hash13(i + vec3(0.0f, 0.0f, 1.0f));
-    float n101 = hash13(i + vec3(1.0f, 0.0f, 1.0f));
-    float n011 = hash13(i + vec3(0.0f, 1.0f, 1.0f));
-    float n111 = hash13(i + vec3(1.0f, 1.0f, 1.0f));
+    T n000 = hash13(i);
+    T n100 = hash13(i + V(1.0f, 0.0f, 0.0f));
+    T n010 = hash13(i + V(0.0f, 1.0f, 0.0f));
+    T n110 = hash13(i + V(1.0f, 1.0f, 0.0f));
+    T n001 = hash13(i + V(0.0f, 0.0f, 1.0f));
+    T n101 = hash13(i + V(1.0f, 0.0f, 1.0f));
+    T n011 = hash13(i + V(0.0f, 1.0f, 1.0f));
+    T n111 = hash13(i + V(1.0f, 1.0f, 1.0f));
     
-    float n00 = mix(n000, n100, u.x);
-    float n10 = mix(n010, n110, u.x);
-    float n01 = mix(n001, n101, u.x);
-    float n11 = mix(n011, n111, u.x);
+    T n00 = mix(n000, n100, u.x);
+    T n10 = mix(n010, n110, u.x);
+    T n01 = mix(n001, n101, u.x);
+    T n11 = mix(n011, n111, u.x);
     
-    float n0 = mix(n00, n10, u.y);
-    float n1 = mix(n01, n11, u.y);
+    T n0 = mix(n00, n10, u.y);
+    T n1 = mix(n01, n11, u.y);
     
     return mix(n0, n1, u.z);
 }
@@ -372,10 +766,11 @@ inline float fbm2D(const vec2& p, int octaves = 4) {
 }
 
 // FBM 3D - 4 octaves
-inline float fbm3D(const vec3& p, int octaves = 4) {
-    float value = 0.0f;
+template <class V>
+inline scalar_t<V> fbm3D(const V& p, int octaves = 4) {
+    scalar_t<V> value(0.0f);
     float amplitude = 0.5f;
-    vec3 freq = p;
+    V freq = p;
     
     for (int i = 0; i < octaves; i++) {
         value += amplitude * valueNoise3D(freq);
@@ -409,13 +804,15 @@ inline vec3 fbm13(float x, float g, int octaves = 6) {
 }
 
 // Linear step (used in various SDFs)
-inline float linearstep(float a, float b, float x) {
-    return clamp((x - a) / (b - a), 0.0f, 1.0f);
+template <class T>
+inline T linearstep(float a, float b, T x) {
+    return clamp((x - a) / (b - a), T(0.0f), T(1.0f));
 }
 
 // Saturate (clamp to [0,1])
-inline float saturate(float x) {
-    return clamp(x, 0.0f, 1.0f);
+template <class T>
+inline T saturate(T x) {
+    return clamp(x, T(0.0f), T(1.0f));
 }
 
 inline vec3 saturate(const vec3& v) {
@@ -0,0 +1,147 @@
+#pragma once
+
+// Forward-mode automatic differentiation for scalar-generic shapes.
+//
+// A Dual carries a value together with its gradient with respect to the query
+// point. Instantiating a templated shape with V = Vec3<Dual>, seeded with the
+// unit vectors as the gradients of x, y and z, returns the distance and its
+// gradient in a single pass. Values are computed with the same float
+// operations as the float instantiation, so they match it exactly.
+//
+// Comparisons compare values and return bool. At points where the code is not
+// differentiable (abs at 0, the crease of min/max) the gradient of the branch
+// taken is returned.
+
+#include "common.hpp"
+
+#include <cmath>
+
+namespace sdf {
+
+/// Value and gradient (d/dx, d/dy, d/dz of the query point).
+///
+/// The partials are kept as separate floats so that the arithmetic compiles
+/// to plain scalar code.
+struct Dual {
+    float v;
+    float dx, dy, dz;
+
+    Dual() = default;
+    Dual(float value) : v(value), dx(0.0f), dy(0.0f), dz(0.0f) {}
+    Dual(float value, float dx_, float dy_, float dz_) : v(value), dx(dx_), dy(dy_), dz(dz_) {}
+    Dual(float value, const glm::vec3& gradient)
+        : v(value), dx(gradient.x), dy(gradient.y), dz(gradient.z) {}
+
+    glm::vec3 gradient() const { return glm::vec3(dx, dy, dz); }
+
+    friend Dual operator+(const Dual& a, const Dual& b) {
+        return Dual(a.v + b.v, a.dx + b.dx, a.dy + b.dy, a.dz + b.dz);
+    }
+    friend Dual operator-(const Dual& a, const Dual& b) {
+        return Dual(a.v - b.v, a.dx - b.dx, a.dy - b.dy, a.dz - b.dz);
+    }
+    friend Dual operator-(const Dual& a) { return Dual(-a.v, -a.dx, -a.dy, -a.dz); }
+
+    friend Dual operator*(const Dual& a, const Dual& b) {
+        return Dual(a.v * b.v, a.dx * b.v + b.dx * a.v, a.dy * b.v + b.dy * a.v, a.dz * b.v + b.dz * a.v);
+    }
+
+    friend Dual operator/(const Dual& a, const Dual& b) {
+        const float q = a.v / b.v;
+        const float r = 1.0f / b.v;
+        return Dual(q, (a.dx - b.dx * q) * r, (a.dy - b.dy * q) * r, (a.dz - b.dz * q) * r);
+    }
+
+    Dual& operator+=(const Dual& b) { return *this = *this + b; }
+    Dual& operator-=(const Dual& b) { return *this = *this - b; }
+    Dual& operator*=(const Dual& b) { return *this = *this * b; }
+    Dual& operator/=(const Dual& b) { return *this = *this / b; }
+
+    friend bool operator<(const Dual& a, const Dual& b) { return a.v < b.v; }
+    friend bool operator<=(const Dual& a, const Dual& b) { return a.v <= b.v; }
+    friend bool operator>(const Dual& a, const Dual& b) { return a.v > b.v; }
+    friend bool operator>=(const Dual& a, const Dual& b) { return a.v >= b.v; }
+
+    friend Dual select(bool c, const Dual& a, const Dual& b) { return c ? a : b; }
+
+    // Same tie-breaking as glm::min/max
+    friend Dual min(const Dual& a, const Dual& b) { return b.v < a.v ? b : a; }
+    friend Dual max(const Dual& a, const Dual& b) { return a.v < b.v ? b : a; }
+    friend Dual clamp(const Dual& x, const Dual& lo, const Dual& hi) { return min(max(x, lo), hi); }
+
+    friend Dual abs(const Dual& a) { return a.v < 0.0f ? -a : Dual(std::abs(a.v), a.dx, a.dy, a.dz); }
+    friend Dual sign(const Dual& a) { return Dual(a.v > 0.0f ? 1.0f : (a.v < 0.0f ? -1.0f : 0.0f)); }
+
+    friend Dual mix(const Dual& x, const Dual& y, const Dual& a) { return x * (1.0f - a) + y * a; }
+
+    friend Dual smoothstep(const Dual& e0, const Dual& e1, const Dual& x) {
+        Dual t = clamp((x - e0) / (e1 - e0), 0.0f, 1.0f);
+        return t * t * (3.0f - 2.0f * t);
+    }
+
+    friend Dual sqrt(const Dual& a) {
+        const float r = std::sqrt(a.v);
+        return chain(a, r, r > 0.0f ? 0.5f / r : 0.0f);
+    }
+
+    friend Dual floor(const Dual& a) { return Dual(std::floor(a.v)); }
+    friend Dual ceil(const Dual& a) { return Dual(std::ceil(a.v)); }
+    friend Dual round(const Dual& a) { return Dual(std::round(a.v)); }
+
+    friend Dual exp(const Dual& a) {
+        const float e = std::exp(a.v);
+        return chain(a, e, e);
+    }
+
+    friend Dual log(const Dual& a) { return chain(a, std::log(a.v), 1.0f / a.v); }
+
+    friend Dual exp2(const Dual& a) {
+        const float e = std::exp2(a.v);
+        return chain(a, e, e * 0.69314718f);
+    }
+
+    friend Dual log2(const Dual& a) { return chain(a, std::log2(a.v), 1.0f / (a.v * 0.69314718f)); }
+
+    friend Dual sin(const Dual& a) { return chain(a, std::sin(a.v), std::cos(a.v)); }
+    friend Dual cos(const Dual& a) { return chain(a, std::cos(a.v), -std::sin(a.v)); }
+
+    friend Dual tan(const Dual& a) {
+        const float t = std::tan(a.v);
+        return chain(a, t, 1.0f + t * t);
+    }
+
+    friend Dual asin(const Dual& a) {
+        return chain(a, std::asin(a.v), 1.0f / std::sqrt(1.0f - a.v * a.v));
+    }
+
+    friend Dual acos(const Dual& a) {
+        return chain(a, std::acos(a.v), -1.0f / std::sqrt(1.0f - a.v * a.v));
+    }
+
+    friend Dual atan(const Dual& a) { return chain(a, std::atan(a.v), 1.0f / (1.0f + a.v * a.v)); }
+
+    friend Dual atan2(const Dual& y, const Dual& x) {
+        const float r2 = x.v * x.v + y.v * y.v;
+        const float sx = r2 > 0.0f ? -y.v / r2 : 0.0f;
+        const float sy = r2 > 0.0f ? x.v / r2 : 0.0f;
+        return Dual(std::atan2(y.v, x.v), y.dx * sy + x.dx * sx, y.dy * sy + x.dy * sx, y.dz * sy + x.dz * sx);
+    }
+
+    friend Dual pow(const Dual& a, const Dual& b) {
+        const float p = std::pow(a.v, b.v);
+        const float sa = a.v != 0.0f ? b.v * p / a.v : 0.0f;
+        const float sb = a.v > 0.0f ? p * std::log(a.v) : 0.0f;
+        return Dual(p, a.dx * sa + b.dx * sb, a.dy * sa + b.dy * sb, a.dz * sa + b.dz * sb);
+    }
+
+private:
+    // f(a) given the value f(a.v) and the derivative f'(a.v)
+    static Dual chain(const Dual& a, float value, float slope) {
+        return Dual(value, a.dx * slope, a.dy * slope, a.dz * slope);
+    }
+};
+
+template <>
+struct is_lane<Dual> : std::true_type {};
+
+} // namespace sdf
@@ -0,0 +1,264 @@
+#pragma once
+
+// Polynomial approximations of the transcendental functions used by the SDFs.
+//
+// The SDF_FAST_MATH CMake option defines SDF_FAST_MATH, and the functions
+// in sdf::approx (common.hpp) then resolve to these instead of libm for the
+// shapes that opt in to them. Each is a short sequence (range reduction, then
+// a minimax polynomial) in which every operation is unconditional and special
+// cases are picked with selects, so loops over it vectorize once the compiler
+// may ignore floating-point exceptions and errno (-fno-trapping-math
+// -fno-math-errno, as that option builds the library). Maximum errors over
+// the stated ranges, measured against double-precision libm:
+//
+//   sin, cos   |x| <= 8192   absolute 1e-7
+//   tan        |x| <= 1.4    relative 3e-7
+//   atan       all x         relative 2.1e-7
+//   atan2      all y, x      absolute 3e-7
+//   asin, acos [-1, 1]       absolute 3e-7
+//   exp        [-87, 88]     relative 2e-7 (subnormal results down to -104)
+//   log        x > 0         relative 1e-7 (absolute 1e-7 near 1)
+//   pow        x > 0         relative 1e-7 * (1 + |y log x|)
+//
+// Larger sin/cos arguments are reduced less accurately (the hash functions
+// of some shapes rely on this only for determinism, not accuracy). pow of a
+// negative base is defined for integral exponents, as in libm.
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+namespace sdf::fast {
+
+namespace detail {
+
+inline uint32_t bits(float x) {
+    uint32_t u;
+    std::memcpy(&u, &x, sizeof(u));
+    return u;
+}
+
+inline float fromBits(uint32_t u) {
+    float x;
+    std::memcpy(&x, &u, sizeof(x));
+    return x;
+}
+
+constexpr float kPi = 3.14159265358979323846f;
+constexpr float kHalfPi = 1.57079632679489661923f;
+constexpr float kQuarterPi = 0.78539816339744830962f;
+
+// pi/2 split into three parts for Cody-Waite range reduction
+constexpr float kHalfPiA = 1.5703125f;
+constexpr float kHalfPiB = 4.83751296997070312500e-4f;
+constexpr float kHalfPiC = 7.54978995489188216e-8f;
+
+// sin and cos on [-pi/4, pi/4]
+inline float sinPoly(float r) {
+    const float z = r * r;
+    return r + r * z * (-1.6666654611e-1f + z * (8.3321608736e-3f + z * -1.9515295891e-4f));
+}
+
+inline float cosPoly(float r) {
+    const float z = r * r;
+    return 1.0f - 0.5f * z
+        + z * z * (4.166664568298827e-2f + z * (-1.388731625493765e-3f + z * 2.443315711809948e-5f));
+}
+
+// Round to the nearest integer for |x| < 2^22 by adding and subtracting
+// 1.5 * 2^23, which leaves no fractional bits
+inline float roundNearest(float x) {
+    return (x + 12582912.0f) - 12582912.0f;
+}
+
+// Reduce x to r in [-pi/4, pi/4] with x = r + quadrant * pi/2
+inline float reduce(float x, int32_t& quadrant) {
+    float t = x * (2.0f / kPi);
+    t = t < -4.0e6f ? -4.0e6f : (t > 4.0e6f ? 4.0e6f : t);
+    const float k = roundNearest(t);
+    quadrant = static_cast<int32_t>(k);
+    return ((x - k * kHalfPiA) - k * kHalfPiB) - k * kHalfPiC;
+}
+
+// atan on [0, tan(pi/8)]
+inline float atanPoly(float x) {
+    const float z = x * x;
+    return x + x * z * (-3.33329491539e-1f + z * (1.99777106478e-1f + z * (-1.38776856032e-1f + z * 8.05374449538e-2f)));
+}
+
+// asin on [0, 0.5]
+inline float asinPoly(float x) {
+    const float z = x * x;
+    return x + x * z * (1.6666752422e-1f + z * (7.4953002686e-2f + z * (4.5470025998e-2f + z * (2.4181311049e-2f + z * 4.2163199048e-2f))));
+}
+
+// e^r for r in [-ln(2)/2, ln(2)/2]
+inline float expPoly(float r) {
+    const float z = r * r;
+    return 1.0f + r + z * (5.0000001201e-1f + r * (1.6666665459e-1f + r * (4.1665795894e-2f
+        + r * (8.3334519073e-3f + r * (1.3981999507e-3f + r * 1.9875691500e-4f)))));
+}
+
+// Natural log of m in [sqrt(1/2), sqrt(2))
+inline float logMantissa(float m) {
+    const float f = m - 1.0f;
+    const float z = f * f;
+    const float poly = 3.3333331174e-1f + f * (-2.4999993993e-1f + f * (2.0000714765e-1f
+        + f * (-1.6668057665e-1f + f * (1.4249322787e-1f + f * (-1.2420140846e-1f
+        + f * (1.1676998740e-1f + f * (-1.1514610310e-1f + f * 7.0376836292e-2f)))))));
+    return f + f * z * poly - 0.5f * z;
+}
+
+// ln(2) split in two for Cody-Waite range reduction
+constexpr float kLn2A = 0.693359375f;
+constexpr float kLn2B = -2.12194440e-4f;
+
+constexpr float kExpMax = 88.7228394f;   // largest x with a finite e^x
+constexpr float kExpMin = -103.972084f;  // smallest x with a nonzero e^x
+
+// e^x for x in [kExpMin, kExpMax]; arguments outside are clamped
+inline float expCore(float x) {
+    constexpr float kLog2e = 1.44269504088896341f;
+    const float c = x < kExpMin ? kExpMin : (x > kExpMax ? kExpMax : x);
+    const float k = roundNearest(c * kLog2e);
+    const float r = (c - k * kLn2A) - k * kLn2B;
+    // e^x = e^r * 2^k, with 2^k applied in two halves so that neither factor
+    // leaves the normal range
+    const int32_t k1 = static_cast<int32_t>(k) / 2;
+    const int32_t k2 = static_cast<int32_t>(k) - k1;
+    const float s1 = fromBits(static_cast<uint32_t>(k1 + 127) << 23);
+    const float s2 = fromBits(static_cast<uint32_t>(k2 + 127) << 23);
+    return expPoly(r) * s1 * s2;
+}
+
+// log(x) for finite x > 0
+inline float logCore(float x) {
+    // Scale subnormals into the normal range, then split x = m * 2^e with m
+    // in [sqrt(1/2), sqrt(2))
+    const bool subnormal = x < std::numeric_limits<float>::min();
+    const float scaled = x * 8388608.0f;
+    const uint32_t u = bits(subnormal ? scaled : x) - 0x3f3504f3u;
+    const int32_t e = (static_cast<int32_t>(u) >> 23) - (subnormal ? 23 : 0);
+    const float m = fromBits((u & 0x007fffffu) + 0x3f3504f3u);
+    const float k = static_cast<float>(e);
+    // e * ln(2) in two parts so that it stays accurate
+    return (logMantissa(m) + k * kLn2B) + k * kLn2A;
+}
+
+} // namespace detail
+
+/// Sine, absolute error 1e-7 for |x| <= 8192.
+inline float sin(float x) {
+    int32_t q;
+    const float r = detail::reduce(x, q);
+    const float s = detail::sinPoly(r);
+    const float c = detail::cosPoly(r);
+    const float v = (q & 1) ? c : s;
+    return (q & 2) ? -v : v;
+}
+
+/// Cosine, absolute error 1e-7 for |x| <= 8192.
+inline float cos(float x) {
+    int32_t q;
+    const float r = detail::reduce(x, q);
+    const float s = detail::sinPoly(r);
+    const float c = detail::cosPoly(r);
+    const float v = (q & 1) ? s : c;
+    return ((q + 1) & 2) ? -v : v;
+}
+
+/// Tangent, computed as sin(x) / cos(x).
+inline float tan(float x) {
+    int32_t q;
+    const float r = detail::reduce(x, q);
+    const float s = detail::sinPoly(r);
+    const float c = detail::cosPoly(r);
+    return ((q & 1) ? -c : s) / ((q & 1) ? s : c);
+}
+
+/// Arctangent, relative error 2.1e-7.
+inline float atan(float x) {
+    const float a = x < 0.0f ? -x : x;
+    // Reduce to [0, tan(pi/8)] via atan(a) = pi/2 - atan(1/a) and
+    // atan(a) = pi/4 + atan((a - 1) / (a + 1))
+    const bool large = a > 2.414213562373095f;
+    const bool medium = a > 0.4142135623730950f;
+    const float num = large ? -1.0f : (medium ? a - 1.0f : a);
+    const float den = large ? a : (medium ? a + 1.0f : 1.0f);
+    const float r = num / den;
+    const float offset = large ? detail::kHalfPi : (medium ? detail::kQuarterPi : 0.0f);
+    const float y = offset + detail::atanPoly(r);
+    return x < 0.0f ? -y : y;
+}
+
+/// Two-argument arctangent, with the quadrant conventions of std::atan2.
+inline float atan2(float y, float x) {
+    const float ax = x < 0.0f ? -x : x;
+    const float ay = y < 0.0f ? -y : y;
+    // Angle of (|x|, |y|) in [0, pi/2], from the smaller ratio for accuracy
+    const bool steep = ay > ax;
+    const float num = steep ? ax : ay;
+    const float den = steep ? ay : ax;
+    const float ratio = atan(num / den);
+    float a = den > 0.0f ? ratio : 0.0f;
+    a = steep ? detail::kHalfPi - a : a;
+    a = std::signbit(x) ? detail::kPi - a : a;
+    return std::signbit(y) ? -a : a;
+}
+
+/// Arcsine, absolute error 3e-7 on [-1, 1].
+inline float asin(float x) {
+    const float a = x < 0.0f ? -x : x;
+    // asin(a) = pi/2 - 2 asin(sqrt((1 - a) / 2)) for a > 1/2
+    const bool large = a > 0.5f;
+    const float h = std::sqrt(0.5f * (1.0f - a));
+    const float p = detail::asinPoly(large ? h : a);
+    const float y = large ? detail::kHalfPi - 2.0f * p : p;
+    return x < 0.0f ? -y : y;
+}
+
+/// Arccosine, absolute error 3e-7 on [-1, 1].
+inline float acos(float x) {
+    const float a = x < 0.0f ? -x : x;
+    // acos(a) = 2 asin(sqrt((1 - a) / 2)) for a > 1/2, and
+    // acos(-a) = pi - acos(a)
+    const bool large = a > 0.5f;
+    const float h = std::sqrt(0.5f * (1.0f - a));
+    const float p = detail::asinPoly(large ? h : a);
+    const float y = large ? 2.0f * p : detail::kHalfPi - p;
+    return x < 0.0f ? detail::kPi - y : y;
+}
+
+/// Exponential, relative error 2e-7 for normal results; follows libm into
+/// the subnormal range and overflows to infinity at the same point.
+inline float exp(float x) {
+    const float y = detail::expCore(x);
+    return x > detail::kExpMax ? std::numeric_limits<float>::infinity() : (x < detail::kExpMin ? 0.0f : y);
+}
+
+/// Natural logarithm, relative error 1e-7 for x > 0 (including subnormals).
+/// Returns -inf for 0 and NaN for negative arguments.
+inline float log(float x) {
+    const float y = detail::logCore(x);
+    return x > std::numeric_limits<float>::max() ? x
+        : (x > 0.0f ? y
+        : (x == 0.0f ? -std::numeric_limits<float>::infinity() : std::numeric_limits<float>::quiet_NaN()));
+}
+
+/// x raised to the power y, computed as exp(y log |x|). A negative base
+/// gives a signed result for integral y and NaN otherwise, as in libm.
+inline float pow(float x, float y) {
+    const float a = x < 0.0f ? -x : x;
+    const float l = y * detail::logCore(a);
+    const float e = l > detail::kExpMax ? std::numeric_limits<float>::infinity() : detail::expCore(l);
+    const float r = a > 0.0f ? e : (y > 0.0f ? 0.0f : (y < 0.0f ? std::numeric_limits<float>::infinity() : 1.0f));
+    // Floats of magnitude 2^24 and above are even integers
+    const bool small = (y < 0.0f ? -y : y) < 16777216.0f;
+    const int32_t n = static_cast<int32_t>(small ? y : 0.0f);
+    const bool integral = !small | (static_cast<float>(n) == y);
+    const bool odd = (n & 1) != 0;
+    return x < 0.0f ? (integral ? (odd ? -r : r) : std::numeric_limits<float>::quiet_NaN()) : (y == 0.0f ? 1.0f : r);
+}
+
+} // namespace sdf::fast
@@ -0,0 +1,172 @@
+#pragma once
+
+// Per-frame evaluation of animated SDFs.
+//
+// Usage:
+//   for (float t : frameTimes) {
+//       sdf::Frame frame = sdf::prepare("Mech", t);
+//       sdf::evaluateParallel(frame, points.data(), distances.data(), points.size());
+//   }
+//
+// Animated SDFs derive some quantities from the time alone: rotation
+// matrices, animation curves, per-cable radii. Evaluating through a Handle
+// recomputes them for every point; prepare() computes them once, and every
+// evaluation against the returned Frame only does the per-point work.
+// Results are identical to evaluating the Handle at the same time and seed.
+
+#include "sdf.hpp"
+
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace sdf {
+
+class Frame;
+
+namespace detail {
+// Evaluation loops in frame.cpp, which call Frame::evaluateUnrecorded()
+struct FrameAccess;
+#if defined(SDF_STATS)
+// Single-point Frame evaluation that updates the counters in sdf/stats.hpp
+float evaluateRecorded(const Frame& frame, const glm::vec3& point);
+#endif
+}
+
+/// A resolved SDF bound to one time and seed, with its time-dependent
+/// constants precomputed.
+///
+/// Obtained via prepare(). Frames are immutable; copies share the constants,
+/// so a Frame is cheap to pass around and safe to use from several threads.
+/// SDFs without per-frame constants (all static SDFs, and animated ones whose
+/// time terms depend on the point) simply evaluate the Handle.
+class Frame {
+public:
+    /// Signature of a per-frame evaluation function
+    using FrameFunc = float(*)(const glm::vec3& p, const void* constants);
+
+    Frame() = default;
+
+    const Handle& handle() const { return handle_; }
+    float time() const { return time_; }
+    uint32_t seed() const { return seed_; }
+
+    /// True if the SDF has precomputed per-frame constants
+    bool hasConstants() const { return func_ != nullptr; }
+
+    explicit operator bool() const { return static_cast<bool>(handle_); }
+
+    /// Signed distance at a point
+    float evaluate(const glm::vec3& point) const {
+#if defined(SDF_STATS)
+        return detail::evaluateRecorded(*this, point);
+#else
+        return evaluateUnrecorded(point);
+#endif
+    }
+
+private:
+    friend Frame prepare(const Handle& sdf, float time, uint32_t seed);
+    friend struct detail::FrameAccess;
+
+    // evaluate() without updating the counters in sdf/stats.hpp
+    float evaluateUnrecorded(const glm::vec3& point) const {
+        if (!func_) return handle_.func(point, time_, seed_);
+#if defined(SDF_FAST_MATH)
+        return detail::shrinkDistance(func_(point, constants_.get()), errorBound_, point);
+#else
+        return func_(point, constants_.get());
+#endif
+    }
+
+    Handle handle_;
+    float time_ = 0.0f;
+    uint32_t seed_ = 12345;
+    FrameFunc func_ = nullptr;
+    std::shared_ptr<const void> constants_;
+    float errorBound_ = 0.0f;  // correction applied to func_ in Conservative fast-math mode
+};
+
+/// Precompute the time-dependent constants of a resolved SDF.
+///
+/// @param sdf  Handle returned by resolve()
+/// @param time Time parameter for animated SDFs (default: 0.0)
+/// @param seed Random seed for procedural SDFs (default: 12345)
+/// @return     Frame to pass to the evaluate() overloads below
+Frame prepare(const Handle& sdf, float time = 0.0f, uint32_t seed = 12345);
+
+/// Precompute the time-dependent constants of an SDF.
+///
+/// @param name The name of the SDF (e.g., "Mech", "Cables", "Snail")
+/// @param time Time parameter for animated SDFs (default: 0.0)
+/// @param seed Random seed for procedural SDFs (default: 12345)
+/// @return     Frame to pass to the evaluate() overloads below
+/// @throws     std::runtime_error if the SDF name is unknown
+Frame prepare(const std::string& name, float time = 0.0f, uint32_t seed = 12345);
+
+/// Evaluate a prepared SDF at a single point.
+///
+/// @param frame Frame returned by prepare()
+/// @param point The query point in R^3
+/// @return      Signed distance at the query point
+inline float evaluate(const Frame& frame, const glm::vec3& point) {
+    return frame.evaluate(point);
+}
+
+/// Evaluate a prepared SDF at an array of points, writing the distances into
+/// a caller-owned output buffer. Performs no allocation.
+///
+/// @param frame  Frame returned by prepare()
+/// @param points Array of `count` query points
+/// @param out    Output buffer with room for `count` floats
+/// @param count  Number of points to evaluate
+void evaluate(const Frame& frame, const glm::vec3* points, float* out, size_t count);
+
+/// Evaluate a prepared SDF at points given as separate x, y and z arrays.
+/// SDFs without per-frame constants use the Handle's SIMD kernel if it has
+/// one.
+///
+/// @param frame Frame returned by prepare()
+/// @param x     Array of `count` x coordinates
+/// @param y     Array of `count` y coordinates
+/// @param z     Array of `count` z coordinates
+/// @param out   Output buffer with room for `count` floats
+/// @param count Number of points to evaluate
+void evaluate(
+    const Frame& frame,
+    const float* x,
+    const float* y,
+    const float* z,
+    float* out,
+    size_t count
+);
+
+/// Parallel counterpart of the array evaluate() overload taking a Frame.
+///
+/// @param frame  Frame returned by prepare()
+/// @param points Array of `count` query points
+/// @param out    Output buffer with room for `count` floats
+/// @param count  Number of points to evaluate
+void evaluateParallel(const Frame& frame, const glm::vec3* points, float* out, size_t count);
+
+/// Parallel counterpart of the structure-of-arrays evaluate() overload
+/// taking a Frame.
+///
+/// @param frame Frame returned by prepare()
+/// @param x     Array of `count` x coordinates
+/// @param y     Array of `count` y coordinates
+/// @param z     Array of `count` z coordinates
+/// @param out   Output buffer with room for `count` floats
+/// @param count Number of points to evaluate
+void evaluateParallel(
+    const Frame& frame,
+    const float* x,
+    const float* y,
+    const float* z,
+    float* out,
+    size_t count
+);
+
+} // namespace sdf
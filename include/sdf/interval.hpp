@@ -0,0 +1,258 @@
+#pragma once
+
+// Interval arithmetic for scalar-generic shapes.
+//
+// Instantiating a templated shape with V = Vec3<Interval> evaluates it over a
+// whole axis-aligned box at once: the result encloses every value the float
+// instantiation can return for a point inside the box. Bounds are rounded
+// outward by one ulp per operation, so the enclosure also covers float
+// rounding. The bounds are conservative and can be loose, especially through
+// select() where the condition is undecided over the box.
+//
+// Comparisons return an IntervalMask recording whether the condition can be
+// true and whether it can be false somewhere in the box; select() returns the
+// hull of both branches when it can be either.
+
+#include "common.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace sdf {
+
+/// Outcome of comparing intervals: which truth values are possible.
+struct IntervalMask {
+    bool canBeTrue;
+    bool canBeFalse;
+
+    friend IntervalMask operator&(IntervalMask a, IntervalMask b) {
+        return {a.canBeTrue && b.canBeTrue, a.canBeFalse || b.canBeFalse};
+    }
+    friend IntervalMask operator|(IntervalMask a, IntervalMask b) {
+        return {a.canBeTrue || b.canBeTrue, a.canBeFalse && b.canBeFalse};
+    }
+    friend IntervalMask operator!(IntervalMask a) { return {a.canBeFalse, a.canBeTrue}; }
+
+    /// The condition holds somewhere in the box (the branch may be needed)
+    friend bool any(IntervalMask m) { return m.canBeTrue; }
+    /// The condition holds everywhere in the box
+    friend bool all(IntervalMask m) { return !m.canBeFalse; }
+};
+
+/// Closed range of floats [lo, hi].
+struct Interval {
+    float lo;
+    float hi;
+
+    Interval() = default;
+    Interval(float v) : lo(v), hi(v) {}
+    Interval(float lo_, float hi_) : lo(lo_), hi(hi_) {}
+
+    float width() const { return hi - lo; }
+    bool contains(float v) const { return lo <= v && v <= hi; }
+
+    /// Smallest interval containing both
+    friend Interval hull(const Interval& a, const Interval& b) {
+        return Interval(std::min(a.lo, b.lo), std::max(a.hi, b.hi));
+    }
+
+    friend Interval operator+(const Interval& a, const Interval& b) {
+        return outward(a.lo + b.lo, a.hi + b.hi);
+    }
+    friend Interval operator-(const Interval& a, const Interval& b) {
+        return outward(a.lo - b.hi, a.hi - b.lo);
+    }
+    friend Interval operator-(const Interval& a) { return Interval(-a.hi, -a.lo); }
+
+    friend Interval operator*(const Interval& a, const Interval& b) {
+        float p0 = a.lo * b.lo, p1 = a.lo * b.hi, p2 = a.hi * b.lo, p3 = a.hi * b.hi;
+        // Same-signed factors give a non-negative product; keeping the widened
+        // bound at 0 lets pow() of a square take its real-exponent path
+        bool sameSign = (a.lo >= 0.0f && b.lo >= 0.0f) || (a.hi <= 0.0f && b.hi <= 0.0f);
+        return outward(std::min(std::min(p0, p1), std::min(p2, p3)),
+                       std::max(std::max(p0, p1), std::max(p2, p3)),
+                       sameSign ? 0.0f : -std::numeric_limits<float>::infinity());
+    }
+
+    friend Interval operator/(const Interval& a, const Interval& b) {
+        if (b.lo <= 0.0f && b.hi >= 0.0f) return entire();
+        float q0 = a.lo / b.lo, q1 = a.lo / b.hi, q2 = a.hi / b.lo, q3 = a.hi / b.hi;
+        return outward(std::min(std::min(q0, q1), std::min(q2, q3)),
+                       std::max(std::max(q0, q1), std::max(q2, q3)));
+    }
+
+    Interval& operator+=(const Interval& b) { return *this = *this + b; }
+    Interval& operator-=(const Interval& b) { return *this = *this - b; }
+    Interval& operator*=(const Interval& b) { return *this = *this * b; }
+    Interval& operator/=(const Interval& b) { return *this = *this / b; }
+
+    friend IntervalMask operator<(const Interval& a, const Interval& b) {
+        return {a.lo < b.hi, a.hi >= b.lo};
+    }
+    friend IntervalMask operator<=(const Interval& a, const Interval& b) {
+        return {a.lo <= b.hi, a.hi > b.lo};
+    }
+    friend IntervalMask operator>(const Interval& a, const Interval& b) { return b < a; }
+    friend IntervalMask operator>=(const Interval& a, const Interval& b) { return b <= a; }
+
+    friend Interval select(IntervalMask m, const Interval& a, const Interval& b) {
+        if (!m.canBeFalse) return a;
+        if (!m.canBeTrue) return b;
+        return hull(a, b);
+    }
+
+    friend Interval min(const Interval& a, const Interval& b) {
+        return Interval(std::min(a.lo, b.lo), std::min(a.hi, b.hi));
+    }
+    friend Interval max(const Interval& a, const Interval& b) {
+        return Interval(std::max(a.lo, b.lo), std::max(a.hi, b.hi));
+    }
+    friend Interval clamp(const Interval& x, const Interval& lo, const Interval& hi) {
+        return min(max(x, lo), hi);
+    }
+
+    friend Interval abs(const Interval& a) {
+        if (a.lo >= 0.0f) return a;
+        if (a.hi <= 0.0f) return -a;
+        return Interval(0.0f, std::max(-a.lo, a.hi));
+    }
+
+    friend Interval sign(const Interval& a) {
+        auto s = [](float x) { return x > 0.0f ? 1.0f : (x < 0.0f ? -1.0f : 0.0f); };
+        return Interval(s(a.lo), s(a.hi));
+    }
+
+    friend Interval mix(const Interval& x, const Interval& y, const Interval& a) {
+        return x * (1.0f - a) + y * a;
+    }
+
+    friend Interval smoothstep(const Interval& e0, const Interval& e1, const Interval& x) {
+        Interval t = clamp((x - e0) / (e1 - e0), 0.0f, 1.0f);
+        return clamp(t * t * (3.0f - 2.0f * t), 0.0f, 1.0f);
+    }
+
+    friend Interval sqrt(const Interval& a) {
+        if (a.hi < 0.0f) return nan();
+        return outward(std::sqrt(std::max(a.lo, 0.0f)), std::sqrt(a.hi), 0.0f);
+    }
+
+    friend Interval floor(const Interval& a) { return Interval(std::floor(a.lo), std::floor(a.hi)); }
+    friend Interval ceil(const Interval& a) { return Interval(std::ceil(a.lo), std::ceil(a.hi)); }
+    friend Interval round(const Interval& a) { return Interval(std::round(a.lo), std::round(a.hi)); }
+
+    // Tighter than x - floor(x), which loses the correlation between the terms
+    friend Interval fract(const Interval& a) {
+        float f = std::floor(a.lo);
+        if (f != std::floor(a.hi)) return Interval(0.0f, 1.0f);
+        return outward(a.lo - f, a.hi - f, 0.0f);
+    }
+
+    friend Interval exp(const Interval& a) {
+        return outward(std::exp(a.lo), std::exp(a.hi), 0.0f);
+    }
+
+    friend Interval log(const Interval& a) {
+        if (a.hi < 0.0f) return nan();
+        return outward(std::log(std::max(a.lo, 0.0f)), std::log(a.hi));
+    }
+
+    friend Interval exp2(const Interval& a) {
+        return outward(std::exp2(a.lo), std::exp2(a.hi), 0.0f);
+    }
+
+    friend Interval log2(const Interval& a) {
+        if (a.hi < 0.0f) return nan();
+        return outward(std::log2(std::max(a.lo, 0.0f)), std::log2(a.hi));
+    }
+
+    friend Interval sin(const Interval& a) { return periodic(a, 0.5 * kPi); }
+    friend Interval cos(const Interval& a) { return periodic(a, 0.0); }
+
+    friend Interval acos(const Interval& a) {
+        if (a.lo > 1.0f || a.hi < -1.0f) return nan();
+        return outward(std::acos(std::min(a.hi, 1.0f)), std::acos(std::max(a.lo, -1.0f)));
+    }
+
+    friend Interval asin(const Interval& a) {
+        if (a.lo > 1.0f || a.hi < -1.0f) return nan();
+        return outward(std::asin(std::max(a.lo, -1.0f)), std::asin(std::min(a.hi, 1.0f)));
+    }
+
+    friend Interval atan(const Interval& a) {
+        return outward(std::atan(a.lo), std::atan(a.hi));
+    }
+
+    friend Interval atan2(const Interval& y, const Interval& x) {
+        // The angle jumps across the negative x axis; a box touching it spans
+        // the whole range. Otherwise the extremes lie at the corners.
+        if (x.lo < 0.0f && y.lo <= 0.0f && y.hi >= 0.0f) {
+            return outward(-static_cast<float>(kPi), static_cast<float>(kPi));
+        }
+        float a0 = std::atan2(y.lo, x.lo), a1 = std::atan2(y.lo, x.hi);
+        float a2 = std::atan2(y.hi, x.lo), a3 = std::atan2(y.hi, x.hi);
+        return outward(std::min(std::min(a0, a1), std::min(a2, a3)),
+                       std::max(std::max(a0, a1), std::max(a2, a3)));
+    }
+
+    friend Interval pow(const Interval& a, const Interval& b) {
+        // Monotonic in each argument for a non-negative base, so the corners
+        // bound it; negative bases are only defined for integer exponents,
+        // where odd powers increase and even powers depend on |a|.
+        if (a.lo < 0.0f) {
+            if (b.lo != b.hi || b.lo < 0.0f || b.lo != std::floor(b.lo)) return entire();
+            if (std::fmod(b.lo, 2.0f) == 0.0f) return pow(abs(a), b);
+            return outward(std::pow(a.lo, b.lo), std::pow(a.hi, b.lo));
+        }
+        float p0 = std::pow(a.lo, b.lo), p1 = std::pow(a.lo, b.hi);
+        float p2 = std::pow(a.hi, b.lo), p3 = std::pow(a.hi, b.hi);
+        return outward(std::min(std::min(p0, p1), std::min(p2, p3)),
+                       std::max(std::max(p0, p1), std::max(p2, p3)), 0.0f);
+    }
+
+    static Interval entire() {
+        float inf = std::numeric_limits<float>::infinity();
+        return Interval(-inf, inf);
+    }
+
+    static Interval nan() {
+        float n = std::numeric_limits<float>::quiet_NaN();
+        return Interval(n, n);
+    }
+
+private:
+    static constexpr double kPi = 3.14159265358979323846;
+
+    // [lo, hi] widened by one ulp each way, optionally clamped below
+    static Interval outward(float lo, float hi, float floorValue = -std::numeric_limits<float>::infinity()) {
+        float inf = std::numeric_limits<float>::infinity();
+        // inf - inf and 0 * inf leave a bound undefined; widen it all the way
+        if (std::isnan(lo)) lo = -inf;
+        if (std::isnan(hi)) hi = inf;
+        return Interval(std::max(std::nextafter(lo, -inf), floorValue), std::nextafter(hi, inf));
+    }
+
+    // sin (phase pi/2) or cos (phase 0): maxima at phase + 2k*pi, minima
+    // half a period later
+    static Interval periodic(const Interval& a, double phase) {
+        const double period = 2.0 * kPi;
+        if (!(a.hi - a.lo < period)) return Interval(-1.0f, 1.0f);
+        auto f = [phase](double x) { return std::cos(x - phase); };
+        double lo = a.lo, hi = a.hi;
+        double vlo = std::min(f(lo), f(hi));
+        double vhi = std::max(f(lo), f(hi));
+        auto hits = [&](double offset) {
+            double k = std::ceil((lo - phase - offset) / period);
+            return phase + offset + k * period <= hi;
+        };
+        if (hits(0.0)) vhi = 1.0;
+        if (hits(kPi)) vlo = -1.0;
+        Interval r = outward(static_cast<float>(vlo), static_cast<float>(vhi));
+        return Interval(std::max(r.lo, -1.0f), std::min(r.hi, 1.0f));
+    }
+};
+
+template <>
+struct is_lane<Interval> : std::true_type {};
+
+} // namespace sdf
@@ -0,0 +1,137 @@
+#pragma once
+
+// Triangle mesh extraction from the library's SDFs.
+//
+// Usage:
+//   sdf::Mesh mesh = sdf::extractMesh(sdf::resolve("Teapot"), glm::uvec3(256),
+//                                     glm::vec3(-1.0f), glm::vec3(1.0f));
+//   sdf::saveOBJ(mesh, "teapot.obj");
+//   sdf::savePLY(mesh, "teapot.ply");
+//
+//   sdf::DualContourOptions options;
+//   options.maxDepth = 10;
+//   sdf::Mesh adaptive = sdf::dualContour(sdf::resolve("Menger"), glm::vec3(-1.0f), 2.0f, options);
+//
+// extractMesh() runs marching cubes on the nodes of a regular grid (see
+// evaluateGrid()). dualContour() places one vertex per cell of an adaptive
+// octree (see Octree) and merges cells where the surface is flat, keeping
+// sharp edges and corners. Does not depend on Polyscope.
+
+#include "sdf.hpp"
+
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace sdf {
+
+/// Indexed triangle mesh.
+struct Mesh {
+    std::vector<glm::vec3> vertices;
+    std::vector<glm::uvec3> triangles;  ///< Counter-clockwise seen from where the SDF exceeds iso
+};
+
+/// Extract the surface where the SDF equals `iso` with marching cubes.
+///
+/// The cells are processed in tiles on all configured threads. Because
+/// every SDF here is conservative, a tile or block of cells whose center
+/// value differs from `iso` by more than its half-diagonal cannot contain
+/// the surface and is skipped without evaluating its nodes; the cost
+/// therefore grows with the surface area rather than the volume. Vertices
+/// lie on grid edges and are shared between the triangles of neighbouring
+/// cells and tiles, so a surface that stays inside the grid gives a closed
+/// mesh. The mesh is the same for any thread count.
+///
+/// For iso = 0 the skipping is exact. For other values it relies on the SDF
+/// changing no faster than the distance, as the library's SDFs are meant to.
+///
+/// @param sdf       Handle returned by resolve()
+/// @param dims      Number of nodes along each axis, at least 2
+/// @param boundLow  Position of node (0, 0, 0)
+/// @param boundHigh Position of node (dims - 1)
+/// @param iso       Value of the extracted level set (default: 0.0)
+/// @param time      Time parameter for animated SDFs (default: 0.0)
+/// @param seed      Random seed for procedural SDFs (default: 12345)
+/// @return          The mesh
+/// @throws          std::runtime_error if a dimension is below 2 or the
+///                  bounds are not increasing
+Mesh extractMesh(
+    const Handle& sdf,
+    const glm::uvec3& dims,
+    const glm::vec3& boundLow,
+    const glm::vec3& boundHigh,
+    float iso = 0.0f,
+    float time = 0.0f,
+    uint32_t seed = 12345
+);
+
+/// Parameters for dualContour().
+struct DualContourOptions {
+    /// Depth of the finest cells, which have edge length size / 2^maxDepth
+    int maxDepth = 8;
+
+    /// Refinement stops where the SDF is within this distance of affine,
+    /// and cells are merged while the merged vertex stays within it of the
+    /// tangent planes of the surface inside them (as the root of the summed
+    /// squared distances); 0 keeps every finest cell
+    float tolerance = 1e-3f;
+
+    /// Regula falsi steps on the SDF refining each edge crossing beyond
+    /// linear interpolation of the corner values
+    int rootSteps = 2;
+};
+
+/// Extract the surface where the SDF is 0 by dual contouring on an octree.
+///
+/// The cube is sampled with Octree::build(), which refines only cells the
+/// surface may cross, so the cost grows with the surface area; with
+/// options.tolerance as its flatness it also stops early where the SDF is
+/// close to affine. On every sign changing edge of the finest cells the
+/// crossing is located and the gradient evaluated there; each cell's vertex
+/// minimizes the squared distance to the resulting tangent planes (a QEF),
+/// which puts it on sharp edges and corners instead of cutting them. Going
+/// up the tree, eight leaves are merged into their parent when the merged
+/// vertex still fits all their planes within options.tolerance and the
+/// merge cannot change the topology of the surface, so flat regions end up
+/// with few large triangles. Finally each sign changing edge gives a quad
+/// (or a triangle) joining the vertices of the leaves around it; a leaf
+/// whose own corners show no crossing gets its vertex from those edges.
+///
+/// The mesh is closed where the surface stays inside the cube. It is not
+/// always manifold: a cell gets a single vertex however many sheets of
+/// surface pass through it, and cells whose corners show two sheets occur
+/// on smooth shapes too, wherever two parts of the surface come within a
+/// cell of each other, as on the Teapot at depth 6. Subtrees are processed
+/// on all configured threads; the mesh is the same for any thread count.
+///
+/// @param sdf      Handle returned by resolve()
+/// @param boundLow Lowest corner of the cube
+/// @param size     Edge length of the cube
+/// @param options  Depth, merging tolerance and crossing refinement
+/// @param time     Time parameter for animated SDFs (default: 0.0)
+/// @param seed     Random seed for procedural SDFs (default: 12345)
+/// @return         The mesh, counter-clockwise seen from outside
+/// @throws         std::runtime_error if size is not positive, maxDepth is
+///                 outside [0, Octree::kMaxDepth] or rootSteps is negative
+Mesh dualContour(
+    const Handle& sdf,
+    const glm::vec3& boundLow,
+    float size,
+    const DualContourOptions& options = DualContourOptions(),
+    float time = 0.0f,
+    uint32_t seed = 12345
+);
+
+/// Write a mesh as Wavefront OBJ text.
+///
+/// @throws std::runtime_error if the file cannot be written
+void saveOBJ(const Mesh& mesh, const std::string& path);
+
+/// Write a mesh as binary PLY in native byte order.
+///
+/// @throws std::runtime_error if the file cannot be written
+void savePLY(const Mesh& mesh, const std::string& path);
+
+} // namespace sdf
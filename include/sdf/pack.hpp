@@ -0,0 +1,249 @@
+#pragma once
+
+// Fixed-width float packs for evaluating scalar-generic shapes on several
+// points at once.
+//
+// Pack<W> holds W float lanes and is registered with is_lane, so templated
+// shapes instantiate with V = Vec3<Pack<W>> (e.g. Pack<8> for 8 points per
+// call). Comparisons return a Mask<W>; branches become select(mask, a, b), and
+// any(mask) can skip work no lane needs. Arithmetic performs the same IEEE
+// operations as the scalar code, and transcendental functions are applied per
+// lane, so each lane matches the float instantiation exactly.
+//
+// Everything lives in sdf::simd::SDF_SIMD_TARGET (default "native") and is
+// visible as sdf::simd::Pack etc. Code built for several instruction sets in
+// one program (see src/soa_kernels_*.cpp) defines a distinct name per
+// translation unit so the linker never merges instantiations compiled for
+// different CPUs. Such a unit also defines SDF_SIMD_ISA (e.g. "avx2") instead
+// of compiling with -m flags: only the pack functions, which are private to
+// its namespace, and the kernels get that target attribute, so no shared
+// inline function (glm, <cmath>, common.hpp) is ever emitted with
+// instructions the CPU may lack. For the same reason the lane functions use
+// compiler builtins rather than <cmath> inline functions.
+//
+// Requires the GCC/Clang vector extensions.
+
+#include "common.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+#ifndef SDF_SIMD_TARGET
+#define SDF_SIMD_TARGET native
+#endif
+
+// Target attribute of the pack functions, empty for the build's own ISA
+#ifdef SDF_SIMD_ISA
+#define SDF_SIMD_FUNC __attribute__((target(SDF_SIMD_ISA)))
+#else
+#define SDF_SIMD_FUNC
+#endif
+
+// Whether 256- and 512-bit intrinsics may be used by the pack functions
+#if defined(__AVX__) || defined(SDF_SIMD_AVX2) || defined(SDF_SIMD_AVX512)
+#define SDF_SIMD_HAS_AVX 1
+#endif
+#if defined(__AVX512F__) || defined(SDF_SIMD_AVX512)
+#define SDF_SIMD_HAS_AVX512 1
+#endif
+
+namespace sdf::simd {
+namespace SDF_SIMD_TARGET {
+
+template <int W> struct Mask;
+
+// Vector-extension types backing a pack of W lanes. Declared outside Pack
+// because GCC drops a dependent vector_size on member typedefs.
+template <int W>
+struct LaneTypes {
+    typedef float Lanes __attribute__((vector_size(W * sizeof(float))));
+    typedef int32_t Bits __attribute__((vector_size(W * sizeof(float))));
+};
+
+/// W float lanes evaluated together.
+///
+/// The lane functions are hidden friends so that mixed calls such as
+/// min(p, 0.0f) convert the float argument instead of failing deduction.
+template <int W>
+struct Pack {
+    typedef typename LaneTypes<W>::Lanes Lanes;
+    typedef typename LaneTypes<W>::Bits Bits;
+    static constexpr int width = W;
+
+    Lanes v;
+
+    Pack() = default;
+    SDF_SIMD_FUNC Pack(float s) : v(Lanes{} + s) {}
+    SDF_SIMD_FUNC explicit Pack(Lanes lanes) : v(lanes) {}
+
+    SDF_SIMD_FUNC static Pack load(const float* p) {
+        Pack r;
+        __builtin_memcpy(&r.v, p, sizeof(Lanes));
+        return r;
+    }
+
+    SDF_SIMD_FUNC void store(float* p) const {
+        __builtin_memcpy(p, &v, sizeof(Lanes));
+    }
+
+    SDF_SIMD_FUNC float operator[](int i) const { return v[i]; }
+
+    SDF_SIMD_FUNC friend Pack operator+(Pack a, Pack b) { return Pack(a.v + b.v); }
+    SDF_SIMD_FUNC friend Pack operator-(Pack a, Pack b) { return Pack(a.v - b.v); }
+    SDF_SIMD_FUNC friend Pack operator*(Pack a, Pack b) { return Pack(a.v * b.v); }
+    SDF_SIMD_FUNC friend Pack operator/(Pack a, Pack b) { return Pack(a.v / b.v); }
+    SDF_SIMD_FUNC friend Pack operator-(Pack a) { return Pack(-a.v); }
+
+    SDF_SIMD_FUNC Pack& operator+=(Pack b) { v += b.v; return *this; }
+    SDF_SIMD_FUNC Pack& operator-=(Pack b) { v -= b.v; return *this; }
+    SDF_SIMD_FUNC Pack& operator*=(Pack b) { v *= b.v; return *this; }
+    SDF_SIMD_FUNC Pack& operator/=(Pack b) { v /= b.v; return *this; }
+
+    SDF_SIMD_FUNC friend Mask<W> operator<(Pack a, Pack b) { return Mask<W>(a.v < b.v); }
+    SDF_SIMD_FUNC friend Mask<W> operator<=(Pack a, Pack b) { return Mask<W>(a.v <= b.v); }
+    SDF_SIMD_FUNC friend Mask<W> operator>(Pack a, Pack b) { return Mask<W>(a.v > b.v); }
+    SDF_SIMD_FUNC friend Mask<W> operator>=(Pack a, Pack b) { return Mask<W>(a.v >= b.v); }
+
+    /// Per-lane `mask ? a : b`
+    SDF_SIMD_FUNC friend Pack select(Mask<W> mask, Pack a, Pack b) {
+        return Pack((Lanes)((mask.m & (Bits)a.v) | (~mask.m & (Bits)b.v)));
+    }
+
+    SDF_SIMD_FUNC friend Pack min(Pack a, Pack b) { return select(b < a, b, a); }
+    SDF_SIMD_FUNC friend Pack max(Pack a, Pack b) { return select(a < b, b, a); }
+    SDF_SIMD_FUNC friend Pack clamp(Pack x, Pack lo, Pack hi) { return min(max(x, lo), hi); }
+    SDF_SIMD_FUNC friend Pack abs(Pack a) { return Pack((Lanes)((Bits)a.v & 0x7fffffff)); }
+
+    // GLSL sign(): 1, -1 or 0
+    SDF_SIMD_FUNC friend Pack sign(Pack a) {
+        return select(a > 0.0f, Pack(1.0f), select(a < 0.0f, Pack(-1.0f), Pack(0.0f)));
+    }
+
+    SDF_SIMD_FUNC friend Pack mix(Pack x, Pack y, Pack a) { return x * (1.0f - a) + y * a; }
+
+    SDF_SIMD_FUNC friend Pack smoothstep(Pack e0, Pack e1, Pack x) {
+        Pack t = clamp((x - e0) / (e1 - e0), 0.0f, 1.0f);
+        return t * t * (3.0f - 2.0f * t);
+    }
+
+    SDF_SIMD_FUNC friend Pack sqrt(Pack a) {
+#if defined(SDF_SIMD_HAS_AVX512)
+        // The masked form with a full mask is the same instruction, but unlike
+        // _mm512_sqrt_ps it does not pass GCC's self-initialized undefined
+        // vector through, which trips -Wmaybe-uninitialized in every kernel
+        if constexpr (W == 16) {
+            const __m512 v = (__m512)a.v;
+            return Pack((Lanes)_mm512_mask_sqrt_ps(v, (__mmask16)0xffff, v));
+        }
+#endif
+#if defined(SDF_SIMD_HAS_AVX)
+        if constexpr (W == 8) return Pack((Lanes)_mm256_sqrt_ps((__m256)a.v));
+#endif
+#if defined(__SSE__)
+        if constexpr (W == 4) return Pack((Lanes)_mm_sqrt_ps((__m128)a.v));
+#endif
+#if defined(__aarch64__)
+        if constexpr (W == 4) return Pack((Lanes)vsqrtq_f32((float32x4_t)a.v));
+#endif
+        return map(a, [](float x) { return __builtin_sqrtf(x); });
+    }
+
+    SDF_SIMD_FUNC friend Pack floor(Pack a) { return map(a, [](float x) { return __builtin_floorf(x); }); }
+    SDF_SIMD_FUNC friend Pack ceil(Pack a) { return map(a, [](float x) { return __builtin_ceilf(x); }); }
+    SDF_SIMD_FUNC friend Pack round(Pack a) { return map(a, [](float x) { return __builtin_roundf(x); }); }
+    SDF_SIMD_FUNC friend Pack sin(Pack a) { return map(a, [](float x) { return __builtin_sinf(x); }); }
+    SDF_SIMD_FUNC friend Pack cos(Pack a) { return map(a, [](float x) { return __builtin_cosf(x); }); }
+    SDF_SIMD_FUNC friend Pack tan(Pack a) { return map(a, [](float x) { return __builtin_tanf(x); }); }
+    SDF_SIMD_FUNC friend Pack asin(Pack a) { return map(a, [](float x) { return __builtin_asinf(x); }); }
+    SDF_SIMD_FUNC friend Pack acos(Pack a) { return map(a, [](float x) { return __builtin_acosf(x); }); }
+    SDF_SIMD_FUNC friend Pack atan(Pack a) { return map(a, [](float x) { return __builtin_atanf(x); }); }
+    SDF_SIMD_FUNC friend Pack exp(Pack a) { return map(a, [](float x) { return __builtin_expf(x); }); }
+    SDF_SIMD_FUNC friend Pack log(Pack a) { return map(a, [](float x) { return __builtin_logf(x); }); }
+    SDF_SIMD_FUNC friend Pack exp2(Pack a) { return map(a, [](float x) { return __builtin_exp2f(x); }); }
+    SDF_SIMD_FUNC friend Pack log2(Pack a) { return map(a, [](float x) { return __builtin_log2f(x); }); }
+
+    SDF_SIMD_FUNC friend Pack atan2(Pack y, Pack x) {
+        return map(y, x, [](float a, float b) { return __builtin_atan2f(a, b); });
+    }
+
+    SDF_SIMD_FUNC friend Pack pow(Pack a, Pack b) {
+        return map(a, b, [](float x, float y) { return __builtin_powf(x, y); });
+    }
+};
+
+/// Per-lane boolean (all bits set for true), as produced by Pack comparisons
+template <int W>
+struct Mask {
+    typedef typename Pack<W>::Bits Bits;
+
+    Bits m;
+
+    Mask() = default;
+    SDF_SIMD_FUNC explicit Mask(Bits bits) : m(bits) {}
+
+    SDF_SIMD_FUNC friend Mask operator&(Mask a, Mask b) { return Mask(a.m & b.m); }
+    SDF_SIMD_FUNC friend Mask operator|(Mask a, Mask b) { return Mask(a.m | b.m); }
+    SDF_SIMD_FUNC friend Mask operator!(Mask a) { return Mask(~a.m); }
+
+    /// True if any lane is set
+    SDF_SIMD_FUNC friend bool any(Mask mask) {
+        for (int i = 0; i < W; ++i) {
+            if (mask.m[i]) return true;
+        }
+        return false;
+    }
+
+    /// True if every lane is set
+    SDF_SIMD_FUNC friend bool all(Mask mask) {
+        for (int i = 0; i < W; ++i) {
+            if (!mask.m[i]) return false;
+        }
+        return true;
+    }
+};
+
+/// Apply a scalar function to every lane
+template <int W, class F>
+SDF_SIMD_FUNC inline Pack<W> map(Pack<W> a, F f) {
+    Pack<W> r;
+    for (int i = 0; i < W; ++i) r.v[i] = f(a.v[i]);
+    return r;
+}
+
+template <int W, class F>
+SDF_SIMD_FUNC inline Pack<W> map(Pack<W> a, Pack<W> b, F f) {
+    Pack<W> r;
+    for (int i = 0; i < W; ++i) r.v[i] = f(a.v[i], b.v[i]);
+    return r;
+}
+
+/// map() restricted to the lanes set in `mask`; the other lanes are zero.
+/// Lets expensive per-lane calls run only where a branch is taken.
+template <int W, class F>
+SDF_SIMD_FUNC inline Pack<W> mapWhere(Mask<W> mask, Pack<W> a, F f) {
+    Pack<W> r(0.0f);
+    for (int i = 0; i < W; ++i) {
+        if (mask.m[i]) r.v[i] = f(a.v[i]);
+    }
+    return r;
+}
+
+} // namespace SDF_SIMD_TARGET
+
+using namespace SDF_SIMD_TARGET;
+
+} // namespace sdf::simd
+
+namespace sdf {
+
+template <int W>
+struct is_lane<simd::Pack<W>> : std::true_type {};
+
+} // namespace sdf
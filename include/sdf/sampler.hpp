@@ -0,0 +1,112 @@
+#pragma once
+
+// Point and distance samples for training learned SDFs.
+//
+// Usage:
+//   sdf::SamplerOptions options;
+//   options.distribution = sdf::SampleDistribution::NearSurface;
+//   sdf::generateSamples(sdf::resolve("HumanHead"), 10000000, options,
+//       [&](size_t first, const glm::vec3* points, const float* values, size_t count) { ... });
+//
+//   sdf::generateSamplesToFile(sdf::resolve("HumanHead"), 10000000, options, "head.samples");
+//
+// Every random number is drawn from a counter-based generator keyed by the
+// seed and indexed by the sample number, so sample i is the same however
+// many threads run and however the samples are chunked.
+
+#include "sdf.hpp"
+
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace sdf {
+
+/// How generateSamples() places points.
+enum class SampleDistribution {
+    Uniform,      ///< Uniform over the sampling box
+    NearSurface,  ///< Surface points displaced by a Gaussian offset
+    Band          ///< Equal numbers of points per band of |distance|
+};
+
+/// Parameters for generateSamples().
+struct SamplerOptions {
+    SampleDistribution distribution = SampleDistribution::NearSurface;
+
+    /// Sampling box: uniform points and surface search candidates lie in it
+    glm::vec3 boundLow = glm::vec3(-1.0f);
+    glm::vec3 boundHigh = glm::vec3(1.0f);
+
+    /// NearSurface: standard deviation of the offset along each axis
+    float sigma = 0.01f;
+
+    /// Band: ascending edges of the |distance| bands. Sample i falls in band
+    /// i % (edges - 1); the last edge may be infinite.
+    std::vector<float> bandEdges = {0.0f, 0.005f, 0.02f, 0.1f, std::numeric_limits<float>::infinity()};
+
+    /// Samples passed to the sink per call
+    size_t chunkSize = 65536;
+
+    /// |distance| below which a projected point counts as on the surface
+    float surfaceTolerance = 1e-4f;
+};
+
+/// Receives consecutive chunks of samples: points[k] and its distance
+/// values[k] are sample `first + k`. The arrays are only valid during the call.
+using SampleSink = std::function<void(size_t first, const glm::vec3* points, const float* values, size_t count)>;
+
+/// Generate point samples of an SDF with their distances.
+///
+/// Surface points are found by projecting uniform candidates from the box:
+/// each step moves a candidate by its distance against the gradient, which
+/// for a conservative SDF never crosses the surface. Candidates that do not
+/// reach options.surfaceTolerance are retried a few times with fresh
+/// candidates, after which the closest one found is used. NearSurface adds a
+/// Gaussian offset to the surface point. Band places a point along the
+/// surface normal at a random distance within its band and retries until
+/// the SDF value falls inside the band; points in an infinite last band are
+/// drawn uniformly from the box. Points that miss their band after the retry
+/// limit are kept as is, so the bands are filled approximately.
+///
+/// Each chunk is generated on all configured threads in fixed blocks of
+/// samples, then passed to `sink` on the calling thread.
+///
+/// @param sdf     Handle returned by resolve()
+/// @param count   Number of samples
+/// @param options Distribution and its parameters
+/// @param sink    Consumer of the chunks
+/// @param time    Time parameter for animated SDFs (default: 0.0)
+/// @param seed    Random seed for procedural SDFs, also the key of the
+///                sample generator (default: 12345)
+/// @throws        std::runtime_error if the box is empty, sigma is negative,
+///                the band edges are not ascending from 0 or more, or
+///                chunkSize is 0
+void generateSamples(
+    const Handle& sdf,
+    size_t count,
+    const SamplerOptions& options,
+    const SampleSink& sink,
+    float time = 0.0f,
+    uint32_t seed = 12345
+);
+
+/// Generate samples into a file of float32 records (x, y, z, distance) in
+/// native byte order, one per sample, writing each chunk as it is done.
+///
+/// @param path Output file, replaced if it exists
+/// @throws     std::runtime_error if the options are invalid or the file
+///             cannot be written
+void generateSamplesToFile(
+    const Handle& sdf,
+    size_t count,
+    const SamplerOptions& options,
+    const std::string& path,
+    float time = 0.0f,
+    uint32_t seed = 12345
+);
+
+} // namespace sdf
@@ -8,14 +8,669 @@
 //
 // The SDF name should match the filename (without extension) of the original
 // GLSL file, e.g., "Sphere", "Fish", "Mandelbulb", etc.
+//
+// For repeated queries, resolve the name once and evaluate through the handle:
+//   sdf::Handle sphere = sdf::resolve("Sphere");
+//   float d = sdf::evaluate(sphere, glm::vec3(0.0f));
 
 #include <glm/glm.hpp>
 #include <string>
 #include <vector>
+#include <limits>
+#include <cstddef>
 #include <cstdint>
 
 namespace sdf {
 
+/// Signature shared by every SDF in the library.
+using SDFFunc = float(*)(const glm::vec3& p, float time, uint32_t seed);
+
+/// Signature of a structure-of-arrays batch kernel: evaluates the points
+/// (x[i], y[i], z[i]) for i in [0, count) into out[i].
+using SoAFunc = void(*)(const float* x, const float* y, const float* z,
+                        float* out, size_t count, float time, uint32_t seed);
+
+/// Signature of a distance-and-gradient function: returns the distance at p
+/// and stores its gradient with respect to p in `gradient`.
+using GradFunc = float(*)(const glm::vec3& p, float time, uint32_t seed, glm::vec3& gradient);
+
+/// Signature of a level-of-detail function: like SDFFunc, but refinement
+/// stops once further detail cannot change the distance by more than
+/// `featureSize`.
+using LODFunc = float(*)(const glm::vec3& p, float featureSize, float time, uint32_t seed);
+
+/// Bounding volume of an SDF's surface.
+///
+/// The surface lies inside both the box and the sphere at every time value,
+/// so the distance from a point to the volume is a lower bound on its
+/// distance to the surface. SDFs whose surface reaches infinity (e.g. the
+/// Jellyfish tentacles) have bounded == false.
+struct Bounds {
+    glm::vec3 boxLow = glm::vec3(0.0f);   ///< Lowest corner of the box
+    glm::vec3 boxHigh = glm::vec3(0.0f);  ///< Highest corner of the box
+    glm::vec3 center = glm::vec3(0.0f);   ///< Center of the sphere
+    float radius = 0.0f;                  ///< Radius of the sphere
+    bool bounded = false;                 ///< False if the surface is unbounded
+};
+
+/// Distance from a point to a bounding volume: the larger of the distances
+/// to the box and to the sphere, 0 inside both. Always 0 for unbounded SDFs.
+///
+/// @param bounds Bounding volume, e.g. Handle::bounds
+/// @param point  The query point in R^3
+/// @return       Lower bound on the distance from the point to the surface
+inline float boundDistance(const Bounds& bounds, const glm::vec3& point) {
+    if (!bounds.bounded) return 0.0f;
+    const glm::vec3 outside = glm::max(glm::max(bounds.boxLow - point, point - bounds.boxHigh), 0.0f);
+    const float box = glm::length(outside);
+    const float sphere = glm::length(point - bounds.center) - bounds.radius;
+    return glm::max(glm::max(box, sphere), 0.0f);
+}
+
+namespace detail {
+
+/// Move a distance towards zero by `bound` * max(1, |point|), keeping its
+/// sign. Applied to an approximated distance at `point` whose error is within
+/// that margin (see Handle::errorBound), the result is again no greater in
+/// magnitude than the exact distance.
+inline float shrinkDistance(float distance, float bound, const glm::vec3& point) {
+    const float margin = bound * glm::max(glm::length(point), 1.0f);
+    return distance > 0.0f ? glm::max(distance - margin, 0.0f) : glm::min(distance + margin, 0.0f);
+}
+
+} // namespace detail
+
+/// A resolved reference to a registered SDF.
+///
+/// Obtained once via resolve(); the evaluate() overloads taking a Handle call
+/// straight through the function pointer without any by-name lookup. Handles
+/// are plain values and remain valid for the lifetime of the program.
+struct Handle {
+    SDFFunc func = nullptr;          ///< Evaluation function
+    SoAFunc soa = nullptr;           ///< SIMD batch kernel, or nullptr if the SDF has none
+    GradFunc grad = nullptr;         ///< Exact gradient function, or nullptr if the SDF has none
+    LODFunc lod = nullptr;           ///< Level-of-detail function, or nullptr if the SDF has none
+    const char* name = nullptr;      ///< Registry name, e.g. "Sphere"
+    const char* category = nullptr;  ///< Category, e.g. "Geometry" or "Fractal"
+    bool animated = false;           ///< True if the SDF depends on the time parameter
+    Bounds bounds;                   ///< Bounding volume of the surface
+    float errorBound = 0.0f;         ///< Fast-math error at p, over max(1, |p|) (0 in the exact build)
+
+    explicit operator bool() const { return func != nullptr; }
+};
+
+/// Look up an SDF by name.
+///
+/// @param name The name of the SDF (e.g., "Sphere", "Fish", "Mandelbulb")
+/// @return     Handle to pass to the evaluate() overloads below
+/// @throws     std::runtime_error if the SDF name is unknown
+Handle resolve(const std::string& name);
+
+#if defined(SDF_STATS)
+namespace detail {
+// Single-point evaluation that updates the counters in sdf/stats.hpp
+float evaluateRecorded(const Handle& sdf, const glm::vec3& point, float time, uint32_t seed);
+}
+#endif
+
+/// Evaluate a resolved SDF at a single point.
+///
+/// @param sdf   Handle returned by resolve()
+/// @param point The query point in R^3
+/// @param time  Time parameter for animated SDFs (default: 0.0)
+/// @param seed  Random seed for procedural SDFs (default: 12345)
+/// @return      Signed distance at the query point
+inline float evaluate(
+    const Handle& sdf,
+    const glm::vec3& point,
+    float time = 0.0f,
+    uint32_t seed = 12345
+) {
+#if defined(SDF_STATS)
+    return detail::evaluateRecorded(sdf, point, time, seed);
+#else
+    return sdf.func(point, time, seed);
+#endif
+}
+
+/// Evaluate a resolved SDF at multiple points.
+///
+/// @param sdf    Handle returned by resolve()
+/// @param points The query points in R^3
+/// @param time   Time parameter for animated SDFs (default: 0.0)
+/// @param seed   Random seed for procedural SDFs (default: 12345)
+/// @return       Vector of signed distances, one per input point
+std::vector<float> evaluate(
+    const Handle& sdf,
+    const std::vector<glm::vec3>& points,
+    float time = 0.0f,
+    uint32_t seed = 12345
+);
+
+/// Evaluate a resolved SDF at points in a caller-owned buffer, writing the
+/// distances into a caller-owned output buffer. Performs no allocation.
+///
+/// @param sdf       Handle returned by resolve()
+/// @param positions Coordinates of the first point; each point is three
+///                  consecutive floats (x, y, z)
+/// @param stride    Distance in floats between consecutive points
+///                  (3 for tightly packed xyz)
+/// @param out       Output buffer with room for `count` floats
+/// @param count     Number of points to evaluate
+/// @param time      Time parameter for animated SDFs (default: 0.0)
+/// @param seed      Random seed for procedural SDFs (default: 12345)
+void evaluate(
+    const Handle& sdf,
+    const float* positions,
+    size_t stride,
+    float* out,
+    size_t count,
+    float time = 0.0f,
+    uint32_t seed = 12345
+);
+
+/// Evaluate a resolved SDF at an array of points, writing the distances into
+/// a caller-owned output buffer. Performs no allocation.
+///
+/// @param sdf    Handle returned by resolve()
+/// @param points Array of `count` query points
+/// @param out    Output buffer with room for `count` floats
+/// @param count  Number of points to evaluate
+/// @param time   Time parameter for animated SDFs (default: 0.0)
+/// @param seed   Random seed for procedural SDFs (default: 12345)
+void evaluate(
+    const Handle& sdf,
+    const glm::vec3* points,
+    float* out,
+    size_t count,
+    float time = 0.0f,
+    uint32_t seed = 12345
+);
+
+/// Evaluate a resolved SDF at points given as separate x, y and z arrays
+/// (structure of arrays), writing into a caller-owned output buffer.
+///
+/// Every registered SDF has a SIMD kernel that evaluates several points per
+/// instruction, using the widest instruction set the CPU supports (AVX-512,
+/// AVX2 or the build's baseline, chosen at runtime). Builds without SIMD
+/// kernels fall back to a scalar loop. Without SDF_FAST_MATH, results match
+/// the single-point evaluate() bit for bit. In the fast-math build, SDFs with
+/// an error bound evaluate a single point through the approximations (moved
+/// towards zero in FastMathMode::Conservative), so the two can differ by up to
+/// Handle::errorBound times max(1, |p|).
+///
+/// @param sdf   Handle returned by resolve()
+/// @param x     Array of `count` x coordinates
+/// @param y     Array of `count` y coordinates
+/// @param z     Array of `count` z coordinates
+/// @param out   Output buffer with room for `count` floats
+/// @param count Number of points to evaluate
+/// @param time  Time parameter for animated SDFs (default: 0.0)
+/// @param seed  Random seed for procedural SDFs (default: 12345)
+void evaluate(
+    const Handle& sdf,
+    const float* x,
+    const float* y,
+    const float* z,
+    float* out,
+    size_t count,
+    float time = 0.0f,
+    uint32_t seed = 12345
+);
+
+/// Name of the instruction set used by the SIMD kernels on this machine:
+/// "avx512", "avx2", "generic" (the build's baseline) or "none".
+const char* getSIMDTarget();
+
+/// How the fast-math build treats the error of its approximations.
+enum class FastMathMode {
+    Approximate,   ///< Return the approximated distances unchanged
+    Conservative   ///< Move each distance towards zero by its error margin (default)
+};
+
+/// True if this is the fast-math build of the library (the SDF_FAST_MATH
+/// CMake option), in which SDFs with a derived error bound use polynomial
+/// approximations of their transcendental functions.
+bool isFastMath();
+
+/// Select the fast-math mode for handles resolved from now on.
+///
+/// The approximations perturb the distance at p by up to Handle::errorBound
+/// times max(1, |p|), so an approximated distance may slightly exceed the
+/// exact one. In Conservative mode every such distance is moved towards zero
+/// by that margin, which restores the guarantee that it never exceeds the exact
+/// distance. Approximate mode skips the correction. Only the SDFs whose bound
+/// has been derived use the approximations, and only in their scalar
+/// evaluation: the other SDFs, the SIMD kernels, gradients and interval
+/// bounds use libm in both modes. Has no effect in the exact build.
+///
+/// @param mode Mode for subsequent resolve() calls
+void setFastMathMode(FastMathMode mode);
+
+/// Get the fast-math mode used by resolve().
+FastMathMode getFastMathMode();
+
+/// Set the number of threads used by the parallel evaluation functions.
+///
+/// Worker threads are created on first use and reused across calls; changing
+/// the count restarts them.
+///
+/// @param count Number of threads, including the calling thread. 0 selects
+///              std::thread::hardware_concurrency() (the default).
+void setThreadCount(unsigned count);
+
+/// Get the number of threads used by the parallel evaluation functions.
+unsigned getThreadCount();
+
+/// Evaluate a resolved SDF at an array of points using all configured threads.
+///
+/// Points are processed in chunks that idle threads steal from busy ones, so
+/// expensive regions do not leave cores idle. Output order (and every value)
+/// is identical to the serial evaluate().
+///
+/// @param sdf    Handle returned by resolve()
+/// @param points Array of `count` query points
+/// @param out    Output buffer with room for `count` floats
+/// @param count  Number of points to evaluate
+/// @param time   Time parameter for animated SDFs (default: 0.0)
+/// @param seed   Random seed for procedural SDFs (default: 12345)
+void evaluateParallel(
+    const Handle& sdf,
+    const glm::vec3* points,
+    float* out,
+    size_t count,
+    float time = 0.0f,
+    uint32_t seed = 12345
+);
+
+/// Parallel counterpart of the strided evaluate() overload.
+///
+/// @param sdf       Handle returned by resolve()
+/// @param positions Coordinates of the first point (x, y, z consecutive)
+/// @param stride    Distance in floats between consecutive points
+/// @param out       Output buffer with room for `count` floats
+/// @param count     Number of points to evaluate
+/// @param time      Time parameter for animated SDFs (default: 0.0)
+/// @param seed      Random seed for procedural SDFs (default: 12345)
+void evaluateParallel(
+    const Handle& sdf,
+    const float* positions,
+    size_t stride,
+    float* out,
+    size_t count,
+    float time = 0.0f,
+    uint32_t seed = 12345
+);
+
+/// Parallel counterpart of the structure-of-arrays evaluate() overload.
+///
+/// @param sdf   Handle returned by resolve()
+/// @param x     Array of `count` x coordinates
+/// @param y     Array of `count` y coordinates
+/// @param z     Array of `count` z coordinates
+/// @param out   Output buffer with room for `count` floats
+/// @param count Number of points to evaluate
+/// @param time  Time parameter for animated SDFs (default: 0.0)
+/// @param seed  Random seed for procedural SDFs (default: 12345)
+void evaluateParallel(
+    const Handle& sdf,
+    const float* x,
+    const float* y,
+    const float* z,
+    float* out,
+    size_t count,
+    float time = 0.0f,
+    uint32_t seed = 12345
+);
+
+/// Parallel counterpart of the vector evaluate() overload.
+///
+/// @param sdf    Handle returned by resolve()
+/// @param points The query points in R^3
+/// @param time   Time parameter for animated SDFs (default: 0.0)
+/// @param seed   Random seed for procedural SDFs (default: 12345)
+/// @return       Vector of signed distances, one per input point
+std::vector<float> evaluateParallel(
+    const Handle& sdf,
+    const std::vector<glm::vec3>& points,
+    float time = 0.0f,
+    uint32_t seed = 12345
+);
+
+/// Evaluate a resolved SDF at every node of a regular grid.
+///
+/// Node (i, j, k) lies at boundLow + (i, j, k) * (boundHigh - boundLow) /
+/// (dims - 1) and its distance is written to out[i + dims.x * (j + dims.y * k)],
+/// i.e. x varies fastest, matching the node order of Polyscope's VolumeGrid.
+/// Coordinates are generated per tile as the grid is walked, so no point list
+/// is ever built. Tiles run on all configured threads and go through the SIMD
+/// kernel when the SDF has one.
+///
+/// @param sdf       Handle returned by resolve()
+/// @param dims      Number of nodes along each axis
+/// @param boundLow  Position of node (0, 0, 0)
+/// @param boundHigh Position of node (dims - 1)
+/// @param out       Output buffer with room for dims.x * dims.y * dims.z floats
+/// @param time      Time parameter for animated SDFs (default: 0.0)
+/// @param seed      Random seed for procedural SDFs (default: 12345)
+void evaluateGrid(
+    const Handle& sdf,
+    const glm::uvec3& dims,
+    const glm::vec3& boundLow,
+    const glm::vec3& boundHigh,
+    float* out,
+    float time = 0.0f,
+    uint32_t seed = 12345
+);
+
+/// Evaluate the nodes of a regular grid whose z index lies in [zBegin, zEnd).
+///
+/// Node (i, j, k) lies where it would in evaluateGrid() and gets the same
+/// value; it is written to out[i + dims.x * (j + dims.y * (k - zBegin))].
+/// Evaluating consecutive slabs therefore produces the full grid piece by
+/// piece (see streamGrid() in sdf/stream.hpp).
+///
+/// @param sdf       Handle returned by resolve()
+/// @param dims      Number of nodes along each axis of the whole grid
+/// @param boundLow  Position of node (0, 0, 0)
+/// @param boundHigh Position of node (dims - 1)
+/// @param zBegin    First z index of the slab
+/// @param zEnd      One past the last z index of the slab (clamped to dims.z)
+/// @param out       Output buffer with room for dims.x * dims.y * (zEnd - zBegin) floats
+/// @param time      Time parameter for animated SDFs (default: 0.0)
+/// @param seed      Random seed for procedural SDFs (default: 12345)
+void evaluateGridSlab(
+    const Handle& sdf,
+    const glm::uvec3& dims,
+    const glm::vec3& boundLow,
+    const glm::vec3& boundHigh,
+    uint32_t zBegin,
+    uint32_t zEnd,
+    float* out,
+    float time = 0.0f,
+    uint32_t seed = 12345
+);
+
+/// Evaluate an SDF at every node of a regular grid.
+///
+/// @param name      The name of the SDF (e.g., "Sphere", "Fish", "Mandelbulb")
+/// @param dims      Number of nodes along each axis
+/// @param boundLow  Position of node (0, 0, 0)
+/// @param boundHigh Position of node (dims - 1)
+/// @param out       Output buffer with room for dims.x * dims.y * dims.z floats
+/// @param time      Time parameter for animated SDFs (default: 0.0)
+/// @param seed      Random seed for procedural SDFs (default: 12345)
+/// @throws          std::runtime_error if the SDF name is unknown
+void evaluateGrid(
+    const std::string& name,
+    const glm::uvec3& dims,
+    const glm::vec3& boundLow,
+    const glm::vec3& boundHigh,
+    float* out,
+    float time = 0.0f,
+    uint32_t seed = 12345
+);
+
+/// Options for evaluateGridNarrowBand().
+struct NarrowBand {
+    /// Nodes closer than this to the surface are always evaluated exactly.
+    /// 0 evaluates only the blocks the surface may pass through.
+    float width = 0.0f;
+
+    /// How skipped nodes are filled: true writes a conservative bound (the
+    /// correct sign and a magnitude no greater than the true distance,
+    /// derived from the block center), false writes +/-sentinel.
+    bool fillBound = true;
+
+    /// Magnitude written to skipped nodes when fillBound is false
+    float sentinel = std::numeric_limits<float>::max();
+};
+
+/// Evaluate a resolved SDF on a regular grid, exactly only near the surface.
+///
+/// Same layout as evaluateGrid(). The grid is split into blocks that are
+/// refined coarse to fine: the SDF is evaluated at each block's center c, and
+/// because every SDF here is conservative, the ball of radius |phi(c)| holds
+/// no surface. A block whose half-diagonal plus `band.width` is smaller than
+/// that is filled without further evaluation. Other blocks are subdivided down
+/// to small tiles that are evaluated densely, so the cost grows with the
+/// surface area rather than the volume of the grid.
+///
+/// @param sdf       Handle returned by resolve()
+/// @param dims      Number of nodes along each axis
+/// @param boundLow  Position of node (0, 0, 0)
+/// @param boundHigh Position of node (dims - 1)
+/// @param band      Band width and fill mode for skipped nodes
+/// @param out       Output buffer with room for dims.x * dims.y * dims.z floats
+/// @param time      Time parameter for animated SDFs (default: 0.0)
+/// @param seed      Random seed for procedural SDFs (default: 12345)
+/// @return          Number of SDF evaluations performed
+size_t evaluateGridNarrowBand(
+    const Handle& sdf,
+    const glm::uvec3& dims,
+    const glm::vec3& boundLow,
+    const glm::vec3& boundHigh,
+    const NarrowBand& band,
+    float* out,
+    float time = 0.0f,
+    uint32_t seed = 12345
+);
+
+/// Evaluate a resolved SDF and its gradient at a single point.
+///
+/// Every registered SDF is differentiated automatically in one pass and
+/// returns the derivative of the code itself, which at creases, fractal
+/// detail and noise can differ from a finite difference; the distance matches
+/// evaluate() exactly. A handle without a gradient function falls back to
+/// central differences, which costs six extra evaluations. Normalizing the
+/// gradient gives the surface normal.
+///
+/// @param sdf      Handle returned by resolve()
+/// @param point    The query point in R^3
+/// @param gradient Output: gradient of the distance at the point
+/// @param time     Time parameter for animated SDFs (default: 0.0)
+/// @param seed     Random seed for procedural SDFs (default: 12345)
+/// @return         Signed distance at the query point
+float evaluateWithGradient(
+    const Handle& sdf,
+    const glm::vec3& point,
+    glm::vec3& gradient,
+    float time = 0.0f,
+    uint32_t seed = 12345
+);
+
+/// Evaluate a resolved SDF and its gradient at an array of points, writing
+/// into caller-owned buffers. Performs no allocation.
+///
+/// @param sdf       Handle returned by resolve()
+/// @param points    Array of `count` query points
+/// @param out       Output buffer with room for `count` distances
+/// @param gradients Output buffer with room for `count` gradients
+/// @param count     Number of points to evaluate
+/// @param time      Time parameter for animated SDFs (default: 0.0)
+/// @param seed      Random seed for procedural SDFs (default: 12345)
+void evaluateWithGradient(
+    const Handle& sdf,
+    const glm::vec3* points,
+    float* out,
+    glm::vec3* gradients,
+    size_t count,
+    float time = 0.0f,
+    uint32_t seed = 12345
+);
+
+/// Parallel counterpart of the batch evaluateWithGradient().
+///
+/// @param sdf       Handle returned by resolve()
+/// @param points    Array of `count` query points
+/// @param out       Output buffer with room for `count` distances
+/// @param gradients Output buffer with room for `count` gradients
+/// @param count     Number of points to evaluate
+/// @param time      Time parameter for animated SDFs (default: 0.0)
+/// @param seed      Random seed for procedural SDFs (default: 12345)
+void evaluateWithGradientParallel(
+    const Handle& sdf,
+    const glm::vec3* points,
+    float* out,
+    glm::vec3* gradients,
+    size_t count,
+    float time = 0.0f,
+    uint32_t seed = 12345
+);
+
+/// Evaluate a resolved SDF, skipping the evaluation far from the surface.
+///
+/// If the point is farther than `truncation` from the SDF's bounding volume,
+/// boundDistance() is returned without evaluating the SDF; otherwise the
+/// exact distance is. Either way the result is the exact value or a lower
+/// bound on the distance to the surface that exceeds `truncation`, which is
+/// all a truncated (TSDF) or far-field query needs. Unbounded SDFs are
+/// always evaluated.
+///
+/// @param sdf        Handle returned by resolve()
+/// @param point      The query point in R^3
+/// @param truncation Distance beyond which the exact value is not needed
+/// @param time       Time parameter for animated SDFs (default: 0.0)
+/// @param seed       Random seed for procedural SDFs (default: 12345)
+/// @return           Signed distance, or a bound greater than `truncation`
+inline float evaluateTruncated(
+    const Handle& sdf,
+    const glm::vec3& point,
+    float truncation,
+    float time = 0.0f,
+    uint32_t seed = 12345
+) {
+    const float bound = boundDistance(sdf.bounds, point);
+    return bound > truncation ? bound : evaluate(sdf, point, time, seed);
+}
+
+/// Evaluate a resolved SDF at an array of points, skipping the evaluation
+/// for points farther than `truncation` from the bounding volume.
+///
+/// The remaining points are gathered into structure-of-arrays tiles, so they
+/// go through the SIMD kernel when the SDF has one. Every value matches the
+/// single-point evaluateTruncated(). Performs no allocation.
+///
+/// @param sdf        Handle returned by resolve()
+/// @param points     Array of `count` query points
+/// @param out        Output buffer with room for `count` floats
+/// @param count      Number of points to evaluate
+/// @param truncation Distance beyond which the exact value is not needed
+/// @param time       Time parameter for animated SDFs (default: 0.0)
+/// @param seed       Random seed for procedural SDFs (default: 12345)
+void evaluateTruncated(
+    const Handle& sdf,
+    const glm::vec3* points,
+    float* out,
+    size_t count,
+    float truncation,
+    float time = 0.0f,
+    uint32_t seed = 12345
+);
+
+/// Parallel counterpart of the batch evaluateTruncated().
+///
+/// @param sdf        Handle returned by resolve()
+/// @param points     Array of `count` query points
+/// @param out        Output buffer with room for `count` floats
+/// @param count      Number of points to evaluate
+/// @param truncation Distance beyond which the exact value is not needed
+/// @param time       Time parameter for animated SDFs (default: 0.0)
+/// @param seed       Random seed for procedural SDFs (default: 12345)
+void evaluateTruncatedParallel(
+    const Handle& sdf,
+    const glm::vec3* points,
+    float* out,
+    size_t count,
+    float truncation,
+    float time = 0.0f,
+    uint32_t seed = 12345
+);
+
+#if defined(SDF_STATS)
+namespace detail {
+// Single-point evaluateLOD() that updates the counters in sdf/stats.hpp
+float evaluateLODRecorded(const Handle& sdf, const glm::vec3& point, float featureSize, float time, uint32_t seed);
+}
+#endif
+
+/// Evaluate a resolved SDF at a single point, refined only down to a
+/// minimum feature size.
+///
+/// The fractals (Menger, Serpinski, Julia, Mandelbulb and
+/// MandelbulbPolynomial) stop folding or iterating once further levels
+/// cannot change the distance by more than `featureSize`, which makes coarse
+/// grids and far-field queries cheaper. For Menger and Serpinski the result
+/// stays conservative: at points outside the fractal, where the full-detail
+/// distance d is non-negative, it lies in [d - featureSize, d]. Julia and
+/// Mandelbulb return 0 for points they stop refining, and choose where to
+/// stop from bands measured by sampling, not derived; the same range holds
+/// at almost every point, but a rare point left unresolved lies farther
+/// than featureSize out. Other SDFs, and a featureSize of 0 or less, return
+/// the full-detail value.
+///
+/// @param sdf         Handle returned by resolve()
+/// @param point       The query point in R^3
+/// @param featureSize Smallest detail that must be resolved, e.g. the grid
+///                    spacing or the pixel footprint at the point
+/// @param time        Time parameter for animated SDFs (default: 0.0)
+/// @param seed        Random seed for procedural SDFs (default: 12345)
+/// @return            Signed distance, within featureSize below the full
+///                    value (empirically for Julia and Mandelbulb)
+inline float evaluateLOD(
+    const Handle& sdf,
+    const glm::vec3& point,
+    float featureSize,
+    float time = 0.0f,
+    uint32_t seed = 12345
+) {
+#if defined(SDF_STATS)
+    return detail::evaluateLODRecorded(sdf, point, featureSize, time, seed);
+#else
+    return sdf.lod ? sdf.lod(point, featureSize, time, seed) : sdf.func(point, time, seed);
+#endif
+}
+
+/// Evaluate a resolved SDF at an array of points, refined only down to a
+/// minimum feature size. Every value matches the single-point evaluateLOD().
+/// Performs no allocation.
+///
+/// @param sdf         Handle returned by resolve()
+/// @param points      Array of `count` query points
+/// @param out         Output buffer with room for `count` floats
+/// @param count       Number of points to evaluate
+/// @param featureSize Smallest detail that must be resolved
+/// @param time        Time parameter for animated SDFs (default: 0.0)
+/// @param seed        Random seed for procedural SDFs (default: 12345)
+void evaluateLOD(
+    const Handle& sdf,
+    const glm::vec3* points,
+    float* out,
+    size_t count,
+    float featureSize,
+    float time = 0.0f,
+    uint32_t seed = 12345
+);
+
+/// Parallel counterpart of the batch evaluateLOD().
+///
+/// @param sdf         Handle returned by resolve()
+/// @param points      Array of `count` query points
+/// @param out         Output buffer with room for `count` floats
+/// @param count       Number of points to evaluate
+/// @param featureSize Smallest detail that must be resolved
+/// @param time        Time parameter for animated SDFs (default: 0.0)
+/// @param seed        Random seed for procedural SDFs (default: 12345)
+void evaluateLODParallel(
+    const Handle& sdf,
+    const glm::vec3* points,
+    float* out,
+    size_t count,
+    float featureSize,
+    float time = 0.0f,
+    uint32_t seed = 12345
+);
+
 /// Evaluate an SDF at multiple points.
 ///
 /// @param name   The name of the SDF (e.g., "Sphere", "Fish", "Mandelbulb")
@@ -0,0 +1,79 @@
+#pragma once
+
+// Evaluation counters for finding out which SDFs consume the evaluation
+// budget.
+//
+// Usage (library built with -DSDF_STATS=ON):
+//   sdf::resetStats();
+//   runWorkload();
+//   std::cout << sdf::stats().toJson();
+//
+// Recording is compiled in only when SDF_STATS is defined. Without it the
+// evaluate() paths contain no instrumentation at all, and stats() returns an
+// empty snapshot with enabled == false.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace sdf {
+
+/// Number of batch-size histogram buckets. Bucket b counts calls that
+/// evaluated between 2^b and 2^(b+1) - 1 points (bucket 0 also counts empty
+/// calls); the last bucket counts every larger batch.
+constexpr size_t kBatchSizeBuckets = 24;
+
+/// Entry points whose calls are counted, in the order of ShapeStats::sites.
+enum class StatsSite {
+    Evaluate,  ///< evaluate() / evaluateParallel() on a Handle
+    Frame,     ///< evaluate() / evaluateParallel() on a Frame (sdf/frame.hpp)
+    Gradient,  ///< evaluateWithGradient() and its batch forms
+    LOD,       ///< evaluateLOD() / evaluateLODParallel()
+};
+
+/// Number of StatsSite values.
+constexpr size_t kStatsSites = 4;
+
+/// Calls and points recorded through one entry point.
+struct SiteStats {
+    uint64_t calls = 0;
+    uint64_t points = 0;
+};
+
+/// Counters for one SDF.
+struct ShapeStats {
+    std::string name;          ///< Registry name, e.g. "Sphere"
+    uint64_t calls = 0;        ///< Number of recorded calls, over all entry points
+    uint64_t points = 0;       ///< Total number of points evaluated
+    uint64_t nanoseconds = 0;  ///< Cumulative wall time spent in those calls
+    std::array<uint64_t, kBatchSizeBuckets> batchSizes{};  ///< Histogram of points per call
+    std::array<SiteStats, kStatsSites> sites{};            ///< Split by entry point, indexed by StatsSite
+};
+
+/// Snapshot of the evaluation counters.
+struct Stats {
+    bool enabled = false;            ///< False if the library was built without SDF_STATS
+    std::vector<ShapeStats> shapes;  ///< SDFs evaluated at least once, sorted by name
+
+    /// Serialize the snapshot as a JSON object.
+    std::string toJson() const;
+};
+
+/// Snapshot of the counters accumulated since startup or the last resetStats().
+///
+/// Every call through one of the StatsSite entry points is counted once,
+/// with its full point count and wall time; a parallel call is not split into
+/// its chunks. Higher-level functions (grids, meshing, tracing, truncated and
+/// baked queries) are counted through the calls they make to evaluate().
+/// Counters are updated atomically, so they stay consistent while other
+/// threads evaluate.
+///
+/// @return Counters per SDF, or an empty snapshot if recording is compiled out
+Stats stats();
+
+/// Zero all counters.
+void resetStats();
+
+} // namespace sdf
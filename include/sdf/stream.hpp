@@ -0,0 +1,86 @@
+#pragma once
+
+// Grid evaluation for grids larger than memory.
+//
+// Usage:
+//   sdf::streamGridToFile(sdf::resolve("Mandelbulb"), glm::uvec3(2048),
+//                         glm::vec3(-1.0f), glm::vec3(1.0f), "bulb.raw");
+//
+//   sdf::streamGrid(handle, dims, low, high,
+//                   [&](uint32_t zBegin, uint32_t zCount, const float* values) { ... });
+//
+// The grid is evaluated in slabs of whole z layers. While one slab is being
+// evaluated on the worker threads, the previous one is handed to the sink on
+// a separate thread, so writing overlaps evaluation and only two slabs are
+// held in memory at any time.
+
+#include "sdf.hpp"
+
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+namespace sdf {
+
+/// Receives consecutive slabs of a streamed grid, in z order. `values` holds
+/// dims.x * dims.y * zCount floats laid out as in evaluateGrid() and is only
+/// valid during the call.
+using SlabSink = std::function<void(uint32_t zBegin, uint32_t zCount, const float* values)>;
+
+/// Parameters for streamGrid().
+struct StreamOptions {
+    /// z layers per slab; 0 picks the largest depth that fits memoryBudget
+    uint32_t slabDepth = 0;
+
+    /// Bytes for the two slab buffers when slabDepth is 0. At least one
+    /// layer per slab is always used, whatever the budget.
+    size_t memoryBudget = size_t(256) << 20;
+};
+
+/// Evaluate a resolved SDF on a regular grid slab by slab.
+///
+/// Values are those of evaluateGrid() on the same arguments. Slabs are
+/// evaluated with evaluateGridSlab() on all configured threads, into one of
+/// two buffers, while the other buffer is passed to `sink` on a dedicated
+/// thread. The sink is called once per slab, in order, never concurrently
+/// with itself. If it throws, no further slabs are evaluated and the
+/// exception is rethrown here.
+///
+/// @param sdf       Handle returned by resolve()
+/// @param dims      Number of nodes along each axis
+/// @param boundLow  Position of node (0, 0, 0)
+/// @param boundHigh Position of node (dims - 1)
+/// @param sink      Consumer of the slabs
+/// @param options   Slab depth or memory budget
+/// @param time      Time parameter for animated SDFs (default: 0.0)
+/// @param seed      Random seed for procedural SDFs (default: 12345)
+void streamGrid(
+    const Handle& sdf,
+    const glm::uvec3& dims,
+    const glm::vec3& boundLow,
+    const glm::vec3& boundHigh,
+    const SlabSink& sink,
+    const StreamOptions& options = StreamOptions(),
+    float time = 0.0f,
+    uint32_t seed = 12345
+);
+
+/// Stream a grid into a file as raw float32 values in evaluateGrid() order
+/// and native byte order. Each slab is written as soon as it is evaluated.
+///
+/// @param path      Output file, replaced if it exists
+/// @throws          std::runtime_error if the file cannot be written
+void streamGridToFile(
+    const Handle& sdf,
+    const glm::uvec3& dims,
+    const glm::vec3& boundLow,
+    const glm::vec3& boundHigh,
+    const std::string& path,
+    const StreamOptions& options = StreamOptions(),
+    float time = 0.0f,
+    uint32_t seed = 12345
+);
+
+} // namespace sdf
@@ -0,0 +1,60 @@
+#pragma once
+
+// Batched sphere tracing against the library's SDFs.
+//
+// Usage:
+//   sdf::Handle bulb = sdf::resolve("Mandelbulb");
+//   sdf::trace(bulb, origins.data(), directions.data(), origins.size(),
+//              /*tMax=*/10.0f, hitT.data(), steps.data());
+//
+// Because every SDF here is conservative, a ray can always advance by the
+// full distance value without passing through the surface.
+
+#include "sdf.hpp"
+
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+
+namespace sdf {
+
+/// Parameters for trace().
+struct TraceOptions {
+    float epsilon = 1e-4f;     ///< A ray hits once the distance drops below this
+    uint32_t maxSteps = 256;   ///< Rays still marching after this many steps miss
+};
+
+/// Sphere trace a batch of rays.
+///
+/// Each ray starts at t = 0 and advances by the SDF value at its current
+/// position until the value drops below options.epsilon (a hit), t exceeds
+/// tMax, or options.maxSteps evaluations have been spent (both misses).
+/// Rays are processed in packets: each step evaluates only the rays still
+/// marching, compacted into one structure-of-arrays batch, so finished rays
+/// cost nothing and the SIMD kernels apply. Packets run on all configured
+/// threads. Does not depend on Polyscope.
+///
+/// @param sdf        Handle returned by resolve()
+/// @param origins    Array of `count` ray origins
+/// @param directions Array of `count` unit-length ray directions
+/// @param count      Number of rays
+/// @param tMax       Maximum distance along each ray
+/// @param outT       Output: distance to the hit, or +infinity for a miss
+/// @param outSteps   Output: SDF evaluations spent per ray (may be nullptr)
+/// @param options    Hit threshold and step limit
+/// @param time       Time parameter for animated SDFs (default: 0.0)
+/// @param seed       Random seed for procedural SDFs (default: 12345)
+void trace(
+    const Handle& sdf,
+    const glm::vec3* origins,
+    const glm::vec3* directions,
+    size_t count,
+    float tMax,
+    float* outT,
+    uint32_t* outSteps,
+    const TraceOptions& options = TraceOptions(),
+    float time = 0.0f,
+    uint32_t seed = 12345
+);
+
+} // namespace sdf
@@ -0,0 +1,361 @@
+// SDF Bake - Write sampled grids of registered SDFs to disk, headless
+//
+// Usage:
+//   sdf_bake [SHAPES...] [--resolution N] [--bounds LOW HIGH] [--time T0[:T1]]
+//            [--frames F] [--seed S] [--format LIST] [--output DIR]
+//            [--threads T] [--max-memory MB]
+//
+// SHAPES are registry names or glob patterns (`*`, `?`), separated by spaces
+// or commas; the default is every SDF. Each shape is sampled on a regular
+// grid (see sdf::evaluateGrid) once per frame: animated shapes at F times
+// spread evenly over [T0, T1], static shapes once at T0. Every grid is
+// streamed to disk in z slabs (see sdf::streamGrid): slabs are evaluated on
+// all threads while the previous slab is written, and memory stays within
+// --max-memory whatever the resolution. Each grid is written in every
+// requested format:
+//
+//   raw   float32 values, x varying fastest, native byte order
+//   npy   NumPy array of shape (z, y, x), loadable with numpy.load()
+//   sdfb  the library's baked-grid format (sdf::BakedGrid::load())
+//
+// Examples:
+//   sdf_bake --output dataset
+//   sdf_bake "Mandel*" Menger --resolution 256 --format npy,sdfb -o fractals
+//   sdf_bake Fish --time 0:2 --frames 16 --format raw
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "sdf/baked.hpp"
+#include "sdf/sdf.hpp"
+#include "sdf/stream.hpp"
+
+namespace {
+
+const char* const kFormats[] = {"raw", "npy", "sdfb"};
+
+struct Options {
+    std::vector<std::string> shapes;
+    uint32_t resolution = 64;
+    float boundLow = -1.0f;
+    float boundHigh = 1.0f;
+    float timeBegin = 0.0f;
+    float timeEnd = 0.0f;
+    uint32_t frames = 1;
+    uint32_t seed = 12345;
+    std::vector<std::string> formats = {"npy"};
+    std::string output = ".";
+    unsigned threads = 0;        // 0: all hardware threads
+    double maxMemoryMB = 256.0;  // Budget for the slab buffers
+};
+
+// One grid to evaluate and write
+struct Job {
+    sdf::Handle handle;
+    float time = 0.0f;
+    std::string stem;  // Output path without extension
+};
+
+void printUsage(const char* progName) {
+    std::cout << "Usage: " << progName << " [SHAPES...] [options]\n"
+              << "\n"
+              << "SHAPES are SDF names or glob patterns (* and ?), separated by spaces or\n"
+              << "commas. Default: all SDFs.\n"
+              << "\n"
+              << "Options:\n"
+              << "  --resolution N, -r N   Grid nodes per axis (default: 64)\n"
+              << "  --bounds LOW HIGH      Grid bounds on every axis (default: -1 1)\n"
+              << "  --time T0[:T1], -t T   Time, or time range for animated SDFs (default: 0)\n"
+              << "  --frames F             Frames per animated SDF over the time range (default: 1)\n"
+              << "  --seed S, -s S         Random seed for procedural SDFs (default: 12345)\n"
+              << "  --format LIST          Comma-separated raw, npy, sdfb (default: npy)\n"
+              << "  --output DIR, -o DIR   Output directory, created if missing (default: .)\n"
+              << "  --threads T, -j T      Evaluation threads (default: all)\n"
+              << "  --max-memory MB        Memory for the slab buffers (default: 256)\n"
+              << "  --list, -l             List all available SDFs\n"
+              << "  --help, -h             Show this help message\n"
+              << "\n"
+              << "Examples:\n"
+              << "  " << progName << " --output dataset\n"
+              << "  " << progName << " \"Mandel*\" Menger --resolution 256 --format npy,sdfb -o fractals\n"
+              << "  " << progName << " Fish --time 0:2 --frames 16 --format raw\n";
+}
+
+std::vector<std::string> split(const std::string& list, char separator) {
+    std::vector<std::string> parts;
+    std::stringstream stream(list);
+    std::string part;
+    while (std::getline(stream, part, separator)) {
+        if (!part.empty()) parts.push_back(part);
+    }
+    return parts;
+}
+
+// Shell-style match of `*` (any run) and `?` (any character)
+bool globMatch(const char* pattern, const char* text) {
+    const char* star = nullptr;
+    const char* resume = nullptr;
+    while (*text) {
+        if (*pattern == '?' || *pattern == *text) {
+            ++pattern;
+            ++text;
+        } else if (*pattern == '*') {
+            star = pattern++;
+            resume = text;
+        } else if (star) {
+            pattern = star + 1;
+            text = ++resume;
+        } else {
+            return false;
+        }
+    }
+    while (*pattern == '*') ++pattern;
+    return *pattern == '\0';
+}
+
+// Registry names selected by the patterns, in registry order, each once
+std::vector<std::string> selectShapes(const std::vector<std::string>& patterns) {
+    const std::vector<std::string> available = sdf::getAvailableSDFs();
+    if (patterns.empty()) return available;
+
+    std::vector<bool> selected(available.size(), false);
+    for (const std::string& pattern : patterns) {
+        bool matched = false;
+        for (size_t i = 0; i < available.size(); ++i) {
+            if (globMatch(pattern.c_str(), available[i].c_str())) {
+                selected[i] = true;
+                matched = true;
+            }
+        }
+        if (!matched) {
+            throw std::runtime_error("No SDF matches '" + pattern + "'");
+        }
+    }
+
+    std::vector<std::string> names;
+    for (size_t i = 0; i < available.size(); ++i) {
+        if (selected[i]) names.push_back(available[i]);
+    }
+    return names;
+}
+
+std::vector<Job> makeJobs(const Options& options, const std::vector<std::string>& names) {
+    const std::filesystem::path dir(options.output);
+    std::vector<Job> jobs;
+    for (const std::string& name : names) {
+        const sdf::Handle handle = sdf::resolve(name);
+        const uint32_t frames = handle.animated ? options.frames : 1;
+        for (uint32_t f = 0; f < frames; ++f) {
+            Job job;
+            job.handle = handle;
+            job.time = frames > 1
+                ? options.timeBegin + (options.timeEnd - options.timeBegin) * static_cast<float>(f) / static_cast<float>(frames - 1)
+                : options.timeBegin;
+            job.stem = (dir / name).string();
+            if (frames > 1) {
+                std::ostringstream suffix;
+                suffix << "_" << std::setw(4) << std::setfill('0') << f;
+                job.stem += suffix.str();
+            }
+            jobs.push_back(job);
+        }
+    }
+    return jobs;
+}
+
+std::ofstream openOutput(const std::string& path) {
+    std::ofstream out(path, std::ios::binary);
+    if (!out) {
+        throw std::runtime_error("Cannot write " + path);
+    }
+    return out;
+}
+
+// NumPy format version 1.0: magic, header length, then a Python dict literal
+// padded with spaces and a newline so the data starts on a 64-byte boundary
+void writeNpyHeader(std::ostream& out, const glm::uvec3& dims) {
+    const uint32_t probe = 1;
+    uint8_t first;
+    std::memcpy(&first, &probe, 1);
+
+    std::ostringstream dict;
+    dict << "{'descr': '" << (first == 1 ? '<' : '>') << "f4', 'fortran_order': False, 'shape': ("
+         << dims.z << ", " << dims.y << ", " << dims.x << "), }";
+    std::string header = dict.str();
+    const size_t prefix = 10;  // magic (6), version (2), header length (2)
+    header.append((64 - (prefix + header.size() + 1) % 64) % 64, ' ');
+    header += '\n';
+
+    const uint16_t length = static_cast<uint16_t>(header.size());
+    const uint8_t lengthBytes[2] = {static_cast<uint8_t>(length & 0xff), static_cast<uint8_t>(length >> 8)};
+
+    out.write("\x93NUMPY\x01\x00", 8);
+    out.write(reinterpret_cast<const char*>(lengthBytes), 2);
+    out.write(header.data(), static_cast<std::streamsize>(header.size()));
+}
+
+// Evaluate one grid and stream it into a file per format. Every format
+// stores the values in the same order after its header, so each slab is
+// appended to all files as soon as it is evaluated.
+void bakeJob(const Job& job, const Options& options, const glm::uvec3& dims) {
+    const glm::vec3 low(options.boundLow);
+    const glm::vec3 high(options.boundHigh);
+
+    std::vector<std::ofstream> files;
+    std::vector<std::string> paths;
+    for (const std::string& format : options.formats) {
+        paths.push_back(job.stem + "." + format);
+        files.push_back(openOutput(paths.back()));
+        if (format == "npy") {
+            writeNpyHeader(files.back(), dims);
+        } else if (format == "sdfb") {
+            sdf::BakedGrid::writeHeader(files.back(), job.handle, dims, low, high, job.time, options.seed);
+        }
+    }
+
+    sdf::StreamOptions stream;
+    stream.memoryBudget = static_cast<size_t>(options.maxMemoryMB * 1024.0 * 1024.0);
+    const size_t layer = static_cast<size_t>(dims.x) * dims.y;
+    sdf::streamGrid(job.handle, dims, low, high, [&](uint32_t, uint32_t count, const float* values) {
+        for (size_t f = 0; f < files.size(); ++f) {
+            files[f].write(reinterpret_cast<const char*>(values),
+                           static_cast<std::streamsize>(layer * count * sizeof(float)));
+            if (!files[f]) {
+                throw std::runtime_error("Failed writing " + paths[f]);
+            }
+        }
+    }, stream, job.time, options.seed);
+
+    // The final flush happens on close; a failure there (e.g. a full disk)
+    // would otherwise leave a truncated file behind without an error
+    for (size_t f = 0; f < files.size(); ++f) {
+        files[f].close();
+        if (!files[f]) {
+            throw std::runtime_error("Failed writing " + paths[f]);
+        }
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+
+        if (arg == "--help" || arg == "-h") {
+            printUsage(argv[0]);
+            return 0;
+        }
+        else if (arg == "--list" || arg == "-l") {
+            for (const auto& name : sdf::getAvailableSDFs()) {
+                std::cout << name << "\n";
+            }
+            return 0;
+        }
+        else if ((arg == "--resolution" || arg == "-r") && i + 1 < argc) {
+            options.resolution = static_cast<uint32_t>(std::atoi(argv[++i]));
+        }
+        else if (arg == "--bounds" && i + 2 < argc) {
+            options.boundLow = static_cast<float>(std::atof(argv[++i]));
+            options.boundHigh = static_cast<float>(std::atof(argv[++i]));
+        }
+        else if ((arg == "--time" || arg == "-t") && i + 1 < argc) {
+            const std::string range = argv[++i];
+            const size_t colon = range.find(':');
+            options.timeBegin = static_cast<float>(std::atof(range.substr(0, colon).c_str()));
+            options.timeEnd = colon == std::string::npos
+                ? options.timeBegin
+                : static_cast<float>(std::atof(range.substr(colon + 1).c_str()));
+        }
+        else if (arg == "--frames" && i + 1 < argc) {
+            options.frames = static_cast<uint32_t>(std::atoi(argv[++i]));
+        }
+        else if ((arg == "--seed" || arg == "-s") && i + 1 < argc) {
+            options.seed = static_cast<uint32_t>(std::atoll(argv[++i]));
+        }
+        else if (arg == "--format" && i + 1 < argc) {
+            options.formats = split(argv[++i], ',');
+        }
+        else if ((arg == "--output" || arg == "-o") && i + 1 < argc) {
+            options.output = argv[++i];
+        }
+        else if ((arg == "--threads" || arg == "-j") && i + 1 < argc) {
+            options.threads = static_cast<unsigned>(std::atoi(argv[++i]));
+        }
+        else if (arg == "--max-memory" && i + 1 < argc) {
+            options.maxMemoryMB = std::atof(argv[++i]);
+        }
+        else if (!arg.empty() && arg[0] != '-') {
+            for (const std::string& pattern : split(arg, ',')) {
+                options.shapes.push_back(pattern);
+            }
+        }
+        else {
+            std::cerr << "Unknown argument: " << arg << "\n";
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (options.resolution < 2) {
+        std::cerr << "Error: --resolution must be at least 2.\n";
+        return 1;
+    }
+    if (options.frames == 0) {
+        std::cerr << "Error: --frames must be positive.\n";
+        return 1;
+    }
+    for (const std::string& format : options.formats) {
+        if (std::find(std::begin(kFormats), std::end(kFormats), format) == std::end(kFormats)) {
+            std::cerr << "Error: Unknown format '" << format << "' (expected raw, npy or sdfb).\n";
+            return 1;
+        }
+    }
+    if (options.formats.empty()) {
+        std::cerr << "Error: --format needs at least one format.\n";
+        return 1;
+    }
+    if (!(options.boundLow < options.boundHigh)) {
+        std::cerr << "Error: --bounds must be increasing.\n";
+        return 1;
+    }
+
+    const glm::uvec3 dims(options.resolution);
+    try {
+        const std::vector<Job> jobs = makeJobs(options, selectShapes(options.shapes));
+        std::filesystem::create_directories(options.output);
+
+        sdf::setThreadCount(options.threads);
+        std::cerr << jobs.size() << " grids of " << options.resolution << "^3 on "
+                  << sdf::getThreadCount() << " threads\n";
+
+        using Clock = std::chrono::steady_clock;
+        const auto start = Clock::now();
+        for (size_t i = 0; i < jobs.size(); ++i) {
+            const Job& job = jobs[i];
+            const auto jobStart = Clock::now();
+            bakeJob(job, options, dims);
+            std::cerr << "  [" << (i + 1) << "/" << jobs.size() << "] " << job.stem << " ("
+                      << std::chrono::duration<double>(Clock::now() - jobStart).count() << " s)\n";
+        }
+
+        std::cerr << "Done in " << std::chrono::duration<double>(Clock::now() - start).count() << " s\n";
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
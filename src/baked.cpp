@@ -0,0 +1,368 @@
+#include "sdf/baked.hpp"
+#include "parallel.hpp"
+#include "slack.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define SDF_HAVE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace sdf {
+
+namespace {
+
+// Points per tile: the points that need an exact value are gathered into
+// stack arrays and evaluated as a single structure-of-arrays batch.
+constexpr size_t kTileSize = 256;
+
+// Points per parallel work chunk
+constexpr size_t kQueryGrain = 1024;
+
+// File layout (native byte order, checked through byteOrder): this header,
+// zero-padded to kHeaderSize bytes, then the node values as float32 with x
+// varying fastest. kHeaderSize is a multiple of the page size on common
+// systems, so a mapped file's values are page-aligned.
+constexpr char kMagic[4] = {'S', 'D', 'F', 'B'};
+constexpr uint32_t kVersion = 1;
+constexpr uint32_t kByteOrder = 0x01020304;
+constexpr uint32_t kHeaderSize = 4096;
+constexpr uint32_t kValueFloat32 = 1;
+constexpr uint32_t kLayoutXFastest = 0;
+constexpr size_t kNameSize = 64;
+
+struct FileHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint32_t headerSize;   // Offset of the first value
+    uint32_t valueType;    // kValueFloat32
+    uint32_t layout;       // kLayoutXFastest
+    uint32_t dims[3];
+    float boundLow[3];
+    float boundHigh[3];
+    float time;
+    uint32_t seed;
+    float narrowBand;
+    uint64_t valueCount;
+    char name[kNameSize];  // Registry name, NUL-padded
+};
+
+static_assert(sizeof(FileHeader) <= kHeaderSize, "baked grid header exceeds its reserved size");
+
+// Validate a header read from `path` and return the number of values. The
+// file holds `dataSize` bytes after the header; the dims are checked against
+// it by division, so no product can wrap.
+size_t checkHeader(const FileHeader& header, uint64_t dataSize, const std::string& path) {
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) {
+        throw std::runtime_error("Invalid baked grid file: bad magic: " + path);
+    }
+    if (header.byteOrder != kByteOrder) {
+        throw std::runtime_error("Baked grid file has a different byte order: " + path);
+    }
+    if (header.version != kVersion) {
+        throw std::runtime_error("Unsupported baked grid file version: " + std::to_string(header.version));
+    }
+    if (header.headerSize != kHeaderSize || header.valueType != kValueFloat32 ||
+        header.layout != kLayoutXFastest || header.dims[0] < 2 || header.dims[1] < 2 ||
+        header.dims[2] < 2 || std::memchr(header.name, '\0', kNameSize) == nullptr) {
+        throw std::runtime_error("Invalid baked grid file: bad header: " + path);
+    }
+    // Each dim is below 2^32, so the product of two cannot wrap
+    const uint64_t available = dataSize / sizeof(float);
+    const uint64_t layer = static_cast<uint64_t>(header.dims[0]) * header.dims[1];
+    if (layer > available / header.dims[2]) {
+        throw std::runtime_error("Invalid baked grid file: unexpected end of data: " + path);
+    }
+    const uint64_t count = layer * header.dims[2];
+    if (header.valueCount != count) {
+        throw std::runtime_error("Invalid baked grid file: bad header: " + path);
+    }
+    return static_cast<size_t>(count);
+}
+
+} // namespace
+
+BakedGrid BakedGrid::bake(
+    const Handle& sdf,
+    const glm::uvec3& dims,
+    const glm::vec3& boundLow,
+    const glm::vec3& boundHigh,
+    float time,
+    uint32_t seed
+) {
+    if (dims.x < 2 || dims.y < 2 || dims.z < 2) {
+        throw std::runtime_error("Baked grid needs at least 2 nodes per axis");
+    }
+    if (!(boundLow.x < boundHigh.x && boundLow.y < boundHigh.y && boundLow.z < boundHigh.z)) {
+        throw std::runtime_error("Baked grid bounds must be increasing");
+    }
+
+    BakedGrid grid;
+    grid.handle_ = sdf;
+    grid.dims_ = dims;
+    grid.boundLow_ = boundLow;
+    grid.boundHigh_ = boundHigh;
+    grid.step_ = (boundHigh - boundLow) / glm::vec3(dims - 1u);
+    grid.time_ = time;
+    grid.seed_ = seed;
+    auto values = std::make_shared<std::vector<float>>(grid.valueCount());
+    evaluateGrid(sdf, dims, boundLow, boundHigh, values->data(), time, seed);
+    grid.values_ = values->data();
+    grid.storage_ = std::move(values);
+    return grid;
+}
+
+void BakedGrid::setNarrowBand(float width) {
+    if (!(width >= 0.0f)) {
+        throw std::runtime_error("Narrow band width must not be negative");
+    }
+    narrowBand_ = width;
+}
+
+void BakedGrid::interpolate(const glm::vec3& point, float& value, float& error) const {
+    // Nearest point on the grid, and how far the query is from it
+    const glm::vec3 clamped = glm::clamp(point, boundLow_, boundHigh_);
+    const float outside = glm::length(point - clamped);
+
+    const glm::vec3 u = (clamped - boundLow_) / step_;
+    const glm::uvec3 cell = glm::min(glm::uvec3(u), dims_ - 2u);
+    const glm::vec3 t = glm::clamp(u - glm::vec3(cell), 0.0f, 1.0f);
+
+    const size_t sx = 1;
+    const size_t sy = dims_.x;
+    const size_t sz = static_cast<size_t>(dims_.x) * dims_.y;
+    const float* v = values_ + cell.x * sx + cell.y * sy + cell.z * sz;
+
+    const float x00 = v[0] + t.x * (v[sx] - v[0]);
+    const float x10 = v[sy] + t.x * (v[sy + sx] - v[sy]);
+    const float x01 = v[sz] + t.x * (v[sz + sx] - v[sz]);
+    const float x11 = v[sz + sy] + t.x * (v[sz + sy + sx] - v[sz + sy]);
+    const float y0 = x00 + t.y * (x10 - x00);
+    const float y1 = x01 + t.y * (x11 - x01);
+    value = y0 + t.z * (y1 - y0);
+
+    // The weighted mean of |p - node| is at most the root of the weighted
+    // mean of |p - node|^2, which separates into t (1 - t) h^2 per axis
+    const glm::vec3 spread = t * (1.0f - t) * step_ * step_;
+    error = (std::sqrt(spread.x + spread.y + spread.z) + outside) * detail::kRoundingSlack;
+}
+
+float BakedGrid::query(const glm::vec3& point) const {
+    float value, error;
+    interpolate(point, value, error);
+    if (std::abs(value) - error <= narrowBand_) {
+        return evaluate(handle_, point, time_, seed_);
+    }
+    return value > 0.0f ? value - error : value + error;
+}
+
+void BakedGrid::query(const glm::vec3* points, float* out, size_t count) const {
+    uint32_t near[kTileSize];
+    float xs[kTileSize], ys[kTileSize], zs[kTileSize], phi[kTileSize];
+
+    for (size_t b = 0; b < count; b += kTileSize) {
+        const size_t n = std::min(kTileSize, count - b);
+        size_t live = 0;
+        for (size_t i = 0; i < n; ++i) {
+            const glm::vec3& p = points[b + i];
+            float value, error;
+            interpolate(p, value, error);
+            if (std::abs(value) - error > narrowBand_) {
+                out[b + i] = value > 0.0f ? value - error : value + error;
+                continue;
+            }
+            near[live] = static_cast<uint32_t>(i);
+            xs[live] = p.x;
+            ys[live] = p.y;
+            zs[live] = p.z;
+            ++live;
+        }
+
+        if (live > 0) {
+            evaluate(handle_, xs, ys, zs, phi, live, time_, seed_);
+            for (size_t a = 0; a < live; ++a) {
+                out[b + near[a]] = phi[a];
+            }
+        }
+    }
+}
+
+void BakedGrid::queryParallel(const glm::vec3* points, float* out, size_t count) const {
+    detail::parallelFor(count, kQueryGrain, [&](size_t begin, size_t end) {
+        query(points + begin, out + begin, end - begin);
+    });
+}
+
+void BakedGrid::writeHeader(
+    std::ostream& out,
+    const Handle& sdf,
+    const glm::uvec3& dims,
+    const glm::vec3& boundLow,
+    const glm::vec3& boundHigh,
+    float time,
+    uint32_t seed,
+    float narrowBand
+) {
+    if (!sdf.name || std::strlen(sdf.name) >= kNameSize) {
+        throw std::runtime_error(std::string("SDF name too long for a baked grid file: ") + (sdf.name ? sdf.name : ""));
+    }
+
+    FileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.byteOrder = kByteOrder;
+    header.headerSize = kHeaderSize;
+    header.valueType = kValueFloat32;
+    header.layout = kLayoutXFastest;
+    for (int a = 0; a < 3; ++a) {
+        header.dims[a] = dims[a];
+        header.boundLow[a] = boundLow[a];
+        header.boundHigh[a] = boundHigh[a];
+    }
+    header.time = time;
+    header.seed = seed;
+    header.narrowBand = narrowBand;
+    header.valueCount = static_cast<uint64_t>(dims.x) * dims.y * dims.z;
+    std::strcpy(header.name, sdf.name);
+
+    std::vector<char> block(kHeaderSize, 0);
+    std::memcpy(block.data(), &header, sizeof(header));
+    out.write(block.data(), static_cast<std::streamsize>(block.size()));
+}
+
+void BakedGrid::save(const std::string& path) const {
+    if (!values_) {
+        throw std::runtime_error("Cannot save an empty baked grid");
+    }
+
+    std::ofstream out(path, std::ios::binary);
+    if (!out) {
+        throw std::runtime_error("Cannot open file for writing: " + path);
+    }
+    writeHeader(out, handle_, dims_, boundLow_, boundHigh_, time_, seed_, narrowBand_);
+    out.write(reinterpret_cast<const char*>(values_), static_cast<std::streamsize>(valueCount() * sizeof(float)));
+    out.close();
+    if (!out) {
+        throw std::runtime_error("Failed to write baked grid: " + path);
+    }
+}
+
+void BakedGrid::bakeToFile(
+    const Handle& sdf,
+    const glm::uvec3& dims,
+    const glm::vec3& boundLow,
+    const glm::vec3& boundHigh,
+    const std::string& path,
+    const StreamOptions& options,
+    float time,
+    uint32_t seed
+) {
+    if (dims.x < 2 || dims.y < 2 || dims.z < 2) {
+        throw std::runtime_error("Baked grid needs at least 2 nodes per axis");
+    }
+    if (!(boundLow.x < boundHigh.x && boundLow.y < boundHigh.y && boundLow.z < boundHigh.z)) {
+        throw std::runtime_error("Baked grid bounds must be increasing");
+    }
+
+    std::ofstream out(path, std::ios::binary);
+    if (!out) {
+        throw std::runtime_error("Cannot open file for writing: " + path);
+    }
+    writeHeader(out, sdf, dims, boundLow, boundHigh, time, seed);
+
+    const size_t layer = static_cast<size_t>(dims.x) * dims.y;
+    streamGrid(sdf, dims, boundLow, boundHigh, [&](uint32_t, uint32_t count, const float* values) {
+        out.write(reinterpret_cast<const char*>(values), static_cast<std::streamsize>(layer * count * sizeof(float)));
+        if (!out) {
+            throw std::runtime_error("Failed to write baked grid: " + path);
+        }
+    }, options, time, seed);
+
+    // Flush on close, so a failed final write is reported too
+    out.close();
+    if (!out) {
+        throw std::runtime_error("Failed to write baked grid: " + path);
+    }
+}
+
+BakedGrid BakedGrid::load(const std::string& path) {
+    FileHeader header;
+    BakedGrid grid;
+
+#if defined(SDF_HAVE_MMAP)
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open file: " + path);
+    }
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || static_cast<uint64_t>(info.st_size) < kHeaderSize) {
+        ::close(fd);
+        throw std::runtime_error("Invalid baked grid file: unexpected end of data: " + path);
+    }
+    const size_t length = static_cast<size_t>(info.st_size);
+    void* address = ::mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (address == MAP_FAILED) {
+        throw std::runtime_error("Cannot map file: " + path);
+    }
+    std::shared_ptr<const void> mapping(address, [length](const void* p) {
+        ::munmap(const_cast<void*>(p), length);
+    });
+
+    std::memcpy(&header, address, sizeof(header));
+    checkHeader(header, length - kHeaderSize, path);
+    grid.values_ = reinterpret_cast<const float*>(static_cast<const char*>(address) + kHeaderSize);
+    grid.storage_ = std::move(mapping);
+    grid.mapped_ = true;
+#else
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("Cannot open file: " + path);
+    }
+    std::vector<char> block(kHeaderSize);
+    if (!in.read(block.data(), kHeaderSize)) {
+        throw std::runtime_error("Invalid baked grid file: unexpected end of data: " + path);
+    }
+    std::memcpy(&header, block.data(), sizeof(header));
+    in.seekg(0, std::ios::end);
+    const std::streamoff end = in.tellg();
+    in.seekg(kHeaderSize);
+    if (!in || end < static_cast<std::streamoff>(kHeaderSize)) {
+        throw std::runtime_error("Cannot read file: " + path);
+    }
+    const size_t count = checkHeader(header, static_cast<uint64_t>(end - kHeaderSize), path);
+    auto values = std::make_shared<std::vector<float>>(count);
+    if (!in.read(reinterpret_cast<char*>(values->data()), static_cast<std::streamsize>(count * sizeof(float)))) {
+        throw std::runtime_error("Invalid baked grid file: unexpected end of data: " + path);
+    }
+    grid.values_ = values->data();
+    grid.storage_ = std::move(values);
+#endif
+
+    grid.handle_ = resolve(header.name);
+    grid.dims_ = glm::uvec3(header.dims[0], header.dims[1], header.dims[2]);
+    grid.boundLow_ = glm::vec3(header.boundLow[0], header.boundLow[1], header.boundLow[2]);
+    grid.boundHigh_ = glm::vec3(header.boundHigh[0], header.boundHigh[1], header.boundHigh[2]);
+    if (!(grid.boundLow_.x < grid.boundHigh_.x && grid.boundLow_.y < grid.boundHigh_.y &&
+          grid.boundLow_.z < grid.boundHigh_.z) || !(header.narrowBand >= 0.0f)) {
+        throw std::runtime_error("Invalid baked grid file: bad header: " + path);
+    }
+    grid.step_ = (grid.boundHigh_ - grid.boundLow_) / glm::vec3(grid.dims_ - 1u);
+    grid.time_ = header.time;
+    grid.seed_ = header.seed;
+    grid.narrowBand_ = header.narrowBand;
+    return grid;
+}
+
+} // namespace sdf
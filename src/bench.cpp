@@ -0,0 +1,369 @@
+// SDF Bench - Measure evaluation throughput of every registered SDF
+//
+// Usage:
+//   sdf_bench [--points N] [--threads T] [--min-time S] [--filter NAME]
+//             [--output FILE] [--baseline FILE] [--threshold P]
+//
+// Each SDF is evaluated on three point distributions: uniform over the
+// [-1, 1]^3 domain, near the surface (|distance| below kNearBand) and far
+// field (a shell of radius 2 to 4 around the domain). Each distribution is
+// timed on one thread and on all configured threads. Results are written as
+// JSON; with --baseline, they are compared against an earlier run and
+// slowdowns beyond the threshold are reported and make the exit code 1.
+//
+// Examples:
+//   sdf_bench > baseline.json
+//   sdf_bench --filter Mandelbulb --points 65536
+//   sdf_bench --baseline baseline.json --threshold 0.05
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "sdf/sdf.hpp"
+
+namespace {
+
+// Near-surface points are drawn from candidates with |distance| below this
+constexpr float kNearBand = 0.02f;
+
+// Candidates tried per near-surface point before settling for the closest ones
+constexpr size_t kNearAttempts = 64;
+
+const char* const kDistributions[] = {"uniform", "near", "far"};
+
+struct Options {
+    size_t points = 4096;
+    unsigned threads = 0;     // 0: all hardware threads
+    double minTime = 0.2;     // Seconds spent timing each measurement
+    std::string filter;
+    std::string output;
+    std::string baseline;
+    double threshold = 0.1;   // Relative slowdown reported as a regression
+};
+
+struct Result {
+    std::string name;
+    std::string category;
+    std::string distribution;
+    std::string mode;          // "single" or "multi"
+    unsigned threads = 1;
+    double pointsPerSecond = 0.0;
+};
+
+void printUsage(const char* progName) {
+    std::cout << "Usage: " << progName << " [options]\n"
+              << "\n"
+              << "Options:\n"
+              << "  --points N, -n N       Points per distribution (default: 4096)\n"
+              << "  --threads T, -j T      Threads for the multi-threaded runs (default: all)\n"
+              << "  --min-time S           Seconds to time each measurement (default: 0.2)\n"
+              << "  --filter NAME, -f NAME Only benchmark SDFs whose name contains NAME\n"
+              << "  --output FILE, -o FILE Write the JSON results to FILE (default: stdout)\n"
+              << "  --baseline FILE        Compare against the JSON results of an earlier run\n"
+              << "  --threshold P          Relative slowdown reported as a regression (default: 0.1)\n"
+              << "  --help, -h             Show this help message\n"
+              << "\n"
+              << "Examples:\n"
+              << "  " << progName << " > baseline.json\n"
+              << "  " << progName << " --filter Mandelbulb --points 65536\n"
+              << "  " << progName << " --baseline baseline.json --threshold 0.05\n";
+}
+
+glm::vec3 uniformPoint(std::mt19937& rng, float low, float high) {
+    std::uniform_real_distribution<float> u(low, high);
+    const float x = u(rng);
+    const float y = u(rng);
+    const float z = u(rng);
+    return glm::vec3(x, y, z);
+}
+
+// Points near the surface: the closest of up to kNearAttempts uniform
+// candidates per point, preferring those within kNearBand.
+std::vector<glm::vec3> nearPoints(const sdf::Handle& sdf, size_t count, std::mt19937& rng) {
+    std::vector<glm::vec3> candidates(count * kNearAttempts);
+    for (auto& p : candidates) {
+        p = uniformPoint(rng, -1.0f, 1.0f);
+    }
+    std::vector<float> distances(candidates.size());
+    sdf::evaluateParallel(sdf, candidates.data(), distances.data(), candidates.size());
+
+    std::vector<size_t> order(candidates.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    // Keep candidate order among the points inside the band so the sample
+    // is not biased towards the exact zero set
+    std::stable_partition(order.begin(), order.end(), [&](size_t i) {
+        return std::abs(distances[i]) < kNearBand;
+    });
+    const auto inBand = static_cast<size_t>(std::count_if(distances.begin(), distances.end(),
+        [](float d) { return std::abs(d) < kNearBand; }));
+    if (inBand < count) {
+        std::nth_element(order.begin() + inBand, order.begin() + count, order.end(), [&](size_t a, size_t b) {
+            return std::abs(distances[a]) < std::abs(distances[b]);
+        });
+    }
+
+    std::vector<glm::vec3> points(count);
+    for (size_t i = 0; i < count; ++i) {
+        points[i] = candidates[order[i]];
+    }
+    return points;
+}
+
+// Points on a shell of radius 2 to 4, well outside the [-1, 1]^3 domain
+std::vector<glm::vec3> farPoints(size_t count, std::mt19937& rng) {
+    std::uniform_real_distribution<float> radius(2.0f, 4.0f);
+    std::vector<glm::vec3> points(count);
+    for (auto& p : points) {
+        glm::vec3 d;
+        do {
+            d = uniformPoint(rng, -1.0f, 1.0f);
+        } while (glm::dot(d, d) > 1.0f || glm::dot(d, d) < 1e-4f);
+        p = glm::normalize(d) * radius(rng);
+    }
+    return points;
+}
+
+// Points per second of the fastest of the repetitions run within minTime
+template <typename F>
+double measure(F&& run, size_t count, double minTime) {
+    using Clock = std::chrono::steady_clock;
+    double best = 0.0;
+    double total = 0.0;
+    do {
+        const auto start = Clock::now();
+        run();
+        const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        total += seconds;
+        if (seconds > 0.0) {
+            best = std::max(best, static_cast<double>(count) / seconds);
+        }
+    } while (total < minTime);
+    return best;
+}
+
+std::string jsonString(const std::string& s) {
+    std::string out = "\"";
+    for (char c : s) {
+        if (c == '"' || c == '\\') out += '\\';
+        out += c;
+    }
+    return out + "\"";
+}
+
+void writeJson(std::ostream& out, const Options& options, unsigned threads, const std::vector<Result>& results) {
+    out << "{\n"
+        << "  \"simd\": " << jsonString(sdf::getSIMDTarget()) << ",\n"
+        << "  \"threads\": " << threads << ",\n"
+        << "  \"points\": " << options.points << ",\n"
+        << "  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        out << "    {\"name\": " << jsonString(r.name)
+            << ", \"category\": " << jsonString(r.category)
+            << ", \"distribution\": " << jsonString(r.distribution)
+            << ", \"mode\": " << jsonString(r.mode)
+            << ", \"threads\": " << r.threads
+            << ", \"pointsPerSecond\": " << r.pointsPerSecond << "}"
+            << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n"
+        << "}\n";
+}
+
+// Value of "key": in a flat JSON object, or an empty string
+std::string jsonField(const std::string& object, const std::string& key) {
+    const std::string pattern = "\"" + key + "\":";
+    size_t pos = object.find(pattern);
+    if (pos == std::string::npos) return "";
+    pos = object.find_first_not_of(" \t\n", pos + pattern.size());
+    if (pos == std::string::npos) return "";
+    if (object[pos] == '"') {
+        const size_t end = object.find('"', pos + 1);
+        return end == std::string::npos ? "" : object.substr(pos + 1, end - pos - 1);
+    }
+    const size_t end = object.find_first_of(",}", pos);
+    return object.substr(pos, end == std::string::npos ? std::string::npos : end - pos);
+}
+
+// Reads the results written by writeJson()
+std::vector<Result> readJson(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) {
+        throw std::runtime_error("Cannot open baseline: " + path);
+    }
+    std::stringstream buffer;
+    buffer << in.rdbuf();
+    const std::string text = buffer.str();
+
+    const size_t list = text.find("\"results\"");
+    if (list == std::string::npos) {
+        throw std::runtime_error("No results in baseline: " + path);
+    }
+
+    std::vector<Result> results;
+    size_t pos = list;
+    while ((pos = text.find('{', pos)) != std::string::npos) {
+        const size_t end = text.find('}', pos);
+        if (end == std::string::npos) break;
+        const std::string object = text.substr(pos, end - pos + 1);
+        Result r;
+        r.name = jsonField(object, "name");
+        r.distribution = jsonField(object, "distribution");
+        r.mode = jsonField(object, "mode");
+        r.pointsPerSecond = std::atof(jsonField(object, "pointsPerSecond").c_str());
+        if (!r.name.empty()) results.push_back(r);
+        pos = end + 1;
+    }
+    return results;
+}
+
+// Prints every result slower than the baseline by more than the threshold;
+// returns the number of regressions.
+size_t compare(const std::vector<Result>& results, const std::vector<Result>& baseline, double threshold) {
+    size_t regressions = 0;
+    size_t matched = 0;
+    for (const Result& r : results) {
+        for (const Result& b : baseline) {
+            if (b.name != r.name || b.distribution != r.distribution || b.mode != r.mode) continue;
+            ++matched;
+            const double change = r.pointsPerSecond / b.pointsPerSecond - 1.0;
+            if (b.pointsPerSecond > 0.0 && change < -threshold) {
+                std::cerr << "REGRESSION " << r.name << " " << r.distribution << " " << r.mode << ": "
+                          << b.pointsPerSecond << " -> " << r.pointsPerSecond << " points/s ("
+                          << static_cast<int>(change * 100.0) << "%)\n";
+                ++regressions;
+            }
+            break;
+        }
+    }
+    std::cerr << matched << " results compared, " << regressions << " regressions beyond "
+              << static_cast<int>(threshold * 100.0) << "%\n";
+    return regressions;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+
+        if (arg == "--help" || arg == "-h") {
+            printUsage(argv[0]);
+            return 0;
+        }
+        else if ((arg == "--points" || arg == "-n") && i + 1 < argc) {
+            options.points = static_cast<size_t>(std::atol(argv[++i]));
+        }
+        else if ((arg == "--threads" || arg == "-j") && i + 1 < argc) {
+            options.threads = static_cast<unsigned>(std::atoi(argv[++i]));
+        }
+        else if (arg == "--min-time" && i + 1 < argc) {
+            options.minTime = std::atof(argv[++i]);
+        }
+        else if ((arg == "--filter" || arg == "-f") && i + 1 < argc) {
+            options.filter = argv[++i];
+        }
+        else if ((arg == "--output" || arg == "-o") && i + 1 < argc) {
+            options.output = argv[++i];
+        }
+        else if (arg == "--baseline" && i + 1 < argc) {
+            options.baseline = argv[++i];
+        }
+        else if (arg == "--threshold" && i + 1 < argc) {
+            options.threshold = std::atof(argv[++i]);
+        }
+        else {
+            std::cerr << "Unknown argument: " << arg << "\n";
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (options.points == 0) {
+        std::cerr << "Error: --points must be positive.\n";
+        return 1;
+    }
+
+    std::vector<Result> baseline;
+    if (!options.baseline.empty()) {
+        try {
+            baseline = readJson(options.baseline);
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << "\n";
+            return 1;
+        }
+    }
+
+    sdf::setThreadCount(options.threads);
+    const unsigned threads = sdf::getThreadCount();
+    std::cerr << "SIMD target: " << sdf::getSIMDTarget() << ", " << threads << " threads, "
+              << options.points << " points per distribution\n";
+
+    std::vector<Result> results;
+    std::vector<float> distances(options.points);
+    for (const auto& name : sdf::getAvailableSDFs()) {
+        if (name.find(options.filter) == std::string::npos) continue;
+        const sdf::Handle handle = sdf::resolve(name);
+
+        // Same points on every run for a given SDF
+        std::mt19937 rng(12345);
+        std::vector<glm::vec3> sets[3];
+        sets[0].resize(options.points);
+        for (auto& p : sets[0]) {
+            p = uniformPoint(rng, -1.0f, 1.0f);
+        }
+        sets[1] = nearPoints(handle, options.points, rng);
+        sets[2] = farPoints(options.points, rng);
+
+        for (int d = 0; d < 3; ++d) {
+            const std::vector<glm::vec3>& points = sets[d];
+            for (bool multi : {false, true}) {
+                Result r;
+                r.name = name;
+                r.category = handle.category;
+                r.distribution = kDistributions[d];
+                r.mode = multi ? "multi" : "single";
+                r.threads = multi ? threads : 1;
+                r.pointsPerSecond = measure([&]() {
+                    if (multi) {
+                        sdf::evaluateParallel(handle, points.data(), distances.data(), points.size());
+                    } else {
+                        sdf::evaluate(handle, points.data(), distances.data(), points.size());
+                    }
+                }, points.size(), options.minTime);
+                std::cerr << "  " << name << " " << r.distribution << " " << r.mode << ": "
+                          << r.pointsPerSecond << " points/s\n";
+                results.push_back(r);
+            }
+        }
+    }
+
+    if (options.output.empty()) {
+        writeJson(std::cout, options, threads, results);
+    } else {
+        std::ofstream out(options.output);
+        if (!out) {
+            std::cerr << "Error: Cannot write " << options.output << "\n";
+            return 1;
+        }
+        writeJson(out, options, threads, results);
+    }
+
+    if (!baseline.empty() && compare(results, baseline, options.threshold) > 0) {
+        return 1;
+    }
+    return 0;
+}
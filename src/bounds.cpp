@@ -0,0 +1,84 @@
+#include "sdf/sdf.hpp"
+#include "parallel.hpp"
+
+#include <algorithm>
+
+namespace sdf {
+
+namespace {
+
+// Points per tile: the points that need an exact value are gathered into
+// stack arrays and evaluated as a single structure-of-arrays batch.
+constexpr size_t kTileSize = 256;
+
+// Points per parallel work chunk
+constexpr size_t kTruncatedGrain = 1024;
+
+void evaluateTile(
+    const Handle& sdf,
+    const glm::vec3* points,
+    float* out,
+    size_t count,
+    float truncation,
+    float time,
+    uint32_t seed
+) {
+    uint32_t near[kTileSize];
+    float xs[kTileSize], ys[kTileSize], zs[kTileSize], phi[kTileSize];
+
+    size_t live = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const float bound = boundDistance(sdf.bounds, points[i]);
+        if (bound > truncation) {
+            out[i] = bound;
+            continue;
+        }
+        near[live] = static_cast<uint32_t>(i);
+        xs[live] = points[i].x;
+        ys[live] = points[i].y;
+        zs[live] = points[i].z;
+        ++live;
+    }
+
+    // A tile with no point near the surface needs no evaluation, and skipping
+    // it keeps the unwritten arrays from being passed on
+    if (live > 0) {
+        evaluate(sdf, xs, ys, zs, phi, live, time, seed);
+        for (size_t a = 0; a < live; ++a) {
+            out[near[a]] = phi[a];
+        }
+    }
+}
+
+} // namespace
+
+void evaluateTruncated(
+    const Handle& sdf,
+    const glm::vec3* points,
+    float* out,
+    size_t count,
+    float truncation,
+    float time,
+    uint32_t seed
+) {
+    for (size_t b = 0; b < count; b += kTileSize) {
+        const size_t n = std::min(kTileSize, count - b);
+        evaluateTile(sdf, points + b, out + b, n, truncation, time, seed);
+    }
+}
+
+void evaluateTruncatedParallel(
+    const Handle& sdf,
+    const glm::vec3* points,
+    float* out,
+    size_t count,
+    float truncation,
+    float time,
+    uint32_t seed
+) {
+    detail::parallelFor(count, kTruncatedGrain, [&](size_t begin, size_t end) {
+        evaluateTruncated(sdf, points + begin, out + begin, end - begin, truncation, time, seed);
+    });
+}
+
+} // namespace sdf
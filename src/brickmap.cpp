@@ -0,0 +1,130 @@
+#include "sdf/brickmap.hpp"
+#include "parallel.hpp"
+#include "slack.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace sdf {
+
+namespace {
+
+// Points per tile: positions are generated into stack arrays and evaluated
+// as a single structure-of-arrays batch.
+constexpr size_t kTileSize = 256;
+
+// Brick centers per parallel work chunk in the classification pass
+constexpr size_t kCenterGrain = 1024;
+
+static_assert(BrickMap::kBrickVolume % kTileSize == 0, "bricks are evaluated in whole tiles");
+
+} // namespace
+
+BrickMap BrickMap::build(
+    const Handle& sdf,
+    const glm::uvec3& dims,
+    const glm::vec3& boundLow,
+    const glm::vec3& boundHigh,
+    float bandWidth,
+    float time,
+    uint32_t seed
+) {
+    if (dims.x < 2 || dims.y < 2 || dims.z < 2) {
+        throw std::runtime_error("Brick map needs at least 2 nodes per axis");
+    }
+    if (!(boundLow.x < boundHigh.x && boundLow.y < boundHigh.y && boundLow.z < boundHigh.z)) {
+        throw std::runtime_error("Brick map bounds must be increasing");
+    }
+    if (!(bandWidth >= 0.0f)) {
+        throw std::runtime_error("Brick map band width must not be negative");
+    }
+
+    BrickMap map;
+    map.dims_ = dims;
+    map.brickDims_ = (dims + (kBrickSize - 1)) / kBrickSize;
+    map.boundLow_ = boundLow;
+    map.boundHigh_ = boundHigh;
+    map.bandWidth_ = bandWidth;
+
+    // Node positions follow evaluateGrid(), so stored values match it
+    const glm::vec3 step = (boundHigh - boundLow) / glm::vec3(dims - 1u);
+    const float radius = 0.5f * glm::length(glm::vec3(kBrickSize - 1) * step) * detail::kRoundingSlack;
+    const glm::uvec3 bd = map.brickDims_;
+    const size_t brickCount = static_cast<size_t>(bd.x) * bd.y * bd.z;
+
+    // Classify every brick by the SDF at its center; partial bricks at the
+    // upper faces are treated as whole, their extra nodes lying past the grid
+    std::vector<float> centers(brickCount);
+    detail::parallelFor(brickCount, kCenterGrain, [&](size_t begin, size_t end) {
+        float xs[kTileSize], ys[kTileSize], zs[kTileSize];
+        for (size_t b0 = begin; b0 < end; b0 += kTileSize) {
+            const size_t n = std::min(kTileSize, end - b0);
+            for (size_t i = 0; i < n; ++i) {
+                const size_t b = b0 + i;
+                const glm::uvec3 brick(b % bd.x, (b / bd.x) % bd.y, b / (static_cast<size_t>(bd.x) * bd.y));
+                const glm::vec3 center = boundLow + (glm::vec3(brick * kBrickSize) + 0.5f * (kBrickSize - 1)) * step;
+                xs[i] = center.x;
+                ys[i] = center.y;
+                zs[i] = center.z;
+            }
+            evaluate(sdf, xs, ys, zs, centers.data() + b0, n, time, seed);
+        }
+    });
+
+    // Allocate storage in brick order so the layout is independent of the
+    // thread count
+    map.index_.assign(brickCount, kInactive);
+    map.fill_.assign(brickCount, 0.0f);
+    for (size_t b = 0; b < brickCount; ++b) {
+        const float phi = centers[b];
+        if (std::abs(phi) - bandWidth > radius) {
+            map.fill_[b] = std::copysign(std::abs(phi) - radius, phi);
+        } else {
+            map.index_[b] = static_cast<uint32_t>(map.bricks_.size());
+            map.bricks_.emplace_back(b % bd.x, (b / bd.x) % bd.y, b / (static_cast<size_t>(bd.x) * bd.y));
+        }
+    }
+
+    // Sample the stored bricks densely, one brick per work item
+    map.values_.resize(map.bricks_.size() * kBrickVolume);
+    detail::parallelFor(map.bricks_.size(), 1, [&](size_t begin, size_t end) {
+        float xs[kTileSize], ys[kTileSize], zs[kTileSize];
+        for (size_t b = begin; b < end; ++b) {
+            const glm::uvec3 base = map.bricks_[b] * kBrickSize;
+            float* out = map.values_.data() + b * kBrickVolume;
+            for (uint32_t t0 = 0; t0 < kBrickVolume; t0 += kTileSize) {
+                for (uint32_t i = 0; i < kTileSize; ++i) {
+                    const uint32_t local = t0 + i;
+                    const uint32_t x = base.x + local % kBrickSize;
+                    const uint32_t y = base.y + (local / kBrickSize) % kBrickSize;
+                    const uint32_t z = base.z + local / (kBrickSize * kBrickSize);
+                    xs[i] = boundLow.x + x * step.x;
+                    ys[i] = boundLow.y + y * step.y;
+                    zs[i] = boundLow.z + z * step.z;
+                }
+                evaluate(sdf, xs, ys, zs, out + t0, kTileSize, time, seed);
+            }
+        }
+    });
+
+    map.evaluations_ = brickCount + map.values_.size();
+    return map;
+}
+
+size_t BrickMap::activeCount() const {
+    size_t count = 0;
+    for (const glm::uvec3& brick : bricks_) {
+        const glm::uvec3 base = brick * kBrickSize;
+        const glm::uvec3 n = glm::min(base + kBrickSize, dims_) - base;
+        count += static_cast<size_t>(n.x) * n.y * n.z;
+    }
+    return count;
+}
+
+size_t BrickMap::memoryBytes() const {
+    return index_.size() * sizeof(uint32_t) + fill_.size() * sizeof(float) +
+           bricks_.size() * sizeof(glm::uvec3) + values_.size() * sizeof(float);
+}
+
+} // namespace sdf
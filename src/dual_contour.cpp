@@ -0,0 +1,696 @@
+#include "sdf/mesh.hpp"
+#include "sdf/octree.hpp"
+#include "parallel.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+
+namespace sdf {
+
+namespace {
+
+using Node = Octree::Node;
+
+// Subtrees rooted at this depth are simplified and contoured in parallel
+constexpr uint32_t kParallelDepth = 3;
+
+// Eigenvalues of the QEF matrix below this fraction of the largest are
+// treated as zero, so the vertex stays at the mass point along directions
+// the surface samples do not constrain
+constexpr double kEigenCutoff = 0.01;
+
+constexpr uint32_t kNone = UINT32_MAX;
+
+// Cells around an edge along axis d, listed counter-clockwise seen from +d:
+// side (0 = low, 1 = high) of each cell along axes (d + 1) % 3 and (d + 2) % 3
+constexpr uint32_t kQuadrant[4][2] = {{0, 0}, {1, 0}, {1, 1}, {0, 1}};
+
+bool inside(float value) {
+    return value < 0.0f;
+}
+
+// Quadratic error function: sum of squared distances to the tangent planes
+// at the surface crossings, stored in normal-equation form so that the
+// functions of neighbouring cells merge by addition
+struct Qef {
+    double ata[6] = {};  // xx, xy, xz, yy, yz, zz
+    double atb[3] = {};
+    double btb = 0.0;
+    double mass[3] = {};
+    uint32_t count = 0;
+
+    void add(const glm::vec3& p, const glm::vec3& n) {
+        const double nx = n.x, ny = n.y, nz = n.z;
+        const double b = nx * p.x + ny * p.y + nz * p.z;
+        ata[0] += nx * nx;
+        ata[1] += nx * ny;
+        ata[2] += nx * nz;
+        ata[3] += ny * ny;
+        ata[4] += ny * nz;
+        ata[5] += nz * nz;
+        atb[0] += nx * b;
+        atb[1] += ny * b;
+        atb[2] += nz * b;
+        btb += b * b;
+        mass[0] += p.x;
+        mass[1] += p.y;
+        mass[2] += p.z;
+        ++count;
+    }
+
+    void merge(const Qef& other) {
+        for (int i = 0; i < 6; ++i) ata[i] += other.ata[i];
+        for (int i = 0; i < 3; ++i) atb[i] += other.atb[i];
+        btb += other.btb;
+        for (int i = 0; i < 3; ++i) mass[i] += other.mass[i];
+        count += other.count;
+    }
+
+    /// Minimize the error, moving from the mass point only along well
+    /// constrained directions. Returns the residual error.
+    double solve(glm::vec3& x) const {
+        const double m[3][3] = {
+            {ata[0], ata[1], ata[2]},
+            {ata[1], ata[3], ata[4]},
+            {ata[2], ata[4], ata[5]},
+        };
+        const double c[3] = {mass[0] / count, mass[1] / count, mass[2] / count};
+        double r[3];
+        for (int i = 0; i < 3; ++i) {
+            r[i] = atb[i] - (m[i][0] * c[0] + m[i][1] * c[1] + m[i][2] * c[2]);
+        }
+
+        double a[3][3], v[3][3], w[3];
+        std::copy(&m[0][0], &m[0][0] + 9, &a[0][0]);
+        eigenSymmetric(a, v, w);
+        const double largest = std::max({w[0], w[1], w[2]});
+        double y[3] = {0.0, 0.0, 0.0};
+        for (int k = 0; k < 3; ++k) {
+            if (!(w[k] > kEigenCutoff * largest)) continue;
+            const double s = (v[0][k] * r[0] + v[1][k] * r[1] + v[2][k] * r[2]) / w[k];
+            for (int i = 0; i < 3; ++i) y[i] += s * v[i][k];
+        }
+
+        const double p[3] = {c[0] + y[0], c[1] + y[1], c[2] + y[2]};
+        x = glm::vec3(static_cast<float>(p[0]), static_cast<float>(p[1]), static_cast<float>(p[2]));
+        double error = btb;
+        for (int i = 0; i < 3; ++i) {
+            error += p[i] * (m[i][0] * p[0] + m[i][1] * p[1] + m[i][2] * p[2] - 2.0 * atb[i]);
+        }
+        return std::max(error, 0.0);
+    }
+
+    // Cyclic Jacobi rotations: a = v diag(w) v^T, eigenvectors in the columns of v
+    static void eigenSymmetric(double a[3][3], double v[3][3], double w[3]) {
+        for (int i = 0; i < 3; ++i) {
+            for (int j = 0; j < 3; ++j) v[i][j] = i == j ? 1.0 : 0.0;
+        }
+        for (int sweep = 0; sweep < 16; ++sweep) {
+            const double off = a[0][1] * a[0][1] + a[0][2] * a[0][2] + a[1][2] * a[1][2];
+            const double diag = a[0][0] * a[0][0] + a[1][1] * a[1][1] + a[2][2] * a[2][2];
+            if (off <= 1e-24 * diag) break;
+            for (int p = 0; p < 2; ++p) {
+                for (int q = p + 1; q < 3; ++q) {
+                    if (a[p][q] == 0.0) continue;
+                    const double theta = (a[q][q] - a[p][p]) / (2.0 * a[p][q]);
+                    const double t = (theta >= 0.0 ? 1.0 : -1.0) /
+                                     (std::abs(theta) + std::sqrt(theta * theta + 1.0));
+                    const double cs = 1.0 / std::sqrt(t * t + 1.0);
+                    const double sn = t * cs;
+                    for (int k = 0; k < 3; ++k) {
+                        const double akp = a[k][p], akq = a[k][q];
+                        a[k][p] = cs * akp - sn * akq;
+                        a[k][q] = sn * akp + cs * akq;
+                    }
+                    for (int k = 0; k < 3; ++k) {
+                        const double apk = a[p][k], aqk = a[q][k];
+                        a[p][k] = cs * apk - sn * aqk;
+                        a[q][k] = sn * apk + cs * aqk;
+                    }
+                    for (int k = 0; k < 3; ++k) {
+                        const double vkp = v[k][p], vkq = v[k][q];
+                        v[k][p] = cs * vkp - sn * vkq;
+                        v[k][q] = sn * vkp + cs * vkq;
+                    }
+                }
+            }
+        }
+        for (int i = 0; i < 3; ++i) w[i] = a[i][i];
+    }
+};
+
+// True if the inside corners and the outside corners of a cube are each
+// connected along its edges. The surface through the cube is then a single
+// disc: each side is one piece, and the cube's edge graph is planar.
+bool isManifold(uint32_t mask) {
+    auto connected = [](uint32_t set) {
+        if (set == 0) return true;
+        uint32_t reached = set & (~set + 1);
+        for (bool grew = true; grew;) {
+            grew = false;
+            for (uint32_t c = 0; c < 8; ++c) {
+                if (!((reached >> c) & 1)) continue;
+                for (uint32_t axis = 0; axis < 3; ++axis) {
+                    const uint32_t n = c ^ (1u << axis);
+                    if (((set >> n) & 1) && !((reached >> n) & 1)) {
+                        reached |= 1u << n;
+                        grew = true;
+                    }
+                }
+            }
+        }
+        return reached == set;
+    };
+    return connected(mask) && connected(~mask & 0xFFu);
+}
+
+uint32_t cornerMask(const Node& node) {
+    uint32_t mask = 0;
+    for (uint32_t c = 0; c < 8; ++c) {
+        if (inside(node.corners[c])) mask |= 1u << c;
+    }
+    return mask;
+}
+
+// A node reached during traversal
+struct Ref {
+    uint32_t node;
+    uint32_t depth;
+    glm::uvec3 min;  // Lowest corner, in the lattice of the finest cells
+};
+
+// Surface crossing of a cell edge, keyed by 3 * (index of the edge's lower
+// end in the lattice of the finest cells) + axis, and by its length in
+// finest cells
+struct Crossing {
+    uint64_t key;
+    uint32_t span;
+    float low;   // SDF value at the lower end
+    float high;  // SDF value at the upper end
+
+    bool operator<(const Crossing& other) const {
+        return key != other.key ? key < other.key : span < other.span;
+    }
+    bool operator==(const Crossing& other) const {
+        return key == other.key && span == other.span;
+    }
+};
+
+// A minimal edge with a sign change and the four leaves around it, in
+// kQuadrant order
+struct Quad {
+    Crossing edge;
+    Ref leaves[4];
+};
+
+class Contourer {
+public:
+    Contourer(const Octree& tree, const Handle& sdf, const DualContourOptions& options,
+              float time, uint32_t seed)
+        : tree_(tree), nodes_(tree.nodes()), sdf_(sdf), options_(options), time_(time), seed_(seed),
+          maxDepth_(static_cast<uint32_t>(tree.maxDepth())),
+          lattice_((1ull << maxDepth_) + 1),
+          cellSize_(tree.size() / static_cast<float>(1u << maxDepth_)),
+          collapsed_(nodes_.size(), 0),
+          vertexIndex_(nodes_.size(), kNone) {}
+
+    Mesh run() {
+        findCrossings();
+        Mesh mesh;
+        placeVertices(mesh);
+        const std::vector<Quad> quads = gatherQuads();
+        placeMissingVertices(quads, mesh);
+        triangulate(quads, mesh);
+        return mesh;
+    }
+
+private:
+    bool isLeaf(uint32_t node) const {
+        return nodes_[node].isLeaf() || collapsed_[node];
+    }
+
+    // Child c of an interior node of the built tree
+    Ref descend(const Ref& ref, uint32_t c) const {
+        const uint32_t half = 1u << (maxDepth_ - ref.depth - 1);
+        return Ref{nodes_[ref.node].firstChild + c, ref.depth + 1,
+                   ref.min + half * glm::uvec3(c & 1, (c >> 1) & 1, (c >> 2) & 1)};
+    }
+
+    // Child c of a node, or the node itself if it is a leaf after collapsing
+    Ref child(const Ref& ref, uint32_t c) const {
+        if (isLeaf(ref.node)) return ref;
+        return descend(ref, c);
+    }
+
+    glm::vec3 latticePoint(uint64_t x, uint64_t y, uint64_t z) const {
+        return tree_.boundLow() + glm::vec3(float(x), float(y), float(z)) * cellSize_;
+    }
+
+    // The sign changing edges of all leaves are gathered once, so each
+    // crossing is located and its normal evaluated once however many cells
+    // share the edge
+    void findCrossings() {
+        collectCrossings(Ref{0, 0, glm::uvec3(0)});
+        std::sort(crossings_.begin(), crossings_.end());
+        crossings_.erase(std::unique(crossings_.begin(), crossings_.end()), crossings_.end());
+
+        locate(crossings_, positions_, normals_);
+    }
+
+    // Locate the surface on each edge by linear interpolation of the end
+    // values, refined by regula falsi on the SDF itself in parallel batches
+    // over all edges, and evaluate the unit normal there
+    void locate(const std::vector<Crossing>& edges, std::vector<glm::vec3>& positions,
+                std::vector<glm::vec3>& normals) const {
+        const size_t count = edges.size();
+        std::vector<glm::vec3> low(count), high(count);
+        std::vector<float> lowValue(count), highValue(count), value(count);
+        for (size_t e = 0; e < count; ++e) {
+            const uint64_t key = edges[e].key;
+            const uint64_t span = edges[e].span;
+            const uint64_t axis = key % 3;
+            const uint64_t index = key / 3;
+            const uint64_t x = index % lattice_, y = (index / lattice_) % lattice_, z = index / (lattice_ * lattice_);
+            low[e] = latticePoint(x, y, z);
+            high[e] = latticePoint(x + span * (axis == 0), y + span * (axis == 1), z + span * (axis == 2));
+            lowValue[e] = edges[e].low;
+            highValue[e] = edges[e].high;
+        }
+        positions.resize(count);
+        auto interpolate = [&]() {
+            for (size_t e = 0; e < count; ++e) {
+                const float t = glm::clamp(lowValue[e] / (lowValue[e] - highValue[e]), 0.0f, 1.0f);
+                positions[e] = low[e] + t * (high[e] - low[e]);
+            }
+        };
+        for (int step = 0; step < options_.rootSteps; ++step) {
+            interpolate();
+            evaluateParallel(sdf_, positions.data(), value.data(), count, time_, seed_);
+            for (size_t e = 0; e < count; ++e) {
+                if (inside(value[e]) == inside(lowValue[e])) {
+                    low[e] = positions[e];
+                    lowValue[e] = value[e];
+                } else {
+                    high[e] = positions[e];
+                    highValue[e] = value[e];
+                }
+            }
+        }
+        interpolate();
+
+        normals.resize(count);
+        evaluateWithGradientParallel(sdf_, positions.data(), value.data(), normals.data(), count, time_, seed_);
+        for (glm::vec3& n : normals) {
+            const float length = glm::length(n);
+            n = length > 0.0f ? n / length : glm::vec3(0.0f);
+        }
+    }
+
+    void collectCrossings(const Ref& ref) {
+        const Node& node = nodes_[ref.node];
+        if (!node.isLeaf()) {
+            for (uint32_t c = 0; c < 8; ++c) collectCrossings(descend(ref, c));
+            return;
+        }
+        forEachCrossing(node, ref.depth, ref.min, [&](const Crossing& crossing) { crossings_.push_back(crossing); });
+    }
+
+    uint64_t edgeKey(const glm::uvec3& low, uint32_t axis) const {
+        return 3 * (low.x + lattice_ * (low.y + lattice_ * low.z)) + axis;
+    }
+
+    // Call f(crossing) for each sign changing edge of a leaf
+    template <class F>
+    void forEachCrossing(const Node& node, uint32_t depth, const glm::uvec3& min, F&& f) const {
+        const uint32_t span = 1u << (maxDepth_ - depth);
+        for (uint32_t axis = 0; axis < 3; ++axis) {
+            for (uint32_t c0 = 0; c0 < 8; ++c0) {
+                if ((c0 >> axis) & 1) continue;
+                const uint32_t c1 = c0 | (1u << axis);
+                if (inside(node.corners[c0]) == inside(node.corners[c1])) continue;
+                const glm::uvec3 low = min + span * glm::uvec3(c0 & 1, (c0 >> 1) & 1, c0 >> 2);
+                f(Crossing{edgeKey(low, axis), span, node.corners[c0], node.corners[c1]});
+            }
+        }
+    }
+
+    // Result of simplifying a subtree
+    struct Simplified {
+        Qef qef;
+        bool leaf;  // The subtree is now a single leaf
+    };
+
+    // Vertex of a leaf, in post-order; a collapse replaces the vertices of
+    // the children, which are the last entries
+    using VertexList = std::vector<std::pair<uint32_t, glm::vec3>>;
+
+    /// Compute the vertices of the subtree and collapse it bottom-up where
+    /// the merged QEF still fits the surface. With frontier results, nodes
+    /// found there are taken from them instead of recursing.
+    Simplified simplify(const Ref& ref, VertexList& vertices,
+                        const std::unordered_map<uint32_t, std::pair<Simplified, VertexList>>* frontier) {
+        if (frontier) {
+            const auto it = frontier->find(ref.node);
+            if (it != frontier->end()) {
+                vertices.insert(vertices.end(), it->second.second.begin(), it->second.second.end());
+                return it->second.first;
+            }
+        }
+
+        const Node& node = nodes_[ref.node];
+        const float size = cellSize_ * static_cast<float>(1u << (maxDepth_ - ref.depth));
+        const glm::vec3 low = latticePoint(ref.min.x, ref.min.y, ref.min.z);
+        Simplified result{Qef{}, true};
+
+        if (node.isLeaf()) {
+            forEachCrossing(node, ref.depth, ref.min, [&](const Crossing& crossing) {
+                const auto it = std::lower_bound(crossings_.begin(), crossings_.end(), crossing);
+                const size_t e = static_cast<size_t>(it - crossings_.begin());
+                result.qef.add(positions_[e], normals_[e]);
+            });
+            if (result.qef.count == 0) return result;
+            vertices.emplace_back(ref.node, cellVertex(result.qef, low, size));
+            return result;
+        }
+
+        const size_t first = vertices.size();
+        bool childrenLeaves = true;
+        for (uint32_t c = 0; c < 8; ++c) {
+            const Simplified sub = simplify(descend(ref, c), vertices, frontier);
+            result.qef.merge(sub.qef);
+            childrenLeaves = childrenLeaves && sub.leaf;
+        }
+
+        result.leaf = false;
+        if (!childrenLeaves || options_.tolerance <= 0.0f || !topologySafe(node)) return result;
+        glm::vec3 x(0.0f);
+        if (result.qef.count > 0) {
+            const double error = result.qef.solve(x);
+            const double tolerance = options_.tolerance;
+            if (error > tolerance * tolerance || !contains(low, size, x)) return result;
+        }
+
+        collapsed_[ref.node] = 1;
+        vertices.resize(first);
+        if (result.qef.count > 0) vertices.emplace_back(ref.node, x);
+        result.leaf = true;
+        return result;
+    }
+
+    // The minimizer of a leaf's QEF, or the mean of its crossings if that
+    // leaves the cell: the crossings all lie in the cell, and so does their
+    // mean
+    static glm::vec3 cellVertex(const Qef& qef, const glm::vec3& low, float size) {
+        glm::vec3 x;
+        qef.solve(x);
+        if (!contains(low, size, x)) {
+            x = glm::vec3(float(qef.mass[0] / qef.count), float(qef.mass[1] / qef.count),
+                          float(qef.mass[2] / qef.count));
+        }
+        return x;
+    }
+
+    static bool contains(const glm::vec3& low, float size, const glm::vec3& x) {
+        return x.x >= low.x && x.y >= low.y && x.z >= low.z &&
+               x.x <= low.x + size && x.y <= low.y + size && x.z <= low.z + size;
+    }
+
+    // Whether replacing the 8 leaf children of a node by one leaf keeps the
+    // topology of the contour: the node's own sign configuration and those
+    // of its children must each carry a single disc, and every corner of the
+    // children must have the sign of the trilinear interpolation of the
+    // node's corners there, so the node's corners show every crossing of
+    // its edges and faces that a smaller neighbour can see
+    bool topologySafe(const Node& node) const {
+        if (!isManifold(cornerMask(node))) return false;
+        for (uint32_t c = 0; c < 8; ++c) {
+            if (!isManifold(cornerMask(nodes_[node.firstChild + c]))) return false;
+        }
+
+        // The corners of the children form a 3x3x3 lattice; indices 0 and 2
+        // are the node's corners, 1 the midpoints
+        auto weight = [](uint32_t index, uint32_t side) {
+            return index == 1 ? 0.5f : (index / 2 == side ? 1.0f : 0.0f);
+        };
+        for (uint32_t k = 0; k < 3; ++k) {
+            for (uint32_t j = 0; j < 3; ++j) {
+                for (uint32_t i = 0; i < 3; ++i) {
+                    const uint32_t cx = i / 2, cy = j / 2, cz = k / 2;
+                    const Node& child = nodes_[node.firstChild + (cx | (cy << 1) | (cz << 2))];
+                    const float value = child.corners[(i - cx) | ((j - cy) << 1) | ((k - cz) << 2)];
+                    float interpolated = 0.0f;
+                    for (uint32_t c = 0; c < 8; ++c) {
+                        interpolated += weight(i, c & 1) * weight(j, (c >> 1) & 1) * weight(k, c >> 2) *
+                                        node.corners[c];
+                    }
+                    if (inside(value) != inside(interpolated)) return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    void placeVertices(Mesh& mesh) {
+        // Simplify the subtrees below kParallelDepth in parallel, then the
+        // levels above them serially on top of their results
+        std::vector<Ref> roots;
+        gatherFrontier(Ref{0, 0, glm::uvec3(0)}, roots);
+        std::vector<std::pair<Simplified, VertexList>> parts(roots.size());
+        detail::parallelFor(roots.size(), 1, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                parts[i].first = simplify(roots[i], parts[i].second, nullptr);
+            }
+        });
+        std::unordered_map<uint32_t, std::pair<Simplified, VertexList>> frontier;
+        for (size_t i = 0; i < roots.size(); ++i) {
+            frontier.emplace(roots[i].node, std::move(parts[i]));
+        }
+
+        VertexList vertices;
+        simplify(Ref{0, 0, glm::uvec3(0)}, vertices, &frontier);
+        mesh.vertices.reserve(vertices.size());
+        for (const auto& [node, position] : vertices) {
+            vertexIndex_[node] = static_cast<uint32_t>(mesh.vertices.size());
+            mesh.vertices.push_back(position);
+        }
+    }
+
+    void gatherFrontier(const Ref& ref, std::vector<Ref>& roots) const {
+        if (nodes_[ref.node].isLeaf()) return;
+        if (ref.depth == kParallelDepth) {
+            roots.push_back(ref);
+            return;
+        }
+        for (uint32_t c = 0; c < 8; ++c) gatherFrontier(descend(ref, c), roots);
+    }
+
+    // Contouring in the manner of Ju et al.: cellProc visits every cell,
+    // faceProc every pair of cells sharing a face and edgeProc every group
+    // of four cells sharing an edge, down to the leaves. Each minimal edge
+    // with a sign change gives one quad joining the vertices of its four
+    // leaves (a triangle when two of them are the same leaf).
+
+    std::vector<Quad> gatherQuads() const {
+        // The top levels run serially and hand the subtrees at
+        // kParallelDepth to the threads; their faces and edges reach into
+        // the subtrees, but a subtree's own interior is contoured once
+        std::vector<Quad> top;
+        std::vector<Ref> tasks;
+        cellProc(Ref{0, 0, glm::uvec3(0)}, top, &tasks);
+        std::vector<std::vector<Quad>> parts(tasks.size());
+        detail::parallelFor(tasks.size(), 1, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) cellProc(tasks[i], parts[i], nullptr);
+        });
+
+        for (const auto& part : parts) top.insert(top.end(), part.begin(), part.end());
+        return top;
+    }
+
+    // A leaf without crossings of its own still needs a vertex when it
+    // borders a sign changing minimal edge: a smaller neighbour can see the
+    // surface cross part of a shared face that the leaf's corners miss, and
+    // a proven inside or outside leaf can meet the surface on its boundary.
+    // Its vertex is placed from the crossings of those edges, which lie on
+    // the leaf's boundary, so that no quad is dropped.
+    void placeMissingVertices(const std::vector<Quad>& quads, Mesh& mesh) {
+        std::vector<std::pair<uint32_t, size_t>> missing;  // Node, quad
+        std::vector<Crossing> edges;
+        for (size_t i = 0; i < quads.size(); ++i) {
+            for (const Ref& leaf : quads[i].leaves) {
+                if (vertexIndex_[leaf.node] != kNone) continue;
+                missing.emplace_back(leaf.node, i);
+                edges.push_back(quads[i].edge);
+            }
+        }
+        if (missing.empty()) return;
+        std::sort(missing.begin(), missing.end());
+        missing.erase(std::unique(missing.begin(), missing.end()), missing.end());
+        std::sort(edges.begin(), edges.end());
+        edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+        std::vector<glm::vec3> positions, normals;
+        locate(edges, positions, normals);
+
+        for (size_t first = 0; first < missing.size();) {
+            const uint32_t node = missing[first].first;
+            Qef qef;
+            Ref ref{};
+            size_t last = first;
+            for (; last < missing.size() && missing[last].first == node; ++last) {
+                const Quad& quad = quads[missing[last].second];
+                const size_t e = static_cast<size_t>(
+                    std::lower_bound(edges.begin(), edges.end(), quad.edge) - edges.begin());
+                qef.add(positions[e], normals[e]);
+                for (const Ref& leaf : quad.leaves) {
+                    if (leaf.node == node) ref = leaf;
+                }
+            }
+            const float size = cellSize_ * static_cast<float>(1u << (maxDepth_ - ref.depth));
+            vertexIndex_[node] = static_cast<uint32_t>(mesh.vertices.size());
+            mesh.vertices.push_back(cellVertex(qef, latticePoint(ref.min.x, ref.min.y, ref.min.z), size));
+            first = last;
+        }
+    }
+
+    void triangulate(const std::vector<Quad>& quads, Mesh& mesh) const {
+        mesh.triangles.reserve(2 * quads.size());
+        for (const Quad& quad : quads) {
+            uint32_t index[4];
+            for (int i = 0; i < 4; ++i) index[i] = vertexIndex_[quad.leaves[i].node];
+
+            // The quad runs counter-clockwise seen from +d, which is outside
+            // when the low end of the edge is inside
+            const bool lowInside = inside(quad.edge.low);
+            auto emit = [&](uint32_t a, uint32_t b, uint32_t c) {
+                if (a == b || b == c || a == c) return;
+                mesh.triangles.emplace_back(a, lowInside ? b : c, lowInside ? c : b);
+            };
+            emit(index[0], index[1], index[2]);
+            emit(index[0], index[2], index[3]);
+        }
+    }
+
+    void cellProc(const Ref& ref, std::vector<Quad>& out, std::vector<Ref>* tasks) const {
+        if (isLeaf(ref.node)) return;
+        if (tasks && ref.depth == kParallelDepth) {
+            tasks->push_back(ref);
+            return;
+        }
+        for (uint32_t c = 0; c < 8; ++c) cellProc(child(ref, c), out, tasks);
+        for (uint32_t d = 0; d < 3; ++d) {
+            for (uint32_t c = 0; c < 8; ++c) {
+                if ((c >> d) & 1) continue;
+                faceProc(child(ref, c), child(ref, c | (1u << d)), d, out);
+            }
+        }
+        for (uint32_t d = 0; d < 3; ++d) {
+            const uint32_t u = (d + 1) % 3, v = (d + 2) % 3;
+            for (uint32_t h = 0; h < 2; ++h) {
+                Ref q[4];
+                for (int i = 0; i < 4; ++i) {
+                    q[i] = child(ref, (h << d) | (kQuadrant[i][0] << u) | (kQuadrant[i][1] << v));
+                }
+                edgeProc(q, d, out);
+            }
+        }
+    }
+
+    // a and b share a face perpendicular to axis d, a on the low side
+    void faceProc(const Ref& a, const Ref& b, uint32_t d, std::vector<Quad>& out) const {
+        if (isLeaf(a.node) && isLeaf(b.node)) return;
+        const uint32_t u = (d + 1) % 3, v = (d + 2) % 3;
+        for (uint32_t su = 0; su < 2; ++su) {
+            for (uint32_t sv = 0; sv < 2; ++sv) {
+                const uint32_t bits = (su << u) | (sv << v);
+                faceProc(child(a, bits | (1u << d)), child(b, bits), d, out);
+            }
+        }
+
+        // Edges inside the face, along u and along v
+        for (uint32_t e : {u, v}) {
+            const uint32_t w = e == u ? v : u;
+            const uint32_t e1 = (e + 1) % 3;
+            for (uint32_t h = 0; h < 2; ++h) {
+                Ref q[4];
+                for (int i = 0; i < 4; ++i) {
+                    const uint32_t sideD = e1 == d ? kQuadrant[i][0] : kQuadrant[i][1];
+                    const uint32_t sideW = e1 == d ? kQuadrant[i][1] : kQuadrant[i][0];
+                    q[i] = child(sideD == 0 ? a : b, (h << e) | ((1u - sideD) << d) | (sideW << w));
+                }
+                edgeProc(q, e, out);
+            }
+        }
+    }
+
+    // q are the four cells around an edge along axis d, in kQuadrant order
+    void edgeProc(const Ref q[4], uint32_t d, std::vector<Quad>& out) const {
+        if (isLeaf(q[0].node) && isLeaf(q[1].node) && isLeaf(q[2].node) && isLeaf(q[3].node)) {
+            processEdge(q, d, out);
+            return;
+        }
+        const uint32_t u = (d + 1) % 3, v = (d + 2) % 3;
+        for (uint32_t h = 0; h < 2; ++h) {
+            Ref r[4];
+            for (int i = 0; i < 4; ++i) {
+                r[i] = child(q[i], (h << d) | ((1u - kQuadrant[i][0]) << u) | ((1u - kQuadrant[i][1]) << v));
+            }
+            edgeProc(r, d, out);
+        }
+    }
+
+    void processEdge(const Ref q[4], uint32_t d, std::vector<Quad>& out) const {
+        // The edge belongs to the smallest of the four cells
+        int smallest = 0;
+        for (int i = 1; i < 4; ++i) {
+            if (q[i].depth > q[smallest].depth) smallest = i;
+        }
+        const Ref& cell = q[smallest];
+        const uint32_t u = (d + 1) % 3, v = (d + 2) % 3;
+        const uint32_t c0 = ((1u - kQuadrant[smallest][0]) << u) | ((1u - kQuadrant[smallest][1]) << v);
+        const uint32_t c1 = c0 | (1u << d);
+        const Node& node = nodes_[cell.node];
+        if (inside(node.corners[c0]) == inside(node.corners[c1])) return;
+
+        const uint32_t span = 1u << (maxDepth_ - cell.depth);
+        const glm::uvec3 low = cell.min + span * glm::uvec3(c0 & 1, (c0 >> 1) & 1, c0 >> 2);
+        out.push_back(Quad{Crossing{edgeKey(low, d), span, node.corners[c0], node.corners[c1]},
+                           {q[0], q[1], q[2], q[3]}});
+    }
+
+    const Octree& tree_;
+    const std::vector<Node>& nodes_;
+    const Handle& sdf_;
+    DualContourOptions options_;
+    float time_;
+    uint32_t seed_;
+    uint32_t maxDepth_;
+    uint64_t lattice_;
+    float cellSize_;
+
+    std::vector<Crossing> crossings_;
+    std::vector<glm::vec3> positions_;
+    std::vector<glm::vec3> normals_;
+    std::vector<uint8_t> collapsed_;
+    std::vector<uint32_t> vertexIndex_;
+};
+
+} // namespace
+
+Mesh dualContour(
+    const Handle& sdf,
+    const glm::vec3& boundLow,
+    float size,
+    const DualContourOptions& options,
+    float time,
+    uint32_t seed
+) {
+    if (options.rootSteps < 0) {
+        throw std::runtime_error("Dual contouring root steps must not be negative");
+    }
+    const Octree tree = Octree::build(sdf, boundLow, size, options.maxDepth, time, seed, options.tolerance);
+    return Contourer(tree, sdf, options, time, seed).run();
+}
+
+} // namespace sdf
@@ -0,0 +1,106 @@
+#include "error_bound.hpp"
+
+#include <array>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+
+namespace sdf::detail {
+
+namespace {
+
+// Error bounds of the fast-math build, for the SDFs that opt in to the
+// approximations (see sdf::approx in common.hpp). Each bounds
+// |approximated - exact| / max(1, |p|), where exact is the libm build's float
+// result. The factor covers the rounding of the operations the perturbation
+// passes through, which grows with the magnitude of the intermediate values.
+// Derivations, with u = 2^-23 the unit roundoff of results below 1:
+//
+// Spike: exp is called on [-5, 0] only, where fast::exp and libm expf differ
+// by at most 6e-8 (checked exhaustively), so the spike thickness moves by at
+// most 1.5e-8. Subtracting it from the spike distance adds one rounding of a
+// value below |p| + 1.25, and the minimum over the spikes does not amplify
+// the difference: 1.5e-8 + u (|p| + 1.25) plus one rounding in
+// shrinkDistance() is below 5e-7 max(1, |p|). Rounded up to 1e-6.
+//
+// TieFighter: atan2 gives the engine angle. fast::atan2 is within 4.9e-7 of
+// the true angle (2.1e-7 relative error of fast::atan, checked over all
+// floats, plus the roundings and the float pi of the quadrant fix-up) and
+// libm within one ulp of pi, so the angles differ by at most 7.5e-7. The
+// first engine box only sees |angle| - 4 < 0 through a max; the second folds
+// 1.7 * angle with fract(), but tests |z|, which is continuous across the
+// fold, so it moves by at most 1.7 * 7.5e-7 plus two roundings below 8.
+// Both enter the result through min() and the final * 0.3, for a total of
+// 1.2e-6 + 5e-7 |p|. Rounded up to 3e-6.
+//
+// The other SDFs keep libm in both builds: hash-based noise (Rock, Mountain,
+// Castle, Temple) amplifies any change in sin without bound, the escape
+// iteration of the fractals can change, and sin or cos of unbounded arguments
+// or rotations whose error grows with the point leave no small bound that has
+// been worked out.
+struct ErrorBoundEntry {
+    const char* name;
+    float bound;
+};
+
+const ErrorBoundEntry kErrorBounds[] = {
+    {"Spike", 1e-6f},
+    {"TieFighter", 3e-6f},
+};
+
+// Wrapped functions are template instances bound to a slot, since SDFFunc
+// is a plain function pointer without room for the bound
+constexpr size_t kMaxSlots = 128;
+
+struct Slot {
+    SDFFunc func = nullptr;
+    float bound = 0.0f;
+};
+
+Slot g_slots[kMaxSlots];
+
+template <size_t I>
+float conservative(const glm::vec3& p, float time, uint32_t seed) {
+    const Slot& slot = g_slots[I];
+    return shrinkDistance(slot.func(p, time, seed), slot.bound, p);
+}
+
+template <size_t... I>
+constexpr std::array<SDFFunc, sizeof...(I)> makeWrappers(std::index_sequence<I...>) {
+    return {{conservative<I>...}};
+}
+
+constexpr std::array<SDFFunc, kMaxSlots> kWrappers = makeWrappers(std::make_index_sequence<kMaxSlots>());
+
+} // namespace
+
+float fastMathErrorBound(const char* name) {
+    for (const auto& entry : kErrorBounds) {
+        if (std::strcmp(entry.name, name) == 0) {
+            return entry.bound;
+        }
+    }
+    return 0.0f;
+}
+
+SDFFunc conservativeFunc(const char* name, SDFFunc func, float bound) {
+    static std::mutex mutex;
+    static std::unordered_map<const char*, size_t> assigned;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = assigned.find(name);
+    if (it == assigned.end()) {
+        if (assigned.size() == kMaxSlots) {
+            throw std::runtime_error("Too many SDFs with fast-math error bounds");
+        }
+        const size_t slot = assigned.size();
+        g_slots[slot].func = func;
+        g_slots[slot].bound = bound;
+        it = assigned.emplace(name, slot).first;
+    }
+    return kWrappers[it->second];
+}
+
+} // namespace sdf::detail
@@ -0,0 +1,22 @@
+#pragma once
+
+// Internal support for the fast-math build (SDF_FAST_MATH): per-SDF bounds
+// on the error of the approximated distances, and evaluation functions that
+// correct for them.
+
+#include "sdf/sdf.hpp"
+
+namespace sdf::detail {
+
+/// Bound on |approximated - exact| / max(1, |p|) for the named SDF in the
+/// fast-math build, or 0 if the SDF uses none of the approximations.
+float fastMathErrorBound(const char* name);
+
+/// Evaluation function that calls `func` and moves the result towards zero
+/// by `bound` * max(1, |p|) (see shrinkDistance()). Repeated calls for the
+/// same name return the same function.
+///
+/// @throws std::runtime_error if more SDFs are wrapped than there are slots
+SDFFunc conservativeFunc(const char* name, SDFFunc func, float bound);
+
+} // namespace sdf::detail
@@ -0,0 +1,173 @@
+#include "sdf/frame.hpp"
+#include "parallel.hpp"
+#include "stats_scope.hpp"
+
+#include "sdf/Animal/Fish.hpp"
+#include "sdf/Animal/Jellyfish.hpp"
+#include "sdf/Animal/MantaRay.hpp"
+#include "sdf/Animal/Snake.hpp"
+#include "sdf/Animal/Snail.hpp"
+#include "sdf/Manufactured/Castle.hpp"
+#include "sdf/Manufactured/Cables.hpp"
+#include "sdf/Manufactured/Mech.hpp"
+
+#include <cstring>
+
+namespace sdf {
+
+namespace {
+
+// Type-erases a shape's XFrame, prepareX() and X(p, frame) triple
+template <typename F, F (*Prepare)(float, uint32_t), float (*Eval)(const glm::vec3&, const F&)>
+struct FrameAdapter {
+    static std::shared_ptr<const void> prepare(float time, uint32_t seed) {
+        return std::make_shared<const F>(Prepare(time, seed));
+    }
+
+    static float evaluate(const glm::vec3& p, const void* constants) {
+        return Eval(p, *static_cast<const F*>(constants));
+    }
+};
+
+using PrepareFunc = std::shared_ptr<const void>(*)(float time, uint32_t seed);
+
+struct FrameEntry {
+    const char* name;
+    PrepareFunc prepare;
+    Frame::FrameFunc func;
+};
+
+template <typename F, F (*Prepare)(float, uint32_t), float (*Eval)(const glm::vec3&, const F&)>
+constexpr FrameEntry entry(const char* name) {
+    return {name, FrameAdapter<F, Prepare, Eval>::prepare, FrameAdapter<F, Prepare, Eval>::evaluate};
+}
+
+// SDFs with per-frame constants
+const FrameEntry* findFrame(const char* name) {
+    static const FrameEntry frames[] = {
+        entry<animal::FishFrame, animal::prepareFish, animal::Fish>("Fish"),
+        entry<animal::JellyfishFrame, animal::prepareJellyfish, animal::Jellyfish>("Jellyfish"),
+        entry<animal::MantaRayFrame, animal::prepareMantaRay, animal::MantaRay>("MantaRay"),
+        entry<animal::SnakeFrame, animal::prepareSnake, animal::Snake>("Snake"),
+        entry<animal::SnailFrame, animal::prepareSnail, animal::Snail>("Snail"),
+        entry<manufactured::CastleFrame, manufactured::prepareCastle, manufactured::Castle>("Castle"),
+        entry<manufactured::CablesFrame, manufactured::prepareCables, manufactured::Cables>("Cables"),
+        entry<manufactured::MechFrame, manufactured::prepareMech, manufactured::Mech>("Mech"),
+    };
+
+    for (const auto& frame : frames) {
+        if (std::strcmp(frame.name, name) == 0) {
+            return &frame;
+        }
+    }
+    return nullptr;
+}
+
+// Points per work chunk for the parallel paths
+constexpr size_t kParallelGrain = 1024;
+
+} // namespace
+
+Frame prepare(const Handle& sdf, float time, uint32_t seed) {
+    Frame frame;
+    frame.handle_ = sdf;
+    frame.time_ = time;
+    frame.seed_ = seed;
+    if (const FrameEntry* entry = findFrame(sdf.name)) {
+        frame.func_ = entry->func;
+        frame.constants_ = entry->prepare(time, seed);
+        if (getFastMathMode() == FastMathMode::Conservative) {
+            frame.errorBound_ = sdf.errorBound;
+        }
+    }
+    return frame;
+}
+
+Frame prepare(const std::string& name, float time, uint32_t seed) {
+    return prepare(resolve(name), time, seed);
+}
+
+namespace detail {
+
+struct FrameAccess {
+    static float evaluate(const Frame& frame, const glm::vec3& point) {
+        return frame.evaluateUnrecorded(point);
+    }
+};
+
+#if defined(SDF_STATS)
+float evaluateRecorded(const Frame& frame, const glm::vec3& point) {
+    StatsScope scope(frame.handle(), 1, StatsSite::Frame);
+    return FrameAccess::evaluate(frame, point);
+}
+#endif
+
+} // namespace detail
+
+// Uninstrumented loops shared by the serial and parallel entry points, so a
+// parallel call is recorded once rather than once per chunk
+
+static void evaluatePoints(const Frame& frame, const glm::vec3* points, float* out, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = detail::FrameAccess::evaluate(frame, points[i]);
+    }
+}
+
+static void evaluateSoA(
+    const Frame& frame,
+    const float* x,
+    const float* y,
+    const float* z,
+    float* out,
+    size_t count
+) {
+    const Handle& sdf = frame.handle();
+    if (!frame.hasConstants() && sdf.soa) {
+        sdf.soa(x, y, z, out, count, frame.time(), frame.seed());
+        return;
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = detail::FrameAccess::evaluate(frame, glm::vec3(x[i], y[i], z[i]));
+    }
+}
+
+void evaluate(const Frame& frame, const glm::vec3* points, float* out, size_t count) {
+    detail::StatsScope scope(frame.handle(), count, StatsSite::Frame);
+    evaluatePoints(frame, points, out, count);
+}
+
+void evaluate(
+    const Frame& frame,
+    const float* x,
+    const float* y,
+    const float* z,
+    float* out,
+    size_t count
+) {
+    detail::StatsScope scope(frame.handle(), count, StatsSite::Frame);
+    evaluateSoA(frame, x, y, z, out, count);
+}
+
+void evaluateParallel(const Frame& frame, const glm::vec3* points, float* out, size_t count) {
+    detail::StatsScope scope(frame.handle(), count, StatsSite::Frame);
+    detail::parallelFor(count, kParallelGrain, [&](size_t begin, size_t end) {
+        evaluatePoints(frame, points + begin, out + begin, end - begin);
+    });
+}
+
+void evaluateParallel(
+    const Frame& frame,
+    const float* x,
+    const float* y,
+    const float* z,
+    float* out,
+    size_t count
+) {
+    detail::StatsScope scope(frame.handle(), count, StatsSite::Frame);
+    detail::parallelFor(count, kParallelGrain, [&](size_t begin, size_t end) {
+        evaluateSoA(frame, x + begin, y + begin, z + begin, out + begin, end - begin);
+    });
+}
+
+} // namespace sdf
@@ -0,0 +1,259 @@
+#include "gradient.hpp"
+#include "parallel.hpp"
+#include "stats_scope.hpp"
+
+#include "sdf/dual.hpp"
+
+#include "sdf/Geometry/Bezier.hpp"
+#include "sdf/Geometry/Capsule.hpp"
+#include "sdf/Geometry/Cone.hpp"
+#include "sdf/Geometry/Cube.hpp"
+#include "sdf/Geometry/Cylinder.hpp"
+#include "sdf/Geometry/Dodecahedron.hpp"
+#include "sdf/Geometry/Helix.hpp"
+#include "sdf/Geometry/Hexprism.hpp"
+#include "sdf/Geometry/Icosahedron.hpp"
+#include "sdf/Geometry/Octabound.hpp"
+#include "sdf/Geometry/Octahedron.hpp"
+#include "sdf/Geometry/Pyramid.hpp"
+#include "sdf/Geometry/Roundbox.hpp"
+#include "sdf/Geometry/Sphere.hpp"
+#include "sdf/Geometry/Tetrahedron.hpp"
+#include "sdf/Geometry/Torus.hpp"
+#include "sdf/Geometry/Trefoil.hpp"
+#include "sdf/Geometry/Triangle.hpp"
+#include "sdf/Geometry/Triprismbound.hpp"
+#include "sdf/Fractal/Julia.hpp"
+#include "sdf/Fractal/Mandelbulb.hpp"
+#include "sdf/Fractal/Menger.hpp"
+#include "sdf/Fractal/Serpinski.hpp"
+#include "sdf/Animal/Dinosaur.hpp"
+#include "sdf/Animal/Elephant.hpp"
+#include "sdf/Animal/Fish.hpp"
+#include "sdf/Animal/Girl.hpp"
+#include "sdf/Animal/HumanHead.hpp"
+#include "sdf/Animal/HumanSkull.hpp"
+#include "sdf/Animal/Jellyfish.hpp"
+#include "sdf/Animal/MantaRay.hpp"
+#include "sdf/Animal/PixarMike.hpp"
+#include "sdf/Animal/Snail.hpp"
+#include "sdf/Animal/Snake.hpp"
+#include "sdf/Animal/Tardigrade.hpp"
+#include "sdf/Nature/Mountain.hpp"
+#include "sdf/Nature/Mushroom.hpp"
+#include "sdf/Nature/Rock.hpp"
+#include "sdf/Nature/Tree.hpp"
+#include "sdf/Manufactured/Cables.hpp"
+#include "sdf/Manufactured/Castle.hpp"
+#include "sdf/Manufactured/Chain.hpp"
+#include "sdf/Manufactured/Gear.hpp"
+#include "sdf/Manufactured/GrandPiano.hpp"
+#include "sdf/Manufactured/Key.hpp"
+#include "sdf/Manufactured/Knob.hpp"
+#include "sdf/Manufactured/Mech.hpp"
+#include "sdf/Manufactured/Mobius.hpp"
+#include "sdf/Manufactured/Rooks.hpp"
+#include "sdf/Manufactured/Spike.hpp"
+#include "sdf/Manufactured/Teapot.hpp"
+#include "sdf/Manufactured/Temple.hpp"
+#include "sdf/Manufactured/UprightPiano.hpp"
+#include "sdf/Manufactured/Vase.hpp"
+#include "sdf/Vehicle/Boat.hpp"
+#include "sdf/Vehicle/Cybertruck.hpp"
+#include "sdf/Vehicle/Jetfighter.hpp"
+#include "sdf/Vehicle/Lamborghini.hpp"
+#include "sdf/Vehicle/Oldcar.hpp"
+#include "sdf/Vehicle/TieFighter.hpp"
+#include "sdf/Misc/Burger.hpp"
+#include "sdf/Misc/Cheese.hpp"
+#include "sdf/Misc/Dalek.hpp"
+
+#include <cstring>
+
+namespace sdf {
+
+namespace {
+
+using D3 = Vec3<Dual>;
+
+// Evaluates a shape instantiated with dual numbers, seeding x, y and z with
+// the unit gradients so the result carries d/dp.
+template <Dual (*Kernel)(const D3&, float, uint32_t)>
+float dualGradient(const glm::vec3& p, float time, uint32_t seed, glm::vec3& gradient) {
+    const D3 q(Dual(p.x, 1.0f, 0.0f, 0.0f),
+               Dual(p.y, 0.0f, 1.0f, 0.0f),
+               Dual(p.z, 0.0f, 0.0f, 1.0f));
+    const Dual d = Kernel(q, time, seed);
+    gradient = d.gradient();
+    return d.v;
+}
+
+// Step for the central-difference fallback, relative to the [-1, 1]^3 domain
+constexpr float kGradientStep = 1e-3f;
+
+float centralDifferences(SDFFunc func, const glm::vec3& p, float time, uint32_t seed, glm::vec3& gradient) {
+    const float h = kGradientStep;
+    gradient = glm::vec3(
+        func(p + glm::vec3(h, 0.0f, 0.0f), time, seed) - func(p - glm::vec3(h, 0.0f, 0.0f), time, seed),
+        func(p + glm::vec3(0.0f, h, 0.0f), time, seed) - func(p - glm::vec3(0.0f, h, 0.0f), time, seed),
+        func(p + glm::vec3(0.0f, 0.0f, h), time, seed) - func(p - glm::vec3(0.0f, 0.0f, h), time, seed)
+    ) / (2.0f * h);
+    return func(p, time, seed);
+}
+
+// Points per work chunk for the parallel path
+constexpr size_t kParallelGrain = 1024;
+
+// Uninstrumented loop shared by the serial and parallel entry points, so a
+// parallel call is recorded once rather than once per chunk
+void gradientPoints(
+    const Handle& sdf,
+    const glm::vec3* points,
+    float* out,
+    glm::vec3* gradients,
+    size_t count,
+    float time,
+    uint32_t seed
+) {
+    if (sdf.grad) {
+        GradFunc grad = sdf.grad;
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = grad(points[i], time, seed, gradients[i]);
+        }
+        return;
+    }
+
+    SDFFunc func = sdf.func;
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = centralDifferences(func, points[i], time, seed, gradients[i]);
+    }
+}
+
+} // namespace
+
+namespace detail {
+
+GradFunc findGradient(const char* name) {
+    static const struct {
+        const char* name;
+        GradFunc func;
+    } kernels[] = {
+        {"Sphere", dualGradient<geometry::Sphere<D3>>},
+        {"Cube", dualGradient<geometry::Cube<D3>>},
+        {"Torus", dualGradient<geometry::Torus<D3>>},
+        {"Capsule", dualGradient<geometry::Capsule<D3>>},
+        {"Cylinder", dualGradient<geometry::Cylinder<D3>>},
+        {"Cone", dualGradient<geometry::Cone<D3>>},
+        {"Roundbox", dualGradient<geometry::Roundbox<D3>>},
+        {"Hexprism", dualGradient<geometry::Hexprism<D3>>},
+        {"Octahedron", dualGradient<geometry::Octahedron<D3>>},
+        {"Octabound", dualGradient<geometry::Octabound<D3>>},
+        {"Pyramid", dualGradient<geometry::Pyramid<D3>>},
+        {"Tetrahedron", dualGradient<geometry::Tetrahedron<D3>>},
+        {"Icosahedron", dualGradient<geometry::Icosahedron<D3>>},
+        {"Dodecahedron", dualGradient<geometry::Dodecahedron<D3>>},
+        {"Triprismbound", dualGradient<geometry::Triprismbound<D3>>},
+        {"Triangle", dualGradient<geometry::Triangle<D3>>},
+        {"Bezier", dualGradient<geometry::Bezier<D3>>},
+        {"Trefoil", dualGradient<geometry::Trefoil<D3>>},
+        {"Helix", dualGradient<geometry::Helix<D3>>},
+        {"Mandelbulb", dualGradient<fractal::Mandelbulb<D3>>},
+        {"MandelbulbPolynomial", dualGradient<fractal::MandelbulbPolynomial<D3>>},
+        {"Menger", dualGradient<fractal::Menger<D3>>},
+        {"Serpinski", dualGradient<fractal::Serpinski<D3>>},
+        {"Julia", dualGradient<fractal::Julia<D3>>},
+        {"Fish", dualGradient<animal::Fish<D3>>},
+        {"Dinosaur", dualGradient<animal::Dinosaur<D3>>},
+        {"Tardigrade", dualGradient<animal::Tardigrade<D3>>},
+        {"Jellyfish", dualGradient<animal::Jellyfish<D3>>},
+        {"MantaRay", dualGradient<animal::MantaRay<D3>>},
+        {"Snake", dualGradient<animal::Snake<D3>>},
+        {"Snail", dualGradient<animal::Snail<D3>>},
+        {"Elephant", dualGradient<animal::Elephant<D3>>},
+        {"PixarMike", dualGradient<animal::PixarMike<D3>>},
+        {"HumanSkull", dualGradient<animal::HumanSkull<D3>>},
+        {"HumanHead", dualGradient<animal::HumanHead<D3>>},
+        {"Girl", dualGradient<animal::Girl<D3>>},
+        {"Rock", dualGradient<nature::Rock<D3>>},
+        {"Mountain", dualGradient<nature::Mountain<D3>>},
+        {"Mushroom", dualGradient<nature::Mushroom<D3>>},
+        {"Tree", dualGradient<nature::Tree<D3>>},
+        {"Teapot", dualGradient<manufactured::Teapot<D3>>},
+        {"Gear", dualGradient<manufactured::Gear<D3>>},
+        {"Chain", dualGradient<manufactured::Chain<D3>>},
+        {"Mobius", dualGradient<manufactured::Mobius<D3>>},
+        {"Spike", dualGradient<manufactured::Spike<D3>>},
+        {"Vase", dualGradient<manufactured::Vase<D3>>},
+        {"Knob", dualGradient<manufactured::Knob<D3>>},
+        {"Key", dualGradient<manufactured::Key<D3>>},
+        {"Castle", dualGradient<manufactured::Castle<D3>>},
+        {"Temple", dualGradient<manufactured::Temple<D3>>},
+        {"Rooks", dualGradient<manufactured::Rooks<D3>>},
+        {"Cables", dualGradient<manufactured::Cables<D3>>},
+        {"Mech", dualGradient<manufactured::Mech<D3>>},
+        {"UprightPiano", dualGradient<manufactured::UprightPiano<D3>>},
+        {"GrandPiano", dualGradient<manufactured::GrandPiano<D3>>},
+        {"Cybertruck", dualGradient<vehicle::Cybertruck<D3>>},
+        {"TieFighter", dualGradient<vehicle::TieFighter<D3>>},
+        {"Boat", dualGradient<vehicle::Boat<D3>>},
+        {"Jetfighter", dualGradient<vehicle::Jetfighter<D3>>},
+        {"Oldcar", dualGradient<vehicle::Oldcar<D3>>},
+        {"Lamborghini", dualGradient<vehicle::Lamborghini<D3>>},
+        {"Burger", dualGradient<misc::Burger<D3>>},
+        {"Cheese", dualGradient<misc::Cheese<D3>>},
+        {"Dalek", dualGradient<misc::Dalek<D3>>},
+    };
+
+    for (const auto& kernel : kernels) {
+        if (std::strcmp(kernel.name, name) == 0) {
+            return kernel.func;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace detail
+
+float evaluateWithGradient(
+    const Handle& sdf,
+    const glm::vec3& point,
+    glm::vec3& gradient,
+    float time,
+    uint32_t seed
+) {
+    detail::StatsScope scope(sdf, 1, StatsSite::Gradient);
+    if (sdf.grad) {
+        return sdf.grad(point, time, seed, gradient);
+    }
+    return centralDifferences(sdf.func, point, time, seed, gradient);
+}
+
+void evaluateWithGradient(
+    const Handle& sdf,
+    const glm::vec3* points,
+    float* out,
+    glm::vec3* gradients,
+    size_t count,
+    float time,
+    uint32_t seed
+) {
+    detail::StatsScope scope(sdf, count, StatsSite::Gradient);
+    gradientPoints(sdf, points, out, gradients, count, time, seed);
+}
+
+void evaluateWithGradientParallel(
+    const Handle& sdf,
+    const glm::vec3* points,
+    float* out,
+    glm::vec3* gradients,
+    size_t count,
+    float time,
+    uint32_t seed
+) {
+    detail::StatsScope scope(sdf, count, StatsSite::Gradient);
+    detail::parallelFor(count, kParallelGrain, [&](size_t begin, size_t end) {
+        gradientPoints(sdf, points + begin, out + begin, gradients + begin, end - begin, time, seed);
+    });
+}
+
+} // namespace sdf
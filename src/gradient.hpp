@@ -0,0 +1,12 @@
+#pragma once
+
+// Internal lookup of the automatically differentiated gradient functions.
+
+#include "sdf/sdf.hpp"
+
+namespace sdf::detail {
+
+/// Exact gradient function for the named SDF, or nullptr if it has none.
+GradFunc findGradient(const char* name);
+
+} // namespace sdf::detail
@@ -0,0 +1,260 @@
+#include "sdf/sdf.hpp"
+#include "parallel.hpp"
+#include "slack.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+namespace sdf {
+
+namespace {
+
+// Points per tile: coordinates for one tile are generated into stack arrays
+// and evaluated as a single structure-of-arrays batch.
+constexpr size_t kTileSize = 256;
+
+// Nodes per parallel work chunk (rounded to whole rows)
+constexpr size_t kGridGrain = 4096;
+
+// Node spacing along one axis; a single node sits at the low bound
+float nodeStep(float low, float high, uint32_t n) {
+    return n > 1 ? (high - low) / static_cast<float>(n - 1) : 0.0f;
+}
+
+// Narrow band: blocks of kTopBlock^3 nodes are refined independently in
+// parallel; blocks of at most kLeafNodes nodes are evaluated densely.
+constexpr uint32_t kTopBlock = 32;
+constexpr size_t kLeafNodes = 64;
+
+// Recursive narrow-band refinement over half-open node ranges [lo, hi)
+class NarrowBandWalker {
+public:
+    NarrowBandWalker(const Handle& sdf, const glm::uvec3& dims, const glm::vec3& low,
+                     const glm::vec3& step, const NarrowBand& band, float* out,
+                     float time, uint32_t seed)
+        : sdf_(sdf), dims_(dims), low_(low), step_(step), band_(band), out_(out),
+          time_(time), seed_(seed) {}
+
+    /// Fill every node in [lo, hi); returns the number of evaluations
+    size_t walk(const glm::uvec3& lo, const glm::uvec3& hi) const {
+        const glm::uvec3 n = hi - lo;
+        const glm::vec3 center = low_ + 0.5f * glm::vec3(lo + hi - 1u) * step_;
+        const float radius = 0.5f * glm::length(glm::vec3(n - 1u) * step_);
+
+        const float phi = evaluate(sdf_, center, time_, seed_);
+        if (std::abs(phi) - band_.width > radius * detail::kRoundingSlack) {
+            fill(lo, hi, center, phi);
+            return 1;
+        }
+
+        if (static_cast<size_t>(n.x) * n.y * n.z <= kLeafNodes) {
+            dense(lo, hi);
+            return 1 + static_cast<size_t>(n.x) * n.y * n.z;
+        }
+
+        // Halve every axis that still spans more than one node
+        const glm::uvec3 mid = lo + n / 2u;
+        size_t evaluations = 1;
+        for (int c = 0; c < 8; ++c) {
+            glm::uvec3 clo = lo, chi = hi;
+            bool empty = false;
+            for (int a = 0; a < 3; ++a) {
+                const bool upper = (c >> a) & 1;
+                if (n[a] < 2) {
+                    empty |= upper;
+                } else if (upper) {
+                    clo[a] = mid[a];
+                } else {
+                    chi[a] = mid[a];
+                }
+            }
+            if (!empty) evaluations += walk(clo, chi);
+        }
+        return evaluations;
+    }
+
+private:
+    float* node(uint32_t x, uint32_t y, uint32_t z) const {
+        return out_ + x + static_cast<size_t>(dims_.x) * (y + static_cast<size_t>(dims_.y) * z);
+    }
+
+    glm::vec3 position(uint32_t x, uint32_t y, uint32_t z) const {
+        return glm::vec3(low_.x + x * step_.x, low_.y + y * step_.y, low_.z + z * step_.z);
+    }
+
+    // Block proven to lie farther than band.width from the surface
+    void fill(const glm::uvec3& lo, const glm::uvec3& hi, const glm::vec3& center, float phi) const {
+        const float sentinel = phi > 0.0f ? band_.sentinel : -band_.sentinel;
+        for (uint32_t z = lo.z; z < hi.z; ++z) {
+            for (uint32_t y = lo.y; y < hi.y; ++y) {
+                float* row = node(0, y, z);
+                for (uint32_t x = lo.x; x < hi.x; ++x) {
+                    if (!band_.fillBound) {
+                        row[x] = sentinel;
+                        continue;
+                    }
+                    // The surface is at least |phi| from the center, so at
+                    // least |phi| - |p - center| from p
+                    const float d = glm::length(position(x, y, z) - center);
+                    row[x] = phi > 0.0f ? phi - d : phi + d;
+                }
+            }
+        }
+    }
+
+    void dense(const glm::uvec3& lo, const glm::uvec3& hi) const {
+        float xs[kLeafNodes], ys[kLeafNodes], zs[kLeafNodes], values[kLeafNodes];
+        size_t count = 0;
+        for (uint32_t z = lo.z; z < hi.z; ++z) {
+            for (uint32_t y = lo.y; y < hi.y; ++y) {
+                for (uint32_t x = lo.x; x < hi.x; ++x) {
+                    const glm::vec3 p = position(x, y, z);
+                    xs[count] = p.x;
+                    ys[count] = p.y;
+                    zs[count] = p.z;
+                    ++count;
+                }
+            }
+        }
+        evaluate(sdf_, xs, ys, zs, values, count, time_, seed_);
+
+        count = 0;
+        for (uint32_t z = lo.z; z < hi.z; ++z) {
+            for (uint32_t y = lo.y; y < hi.y; ++y) {
+                float* row = node(0, y, z);
+                for (uint32_t x = lo.x; x < hi.x; ++x) {
+                    row[x] = values[count++];
+                }
+            }
+        }
+    }
+
+    const Handle& sdf_;
+    glm::uvec3 dims_;
+    glm::vec3 low_;
+    glm::vec3 step_;
+    const NarrowBand& band_;
+    float* out_;
+    float time_;
+    uint32_t seed_;
+};
+
+} // namespace
+
+void evaluateGrid(
+    const Handle& sdf,
+    const glm::uvec3& dims,
+    const glm::vec3& boundLow,
+    const glm::vec3& boundHigh,
+    float* out,
+    float time,
+    uint32_t seed
+) {
+    evaluateGridSlab(sdf, dims, boundLow, boundHigh, 0, dims.z, out, time, seed);
+}
+
+void evaluateGridSlab(
+    const Handle& sdf,
+    const glm::uvec3& dims,
+    const glm::vec3& boundLow,
+    const glm::vec3& boundHigh,
+    uint32_t zBegin,
+    uint32_t zEnd,
+    float* out,
+    float time,
+    uint32_t seed
+) {
+    zEnd = std::min(zEnd, dims.z);
+    const size_t nx = dims.x;
+    if (nx == 0 || dims.y == 0 || zBegin >= zEnd) return;
+    const size_t firstRow = static_cast<size_t>(dims.y) * zBegin;
+    const size_t rows = static_cast<size_t>(dims.y) * (zEnd - zBegin);
+
+    const glm::vec3 step(
+        nodeStep(boundLow.x, boundHigh.x, dims.x),
+        nodeStep(boundLow.y, boundHigh.y, dims.y),
+        nodeStep(boundLow.z, boundHigh.z, dims.z)
+    );
+
+    // Work is split by rows of constant (y, z); each row is walked in tiles.
+    // Rows are numbered over the whole grid so every node's position does not
+    // depend on the slab it is evaluated in.
+    const size_t grain = std::max<size_t>(1, kGridGrain / nx);
+    detail::parallelFor(rows, grain, [&](size_t begin, size_t end) {
+        float xs[kTileSize], ys[kTileSize], zs[kTileSize];
+
+        for (size_t local = begin; local < end; ++local) {
+            const size_t row = firstRow + local;
+            const float py = boundLow.y + static_cast<uint32_t>(row % dims.y) * step.y;
+            const float pz = boundLow.z + static_cast<uint32_t>(row / dims.y) * step.z;
+            float* rowOut = out + local * nx;
+
+            for (size_t x0 = 0; x0 < nx; x0 += kTileSize) {
+                const size_t n = std::min(kTileSize, nx - x0);
+                for (size_t i = 0; i < n; ++i) {
+                    xs[i] = boundLow.x + static_cast<uint32_t>(x0 + i) * step.x;
+                    ys[i] = py;
+                    zs[i] = pz;
+                }
+                evaluate(sdf, xs, ys, zs, rowOut + x0, n, time, seed);
+            }
+        }
+    });
+}
+
+size_t evaluateGridNarrowBand(
+    const Handle& sdf,
+    const glm::uvec3& dims,
+    const glm::vec3& boundLow,
+    const glm::vec3& boundHigh,
+    const NarrowBand& band,
+    float* out,
+    float time,
+    uint32_t seed
+) {
+    if (dims.x == 0 || dims.y == 0 || dims.z == 0) return 0;
+
+    const glm::vec3 step(
+        nodeStep(boundLow.x, boundHigh.x, dims.x),
+        nodeStep(boundLow.y, boundHigh.y, dims.y),
+        nodeStep(boundLow.z, boundHigh.z, dims.z)
+    );
+    const NarrowBandWalker walker(sdf, dims, boundLow, step, band, out, time, seed);
+
+    // Top-level blocks are independent, so each is one unit of parallel work
+    const glm::uvec3 blocks = (dims + (kTopBlock - 1)) / kTopBlock;
+    const size_t blockCount = static_cast<size_t>(blocks.x) * blocks.y * blocks.z;
+    std::atomic<size_t> evaluations{0};
+
+    detail::parallelFor(blockCount, 1, [&](size_t begin, size_t end) {
+        size_t local = 0;
+        for (size_t b = begin; b < end; ++b) {
+            const glm::uvec3 index(
+                static_cast<uint32_t>(b % blocks.x),
+                static_cast<uint32_t>((b / blocks.x) % blocks.y),
+                static_cast<uint32_t>(b / (static_cast<size_t>(blocks.x) * blocks.y))
+            );
+            const glm::uvec3 lo = index * kTopBlock;
+            const glm::uvec3 hi = glm::min(lo + kTopBlock, dims);
+            local += walker.walk(lo, hi);
+        }
+        evaluations += local;
+    });
+
+    return evaluations;
+}
+
+void evaluateGrid(
+    const std::string& name,
+    const glm::uvec3& dims,
+    const glm::vec3& boundLow,
+    const glm::vec3& boundHigh,
+    float* out,
+    float time,
+    uint32_t seed
+) {
+    evaluateGrid(resolve(name), dims, boundLow, boundHigh, out, time, seed);
+}
+
+} // namespace sdf
@@ -0,0 +1,138 @@
+#include "lod.hpp"
+#include "error_bound.hpp"
+#include "parallel.hpp"
+#include "stats_scope.hpp"
+
+#include "sdf/Fractal/Julia.hpp"
+#include "sdf/Fractal/Mandelbulb.hpp"
+#include "sdf/Fractal/Menger.hpp"
+#include "sdf/Fractal/Serpinski.hpp"
+
+#include <array>
+#include <cstring>
+#include <utility>
+
+namespace sdf {
+
+namespace {
+
+struct LODEntry {
+    const char* name;
+    LODFunc func;
+};
+
+constexpr LODEntry kLODs[] = {
+    {"Menger", fractal::MengerLOD},
+    {"Serpinski", fractal::SerpinskiLOD},
+    {"Julia", fractal::JuliaLOD},
+    {"Mandelbulb", fractal::MandelbulbLOD},
+    {"MandelbulbPolynomial", fractal::MandelbulbPolynomialLOD},
+};
+
+constexpr size_t kLODCount = sizeof(kLODs) / sizeof(kLODs[0]);
+
+#if defined(SDF_FAST_MATH)
+template <size_t I>
+float conservativeLOD(const glm::vec3& p, float featureSize, float time, uint32_t seed) {
+    static const float bound = detail::fastMathErrorBound(kLODs[I].name);
+    return detail::shrinkDistance(kLODs[I].func(p, featureSize, time, seed), bound, p);
+}
+
+template <size_t... I>
+constexpr std::array<LODFunc, sizeof...(I)> makeConservative(std::index_sequence<I...>) {
+    return {{conservativeLOD<I>...}};
+}
+
+constexpr std::array<LODFunc, kLODCount> kConservativeLODs = makeConservative(std::make_index_sequence<kLODCount>());
+#endif
+
+// Points per work chunk for the parallel path
+constexpr size_t kParallelGrain = 1024;
+
+// Uninstrumented loop shared by the serial and parallel entry points, so a
+// parallel call is recorded once rather than once per chunk
+void lodPoints(
+    const Handle& sdf,
+    const glm::vec3* points,
+    float* out,
+    size_t count,
+    float featureSize,
+    float time,
+    uint32_t seed
+) {
+    if (!sdf.lod) {
+        SDFFunc func = sdf.func;
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = func(points[i], time, seed);
+        }
+        return;
+    }
+
+    LODFunc lod = sdf.lod;
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = lod(points[i], featureSize, time, seed);
+    }
+}
+
+} // namespace
+
+namespace detail {
+
+LODFunc findLOD(const char* name) {
+    for (const auto& entry : kLODs) {
+        if (std::strcmp(entry.name, name) == 0) {
+            return entry.func;
+        }
+    }
+    return nullptr;
+}
+
+#if defined(SDF_STATS)
+float evaluateLODRecorded(const Handle& sdf, const glm::vec3& point, float featureSize, float time, uint32_t seed) {
+    StatsScope scope(sdf, 1, StatsSite::LOD);
+    return sdf.lod ? sdf.lod(point, featureSize, time, seed) : sdf.func(point, time, seed);
+}
+#endif
+
+#if defined(SDF_FAST_MATH)
+LODFunc findConservativeLOD(const char* name) {
+    for (size_t i = 0; i < kLODCount; ++i) {
+        if (std::strcmp(kLODs[i].name, name) == 0) {
+            return kConservativeLODs[i];
+        }
+    }
+    return nullptr;
+}
+#endif
+
+} // namespace detail
+
+void evaluateLOD(
+    const Handle& sdf,
+    const glm::vec3* points,
+    float* out,
+    size_t count,
+    float featureSize,
+    float time,
+    uint32_t seed
+) {
+    detail::StatsScope scope(sdf, count, StatsSite::LOD);
+    lodPoints(sdf, points, out, count, featureSize, time, seed);
+}
+
+void evaluateLODParallel(
+    const Handle& sdf,
+    const glm::vec3* points,
+    float* out,
+    size_t count,
+    float featureSize,
+    float time,
+    uint32_t seed
+) {
+    detail::StatsScope scope(sdf, count, StatsSite::LOD);
+    detail::parallelFor(count, kParallelGrain, [&](size_t begin, size_t end) {
+        lodPoints(sdf, points + begin, out + begin, end - begin, featureSize, time, seed);
+    });
+}
+
+} // namespace sdf
@@ -0,0 +1,18 @@
+#pragma once
+
+// Internal lookup of the level-of-detail functions.
+
+#include "sdf/sdf.hpp"
+
+namespace sdf::detail {
+
+/// Level-of-detail function for the named SDF, or nullptr if it has none.
+LODFunc findLOD(const char* name);
+
+#if defined(SDF_FAST_MATH)
+/// findLOD() with each distance moved towards zero by the SDF's fast-math
+/// error margin (see conservativeFunc()).
+LODFunc findConservativeLOD(const char* name);
+#endif
+
+} // namespace sdf::detail
@@ -1,12 +1,13 @@
 // SDF Viewer - Visualize SDFs using Polyscope volume grids
 //
 // Usage:
-//   sdf_viewer <sdf_name> [--resolution N] [--time T] [--seed S] [--list]
+//   sdf_viewer <sdf_name> [--resolution N] [--time T] [--seed S] [--band W] [--list]
 //
 // Examples:
 //   sdf_viewer Sphere
 //   sdf_viewer Mandelbulb --resolution 64
 //   sdf_viewer Fish --time 1.5
+//   sdf_viewer Tree --resolution 256 --band 0.05
 //   sdf_viewer --list
 
 #include <iostream>
@@ -28,13 +29,15 @@ void printUsage(const char* progName) {
               << "  --resolution N, -r N   Grid resolution (default: 32)\n"
               << "  --time T, -t T         Time parameter for animated SDFs (default: 0.0)\n"
               << "  --seed S, -s S         Random seed for procedural SDFs (default: 12345)\n"
+              << "  --band W, -b W         Evaluate exactly only within W of the surface\n"
               << "  --list, -l             List all available SDFs\n"
               << "  --help, -h             Show this help message\n"
               << "\n"
               << "Examples:\n"
               << "  " << progName << " Sphere\n"
               << "  " << progName << " Mandelbulb --resolution 64\n"
-              << "  " << progName << " Fish --time 1.5\n";
+              << "  " << progName << " Fish --time 1.5\n"
+              << "  " << progName << " Tree --resolution 256 --band 0.05\n";
 }
 
 void listSDFs() {
@@ -50,6 +53,7 @@ int main(int argc, char* argv[]) {
     uint32_t resolution = 32;
     float time = 0.0f;
     uint32_t seed = 12345;
+    float band = -1.0f;  // negative: evaluate every node
     
     for (int i = 1; i < argc; ++i) {
         std::string arg = argv[i];
@@ -71,6 +75,9 @@ int main(int argc, char* argv[]) {
         else if ((arg == "--seed" || arg == "-s") && i + 1 < argc) {
             seed = static_cast<uint32_t>(std::atoi(argv[++i]));
         }
+        else if ((arg == "--band" || arg == "-b") && i + 1 < argc) {
+            band = static_cast<float>(std::atof(argv[++i]));
+        }
         else if (arg[0] != '-' && sdfName.empty()) {
             sdfName = arg;
         }
@@ -102,34 +109,32 @@ int main(int argc, char* argv[]) {
         std::cerr << "Use --list to see available SDFs.\n";
         return 1;
     }
+    sdf::Handle sdfHandle = sdf::resolve(sdfName);
 
     std::cout << "Evaluating SDF '" << sdfName << "' on " 
               << resolution << "x" << resolution << "x" << resolution << " grid...\n";
     
-    // Generate grid points in [0,1]^3 (node locations)
-    std::vector<glm::vec3> points;
-    points.reserve(resolution * resolution * resolution);
-    
     // The grid spans [-1, 1]^3 to match typical SDF bounds
     const float minBound = -1.0f;
     const float maxBound = 1.0f;
-    const float step = (maxBound - minBound) / static_cast<float>(resolution - 1);
-    
-    for (uint32_t z = 0; z < resolution; ++z) {
-        for (uint32_t y = 0; y < resolution; ++y) {
-            for (uint32_t x = 0; x < resolution; ++x) {
-                float px = minBound + x * step;
-                float py = minBound + y * step;
-                float pz = minBound + z * step;
-                points.emplace_back(px, py, pz);
-            }
-        }
-    }
+    glm::vec3 boundLow(minBound, minBound, minBound);
+    glm::vec3 boundHigh(maxBound, maxBound, maxBound);
+    glm::uvec3 gridDim(resolution, resolution, resolution);
     
-    // Evaluate SDF at all points
-    std::vector<float> sdfValues;
+    // Evaluate SDF at all grid nodes (x fastest, as VolumeGrid expects)
+    std::vector<float> sdfValues(static_cast<size_t>(resolution) * resolution * resolution);
     try {
-        sdfValues = sdf::evaluate(sdfName, points, time, seed);
+        if (band >= 0.0f) {
+            sdf::NarrowBand narrowBand;
+            narrowBand.width = band;
+            size_t evaluations = sdf::evaluateGridNarrowBand(
+                sdfHandle, gridDim, boundLow, boundHigh, narrowBand, sdfValues.data(), time, seed
+            );
+            std::cout << "Narrow band: " << evaluations << " evaluations for "
+                      << sdfValues.size() << " nodes.\n";
+        } else {
+            sdf::evaluateGrid(sdfHandle, gridDim, boundLow, boundHigh, sdfValues.data(), time, seed);
+        }
     } catch (const std::exception& e) {
         std::cerr << "Error evaluating SDF: " << e.what() << "\n";
         return 1;
@@ -144,10 +149,6 @@ int main(int argc, char* argv[]) {
     polyscope::options::groundPlaneMode = polyscope::GroundPlaneMode::ShadowOnly;
     
     // Register volume grid
-    glm::vec3 boundLow(minBound, minBound, minBound);
-    glm::vec3 boundHigh(maxBound, maxBound, maxBound);
-    glm::uvec3 gridDim(resolution, resolution, resolution);
-    
     polyscope::VolumeGrid* grid = polyscope::registerVolumeGrid(
         sdfName, gridDim, boundLow, boundHigh
     );
@@ -174,14 +175,7 @@ int main(int argc, char* argv[]) {
    
     // wrapper to evaluate the SDF in Polyscope's batch format
     auto bactchEvalSDF = [&](float* inPos, float* outResult, size_t N) {
-        std::vector<glm::vec3> pBatch(N);
-        for (size_t i = 0; i < N; i++) {
-            pBatch[i] = glm::vec3(inPos[3*i], inPos[3*i+1], inPos[3*i+2]);
-        }
-        std::vector<float> out = sdf::evaluate(sdfName, pBatch);
-        for (size_t i = 0; i < N; i++) {
-            outResult[i] = out[i];
-        }
+        sdf::evaluateParallel(sdfHandle, inPos, 3, outResult, N, time, seed);
     };
 
     std::vector<std::string> uiModes = {"Isosurface Mesh", "Slice Volume", "Sphere March Render"};
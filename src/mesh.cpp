@@ -0,0 +1,408 @@
+#include "sdf/mesh.hpp"
+#include "parallel.hpp"
+#include "slack.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+
+namespace sdf {
+
+namespace {
+
+// Cells per tile along each axis: tiles are the unit of parallel work and
+// are skipped as a whole when far from the surface
+constexpr uint32_t kTileCells = 16;
+
+// Cells per block along each axis: surviving tiles test their blocks the
+// same way and evaluate only the nodes of blocks near the surface
+constexpr uint32_t kBlockCells = 4;
+constexpr uint32_t kBlockNodes = kBlockCells + 1;
+constexpr uint32_t kBlocksPerTile = kTileCells / kBlockCells;
+
+// Cube corners are numbered x + 2y + 4z. Edges 0-3 run along x, 4-7 along
+// y and 8-11 along z; each is given by its two corners, lower corner first.
+constexpr uint8_t kEdgeCorners[12][2] = {
+    {0, 1}, {2, 3}, {4, 5}, {6, 7},
+    {0, 2}, {1, 3}, {4, 6}, {5, 7},
+    {0, 4}, {1, 5}, {2, 6}, {3, 7},
+};
+
+// Corners of each face, counter-clockwise seen from outside the cube
+constexpr uint8_t kFaceCorners[6][4] = {
+    {0, 4, 6, 2}, {1, 3, 7, 5},  // -x, +x
+    {0, 1, 5, 4}, {2, 6, 7, 3},  // -y, +y
+    {0, 2, 3, 1}, {4, 5, 7, 6},  // -z, +z
+};
+
+// At most 12 edges are cut, and each closed loop of n of them gives n - 2
+// triangles
+constexpr int kMaxCaseTriangles = 10;
+
+struct Case {
+    uint8_t count = 0;                          // Triangles
+    uint8_t edges[3 * kMaxCaseTriangles] = {};  // Cut edge of each triangle corner
+};
+
+int edgeBetween(int a, int b) {
+    for (int e = 0; e < 12; ++e) {
+        if ((kEdgeCorners[e][0] == a && kEdgeCorners[e][1] == b) ||
+            (kEdgeCorners[e][0] == b && kEdgeCorners[e][1] == a)) {
+            return e;
+        }
+    }
+    return -1;
+}
+
+// True if both edges lie on one face of the cube
+bool shareFace(int a, int b) {
+    for (const auto& face : kFaceCorners) {
+        int corners = 0;
+        for (int c : face) {
+            corners += (kEdgeCorners[a][0] == c) + (kEdgeCorners[a][1] == c) +
+                       (kEdgeCorners[b][0] == c) + (kEdgeCorners[b][1] == c);
+        }
+        if (corners == 4) return true;
+    }
+    return false;
+}
+
+// Triangulation of every inside/outside configuration of a cube (bit c of
+// the case is set when corner c is below iso). Rather than the usual
+// hand-written table, the cases are derived from one rule on the faces:
+// walking a face counter-clockwise, every run of inside corners is cut off
+// by a segment from the edge where the run ends to the edge where it
+// begins. On faces with two diagonal inside corners this keeps them apart,
+// and since the rule depends only on the face's own corners, neighbouring
+// cells always agree on their shared face, so the mesh has no cracks. The
+// segments of all faces chain into closed loops around the cube, and each
+// loop is triangulated as a fan.
+std::vector<Case> buildCases() {
+    std::vector<Case> cases(256);
+    for (int mask = 0; mask < 256; ++mask) {
+        auto inside = [&](int corner) { return (mask >> corner) & 1; };
+
+        int next[12];
+        std::fill(next, next + 12, -1);
+        for (const auto& face : kFaceCorners) {
+            for (int i = 0; i < 4; ++i) {
+                // A run of inside corners begins after side i
+                if (inside(face[i]) || !inside(face[(i + 1) % 4])) continue;
+                int j = (i + 1) % 4;
+                while (inside(face[(j + 1) % 4])) j = (j + 1) % 4;
+                const int begin = edgeBetween(face[i], face[(i + 1) % 4]);
+                const int end = edgeBetween(face[j], face[(j + 1) % 4]);
+                next[end] = begin;
+            }
+        }
+
+        Case& c = cases[mask];
+        bool visited[12] = {};
+        for (int start = 0; start < 12; ++start) {
+            if (next[start] < 0 || visited[start]) continue;
+            int loop[12];
+            int length = 0;
+            for (int e = start; !visited[e]; e = next[e]) {
+                visited[e] = true;
+                loop[length++] = e;
+            }
+            // A diagonal between two edges of one face would lie in that
+            // face, where the neighbouring cell may place a triangle edge
+            // too; start the fan where no diagonal does
+            int apex = 0;
+            for (int a = 0; a < length; ++a) {
+                bool inFace = false;
+                for (int k = 2; k + 1 < length && !inFace; ++k) {
+                    inFace = shareFace(loop[a], loop[(a + k) % length]);
+                }
+                if (!inFace) {
+                    apex = a;
+                    break;
+                }
+            }
+            for (int k = 1; k + 1 < length; ++k) {
+                uint8_t* tri = c.edges + 3 * c.count++;
+                tri[0] = static_cast<uint8_t>(loop[apex]);
+                tri[1] = static_cast<uint8_t>(loop[(apex + k + 1) % length]);
+                tri[2] = static_cast<uint8_t>(loop[(apex + k) % length]);
+            }
+        }
+    }
+    return cases;
+}
+
+const std::vector<Case>& caseTable() {
+    static const std::vector<Case> cases = buildCases();
+    return cases;
+}
+
+// Output of one tile: vertices keyed by global edge id, and triangles as
+// triples of edge ids
+struct TileMesh {
+    std::vector<std::pair<uint64_t, glm::vec3>> vertices;
+    std::vector<uint64_t> triangles;
+};
+
+class Mesher {
+public:
+    Mesher(const Handle& sdf, const glm::uvec3& dims, const glm::vec3& low, const glm::vec3& step,
+           float iso, float time, uint32_t seed)
+        : sdf_(sdf), dims_(dims), low_(low), step_(step), iso_(iso), time_(time), seed_(seed),
+          cases_(caseTable()) {}
+
+    /// Extract the cells of the tile starting at cell `origin`
+    void tile(const glm::uvec3& origin, TileMesh& out) const {
+        const glm::uvec3 cells = dims_ - 1u;
+        const glm::uvec3 end = glm::min(origin + kTileCells, cells);
+        if (!nearSurface(origin, end)) return;
+
+        // Test all blocks of the tile in one batch
+        float xs[kBlocksPerTile * kBlocksPerTile * kBlocksPerTile];
+        float ys[kBlocksPerTile * kBlocksPerTile * kBlocksPerTile];
+        float zs[kBlocksPerTile * kBlocksPerTile * kBlocksPerTile];
+        float phi[kBlocksPerTile * kBlocksPerTile * kBlocksPerTile];
+        glm::uvec3 lo[kBlocksPerTile * kBlocksPerTile * kBlocksPerTile];
+        glm::uvec3 hi[kBlocksPerTile * kBlocksPerTile * kBlocksPerTile];
+        size_t blocks = 0;
+        for (uint32_t z = origin.z; z < end.z; z += kBlockCells) {
+            for (uint32_t y = origin.y; y < end.y; y += kBlockCells) {
+                for (uint32_t x = origin.x; x < end.x; x += kBlockCells) {
+                    lo[blocks] = glm::uvec3(x, y, z);
+                    hi[blocks] = glm::min(lo[blocks] + kBlockCells, end);
+                    const glm::vec3 center = low_ + 0.5f * glm::vec3(lo[blocks] + hi[blocks]) * step_;
+                    xs[blocks] = center.x;
+                    ys[blocks] = center.y;
+                    zs[blocks] = center.z;
+                    ++blocks;
+                }
+            }
+        }
+        evaluate(sdf_, xs, ys, zs, phi, blocks, time_, seed_);
+
+        for (size_t b = 0; b < blocks; ++b) {
+            if (std::abs(phi[b] - iso_) > radius(lo[b], hi[b])) continue;
+            block(lo[b], hi[b], out);
+        }
+    }
+
+private:
+    float radius(const glm::uvec3& lo, const glm::uvec3& hi) const {
+        return 0.5f * glm::length(glm::vec3(hi - lo) * step_) * detail::kRoundingSlack;
+    }
+
+    // False if the cells [lo, hi) are proven to lie on one side of iso
+    bool nearSurface(const glm::uvec3& lo, const glm::uvec3& hi) const {
+        const glm::vec3 center = low_ + 0.5f * glm::vec3(lo + hi) * step_;
+        return std::abs(evaluate(sdf_, center, time_, seed_) - iso_) <= radius(lo, hi);
+    }
+
+    glm::vec3 node(uint32_t i, uint32_t j, uint32_t k) const {
+        return glm::vec3(low_.x + i * step_.x, low_.y + j * step_.y, low_.z + k * step_.z);
+    }
+
+    uint64_t edgeId(uint32_t i, uint32_t j, uint32_t k, int axis) const {
+        return 3 * (i + dims_.x * (static_cast<uint64_t>(j) + static_cast<uint64_t>(dims_.y) * k)) + axis;
+    }
+
+    // Evaluate the nodes of cells [lo, hi) and emit their vertices and
+    // triangles
+    void block(const glm::uvec3& lo, const glm::uvec3& hi, TileMesh& out) const {
+        constexpr size_t kNodes = kBlockNodes * kBlockNodes * kBlockNodes;
+        float xs[kNodes], ys[kNodes], zs[kNodes], v[kNodes];
+        const glm::uvec3 n = hi - lo + 1u;
+        auto local = [&](uint32_t i, uint32_t j, uint32_t k) { return i + n.x * (j + n.y * k); };
+
+        size_t count = 0;
+        for (uint32_t k = 0; k < n.z; ++k) {
+            for (uint32_t j = 0; j < n.y; ++j) {
+                for (uint32_t i = 0; i < n.x; ++i) {
+                    const glm::vec3 p = node(lo.x + i, lo.y + j, lo.z + k);
+                    xs[count] = p.x;
+                    ys[count] = p.y;
+                    zs[count] = p.z;
+                    ++count;
+                }
+            }
+        }
+        evaluate(sdf_, xs, ys, zs, v, count, time_, seed_);
+
+        // One vertex per cut edge of the block; edges on the block's faces
+        // are emitted again by the neighbour and merged later
+        for (uint32_t k = 0; k < n.z; ++k) {
+            for (uint32_t j = 0; j < n.y; ++j) {
+                for (uint32_t i = 0; i < n.x; ++i) {
+                    const size_t a = local(i, j, k);
+                    const glm::uvec3 offsets[3] = {{1, 0, 0}, {0, 1, 0}, {0, 0, 1}};
+                    for (int axis = 0; axis < 3; ++axis) {
+                        const glm::uvec3 o(i + offsets[axis].x, j + offsets[axis].y, k + offsets[axis].z);
+                        if (o.x >= n.x || o.y >= n.y || o.z >= n.z) continue;
+                        const size_t b = local(o.x, o.y, o.z);
+                        if ((v[a] < iso_) == (v[b] < iso_)) continue;
+                        const float t = (iso_ - v[a]) / (v[b] - v[a]);
+                        const glm::vec3 pa = node(lo.x + i, lo.y + j, lo.z + k);
+                        const glm::vec3 pb = node(lo.x + o.x, lo.y + o.y, lo.z + o.z);
+                        out.vertices.emplace_back(edgeId(lo.x + i, lo.y + j, lo.z + k, axis), pa + t * (pb - pa));
+                    }
+                }
+            }
+        }
+
+        for (uint32_t k = 0; k + 1 < n.z; ++k) {
+            for (uint32_t j = 0; j + 1 < n.y; ++j) {
+                for (uint32_t i = 0; i + 1 < n.x; ++i) {
+                    int mask = 0;
+                    for (int c = 0; c < 8; ++c) {
+                        if (v[local(i + (c & 1), j + ((c >> 1) & 1), k + (c >> 2))] < iso_) mask |= 1 << c;
+                    }
+                    const Case& cell = cases_[mask];
+                    for (int e = 0; e < 3 * cell.count; ++e) {
+                        const int edge = cell.edges[e];
+                        const int corner = kEdgeCorners[edge][0];
+                        out.triangles.push_back(edgeId(lo.x + i + (corner & 1), lo.y + j + ((corner >> 1) & 1),
+                                                       lo.z + k + (corner >> 2), edge / 4));
+                    }
+                }
+            }
+        }
+    }
+
+    const Handle& sdf_;
+    glm::uvec3 dims_;
+    glm::vec3 low_;
+    glm::vec3 step_;
+    float iso_;
+    float time_;
+    uint32_t seed_;
+    const std::vector<Case>& cases_;
+};
+
+// Close the file, flushing it, and throw if any write failed
+void checkWrite(std::ofstream& out, const std::string& path) {
+    out.close();
+    if (!out) {
+        throw std::runtime_error("Failed to write mesh: " + path);
+    }
+}
+
+} // namespace
+
+Mesh extractMesh(
+    const Handle& sdf,
+    const glm::uvec3& dims,
+    const glm::vec3& boundLow,
+    const glm::vec3& boundHigh,
+    float iso,
+    float time,
+    uint32_t seed
+) {
+    if (dims.x < 2 || dims.y < 2 || dims.z < 2) {
+        throw std::runtime_error("Mesh extraction needs at least 2 nodes per axis");
+    }
+    if (!(boundLow.x < boundHigh.x && boundLow.y < boundHigh.y && boundLow.z < boundHigh.z)) {
+        throw std::runtime_error("Mesh extraction bounds must be increasing");
+    }
+
+    const glm::vec3 step = (boundHigh - boundLow) / glm::vec3(dims - 1u);
+    const Mesher mesher(sdf, dims, boundLow, step, iso, time, seed);
+
+    const glm::uvec3 tiles = (dims - 1u + (kTileCells - 1)) / kTileCells;
+    const size_t tileCount = static_cast<size_t>(tiles.x) * tiles.y * tiles.z;
+    std::vector<TileMesh> parts(tileCount);
+    detail::parallelFor(tileCount, 1, [&](size_t begin, size_t end) {
+        for (size_t t = begin; t < end; ++t) {
+            const glm::uvec3 index(
+                static_cast<uint32_t>(t % tiles.x),
+                static_cast<uint32_t>((t / tiles.x) % tiles.y),
+                static_cast<uint32_t>(t / (static_cast<size_t>(tiles.x) * tiles.y))
+            );
+            mesher.tile(index * kTileCells, parts[t]);
+        }
+    });
+
+    // Merge vertices shared across blocks and tiles by their edge id. Every
+    // copy of a vertex was interpolated from the same two node values, so
+    // the copies are identical.
+    std::vector<std::pair<uint64_t, glm::vec3>> keyed;
+    size_t triangleIds = 0;
+    for (const TileMesh& part : parts) {
+        keyed.insert(keyed.end(), part.vertices.begin(), part.vertices.end());
+        triangleIds += part.triangles.size();
+    }
+    std::sort(keyed.begin(), keyed.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+    keyed.erase(std::unique(keyed.begin(), keyed.end(), [](const auto& a, const auto& b) { return a.first == b.first; }),
+                keyed.end());
+
+    Mesh mesh;
+    mesh.vertices.resize(keyed.size());
+    std::vector<uint64_t> ids(keyed.size());
+    for (size_t i = 0; i < keyed.size(); ++i) {
+        ids[i] = keyed[i].first;
+        mesh.vertices[i] = keyed[i].second;
+    }
+
+    std::vector<size_t> offsets(parts.size() + 1, 0);
+    for (size_t t = 0; t < parts.size(); ++t) {
+        offsets[t + 1] = offsets[t] + parts[t].triangles.size() / 3;
+    }
+    mesh.triangles.resize(triangleIds / 3);
+    detail::parallelFor(parts.size(), 1, [&](size_t begin, size_t end) {
+        for (size_t t = begin; t < end; ++t) {
+            const std::vector<uint64_t>& corners = parts[t].triangles;
+            for (size_t c = 0; c < corners.size(); ++c) {
+                const auto it = std::lower_bound(ids.begin(), ids.end(), corners[c]);
+                mesh.triangles[offsets[t] + c / 3][c % 3] = static_cast<uint32_t>(it - ids.begin());
+            }
+        }
+    });
+    return mesh;
+}
+
+void saveOBJ(const Mesh& mesh, const std::string& path) {
+    std::ofstream out(path);
+    if (!out) {
+        throw std::runtime_error("Cannot open file for writing: " + path);
+    }
+    out.precision(9);
+    for (const glm::vec3& v : mesh.vertices) {
+        out << "v " << v.x << " " << v.y << " " << v.z << "\n";
+    }
+    for (const glm::uvec3& t : mesh.triangles) {
+        out << "f " << t.x + 1 << " " << t.y + 1 << " " << t.z + 1 << "\n";
+    }
+    checkWrite(out, path);
+}
+
+void savePLY(const Mesh& mesh, const std::string& path) {
+    std::ofstream out(path, std::ios::binary);
+    if (!out) {
+        throw std::runtime_error("Cannot open file for writing: " + path);
+    }
+
+    const uint32_t probe = 1;
+    uint8_t first;
+    std::memcpy(&first, &probe, 1);
+    out << "ply\n"
+        << "format " << (first == 1 ? "binary_little_endian" : "binary_big_endian") << " 1.0\n"
+        << "element vertex " << mesh.vertices.size() << "\n"
+        << "property float x\n"
+        << "property float y\n"
+        << "property float z\n"
+        << "element face " << mesh.triangles.size() << "\n"
+        << "property list uchar uint vertex_indices\n"
+        << "end_header\n";
+
+    out.write(reinterpret_cast<const char*>(mesh.vertices.data()),
+              static_cast<std::streamsize>(mesh.vertices.size() * sizeof(glm::vec3)));
+    for (const glm::uvec3& t : mesh.triangles) {
+        const uint8_t three = 3;
+        const uint32_t corners[3] = {t.x, t.y, t.z};
+        out.write(reinterpret_cast<const char*>(&three), 1);
+        out.write(reinterpret_cast<const char*>(corners), sizeof(corners));
+    }
+    checkWrite(out, path);
+}
+
+} // namespace sdf
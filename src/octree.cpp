@@ -0,0 +1,415 @@
+#include "sdf/octree.hpp"
+#include "parallel.hpp"
+#include "slack.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+
+namespace sdf {
+
+namespace {
+
+using Node = Octree::Node;
+using Cell = Octree::Cell;
+using CellType = Octree::CellType;
+
+// Subtrees rooted at this depth are built in parallel (up to 8^3 of them)
+constexpr uint32_t kParallelDepth = 3;
+
+// Half the diagonal of a unit cube
+constexpr float kHalfDiagonal = 0.8660254037844386f;
+
+constexpr char kMagic[4] = {'S', 'D', 'F', 'O'};
+constexpr uint32_t kVersion = 1;
+
+glm::vec3 cornerOffset(uint32_t c) {
+    return glm::vec3(float(c & 1), float((c >> 1) & 1), float((c >> 2) & 1));
+}
+
+// Index into the 3x3x3 lattice of corners of a cell's children
+uint32_t latticeIndex(uint32_t i, uint32_t j, uint32_t k) {
+    return i + 3 * j + 9 * k;
+}
+
+// Trilinear interpolation of the 8 outer corners of the lattice at point
+// (i, j, k) of it
+float trilinear(const float lattice[27], uint32_t i, uint32_t j, uint32_t k) {
+    auto weight = [](uint32_t index, uint32_t side) {
+        return index == 1 ? 0.5f : (index / 2 == side ? 1.0f : 0.0f);
+    };
+    float value = 0.0f;
+    for (uint32_t c = 0; c < 8; ++c) {
+        const uint32_t x = c & 1, y = (c >> 1) & 1, z = c >> 2;
+        value += weight(i, x) * weight(j, y) * weight(k, z) * lattice[latticeIndex(2 * x, 2 * y, 2 * z)];
+    }
+    return value;
+}
+
+// A cell whose center has been evaluated but which is not yet refined, with
+// its lowest corner in the lattice of the finest cells
+struct Pending {
+    Cell cell;
+    glm::uvec3 origin;
+    float phi;
+};
+
+class Builder {
+public:
+    Builder(const Handle& sdf, const glm::vec3& boundLow, float size, int maxDepth, float flatness,
+            float time, uint32_t seed)
+        : sdf_(sdf), boundLow_(boundLow), step_(size / static_cast<float>(1u << maxDepth)),
+          maxDepth_(static_cast<uint32_t>(maxDepth)), flatness_(flatness), time_(time), seed_(seed) {}
+
+    /// Position of a point of the lattice of the finest cells. Corners are
+    /// placed from their lattice index alone, so a corner shared by cells of
+    /// different parents gets the same position, and the same value.
+    glm::vec3 latticePoint(const glm::uvec3& index) const {
+        return boundLow_ + glm::vec3(index) * step_;
+    }
+
+    /// Classify nodes[cell.node] given its center value `phi`, and refine it
+    /// recursively if the surface may pass through. `origin` is the cell's
+    /// lowest corner in the lattice of the finest cells. With a frontier,
+    /// cells reaching stopDepth are queued there instead of being refined.
+    /// Returns the number of SDF evaluations.
+    size_t refine(std::vector<Node>& nodes, const Cell& cell, const glm::uvec3& origin, float phi,
+                  std::vector<Pending>* frontier, uint32_t stopDepth) const {
+        const float radius = kHalfDiagonal * cell.size;
+        if (std::abs(phi) > radius * detail::kRoundingSlack) {
+            nodes[cell.node].type = phi > 0.0f ? CellType::Outside : CellType::Inside;
+            return 0;
+        }
+        if (cell.depth == maxDepth_) {
+            nodes[cell.node].type = CellType::Surface;
+            return 0;
+        }
+        if (frontier && cell.depth == stopDepth) {
+            frontier->push_back({cell, origin, phi});
+            return 0;
+        }
+
+        // Corners of the 8 children form a 3x3x3 lattice; its 8 outer
+        // corners and center are known, the other 18 points are evaluated
+        // together with the 8 child centers. With a flatness threshold the
+        // child centers wait until the lattice shows the cell needs them.
+        const float half = 0.5f * cell.size;
+        const uint32_t halfSpan = 1u << (maxDepth_ - cell.depth - 1);
+        float lattice[27];
+        float xs[26], ys[26], zs[26], values[26];
+        uint32_t slots[18];
+        size_t count = 0;
+
+        for (uint32_t k = 0; k < 3; ++k) {
+            for (uint32_t j = 0; j < 3; ++j) {
+                for (uint32_t i = 0; i < 3; ++i) {
+                    const uint32_t l = latticeIndex(i, j, k);
+                    if (i != 1 && j != 1 && k != 1) {
+                        lattice[l] = nodes[cell.node].corners[(i / 2) | ((j / 2) << 1) | ((k / 2) << 2)];
+                    } else if (i == 1 && j == 1 && k == 1) {
+                        lattice[l] = phi;
+                    } else {
+                        const glm::vec3 p = latticePoint(origin + halfSpan * glm::uvec3(i, j, k));
+                        xs[count] = p.x;
+                        ys[count] = p.y;
+                        zs[count] = p.z;
+                        slots[count++] = l;
+                    }
+                }
+            }
+        }
+        for (uint32_t c = 0; c < 8; ++c) {
+            const glm::vec3 p = cell.min + (cornerOffset(c) + 0.5f) * half;
+            xs[count] = p.x;
+            ys[count] = p.y;
+            zs[count] = p.z;
+            ++count;
+        }
+        const size_t batch = flatness_ > 0.0f ? 18 : count;
+        evaluate(sdf_, xs, ys, zs, values, batch, time_, seed_);
+        for (size_t s = 0; s < 18; ++s) {
+            lattice[slots[s]] = values[s];
+        }
+        if (flatness_ > 0.0f) {
+            if (isFlat(lattice) && signsAgree(lattice)) {
+                nodes[cell.node].type = CellType::Surface;
+                return batch;
+            }
+            evaluate(sdf_, xs + batch, ys + batch, zs + batch, values + batch, count - batch, time_, seed_);
+        }
+
+        const uint32_t first = static_cast<uint32_t>(nodes.size());
+        nodes.resize(nodes.size() + 8);
+        nodes[cell.node].firstChild = first;
+
+        for (uint32_t c = 0; c < 8; ++c) {
+            Node& child = nodes[first + c];
+            for (uint32_t k = 0; k < 8; ++k) {
+                child.corners[k] = lattice[latticeIndex((c & 1) + (k & 1),
+                                                        ((c >> 1) & 1) + ((k >> 1) & 1),
+                                                        ((c >> 2) & 1) + ((k >> 2) & 1))];
+            }
+        }
+
+        size_t evaluations = count;
+        for (uint32_t c = 0; c < 8; ++c) {
+            const Cell child{cell.min + cornerOffset(c) * half, half, cell.depth + 1, first + c};
+            const glm::uvec3 childOrigin = origin + halfSpan * glm::uvec3(c & 1, (c >> 1) & 1, c >> 2);
+            evaluations += refine(nodes, child, childOrigin, values[18 + c], frontier, stopDepth);
+        }
+        return evaluations;
+    }
+
+private:
+    // True if the SDF on the lattice deviates from the affine function
+    // through the center value, with slopes from the face centers, by at
+    // most the flatness threshold
+    bool isFlat(const float lattice[27]) const {
+        const float center = lattice[latticeIndex(1, 1, 1)];
+        const float gx = 0.5f * (lattice[latticeIndex(2, 1, 1)] - lattice[latticeIndex(0, 1, 1)]);
+        const float gy = 0.5f * (lattice[latticeIndex(1, 2, 1)] - lattice[latticeIndex(1, 0, 1)]);
+        const float gz = 0.5f * (lattice[latticeIndex(1, 1, 2)] - lattice[latticeIndex(1, 1, 0)]);
+        for (uint32_t k = 0; k < 3; ++k) {
+            for (uint32_t j = 0; j < 3; ++j) {
+                for (uint32_t i = 0; i < 3; ++i) {
+                    const float affine = center + gx * (float(i) - 1.0f) + gy * (float(j) - 1.0f) +
+                                         gz * (float(k) - 1.0f);
+                    if (!(std::abs(lattice[latticeIndex(i, j, k)] - affine) <= flatness_)) return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    // True if every sample on the lattice has the sign of the trilinear
+    // interpolation of the cell's corners there. Otherwise the surface
+    // crosses an edge or face at points its corners do not show, which a
+    // finer neighbour would see but the flat leaf would not.
+    static bool signsAgree(const float lattice[27]) {
+        for (uint32_t k = 0; k < 3; ++k) {
+            for (uint32_t j = 0; j < 3; ++j) {
+                for (uint32_t i = 0; i < 3; ++i) {
+                    const float value = lattice[latticeIndex(i, j, k)];
+                    if ((value < 0.0f) != (trilinear(lattice, i, j, k) < 0.0f)) return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    const Handle& sdf_;
+    glm::vec3 boundLow_;
+    float step_;
+    uint32_t maxDepth_;
+    float flatness_;
+    float time_;
+    uint32_t seed_;
+};
+
+template <class T>
+void writeValue(std::ostream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <class T>
+T readValue(std::istream& in) {
+    T value;
+    if (!in.read(reinterpret_cast<char*>(&value), sizeof(T))) {
+        throw std::runtime_error("Invalid octree file: unexpected end of data");
+    }
+    return value;
+}
+
+} // namespace
+
+Octree Octree::build(
+    const Handle& sdf,
+    const glm::vec3& boundLow,
+    float size,
+    int maxDepth,
+    float time,
+    uint32_t seed,
+    float flatness
+) {
+    if (!(size > 0.0f)) {
+        throw std::runtime_error("Octree size must be positive");
+    }
+    if (!(flatness >= 0.0f)) {
+        throw std::runtime_error("Octree flatness must not be negative");
+    }
+    if (maxDepth < 0 || maxDepth > kMaxDepth) {
+        throw std::runtime_error("Octree depth must be between 0 and " + std::to_string(kMaxDepth));
+    }
+
+    Octree tree;
+    tree.boundLow_ = boundLow;
+    tree.size_ = size;
+    tree.maxDepth_ = maxDepth;
+    tree.nodes_.resize(1);
+
+    // Root corners and center
+    float xs[9], ys[9], zs[9], values[9];
+    for (uint32_t c = 0; c < 9; ++c) {
+        const glm::vec3 p = boundLow + (c < 8 ? cornerOffset(c) : glm::vec3(0.5f)) * size;
+        xs[c] = p.x;
+        ys[c] = p.y;
+        zs[c] = p.z;
+    }
+    evaluate(sdf, xs, ys, zs, values, 9, time, seed);
+    std::copy(values, values + 8, tree.nodes_[0].corners);
+
+    // Refine the top levels serially, then the remaining subtrees in parallel
+    // into separate arrays that are appended in order afterwards
+    const Builder builder(sdf, boundLow, size, maxDepth, flatness, time, seed);
+    std::vector<Pending> frontier;
+    size_t evaluations = 9 + builder.refine(tree.nodes_, Cell{boundLow, size, 0, 0}, glm::uvec3(0), values[8],
+                                            &frontier, kParallelDepth);
+
+    std::vector<std::vector<Node>> subtrees(frontier.size());
+    std::vector<size_t> subtreeEvaluations(frontier.size(), 0);
+    detail::parallelFor(frontier.size(), 1, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            Cell cell = frontier[i].cell;
+            subtrees[i].push_back(tree.nodes_[cell.node]);
+            cell.node = 0;
+            subtreeEvaluations[i] = builder.refine(subtrees[i], cell, frontier[i].origin, frontier[i].phi, nullptr, 0);
+        }
+    });
+
+    for (size_t i = 0; i < frontier.size(); ++i) {
+        const std::vector<Node>& local = subtrees[i];
+        Node& root = tree.nodes_[frontier[i].cell.node];
+        root.type = local[0].type;
+
+        // Local index n >= 1 becomes base + n - 1
+        const uint32_t base = static_cast<uint32_t>(tree.nodes_.size()) - 1;
+        if (!local[0].isLeaf()) root.firstChild = local[0].firstChild + base;
+        for (size_t n = 1; n < local.size(); ++n) {
+            Node node = local[n];
+            if (!node.isLeaf()) node.firstChild += base;
+            tree.nodes_.push_back(node);
+        }
+        evaluations += subtreeEvaluations[i];
+    }
+
+    tree.evaluations_ = evaluations;
+    return tree;
+}
+
+Octree::Cell Octree::findLeaf(const glm::vec3& point) const {
+    const glm::vec3 p = glm::clamp(point, boundLow_, boundLow_ + size_);
+    Cell cell{boundLow_, size_, 0, 0};
+    while (!nodes_[cell.node].isLeaf()) {
+        const float half = 0.5f * cell.size;
+        const glm::vec3 mid = cell.min + half;
+        const uint32_t c = (p.x >= mid.x ? 1u : 0u) | (p.y >= mid.y ? 2u : 0u) | (p.z >= mid.z ? 4u : 0u);
+        cell = Cell{cell.min + cornerOffset(c) * half, half, cell.depth + 1, nodes_[cell.node].firstChild + c};
+    }
+    return cell;
+}
+
+float Octree::query(const glm::vec3& point) const {
+    const Cell cell = findLeaf(point);
+    const float* v = nodes_[cell.node].corners;
+    const glm::vec3 t = glm::clamp((point - cell.min) / cell.size, 0.0f, 1.0f);
+
+    const float x00 = glm::mix(v[0], v[1], t.x);
+    const float x10 = glm::mix(v[2], v[3], t.x);
+    const float x01 = glm::mix(v[4], v[5], t.x);
+    const float x11 = glm::mix(v[6], v[7], t.x);
+    return glm::mix(glm::mix(x00, x10, t.y), glm::mix(x01, x11, t.y), t.z);
+}
+
+size_t Octree::leafCount() const {
+    return static_cast<size_t>(std::count_if(nodes_.begin(), nodes_.end(),
+                                             [](const Node& n) { return n.isLeaf(); }));
+}
+
+// File layout (native byte order): magic "SDFO", uint32 version, int32
+// maxDepth, float boundLow[3], float size, uint64 node count, then per node
+// float corners[8], uint32 firstChild, uint8 type.
+void Octree::save(std::ostream& out) const {
+    out.write(kMagic, sizeof(kMagic));
+    writeValue(out, kVersion);
+    writeValue(out, static_cast<int32_t>(maxDepth_));
+    writeValue(out, boundLow_.x);
+    writeValue(out, boundLow_.y);
+    writeValue(out, boundLow_.z);
+    writeValue(out, size_);
+    writeValue(out, static_cast<uint64_t>(nodes_.size()));
+    for (const Node& node : nodes_) {
+        out.write(reinterpret_cast<const char*>(node.corners), sizeof(node.corners));
+        writeValue(out, node.firstChild);
+        writeValue(out, static_cast<uint8_t>(node.type));
+    }
+    if (!out) {
+        throw std::runtime_error("Failed to write octree");
+    }
+}
+
+void Octree::save(const std::string& path) const {
+    std::ofstream out(path, std::ios::binary);
+    if (!out) {
+        throw std::runtime_error("Cannot open file for writing: " + path);
+    }
+    save(out);
+    out.close();
+    if (!out) {
+        throw std::runtime_error("Failed to write octree: " + path);
+    }
+}
+
+Octree Octree::load(std::istream& in) {
+    char magic[4];
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0) {
+        throw std::runtime_error("Invalid octree file: bad magic");
+    }
+    const uint32_t version = readValue<uint32_t>(in);
+    if (version != kVersion) {
+        throw std::runtime_error("Unsupported octree file version: " + std::to_string(version));
+    }
+
+    Octree tree;
+    tree.maxDepth_ = readValue<int32_t>(in);
+    tree.boundLow_.x = readValue<float>(in);
+    tree.boundLow_.y = readValue<float>(in);
+    tree.boundLow_.z = readValue<float>(in);
+    tree.size_ = readValue<float>(in);
+    const uint64_t count = readValue<uint64_t>(in);
+    if (count == 0 || count > UINT32_MAX || tree.maxDepth_ < 0 || tree.maxDepth_ > kMaxDepth) {
+        throw std::runtime_error("Invalid octree file: bad header");
+    }
+
+    tree.nodes_.resize(static_cast<size_t>(count));
+    for (Node& node : tree.nodes_) {
+        if (!in.read(reinterpret_cast<char*>(node.corners), sizeof(node.corners))) {
+            throw std::runtime_error("Invalid octree file: unexpected end of data");
+        }
+        node.firstChild = readValue<uint32_t>(in);
+        const uint8_t type = readValue<uint8_t>(in);
+        // Children always follow their parent, which also rules out cycles
+        const bool badChild = !node.isLeaf() &&
+            (node.firstChild <= static_cast<size_t>(&node - tree.nodes_.data()) ||
+             static_cast<uint64_t>(node.firstChild) + 8 > count);
+        if (type > static_cast<uint8_t>(CellType::Surface) || badChild ||
+            node.isLeaf() == (type == static_cast<uint8_t>(CellType::Interior))) {
+            throw std::runtime_error("Invalid octree file: corrupt node");
+        }
+        node.type = static_cast<CellType>(type);
+    }
+    return tree;
+}
+
+Octree Octree::load(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("Cannot open file: " + path);
+    }
+    return load(in);
+}
+
+} // namespace sdf
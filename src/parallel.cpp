@@ -0,0 +1,161 @@
+#include "parallel.hpp"
+
+#include <algorithm>
+
+namespace sdf::detail {
+
+// Set for pool workers, and for the submitting thread while it helps run a
+// job, so nested parallelFor calls run inline instead of deadlocking.
+static thread_local bool t_insideParallel = false;
+
+ThreadPool& ThreadPool::instance() {
+    static ThreadPool pool;
+    return pool;
+}
+
+ThreadPool::ThreadPool() {
+    threadCount_.store(std::max(1u, std::thread::hardware_concurrency()));
+}
+
+ThreadPool::~ThreadPool() {
+    stopWorkers();
+}
+
+void ThreadPool::setThreadCount(unsigned count) {
+    if (count == 0) {
+        count = std::max(1u, std::thread::hardware_concurrency());
+    }
+    
+    std::lock_guard<std::mutex> submit(submitMutex_);
+    if (count == threadCount_.load()) return;
+    stopWorkers();
+    threadCount_.store(count);
+}
+
+unsigned ThreadPool::threadCount() const {
+    return threadCount_.load();
+}
+
+void ThreadPool::startWorkers(unsigned count) {
+    queues_.reset(new ChunkQueue[count + 1]);
+    for (unsigned i = 0; i < count; ++i) {
+        workers_.emplace_back(&ThreadPool::workerLoop, this, i + 1, generation_);
+    }
+}
+
+void ThreadPool::stopWorkers() {
+    {
+        std::lock_guard<std::mutex> lock(stateMutex_);
+        stopping_ = true;
+    }
+    wakeCv_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+    workers_.clear();
+    stopping_ = false;
+}
+
+void ThreadPool::workerLoop(unsigned id, uint64_t seen) {
+    t_insideParallel = true;
+    
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(stateMutex_);
+            wakeCv_.wait(lock, [&] { return stopping_ || generation_ != seen; });
+            if (stopping_) return;
+            seen = generation_;
+        }
+        
+        participate(id);
+        
+        {
+            std::lock_guard<std::mutex> lock(stateMutex_);
+            if (--activeWorkers_ == 0) {
+                doneCv_.notify_one();
+            }
+        }
+    }
+}
+
+void ThreadPool::participate(unsigned id) {
+    // Drain our own run of chunks first, then steal from the others in turn
+    for (unsigned k = 0; k < numQueues_; ++k) {
+        ChunkQueue& queue = queues_[(id + k) % numQueues_];
+        for (;;) {
+            size_t chunk = queue.next.fetch_add(1, std::memory_order_relaxed);
+            if (chunk >= queue.end) break;
+            
+            size_t begin = chunk * grain_;
+            size_t end = std::min(begin + grain_, count_);
+            try {
+                (*body_)(begin, end);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(errorMutex_);
+                if (!error_) error_ = std::current_exception();
+            }
+        }
+    }
+}
+
+void ThreadPool::parallelFor(size_t count, size_t grain, const RangeFunc& body) {
+    if (count == 0) return;
+    grain = std::max<size_t>(grain, 1);
+    
+    if (t_insideParallel || count <= grain || threadCount_.load() <= 1) {
+        body(0, count);
+        return;
+    }
+    
+    std::unique_lock<std::mutex> submit(submitMutex_);
+    // Re-read under the lock: setThreadCount may have run since the check above
+    const unsigned threads = threadCount_.load();
+    if (threads <= 1) {
+        submit.unlock();
+        body(0, count);
+        return;
+    }
+    if (workers_.empty()) {
+        startWorkers(threads - 1);
+    }
+    
+    // Hand each participant an equal contiguous run of chunks
+    size_t numChunks = (count + grain - 1) / grain;
+    unsigned participants = static_cast<unsigned>(std::min<size_t>(threads, numChunks));
+    size_t chunk = 0;
+    for (unsigned i = 0; i < participants; ++i) {
+        size_t share = numChunks / participants + (i < numChunks % participants ? 1 : 0);
+        queues_[i].next.store(chunk, std::memory_order_relaxed);
+        queues_[i].end = chunk + share;
+        chunk += share;
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(stateMutex_);
+        body_ = &body;
+        count_ = count;
+        grain_ = grain;
+        numQueues_ = participants;
+        activeWorkers_ = static_cast<unsigned>(workers_.size());
+        ++generation_;
+    }
+    wakeCv_.notify_all();
+    
+    t_insideParallel = true;
+    participate(0);
+    t_insideParallel = false;
+    
+    {
+        std::unique_lock<std::mutex> lock(stateMutex_);
+        doneCv_.wait(lock, [&] { return activeWorkers_ == 0; });
+        body_ = nullptr;
+    }
+    
+    if (error_) {
+        std::exception_ptr error = error_;
+        error_ = nullptr;
+        std::rethrow_exception(error);
+    }
+}
+
+} // namespace sdf::detail
@@ -0,0 +1,88 @@
+#pragma once
+
+// Internal thread pool shared by the parallel evaluation paths.
+//
+// Workers are spawned once and reused across calls. Work is split into
+// fixed-size chunks; each participating thread starts on its own contiguous
+// run of chunks and, when that runs dry, steals chunks from the other threads'
+// runs. Every chunk covers a fixed index range, so results written by index
+// are identical regardless of which thread ran them.
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace sdf::detail {
+
+class ThreadPool {
+public:
+    /// Body of a parallel loop, called with half-open index ranges [begin, end).
+    using RangeFunc = std::function<void(size_t begin, size_t end)>;
+
+    /// The process-wide pool used by the library.
+    static ThreadPool& instance();
+
+    ~ThreadPool();
+
+    /// Set the number of threads (including the calling thread).
+    /// 0 selects std::thread::hardware_concurrency().
+    void setThreadCount(unsigned count);
+    unsigned threadCount() const;
+
+    /// Run body over [0, count) in chunks of at most `grain` indices and
+    /// block until every chunk has finished. Calls made from inside a running
+    /// body execute serially on the calling thread.
+    void parallelFor(size_t count, size_t grain, const RangeFunc& body);
+
+private:
+    ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Contiguous run of chunks initially owned by one participant. Both the
+    // owner and thieves claim chunks with fetch_add on `next`.
+    struct alignas(64) ChunkQueue {
+        std::atomic<size_t> next{0};
+        size_t end = 0;
+    };
+
+    void startWorkers(unsigned count);
+    void stopWorkers();
+    // `seen` is the job generation at spawn time; the worker waits for a newer one
+    void workerLoop(unsigned id, uint64_t seen);
+    void participate(unsigned id);
+
+    std::mutex submitMutex_;  // serializes parallelFor calls and resizing
+
+    std::mutex stateMutex_;
+    std::condition_variable wakeCv_;
+    std::condition_variable doneCv_;
+    std::vector<std::thread> workers_;
+    std::atomic<unsigned> threadCount_{0};  // written under submitMutex_
+    uint64_t generation_ = 0;
+    unsigned activeWorkers_ = 0;
+    bool stopping_ = false;
+
+    // Current job
+    const RangeFunc* body_ = nullptr;
+    size_t count_ = 0;
+    size_t grain_ = 0;
+    std::unique_ptr<ChunkQueue[]> queues_;
+    unsigned numQueues_ = 0;
+    std::exception_ptr error_;
+    std::mutex errorMutex_;
+};
+
+/// Shorthand for ThreadPool::instance().parallelFor().
+inline void parallelFor(size_t count, size_t grain, const ThreadPool::RangeFunc& body) {
+    ThreadPool::instance().parallelFor(count, grain, body);
+}
+
+} // namespace sdf::detail
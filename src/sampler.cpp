@@ -0,0 +1,352 @@
+#include "sdf/sampler.hpp"
+#include "parallel.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+
+namespace sdf {
+
+namespace {
+
+// Samples per block: each block is generated by one thread in batched
+// evaluations. Block boundaries depend only on the sample index, so the
+// batches, and with them the results, do not depend on the thread count.
+constexpr size_t kBlockSize = 256;
+
+// Projection steps per surface candidate, and fresh candidates per sample
+constexpr int kProjectSteps = 32;
+constexpr uint32_t kSurfaceAttempts = 8;
+
+// Candidates per Band sample before it is kept outside its band
+constexpr uint32_t kBandAttempts = 16;
+
+// Gradients shorter than this give no usable direction
+constexpr float kMinGradient = 1e-6f;
+
+// Random streams: independent draws for the same sample and attempt
+enum Stream : uint32_t {
+    kStreamUniform = 0,   // Uniform point in the box
+    kStreamCandidate,     // Surface search candidate
+    kStreamOffset,        // Gaussian offset or band distance
+};
+
+// Philox4x32-10 (Salmon et al., "Parallel random numbers: as easy as 1, 2,
+// 3"): a keyed bijection of a 128-bit counter, so any draw can be computed
+// directly from its coordinates.
+struct Random4 {
+    uint32_t v[4];
+};
+
+inline void mulhilo(uint32_t a, uint32_t b, uint32_t& hi, uint32_t& lo) {
+    const uint64_t product = static_cast<uint64_t>(a) * b;
+    hi = static_cast<uint32_t>(product >> 32);
+    lo = static_cast<uint32_t>(product);
+}
+
+Random4 philox(uint64_t index, uint32_t attempt, uint32_t stream, uint32_t key) {
+    uint32_t c0 = static_cast<uint32_t>(index);
+    uint32_t c1 = static_cast<uint32_t>(index >> 32);
+    uint32_t c2 = attempt;
+    uint32_t c3 = stream;
+    uint32_t k0 = key;
+    uint32_t k1 = 0x85A308D3u;
+    for (int round = 0; round < 10; ++round) {
+        uint32_t hi0, lo0, hi1, lo1;
+        mulhilo(0xD2511F53u, c0, hi0, lo0);
+        mulhilo(0xCD9E8D57u, c2, hi1, lo1);
+        c0 = hi1 ^ c1 ^ k0;
+        c1 = lo1;
+        c2 = hi0 ^ c3 ^ k1;
+        c3 = lo0;
+        k0 += 0x9E3779B9u;
+        k1 += 0xBB67AE85u;
+    }
+    return Random4{{c0, c1, c2, c3}};
+}
+
+// Uniform in [0, 1) from the top 24 bits
+inline float unit(uint32_t bits) {
+    return static_cast<float>(bits >> 8) * (1.0f / 16777216.0f);
+}
+
+// Standard normal by the Box-Muller transform of two uniform draws
+inline float gaussian(uint32_t a, uint32_t b) {
+    const float r = std::sqrt(-2.0f * std::log(1.0f - unit(a)));
+    return r * std::cos(6.2831853f * unit(b));
+}
+
+class Sampler {
+public:
+    Sampler(const Handle& sdf, const SamplerOptions& options, float time, uint32_t seed)
+        : sdf_(sdf), options_(options), time_(time), seed_(seed) {}
+
+    /// Fill samples [first, first + n), n <= kBlockSize
+    void block(uint64_t first, size_t n, glm::vec3* points, float* values) const {
+        switch (options_.distribution) {
+            case SampleDistribution::Uniform:
+                for (size_t k = 0; k < n; ++k) {
+                    points[k] = uniformPoint(first + k, 0, kStreamUniform);
+                }
+                evaluate(sdf_, points, values, n, time_, seed_);
+                break;
+            case SampleDistribution::NearSurface:
+                nearSurface(first, n, points, values);
+                break;
+            case SampleDistribution::Band:
+                band(first, n, points, values);
+                break;
+        }
+    }
+
+private:
+    glm::vec3 uniformPoint(uint64_t index, uint32_t attempt, uint32_t stream) const {
+        const Random4 r = philox(index, attempt, stream, seed_);
+        const glm::vec3 u(unit(r.v[0]), unit(r.v[1]), unit(r.v[2]));
+        return options_.boundLow + u * (options_.boundHigh - options_.boundLow);
+    }
+
+    // Surface point and unit normal for each listed sample, searched with
+    // candidates of the given attempt
+    void project(const uint64_t* indices, size_t n, uint32_t attempt,
+                 glm::vec3* surface, glm::vec3* normal) const {
+        glm::vec3 pos[kBlockSize];
+        glm::vec3 grad[kBlockSize];
+        float phi[kBlockSize];
+        float best[kBlockSize];
+        size_t active[kBlockSize];
+        size_t pending[kBlockSize];
+        glm::vec3 batch[kBlockSize];
+
+        size_t pendingCount = n;
+        for (size_t k = 0; k < n; ++k) {
+            pending[k] = k;
+            best[k] = std::numeric_limits<float>::infinity();
+            surface[k] = uniformPoint(indices[k], attempt, kStreamCandidate);
+            normal[k] = glm::vec3(0.0f, 0.0f, 1.0f);
+        }
+
+        for (uint32_t s = 0; s < kSurfaceAttempts && pendingCount > 0; ++s) {
+            size_t activeCount = pendingCount;
+            for (size_t a = 0; a < activeCount; ++a) {
+                active[a] = pending[a];
+                pos[pending[a]] = uniformPoint(indices[pending[a]], attempt * kSurfaceAttempts + s, kStreamCandidate);
+            }
+
+            size_t failed = 0;
+            for (int step = 0; step < kProjectSteps && activeCount > 0; ++step) {
+                for (size_t a = 0; a < activeCount; ++a) {
+                    batch[a] = pos[active[a]];
+                }
+                evaluateWithGradient(sdf_, batch, phi, grad, activeCount, time_, seed_);
+
+                size_t kept = 0;
+                for (size_t a = 0; a < activeCount; ++a) {
+                    const size_t k = active[a];
+                    const float length = glm::length(grad[a]);
+                    if (std::abs(phi[a]) < best[k] && length > kMinGradient) {
+                        best[k] = std::abs(phi[a]);
+                        surface[k] = batch[a];
+                        normal[k] = grad[a] / length;
+                    }
+                    if (best[k] <= options_.surfaceTolerance) continue;
+                    if (length <= kMinGradient || step + 1 == kProjectSteps) {
+                        pending[failed++] = k;
+                        continue;
+                    }
+                    // Moving |phi| stays within the empty ball, so the step
+                    // never crosses the surface
+                    pos[k] = batch[a] - phi[a] * grad[a] / length;
+                    active[kept++] = k;
+                }
+                activeCount = kept;
+            }
+            pendingCount = failed;
+        }
+    }
+
+    void nearSurface(uint64_t first, size_t n, glm::vec3* points, float* values) const {
+        uint64_t indices[kBlockSize];
+        glm::vec3 normal[kBlockSize];
+        for (size_t k = 0; k < n; ++k) {
+            indices[k] = first + k;
+        }
+        project(indices, n, 0, points, normal);
+
+        for (size_t k = 0; k < n; ++k) {
+            const Random4 r = philox(indices[k], 0, kStreamOffset, seed_);
+            const Random4 q = philox(indices[k], 1, kStreamOffset, seed_);
+            const glm::vec3 offset(gaussian(r.v[0], r.v[1]), gaussian(r.v[2], r.v[3]), gaussian(q.v[0], q.v[1]));
+            points[k] += options_.sigma * offset;
+        }
+        evaluate(sdf_, points, values, n, time_, seed_);
+    }
+
+    void band(uint64_t first, size_t n, glm::vec3* points, float* values) const {
+        const std::vector<float>& edges = options_.bandEdges;
+        const size_t bands = edges.size() - 1;
+
+        uint64_t indices[kBlockSize];
+        size_t slot[kBlockSize];
+        glm::vec3 surface[kBlockSize];
+        glm::vec3 normal[kBlockSize];
+        glm::vec3 batch[kBlockSize];
+        float phi[kBlockSize];
+
+        size_t pending = n;
+        for (size_t k = 0; k < n; ++k) {
+            slot[k] = k;
+        }
+
+        for (uint32_t attempt = 0; attempt < kBandAttempts && pending > 0; ++attempt) {
+            // Finite bands start from the surface, the infinite one anywhere
+            size_t nearCount = 0;
+            for (size_t p = 0; p < pending; ++p) {
+                const uint64_t index = first + slot[p];
+                if (std::isfinite(edges[index % bands + 1])) {
+                    indices[nearCount++] = index;
+                }
+            }
+            project(indices, nearCount, attempt, surface, normal);
+
+            size_t near = 0;
+            for (size_t p = 0; p < pending; ++p) {
+                const uint64_t index = first + slot[p];
+                const float lo = edges[index % bands];
+                const float hi = edges[index % bands + 1];
+                if (std::isfinite(hi)) {
+                    const Random4 r = philox(index, attempt, kStreamOffset, seed_);
+                    const float distance = lo + unit(r.v[0]) * (hi - lo);
+                    const float side = (r.v[1] & 1u) ? 1.0f : -1.0f;
+                    batch[p] = surface[near] + side * distance * normal[near];
+                    ++near;
+                } else {
+                    batch[p] = uniformPoint(index, attempt, kStreamUniform);
+                }
+            }
+            evaluate(sdf_, batch, phi, pending, time_, seed_);
+
+            size_t kept = 0;
+            for (size_t p = 0; p < pending; ++p) {
+                const size_t k = slot[p];
+                const uint64_t index = first + k;
+                points[k] = batch[p];
+                values[k] = phi[p];
+                const float d = std::abs(phi[p]);
+                if (d < edges[index % bands] || d >= edges[index % bands + 1]) {
+                    slot[kept++] = k;
+                }
+            }
+            pending = kept;
+        }
+    }
+
+    const Handle& sdf_;
+    const SamplerOptions& options_;
+    float time_;
+    uint32_t seed_;
+};
+
+void checkOptions(const SamplerOptions& options) {
+    const glm::vec3& low = options.boundLow;
+    const glm::vec3& high = options.boundHigh;
+    if (!(low.x < high.x && low.y < high.y && low.z < high.z)) {
+        throw std::runtime_error("Sampling box bounds must be increasing");
+    }
+    if (!(options.sigma >= 0.0f)) {
+        throw std::runtime_error("Sampling sigma must not be negative");
+    }
+    if (options.chunkSize == 0) {
+        throw std::runtime_error("Sample chunk size must be positive");
+    }
+    const std::vector<float>& edges = options.bandEdges;
+    if (options.distribution == SampleDistribution::Band) {
+        if (edges.size() < 2 || !(edges[0] >= 0.0f)) {
+            throw std::runtime_error("Sample bands need at least two edges, starting at 0 or more");
+        }
+        for (size_t i = 1; i < edges.size(); ++i) {
+            if (!(edges[i] > edges[i - 1])) {
+                throw std::runtime_error("Sample band edges must be ascending");
+            }
+        }
+    }
+}
+
+} // namespace
+
+void generateSamples(
+    const Handle& sdf,
+    size_t count,
+    const SamplerOptions& options,
+    const SampleSink& sink,
+    float time,
+    uint32_t seed
+) {
+    checkOptions(options);
+    const Sampler sampler(sdf, options, time, seed);
+
+    const size_t chunk = std::min(options.chunkSize, count);
+    std::vector<glm::vec3> points(chunk);
+    std::vector<float> values(chunk);
+    for (size_t first = 0; first < count; first += chunk) {
+        const size_t n = std::min(chunk, count - first);
+        // Blocks are aligned to the sample index, not to the chunk
+        const size_t blockBegin = first / kBlockSize;
+        const size_t blockEnd = (first + n + kBlockSize - 1) / kBlockSize;
+        detail::parallelFor(blockEnd - blockBegin, 1, [&](size_t begin, size_t end) {
+            glm::vec3 blockPoints[kBlockSize];
+            float blockValues[kBlockSize];
+            for (size_t b = blockBegin + begin; b < blockBegin + end; ++b) {
+                // Always the whole block, so its batches do not depend on
+                // the chunk size either
+                const size_t base = b * kBlockSize;
+                sampler.block(base, std::min(kBlockSize, count - base), blockPoints, blockValues);
+                const size_t lo = std::max(base, first) - base;
+                const size_t hi = std::min(base + kBlockSize, first + n) - base;
+                std::copy(blockPoints + lo, blockPoints + hi, points.begin() + (base + lo - first));
+                std::copy(blockValues + lo, blockValues + hi, values.begin() + (base + lo - first));
+            }
+        });
+        sink(first, points.data(), values.data(), n);
+    }
+}
+
+void generateSamplesToFile(
+    const Handle& sdf,
+    size_t count,
+    const SamplerOptions& options,
+    const std::string& path,
+    float time,
+    uint32_t seed
+) {
+    checkOptions(options);
+    std::ofstream out(path, std::ios::binary);
+    if (!out) {
+        throw std::runtime_error("Cannot open file for writing: " + path);
+    }
+
+    std::vector<float> records;
+    generateSamples(sdf, count, options, [&](size_t, const glm::vec3* points, const float* values, size_t n) {
+        records.resize(n * 4);
+        for (size_t k = 0; k < n; ++k) {
+            records[4 * k + 0] = points[k].x;
+            records[4 * k + 1] = points[k].y;
+            records[4 * k + 2] = points[k].z;
+            records[4 * k + 3] = values[k];
+        }
+        out.write(reinterpret_cast<const char*>(records.data()), static_cast<std::streamsize>(records.size() * sizeof(float)));
+        if (!out) {
+            throw std::runtime_error("Failed to write samples: " + path);
+        }
+    }, time, seed);
+
+    // Flush on close, so a failed final write is reported too
+    out.close();
+    if (!out) {
+        throw std::runtime_error("Failed to write samples: " + path);
+    }
+}
+
+} // namespace sdf
@@ -1,8 +1,18 @@
 #include "sdf/sdf.hpp"
+#include "sdf/stats.hpp"
+#include "error_bound.hpp"
+#include "gradient.hpp"
+#include "lod.hpp"
+#include "parallel.hpp"
+#include "soa.hpp"
+#include "stats_scope.hpp"
 
 #include <stdexcept>
 #include <unordered_map>
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <sstream>
 
 // Include all SDF headers
 // Geometry
@@ -84,130 +94,569 @@
 
 namespace sdf {
 
-// Type alias for SDF function pointer
-using SDFFunc = float(*)(const glm::vec3&, float, uint32_t);
+// Registry entry: evaluation function plus the metadata exposed through Handle
+struct RegistryEntry {
+    SDFFunc func;
+    const char* category;
+    bool animated;
+    Bounds bounds;
+};
+
+// Bounding box plus a sphere of the given radius around its center. The
+// registry's volumes were found by sampling each SDF with a conservative
+// octree over [-4, 4]^3 (and over the animation period for animated SDFs),
+// then padded by 0.02 and rounded outward. Cheese's is the union of the
+// depth-9 octree's leaves that are not proven outside, rounded outward;
+// those leaves cover the shape wherever its SDF is conservative.
+static Bounds box(const glm::vec3& low, const glm::vec3& high, float radius) {
+    Bounds bounds;
+    bounds.boxLow = low;
+    bounds.boxHigh = high;
+    bounds.center = 0.5f * (low + high);
+    bounds.radius = radius;
+    bounds.bounded = true;
+    return bounds;
+}
+
+// For SDFs whose surface reaches infinity
+static const Bounds kUnbounded;
 
 // Registry of all available SDFs
-static const std::unordered_map<std::string, SDFFunc> g_registry = {
+static const std::unordered_map<std::string, RegistryEntry> g_registry = {
     // Geometry
-    {"Sphere", geometry::Sphere},
-    {"Cube", geometry::Cube},
-    {"Torus", geometry::Torus},
-    {"Capsule", geometry::Capsule},
-    {"Cylinder", geometry::Cylinder},
-    {"Cone", geometry::Cone},
-    {"Roundbox", geometry::Roundbox},
-    {"Hexprism", geometry::Hexprism},
-    {"Octahedron", geometry::Octahedron},
-    {"Octabound", geometry::Octabound},
-    {"Pyramid", geometry::Pyramid},
-    {"Tetrahedron", geometry::Tetrahedron},
-    {"Icosahedron", geometry::Icosahedron},
-    {"Dodecahedron", geometry::Dodecahedron},
-    {"Triprismbound", geometry::Triprismbound},
-    {"Triangle", geometry::Triangle},
-    {"Bezier", geometry::Bezier},
-    {"Trefoil", geometry::Trefoil},
-    {"Helix", geometry::Helix},
+    {"Sphere", {geometry::Sphere, "Geometry", false,
+        box({-0.56f, -0.56f, -0.56f}, {0.56f, 0.56f, 0.56f}, 0.58f)}},
+    {"Cube", {geometry::Cube, "Geometry", false,
+        box({-0.56f, -0.56f, -0.56f}, {0.56f, 0.56f, 0.56f}, 0.95f)}},
+    {"Torus", {geometry::Torus, "Geometry", false,
+        box({-0.65f, -0.65f, -0.24f}, {0.65f, 0.65f, 0.24f}, 0.67f)}},
+    {"Capsule", {geometry::Capsule, "Geometry", false,
+        box({-0.56f, -1.06f, -0.56f}, {0.56f, 1.06f, 0.56f}, 1.06f)}},
+    {"Cylinder", {geometry::Cylinder, "Geometry", false,
+        box({-1.06f, -1.06f, -1.06f}, {1.06f, 1.06f, 1.06f}, 1.49f)}},
+    {"Cone", {geometry::Cone, "Geometry", false,
+        box({-1.06f, -1.06f, -1.06f}, {1.06f, 1.06f, 1.06f}, 1.50f)}},
+    {"Roundbox", {geometry::Roundbox, "Geometry", false,
+        box({-0.71f, -0.71f, -0.71f}, {0.71f, 0.71f, 0.71f}, 1.02f)}},
+    {"Hexprism", {geometry::Hexprism, "Geometry", false,
+        box({-0.62f, -0.56f, -0.56f}, {0.62f, 0.56f, 0.56f}, 0.84f)}},
+    {"Octahedron", {geometry::Octahedron, "Geometry", false,
+        box({-0.56f, -0.56f, -0.56f}, {0.56f, 0.56f, 0.56f}, 0.56f)}},
+    {"Octabound", {geometry::Octabound, "Geometry", false,
+        box({-0.56f, -0.56f, -0.56f}, {0.56f, 0.56f, 0.56f}, 0.56f)}},
+    {"Pyramid", {geometry::Pyramid, "Geometry", false,
+        box({-1.06f, -1.06f, -1.06f}, {1.06f, 1.06f, 1.06f}, 1.81f)}},
+    {"Tetrahedron", {geometry::Tetrahedron, "Geometry", false,
+        box({-0.93f, -1.06f, -0.56f}, {0.93f, 1.06f, 1.06f}, 1.60f)}},
+    {"Icosahedron", {geometry::Icosahedron, "Geometry", false,
+        box({-0.81f, -0.81f, -0.81f}, {0.81f, 0.81f, 0.81f}, 0.94f)}},
+    {"Dodecahedron", {geometry::Dodecahedron, "Geometry", false,
+        box({-0.87f, -0.87f, -0.87f}, {0.87f, 0.87f, 0.87f}, 0.95f)}},
+    {"Triprismbound", {geometry::Triprismbound, "Geometry", false,
+        box({-0.49f, -0.31f, -0.56f}, {0.49f, 0.56f, 0.56f}, 0.84f)}},
+    {"Triangle", {geometry::Triangle, "Geometry", false,
+        box({-1.06f, -1.06f, -0.06f}, {1.06f, 1.06f, 0.06f}, 1.48f)}},
+    {"Bezier", {geometry::Bezier, "Geometry", false,
+        box({-0.81f, -0.71f, -0.06f}, {0.21f, 0.81f, 0.06f}, 0.91f)}},
+    {"Trefoil", {geometry::Trefoil, "Geometry", false,
+        box({-0.81f, -0.93f, -0.31f}, {0.96f, 0.93f, 0.31f}, 1.02f)}},
+    {"Helix", {geometry::Helix, "Geometry", false,
+        box({-0.40f, -1.24f, -0.40f}, {0.40f, 1.24f, 0.40f}, 1.31f)}},
     
     // Fractal
-    {"Mandelbulb", fractal::Mandelbulb},
-    {"Menger", fractal::Menger},
-    {"Serpinski", fractal::Serpinski},
-    {"Julia", fractal::Julia},
+    {"Mandelbulb", {fractal::Mandelbulb, "Fractal", false,
+        box({-0.71f, -0.71f, -0.74f}, {0.71f, 0.71f, 0.68f}, 0.78f)}},
+    {"MandelbulbPolynomial", {fractal::MandelbulbPolynomial, "Fractal", false,
+        box({-0.71f, -0.71f, -0.74f}, {0.71f, 0.71f, 0.68f}, 0.78f)}},
+    {"Menger", {fractal::Menger, "Fractal", false,
+        box({-1.06f, -1.06f, -1.06f}, {1.06f, 1.06f, 1.06f}, 1.81f)}},
+    {"Serpinski", {fractal::Serpinski, "Fractal", false,
+        box({-0.84f, -0.84f, -0.84f}, {0.84f, 0.84f, 0.84f}, 1.43f)}},
+    {"Julia", {fractal::Julia, "Fractal", false,
+        box({-1.02f, -0.59f, -0.68f}, {1.02f, 0.93f, 0.96f}, 1.25f)}},
     
     // Animal
-    {"Fish", animal::Fish},
-    {"Dinosaur", animal::Dinosaur},
-    {"Tardigrade", animal::Tardigrade},
-    {"Jellyfish", animal::Jellyfish},
-    {"MantaRay", animal::MantaRay},
-    {"Snake", animal::Snake},
-    {"Snail", animal::Snail},
-    {"Elephant", animal::Elephant},
-    {"PixarMike", animal::PixarMike},
-    {"HumanSkull", animal::HumanSkull},
-    {"HumanHead", animal::HumanHead},
-    {"Girl", animal::Girl},
+    {"Fish", {animal::Fish, "Animal", true,
+        box({-0.34f, -0.96f, -1.40f}, {0.34f, 1.02f, 1.84f}, 1.67f)}},
+    {"Dinosaur", {animal::Dinosaur, "Animal", false,
+        box({-0.43f, -0.49f, -0.93f}, {0.34f, 0.68f, 0.81f}, 1.00f)}},
+    {"Tardigrade", {animal::Tardigrade, "Animal", false,
+        box({-0.43f, -0.62f, -0.74f}, {0.43f, 0.34f, 0.62f}, 0.75f)}},
+    {"Jellyfish", {animal::Jellyfish, "Animal", true,
+        kUnbounded}},
+    {"MantaRay", {animal::MantaRay, "Animal", true,
+        kUnbounded}},
+    {"Snake", {animal::Snake, "Animal", true,
+        kUnbounded}},
+    {"Snail", {animal::Snail, "Animal", true,
+        box({-1.09f, -1.27f, -0.46f}, {0.52f, 1.27f, 0.40f}, 1.31f)}},
+    {"Elephant", {animal::Elephant, "Animal", false,
+        box({-0.40f, -0.46f, -0.68f}, {0.40f, 0.59f, 0.68f}, 0.71f)}},
+    {"PixarMike", {animal::PixarMike, "Animal", false,
+        box({-0.49f, -0.59f, -0.43f}, {0.49f, 0.90f, 0.40f}, 0.84f)}},
+    {"HumanSkull", {animal::HumanSkull, "Animal", false,
+        box({-0.87f, -0.49f, -0.71f}, {0.87f, 0.71f, 0.71f}, 0.98f)}},
+    {"HumanHead", {animal::HumanHead, "Animal", false,
+        box({-0.49f, -0.59f, -0.59f}, {0.49f, 0.68f, 0.65f}, 0.77f)}},
+    {"Girl", {animal::Girl, "Animal", true,
+        box({-0.93f, -0.87f, -0.77f}, {0.93f, 0.93f, 0.71f}, 1.29f)}},
     
     // Nature
-    {"Rock", nature::Rock},
-    {"Mountain", nature::Mountain},
-    {"Mushroom", nature::Mushroom},
-    {"Tree", nature::Tree},
+    {"Rock", {nature::Rock, "Nature", false,
+        box({-0.84f, -0.84f, -0.84f}, {0.62f, 0.84f, 0.74f}, 0.94f)}},
+    {"Mountain", {nature::Mountain, "Nature", false,
+        box({-0.56f, -0.56f, -0.56f}, {0.56f, 0.56f, 0.56f}, 0.95f)}},
+    {"Mushroom", {nature::Mushroom, "Nature", false,
+        box({-0.65f, -0.87f, -0.52f}, {0.87f, 0.96f, 0.52f}, 1.04f)}},
+    {"Tree", {nature::Tree, "Nature", true,
+        box({-0.90f, -0.71f, -0.71f}, {0.84f, 1.02f, 0.96f}, 0.97f)}},
     
     // Manufactured
-    {"Teapot", manufactured::Teapot},
-    {"Gear", manufactured::Gear},
-    {"Chain", manufactured::Chain},
-    {"Mobius", manufactured::Mobius},
-    {"Spike", manufactured::Spike},
-    {"Vase", manufactured::Vase},
-    {"Knob", manufactured::Knob},
-    {"Key", manufactured::Key},
-    {"Castle", manufactured::Castle},
-    {"Temple", manufactured::Temple},
-    {"Rooks", manufactured::Rooks},
-    {"Cables", manufactured::Cables},
-    {"Mech", manufactured::Mech},
-    {"UprightPiano", manufactured::UprightPiano},
-    {"GrandPiano", manufactured::GrandPiano},
+    {"Teapot", {manufactured::Teapot, "Manufactured", false,
+        box({-0.52f, -0.40f, -0.74f}, {0.52f, 0.59f, 0.84f}, 0.81f)}},
+    {"Gear", {manufactured::Gear, "Manufactured", false,
+        box({-0.90f, -0.90f, -0.12f}, {0.90f, 0.90f, 1.06f}, 1.06f)}},
+    {"Chain", {manufactured::Chain, "Manufactured", false,
+        box({-0.90f, -0.84f, -0.18f}, {0.84f, 0.93f, 0.18f}, 0.92f)}},
+    {"Mobius", {manufactured::Mobius, "Manufactured", false,
+        kUnbounded}},
+    {"Spike", {manufactured::Spike, "Manufactured", false,
+        box({-0.99f, -0.99f, -0.99f}, {0.99f, 0.99f, 0.99f}, 1.07f)}},
+    {"Vase", {manufactured::Vase, "Manufactured", false,
+        box({-0.52f, -0.84f, -0.52f}, {0.52f, 0.81f, 0.52f}, 0.91f)}},
+    {"Knob", {manufactured::Knob, "Manufactured", false,
+        box({-0.84f, -0.84f, -0.84f}, {0.84f, 0.84f, 0.84f}, 0.88f)}},
+    {"Key", {manufactured::Key, "Manufactured", false,
+        box({-0.31f, -0.71f, -0.15f}, {0.31f, 0.74f, 0.15f}, 0.75f)}},
+    {"Castle", {manufactured::Castle, "Manufactured", true,
+        box({-1.02f, -1.09f, -1.09f}, {1.02f, 0.71f, 1.02f}, 1.15f)}},
+    {"Temple", {manufactured::Temple, "Manufactured", false,
+        box({-0.84f, -0.62f, -1.02f}, {0.84f, 0.43f, 0.99f}, 1.33f)}},
+    {"Rooks", {manufactured::Rooks, "Manufactured", false,
+        box({-0.84f, -0.46f, -0.84f}, {0.84f, 0.37f, 0.84f}, 1.10f)}},
+    {"Cables", {manufactured::Cables, "Manufactured", true,
+        box({-1.02f, -0.65f, -0.96f}, {1.02f, 0.84f, 0.84f}, 1.09f)}},
+    {"Mech", {manufactured::Mech, "Manufactured", true,
+        box({-0.96f, -0.96f, -0.90f}, {0.71f, 0.84f, 1.15f}, 1.28f)}},
+    {"UprightPiano", {manufactured::UprightPiano, "Manufactured", false,
+        box({-0.81f, -0.62f, -0.56f}, {0.81f, 0.34f, 0.56f}, 1.07f)}},
+    {"GrandPiano", {manufactured::GrandPiano, "Manufactured", false,
+        box({-0.59f, -0.65f, -0.84f}, {0.74f, 0.28f, 0.71f}, 1.05f)}},
     
     // Vehicle
-    {"Cybertruck", vehicle::Cybertruck},
-    {"TieFighter", vehicle::TieFighter},
-    {"Boat", vehicle::Boat},
-    {"Jetfighter", vehicle::Jetfighter},
-    {"Oldcar", vehicle::Oldcar},
-    {"Lamborghini", vehicle::Lamborghini},
+    {"Cybertruck", {vehicle::Cybertruck, "Vehicle", false,
+        box({-0.40f, -0.24f, -0.84f}, {0.40f, 0.37f, 0.84f}, 0.90f)}},
+    {"TieFighter", {vehicle::TieFighter, "Vehicle", false,
+        box({-0.62f, -0.87f, -0.71f}, {0.62f, 0.87f, 0.71f}, 1.11f)}},
+    {"Boat", {vehicle::Boat, "Vehicle", false,
+        box({-0.24f, -0.65f, -0.84f}, {0.24f, -0.26f, 0.74f}, 0.82f)}},
+    {"Jetfighter", {vehicle::Jetfighter, "Vehicle", false,
+        box({-0.93f, -0.18f, -1.56f}, {0.93f, 0.28f, 0.49f}, 1.15f)}},
+    {"Oldcar", {vehicle::Oldcar, "Vehicle", false,
+        box({-0.49f, -0.43f, -0.99f}, {0.49f, 0.34f, 0.93f}, 1.05f)}},
+    {"Lamborghini", {vehicle::Lamborghini, "Vehicle", false,
+        box({-0.40f, -0.90f, -0.71f}, {0.40f, 0.37f, 0.68f}, 0.81f)}},
     
     // Misc
-    {"Burger", misc::Burger},
-    {"Cheese", misc::Cheese},
-    {"Dalek", misc::Dalek},
+    {"Burger", {misc::Burger, "Misc", false,
+        box({-0.93f, -0.52f, -0.93f}, {0.93f, 0.46f, 0.93f}, 1.00f)}},
+    {"Cheese", {misc::Cheese, "Misc", false,
+        box({-0.72f, -0.30f, -0.47f}, {0.57f, 0.19f, 0.54f}, 0.82f)}},
+    {"Dalek", {misc::Dalek, "Misc", false,
+        box({-0.52f, -0.87f, -0.74f}, {0.52f, 0.71f, 0.52f}, 1.00f)}},
 };
 
-std::vector<float> evaluate(
-    const std::string& name,
-    const std::vector<glm::vec3>& points,
-    float time,
-    uint32_t seed
-) {
+Handle resolve(const std::string& name) {
     auto it = g_registry.find(name);
     if (it == g_registry.end()) {
         throw std::runtime_error("Unknown SDF: " + name);
     }
     
-    SDFFunc func = it->second;
-    std::vector<float> results;
-    results.reserve(points.size());
-    
-    for (const auto& p : points) {
-        results.push_back(func(p, time, seed));
+    Handle handle;
+    handle.func = it->second.func;
+    handle.soa = simd::findKernel(it->first.c_str());
+    handle.grad = detail::findGradient(it->first.c_str());
+    handle.lod = detail::findLOD(it->first.c_str());
+    handle.name = it->first.c_str();
+    handle.category = it->second.category;
+    handle.animated = it->second.animated;
+    handle.bounds = it->second.bounds;
+#if defined(SDF_FAST_MATH)
+    handle.errorBound = detail::fastMathErrorBound(handle.name);
+    if (handle.errorBound > 0.0f && getFastMathMode() == FastMathMode::Conservative) {
+        handle.func = detail::conservativeFunc(handle.name, handle.func, handle.errorBound);
+        if (handle.lod) {
+            handle.lod = detail::findConservativeLOD(handle.name);
+        }
+    }
+#endif
+    return handle;
+}
+
+static std::atomic<FastMathMode> g_fastMathMode{FastMathMode::Conservative};
+
+bool isFastMath() {
+#if defined(SDF_FAST_MATH)
+    return true;
+#else
+    return false;
+#endif
+}
+
+void setFastMathMode(FastMathMode mode) {
+    g_fastMathMode.store(mode);
+}
+
+FastMathMode getFastMathMode() {
+    return g_fastMathMode.load();
+}
+
+// ============================================================================
+// Evaluation statistics (sdf/stats.hpp)
+// ============================================================================
+
+#if defined(SDF_STATS)
+
+// Counters for one registry entry. Padded to a cache line so threads
+// evaluating different SDFs do not contend.
+struct alignas(64) ShapeCounters {
+    std::atomic<uint64_t> calls{0};
+    std::atomic<uint64_t> points{0};
+    std::atomic<uint64_t> nanoseconds{0};
+    std::atomic<uint64_t> batchSizes[kBatchSizeBuckets] = {};
+    std::atomic<uint64_t> siteCalls[kStatsSites] = {};
+    std::atomic<uint64_t> sitePoints[kStatsSites] = {};
+};
+
+// One entry per registered SDF, keyed by the registry's name pointer (which
+// Handle::name points to). Built once and never modified afterwards, so
+// lookups are safe from any thread.
+static std::unordered_map<const char*, ShapeCounters>& counters() {
+    static std::unordered_map<const char*, ShapeCounters> table = [] {
+        std::unordered_map<const char*, ShapeCounters> t;
+        for (const auto& [name, entry] : g_registry) {
+            t.try_emplace(name.c_str());
+        }
+        return t;
+    }();
+    return table;
+}
+
+static size_t batchSizeBucket(size_t count) {
+    size_t bucket = 0;
+    while (count > 1 && bucket + 1 < kBatchSizeBuckets) {
+        count >>= 1;
+        ++bucket;
+    }
+    return bucket;
+}
+
+namespace detail {
+
+StatsScope::~StatsScope() {
+    const auto elapsed = std::chrono::steady_clock::now() - start_;
+    auto it = counters().find(name_);
+    if (it == counters().end()) return;
+
+    ShapeCounters& c = it->second;
+    const size_t site = static_cast<size_t>(site_);
+    c.calls.fetch_add(1, std::memory_order_relaxed);
+    c.points.fetch_add(count_, std::memory_order_relaxed);
+    c.nanoseconds.fetch_add(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count(),
+        std::memory_order_relaxed);
+    c.batchSizes[batchSizeBucket(count_)].fetch_add(1, std::memory_order_relaxed);
+    c.siteCalls[site].fetch_add(1, std::memory_order_relaxed);
+    c.sitePoints[site].fetch_add(count_, std::memory_order_relaxed);
+}
+
+float evaluateRecorded(const Handle& sdf, const glm::vec3& point, float time, uint32_t seed) {
+    StatsScope scope(sdf, 1);
+    return sdf.func(point, time, seed);
+}
+
+} // namespace detail
+
+#endif
+
+Stats stats() {
+    Stats snapshot;
+#if defined(SDF_STATS)
+    snapshot.enabled = true;
+    for (const auto& [name, c] : counters()) {
+        ShapeStats shape;
+        shape.name = name;
+        shape.calls = c.calls.load(std::memory_order_relaxed);
+        if (shape.calls == 0) continue;
+
+        shape.points = c.points.load(std::memory_order_relaxed);
+        shape.nanoseconds = c.nanoseconds.load(std::memory_order_relaxed);
+        for (size_t b = 0; b < kBatchSizeBuckets; ++b) {
+            shape.batchSizes[b] = c.batchSizes[b].load(std::memory_order_relaxed);
+        }
+        for (size_t i = 0; i < kStatsSites; ++i) {
+            shape.sites[i].calls = c.siteCalls[i].load(std::memory_order_relaxed);
+            shape.sites[i].points = c.sitePoints[i].load(std::memory_order_relaxed);
+        }
+        snapshot.shapes.push_back(std::move(shape));
+    }
+    std::sort(snapshot.shapes.begin(), snapshot.shapes.end(),
+              [](const ShapeStats& a, const ShapeStats& b) { return a.name < b.name; });
+#endif
+    return snapshot;
+}
+
+void resetStats() {
+#if defined(SDF_STATS)
+    for (auto& [name, c] : counters()) {
+        c.calls.store(0, std::memory_order_relaxed);
+        c.points.store(0, std::memory_order_relaxed);
+        c.nanoseconds.store(0, std::memory_order_relaxed);
+        for (auto& bucket : c.batchSizes) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+        for (size_t i = 0; i < kStatsSites; ++i) {
+            c.siteCalls[i].store(0, std::memory_order_relaxed);
+            c.sitePoints[i].store(0, std::memory_order_relaxed);
+        }
+    }
+#endif
+}
+
+// JSON keys of the StatsSite values
+static const char* const kSiteNames[kStatsSites] = {"evaluate", "frame", "gradient", "lod"};
+
+std::string Stats::toJson() const {
+    // Registry names are plain identifiers and need no escaping
+    std::ostringstream out;
+    out << "{\n"
+        << "  \"enabled\": " << (enabled ? "true" : "false") << ",\n"
+        << "  \"shapes\": [\n";
+    for (size_t i = 0; i < shapes.size(); ++i) {
+        const ShapeStats& s = shapes[i];
+        out << "    {\"name\": \"" << s.name << "\""
+            << ", \"calls\": " << s.calls
+            << ", \"points\": " << s.points
+            << ", \"nanoseconds\": " << s.nanoseconds
+            << ", \"batchSizes\": [";
+        for (size_t b = 0; b < kBatchSizeBuckets; ++b) {
+            out << (b ? ", " : "") << s.batchSizes[b];
+        }
+        out << "], \"sites\": {";
+        for (size_t site = 0; site < kStatsSites; ++site) {
+            out << (site ? ", " : "") << "\"" << kSiteNames[site] << "\": {\"calls\": " << s.sites[site].calls
+                << ", \"points\": " << s.sites[site].points << "}";
+        }
+        out << "}}" << (i + 1 < shapes.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n"
+        << "}\n";
+    return out.str();
+}
+
+// ============================================================================
+// Batch evaluation
+// ============================================================================
+
+// Uninstrumented loops shared by the serial and parallel entry points, so a
+// parallel call is recorded once rather than once per chunk
+
+static void evaluateStrided(
+    const Handle& sdf,
+    const float* positions,
+    size_t stride,
+    float* out,
+    size_t count,
+    float time,
+    uint32_t seed
+) {
+    SDFFunc func = sdf.func;
+    for (size_t i = 0; i < count; ++i) {
+        const float* p = positions + i * stride;
+        out[i] = func(glm::vec3(p[0], p[1], p[2]), time, seed);
+    }
+}
+
+static void evaluatePoints(
+    const Handle& sdf,
+    const glm::vec3* points,
+    float* out,
+    size_t count,
+    float time,
+    uint32_t seed
+) {
+    SDFFunc func = sdf.func;
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = func(points[i], time, seed);
+    }
+}
+
+static void evaluateSoA(
+    const Handle& sdf,
+    const float* x,
+    const float* y,
+    const float* z,
+    float* out,
+    size_t count,
+    float time,
+    uint32_t seed
+) {
+    if (sdf.soa) {
+        sdf.soa(x, y, z, out, count, time, seed);
+        return;
     }
     
+    SDFFunc func = sdf.func;
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = func(glm::vec3(x[i], y[i], z[i]), time, seed);
+    }
+}
+
+void evaluate(
+    const Handle& sdf,
+    const float* positions,
+    size_t stride,
+    float* out,
+    size_t count,
+    float time,
+    uint32_t seed
+) {
+    detail::StatsScope scope(sdf, count);
+    evaluateStrided(sdf, positions, stride, out, count, time, seed);
+}
+
+void evaluate(
+    const Handle& sdf,
+    const glm::vec3* points,
+    float* out,
+    size_t count,
+    float time,
+    uint32_t seed
+) {
+    detail::StatsScope scope(sdf, count);
+    evaluatePoints(sdf, points, out, count, time, seed);
+}
+
+void evaluate(
+    const Handle& sdf,
+    const float* x,
+    const float* y,
+    const float* z,
+    float* out,
+    size_t count,
+    float time,
+    uint32_t seed
+) {
+    detail::StatsScope scope(sdf, count);
+    evaluateSoA(sdf, x, y, z, out, count, time, seed);
+}
+
+const char* getSIMDTarget() {
+    return simd::activeTarget();
+}
+
+std::vector<float> evaluate(
+    const Handle& sdf,
+    const std::vector<glm::vec3>& points,
+    float time,
+    uint32_t seed
+) {
+    std::vector<float> results(points.size());
+    evaluate(sdf, points.data(), results.data(), points.size(), time, seed);
     return results;
 }
 
+// Points per work chunk for the parallel paths. Small enough that expensive
+// shapes still balance across threads, large enough to amortize scheduling.
+static constexpr size_t kParallelGrain = 1024;
+
+void setThreadCount(unsigned count) {
+    detail::ThreadPool::instance().setThreadCount(count);
+}
+
+unsigned getThreadCount() {
+    return detail::ThreadPool::instance().threadCount();
+}
+
+void evaluateParallel(
+    const Handle& sdf,
+    const glm::vec3* points,
+    float* out,
+    size_t count,
+    float time,
+    uint32_t seed
+) {
+    detail::StatsScope scope(sdf, count);
+    detail::parallelFor(count, kParallelGrain, [&](size_t begin, size_t end) {
+        evaluatePoints(sdf, points + begin, out + begin, end - begin, time, seed);
+    });
+}
+
+void evaluateParallel(
+    const Handle& sdf,
+    const float* positions,
+    size_t stride,
+    float* out,
+    size_t count,
+    float time,
+    uint32_t seed
+) {
+    detail::StatsScope scope(sdf, count);
+    detail::parallelFor(count, kParallelGrain, [&](size_t begin, size_t end) {
+        evaluateStrided(sdf, positions + begin * stride, stride, out + begin, end - begin, time, seed);
+    });
+}
+
+void evaluateParallel(
+    const Handle& sdf,
+    const float* x,
+    const float* y,
+    const float* z,
+    float* out,
+    size_t count,
+    float time,
+    uint32_t seed
+) {
+    detail::StatsScope scope(sdf, count);
+    detail::parallelFor(count, kParallelGrain, [&](size_t begin, size_t end) {
+        evaluateSoA(sdf, x + begin, y + begin, z + begin, out + begin, end - begin, time, seed);
+    });
+}
+
+std::vector<float> evaluateParallel(
+    const Handle& sdf,
+    const std::vector<glm::vec3>& points,
+    float time,
+    uint32_t seed
+) {
+    std::vector<float> results(points.size());
+    evaluateParallel(sdf, points.data(), results.data(), points.size(), time, seed);
+    return results;
+}
+
+std::vector<float> evaluate(
+    const std::string& name,
+    const std::vector<glm::vec3>& points,
+    float time,
+    uint32_t seed
+) {
+    return evaluate(resolve(name), points, time, seed);
+}
+
 float evaluate(
     const std::string& name,
     const glm::vec3& point,
     float time,
     uint32_t seed
 ) {
-    auto it = g_registry.find(name);
-    if (it == g_registry.end()) {
-        throw std::runtime_error("Unknown SDF: " + name);
-    }
-    
-    return it->second(point, time, seed);
+    return evaluate(resolve(name), point, time, seed);
 }
 
 std::vector<std::string> getAvailableSDFs() {
     std::vector<std::string> names;
     names.reserve(g_registry.size());
     
-    for (const auto& [name, func] : g_registry) {
+    for (const auto& [name, entry] : g_registry) {
         names.push_back(name);
     }
     
@@ -0,0 +1,15 @@
+#pragma once
+
+// Internal constant shared by the conservative distance tests of the grid,
+// octree, mesh, baked grid and brickmap builders.
+
+namespace sdf::detail {
+
+/// Relative slack on a radius or error term compared against a distance.
+/// Float rounding in the node, center and cell positions (or in the baked
+/// interpolation) can shrink the computed term by a few ulps; scaling it by
+/// this factor keeps those tests from skipping, pruning or dropping a region
+/// the surface may still cross, or from returning a value above its bound.
+constexpr float kRoundingSlack = 1.0001f;
+
+} // namespace sdf::detail
@@ -0,0 +1,55 @@
+#include "soa.hpp"
+
+namespace sdf::simd {
+
+namespace {
+
+enum class Target { None, Generic, AVX2, AVX512 };
+
+Target detectTarget() {
+#if !defined(SDF_SIMD_KERNELS)
+    return Target::None;
+#else
+    // The AVX kernels rely on run() flattening the shape code into itself;
+    // unoptimized builds do not inline, and out-of-line shape code would pass
+    // packs between baseline and AVX functions, which use different calling
+    // conventions for them.
+#if defined(SDF_SIMD_X86) && defined(__OPTIMIZE__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return Target::AVX512;
+    if (__builtin_cpu_supports("avx2")) return Target::AVX2;
+#endif
+    return Target::Generic;
+#endif
+}
+
+Target activeTargetEnum() {
+    static const Target target = detectTarget();
+    return target;
+}
+
+} // namespace
+
+SoAFunc findKernel(const char* name) {
+    switch (activeTargetEnum()) {
+#if defined(SDF_SIMD_X86)
+        case Target::AVX512: return avx512::findKernel(name);
+        case Target::AVX2: return avx2::findKernel(name);
+#endif
+#if defined(SDF_SIMD_KERNELS)
+        case Target::Generic: return generic::findKernel(name);
+#endif
+        default: return nullptr;
+    }
+}
+
+const char* activeTarget() {
+    switch (activeTargetEnum()) {
+        case Target::AVX512: return "avx512";
+        case Target::AVX2: return "avx2";
+        case Target::Generic: return "generic";
+        default: return "none";
+    }
+}
+
+} // namespace sdf::simd
@@ -0,0 +1,25 @@
+#pragma once
+
+// Internal dispatch for the structure-of-arrays SIMD kernels.
+//
+// soa_kernels.hpp is compiled into one namespace per instruction set; this
+// header declares the per-target lookup functions and the runtime dispatcher
+// that picks the widest one the CPU supports.
+
+#include "sdf/sdf.hpp"
+
+namespace sdf::simd {
+
+namespace generic { SoAFunc findKernel(const char* name); }
+namespace avx2 { SoAFunc findKernel(const char* name); }
+namespace avx512 { SoAFunc findKernel(const char* name); }
+
+/// SIMD kernel for the named SDF on the best instruction set available at
+/// runtime, or nullptr if the SDF has no SIMD kernel.
+SoAFunc findKernel(const char* name);
+
+/// Name of the instruction set findKernel() dispatches to
+/// ("avx512", "avx2", "generic" or "none").
+const char* activeTarget();
+
+} // namespace sdf::simd
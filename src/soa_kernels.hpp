@@ -0,0 +1,212 @@
+#pragma once
+
+// Structure-of-arrays SIMD kernels.
+//
+// Each kernel instantiates a scalar-generic shape from include/sdf/ with
+// V = Vec3<Pack<W>>. The pack performs the same floating-point operations in
+// the same order as the float instantiation, so results match the scalar SDFs
+// (the library is built with -ffp-contract=off so that neither side fuses
+// multiplies and adds on targets with FMA).
+//
+// Included once per instruction set by soa_kernels_*.cpp, which define
+// SDF_SIMD_TARGET (namespace name) and SDF_SIMD_WIDTH (lanes per pack), and
+// for instruction sets beyond the build's baseline SDF_SIMD_ISA (target
+// attribute). The files are compiled without -m flags: run() carries the
+// target and flattens the whole kernel into itself, so the shape code and
+// the shared inline helpers it calls are compiled for that target only as
+// part of run(), and their out-of-line copies stay baseline code.
+// Unoptimized builds do not flatten, so soa.cpp only dispatches to these
+// targets when __OPTIMIZE__ is defined.
+// The shapes set up a few constants with float helpers from common.hpp; those
+// run once per call and are inlined in optimized builds.
+
+#ifndef SDF_SIMD_WIDTH
+#error "Define SDF_SIMD_WIDTH before including soa_kernels.hpp"
+#endif
+#ifndef SDF_SIMD_TARGET
+#error "Define SDF_SIMD_TARGET before including soa_kernels.hpp"
+#endif
+
+#include "sdf/pack.hpp"
+#include "soa.hpp"
+
+#include "sdf/Geometry/Bezier.hpp"
+#include "sdf/Geometry/Capsule.hpp"
+#include "sdf/Geometry/Cone.hpp"
+#include "sdf/Geometry/Cube.hpp"
+#include "sdf/Geometry/Cylinder.hpp"
+#include "sdf/Geometry/Dodecahedron.hpp"
+#include "sdf/Geometry/Helix.hpp"
+#include "sdf/Geometry/Hexprism.hpp"
+#include "sdf/Geometry/Icosahedron.hpp"
+#include "sdf/Geometry/Octabound.hpp"
+#include "sdf/Geometry/Octahedron.hpp"
+#include "sdf/Geometry/Pyramid.hpp"
+#include "sdf/Geometry/Roundbox.hpp"
+#include "sdf/Geometry/Sphere.hpp"
+#include "sdf/Geometry/Tetrahedron.hpp"
+#include "sdf/Geometry/Torus.hpp"
+#include "sdf/Geometry/Trefoil.hpp"
+#include "sdf/Geometry/Triangle.hpp"
+#include "sdf/Geometry/Triprismbound.hpp"
+#include "sdf/Fractal/Julia.hpp"
+#include "sdf/Fractal/Mandelbulb.hpp"
+#include "sdf/Fractal/Menger.hpp"
+#include "sdf/Fractal/Serpinski.hpp"
+#include "sdf/Animal/Dinosaur.hpp"
+#include "sdf/Animal/Elephant.hpp"
+#include "sdf/Animal/Fish.hpp"
+#include "sdf/Animal/Girl.hpp"
+#include "sdf/Animal/HumanHead.hpp"
+#include "sdf/Animal/HumanSkull.hpp"
+#include "sdf/Animal/Jellyfish.hpp"
+#include "sdf/Animal/MantaRay.hpp"
+#include "sdf/Animal/PixarMike.hpp"
+#include "sdf/Animal/Snail.hpp"
+#include "sdf/Animal/Snake.hpp"
+#include "sdf/Animal/Tardigrade.hpp"
+#include "sdf/Nature/Mountain.hpp"
+#include "sdf/Nature/Mushroom.hpp"
+#include "sdf/Nature/Rock.hpp"
+#include "sdf/Nature/Tree.hpp"
+#include "sdf/Manufactured/Cables.hpp"
+#include "sdf/Manufactured/Castle.hpp"
+#include "sdf/Manufactured/Chain.hpp"
+#include "sdf/Manufactured/Gear.hpp"
+#include "sdf/Manufactured/GrandPiano.hpp"
+#include "sdf/Manufactured/Key.hpp"
+#include "sdf/Manufactured/Knob.hpp"
+#include "sdf/Manufactured/Mech.hpp"
+#include "sdf/Manufactured/Mobius.hpp"
+#include "sdf/Manufactured/Rooks.hpp"
+#include "sdf/Manufactured/Spike.hpp"
+#include "sdf/Manufactured/Teapot.hpp"
+#include "sdf/Manufactured/Temple.hpp"
+#include "sdf/Manufactured/UprightPiano.hpp"
+#include "sdf/Manufactured/Vase.hpp"
+#include "sdf/Vehicle/Boat.hpp"
+#include "sdf/Vehicle/Cybertruck.hpp"
+#include "sdf/Vehicle/Jetfighter.hpp"
+#include "sdf/Vehicle/Lamborghini.hpp"
+#include "sdf/Vehicle/Oldcar.hpp"
+#include "sdf/Vehicle/TieFighter.hpp"
+#include "sdf/Misc/Burger.hpp"
+#include "sdf/Misc/Cheese.hpp"
+#include "sdf/Misc/Dalek.hpp"
+
+namespace sdf::simd::SDF_SIMD_TARGET {
+
+using P = Pack<SDF_SIMD_WIDTH>;
+using V3 = Vec3<P>;
+
+#ifdef SDF_SIMD_ISA
+#define SDF_SIMD_KERNEL __attribute__((target(SDF_SIMD_ISA), flatten))
+#else
+#define SDF_SIMD_KERNEL __attribute__((flatten))
+#endif
+
+// Runs a lane kernel over SoA arrays. The tail is padded by repeating the last
+// point so every lane holds a valid position.
+template <P (*Kernel)(const V3&, float, uint32_t)>
+SDF_SIMD_KERNEL void run(const float* x, const float* y, const float* z, float* out, size_t count,
+         float time, uint32_t seed) {
+    constexpr size_t W = SDF_SIMD_WIDTH;
+    size_t i = 0;
+    for (; i + W <= count; i += W) {
+        Kernel(V3(P::load(x + i), P::load(y + i), P::load(z + i)), time, seed).store(out + i);
+    }
+    if (i < count) {
+        float tx[W], ty[W], tz[W], tout[W];
+        for (size_t j = 0; j < W; ++j) {
+            size_t k = (i + j < count) ? i + j : count - 1;
+            tx[j] = x[k];
+            ty[j] = y[k];
+            tz[j] = z[k];
+        }
+        Kernel(V3(P::load(tx), P::load(ty), P::load(tz)), time, seed).store(tout);
+        for (size_t j = 0; i + j < count; ++j) {
+            out[i + j] = tout[j];
+        }
+    }
+}
+
+SoAFunc findKernel(const char* name) {
+    static const struct {
+        const char* name;
+        SoAFunc func;
+    } kernels[] = {
+        {"Sphere", run<geometry::Sphere<V3>>},
+        {"Cube", run<geometry::Cube<V3>>},
+        {"Torus", run<geometry::Torus<V3>>},
+        {"Capsule", run<geometry::Capsule<V3>>},
+        {"Cylinder", run<geometry::Cylinder<V3>>},
+        {"Cone", run<geometry::Cone<V3>>},
+        {"Roundbox", run<geometry::Roundbox<V3>>},
+        {"Hexprism", run<geometry::Hexprism<V3>>},
+        {"Octahedron", run<geometry::Octahedron<V3>>},
+        {"Octabound", run<geometry::Octabound<V3>>},
+        {"Pyramid", run<geometry::Pyramid<V3>>},
+        {"Tetrahedron", run<geometry::Tetrahedron<V3>>},
+        {"Icosahedron", run<geometry::Icosahedron<V3>>},
+        {"Dodecahedron", run<geometry::Dodecahedron<V3>>},
+        {"Triprismbound", run<geometry::Triprismbound<V3>>},
+        {"Triangle", run<geometry::Triangle<V3>>},
+        {"Bezier", run<geometry::Bezier<V3>>},
+        {"Trefoil", run<geometry::Trefoil<V3>>},
+        {"Helix", run<geometry::Helix<V3>>},
+        {"Mandelbulb", run<fractal::Mandelbulb<V3>>},
+        {"MandelbulbPolynomial", run<fractal::MandelbulbPolynomial<V3>>},
+        {"Menger", run<fractal::Menger<V3>>},
+        {"Serpinski", run<fractal::Serpinski<V3>>},
+        {"Julia", run<fractal::Julia<V3>>},
+        {"Fish", run<animal::Fish<V3>>},
+        {"Dinosaur", run<animal::Dinosaur<V3>>},
+        {"Tardigrade", run<animal::Tardigrade<V3>>},
+        {"Jellyfish", run<animal::Jellyfish<V3>>},
+        {"MantaRay", run<animal::MantaRay<V3>>},
+        {"Snake", run<animal::Snake<V3>>},
+        {"Snail", run<animal::Snail<V3>>},
+        {"Elephant", run<animal::Elephant<V3>>},
+        {"PixarMike", run<animal::PixarMike<V3>>},
+        {"HumanSkull", run<animal::HumanSkull<V3>>},
+        {"HumanHead", run<animal::HumanHead<V3>>},
+        {"Girl", run<animal::Girl<V3>>},
+        {"Rock", run<nature::Rock<V3>>},
+        {"Mountain", run<nature::Mountain<V3>>},
+        {"Mushroom", run<nature::Mushroom<V3>>},
+        {"Tree", run<nature::Tree<V3>>},
+        {"Teapot", run<manufactured::Teapot<V3>>},
+        {"Gear", run<manufactured::Gear<V3>>},
+        {"Chain", run<manufactured::Chain<V3>>},
+        {"Mobius", run<manufactured::Mobius<V3>>},
+        {"Spike", run<manufactured::Spike<V3>>},
+        {"Vase", run<manufactured::Vase<V3>>},
+        {"Knob", run<manufactured::Knob<V3>>},
+        {"Key", run<manufactured::Key<V3>>},
+        {"Castle", run<manufactured::Castle<V3>>},
+        {"Temple", run<manufactured::Temple<V3>>},
+        {"Rooks", run<manufactured::Rooks<V3>>},
+        {"Cables", run<manufactured::Cables<V3>>},
+        {"Mech", run<manufactured::Mech<V3>>},
+        {"UprightPiano", run<manufactured::UprightPiano<V3>>},
+        {"GrandPiano", run<manufactured::GrandPiano<V3>>},
+        {"Cybertruck", run<vehicle::Cybertruck<V3>>},
+        {"TieFighter", run<vehicle::TieFighter<V3>>},
+        {"Boat", run<vehicle::Boat<V3>>},
+        {"Jetfighter", run<vehicle::Jetfighter<V3>>},
+        {"Oldcar", run<vehicle::Oldcar<V3>>},
+        {"Lamborghini", run<vehicle::Lamborghini<V3>>},
+        {"Burger", run<misc::Burger<V3>>},
+        {"Cheese", run<misc::Cheese<V3>>},
+        {"Dalek", run<misc::Dalek<V3>>},
+    };
+
+    for (const auto& kernel : kernels) {
+        if (__builtin_strcmp(kernel.name, name) == 0) {
+            return kernel.func;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace sdf::simd::SDF_SIMD_TARGET
@@ -0,0 +1,7 @@
+// SoA kernels for AVX2; only called when the CPU supports AVX2.
+
+#define SDF_SIMD_TARGET avx2
+#define SDF_SIMD_WIDTH 8
+#define SDF_SIMD_ISA "avx2"
+#define SDF_SIMD_AVX2 1
+#include "soa_kernels.hpp"
@@ -0,0 +1,7 @@
+// SoA kernels for AVX-512F; only called when the CPU supports AVX-512F.
+
+#define SDF_SIMD_TARGET avx512
+#define SDF_SIMD_WIDTH 16
+#define SDF_SIMD_ISA "avx512f"
+#define SDF_SIMD_AVX512 1
+#include "soa_kernels.hpp"
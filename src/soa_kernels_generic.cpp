@@ -0,0 +1,6 @@
+// SoA kernels for the baseline instruction set of the build (e.g. SSE2 on
+// x86-64, NEON on AArch64).
+
+#define SDF_SIMD_TARGET generic
+#define SDF_SIMD_WIDTH 4
+#include "soa_kernels.hpp"
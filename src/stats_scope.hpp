@@ -0,0 +1,44 @@
+#pragma once
+
+// Internal recording of the evaluation counters in sdf/stats.hpp, shared by
+// the translation units that implement the counted entry points.
+
+#include "sdf/sdf.hpp"
+#include "sdf/stats.hpp"
+
+#include <chrono>
+#include <cstddef>
+
+namespace sdf::detail {
+
+#if defined(SDF_STATS)
+
+/// Records one call on destruction: its point count and elapsed wall time,
+/// under the given entry point.
+class StatsScope {
+public:
+    StatsScope(const Handle& sdf, size_t count, StatsSite site = StatsSite::Evaluate)
+        : name_(sdf.name), count_(count), site_(site), start_(std::chrono::steady_clock::now()) {}
+
+    ~StatsScope();
+
+    StatsScope(const StatsScope&) = delete;
+    StatsScope& operator=(const StatsScope&) = delete;
+
+private:
+    const char* name_;
+    size_t count_;
+    StatsSite site_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+#else
+
+// Recording compiled out
+struct StatsScope {
+    StatsScope(const Handle&, size_t, StatsSite = StatsSite::Evaluate) {}
+};
+
+#endif
+
+} // namespace sdf::detail
@@ -0,0 +1,174 @@
+#include "sdf/stream.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace sdf {
+
+namespace {
+
+// Two slab buffers passed between the evaluating thread and the sink thread.
+// A slot is either free (count 0) or holds an evaluated slab waiting for the
+// sink; both sides visit the slots alternately, so slabs stay in order.
+class SlabQueue {
+public:
+    /// Block until `slot` is free; false if the sink has failed
+    bool waitFree(int slot) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [&] { return count_[slot] == 0 || error_; });
+        return !error_;
+    }
+
+    void markFull(int slot, uint32_t zBegin, uint32_t count) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            zBegin_[slot] = zBegin;
+            count_[slot] = count;
+        }
+        cv_.notify_all();
+    }
+
+    /// Block until `slot` is full; false once no more slabs will come
+    bool waitFull(int slot, uint32_t& zBegin, uint32_t& count) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [&] { return count_[slot] != 0 || closed_; });
+        if (count_[slot] == 0) return false;
+        zBegin = zBegin_[slot];
+        count = count_[slot];
+        return true;
+    }
+
+    void markFree(int slot) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            count_[slot] = 0;
+        }
+        cv_.notify_all();
+    }
+
+    /// No more slabs will be added; full slots are still drained
+    void close() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            closed_ = true;
+        }
+        cv_.notify_all();
+    }
+
+    void fail(std::exception_ptr error) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            error_ = error;
+        }
+        cv_.notify_all();
+    }
+
+    std::exception_ptr error() const { return error_; }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    uint32_t zBegin_[2] = {0, 0};
+    uint32_t count_[2] = {0, 0};
+    bool closed_ = false;
+    std::exception_ptr error_;
+};
+
+} // namespace
+
+void streamGrid(
+    const Handle& sdf,
+    const glm::uvec3& dims,
+    const glm::vec3& boundLow,
+    const glm::vec3& boundHigh,
+    const SlabSink& sink,
+    const StreamOptions& options,
+    float time,
+    uint32_t seed
+) {
+    const size_t layer = static_cast<size_t>(dims.x) * dims.y;
+    if (layer == 0 || dims.z == 0) return;
+
+    uint32_t depth = options.slabDepth;
+    if (depth == 0) {
+        const size_t fit = options.memoryBudget / (2 * layer * sizeof(float));
+        depth = static_cast<uint32_t>(std::min<size_t>(std::max<size_t>(fit, 1), dims.z));
+    }
+    depth = std::min(depth, dims.z);
+
+    std::vector<float> buffers[2];
+    buffers[0].resize(layer * depth);
+    buffers[1].resize(layer * depth);
+
+    SlabQueue queue;
+    std::thread writer([&] {
+        uint32_t zBegin = 0;
+        uint32_t count = 0;
+        for (int slot = 0; queue.waitFull(slot, zBegin, count); slot ^= 1) {
+            try {
+                sink(zBegin, count, buffers[slot].data());
+            } catch (...) {
+                queue.fail(std::current_exception());
+                return;
+            }
+            queue.markFree(slot);
+        }
+    });
+
+    std::exception_ptr error;
+    try {
+        int slot = 0;
+        for (uint32_t z = 0; z < dims.z; z += depth, slot ^= 1) {
+            if (!queue.waitFree(slot)) break;
+            const uint32_t count = std::min(depth, dims.z - z);
+            evaluateGridSlab(sdf, dims, boundLow, boundHigh, z, z + count, buffers[slot].data(), time, seed);
+            queue.markFull(slot, z, count);
+        }
+    } catch (...) {
+        error = std::current_exception();
+    }
+    queue.close();
+    writer.join();
+
+    if (error) std::rethrow_exception(error);
+    if (queue.error()) std::rethrow_exception(queue.error());
+}
+
+void streamGridToFile(
+    const Handle& sdf,
+    const glm::uvec3& dims,
+    const glm::vec3& boundLow,
+    const glm::vec3& boundHigh,
+    const std::string& path,
+    const StreamOptions& options,
+    float time,
+    uint32_t seed
+) {
+    std::ofstream out(path, std::ios::binary);
+    if (!out) {
+        throw std::runtime_error("Cannot open file for writing: " + path);
+    }
+
+    const size_t layer = static_cast<size_t>(dims.x) * dims.y;
+    streamGrid(sdf, dims, boundLow, boundHigh, [&](uint32_t, uint32_t count, const float* values) {
+        out.write(reinterpret_cast<const char*>(values),
+                  static_cast<std::streamsize>(layer * count * sizeof(float)));
+        if (!out) {
+            throw std::runtime_error("Failed writing grid to " + path);
+        }
+    }, options, time, seed);
+
+    // Flush on close, so a failed final write is reported too
+    out.close();
+    if (!out) {
+        throw std::runtime_error("Failed writing grid to " + path);
+    }
+}
+
+} // namespace sdf
@@ -0,0 +1,279 @@
+// SDF Test - Check the guarantees the library documents
+//
+// Usage:
+//   sdf_test
+//
+// Runs every check below and prints one line per failure. The exit code is 1
+// if any check failed, so the program doubles as the ctest entry:
+//   - the single-point, structure-of-arrays and parallel paths agree
+//   - every SDF has finite values and gradients around its domain
+//   - points inside a shape lie within its registered bounding volume
+//   - baked grids and brick maps never exceed the true distance
+//   - extracted meshes of closed shapes have no boundary edges
+//   - the sampler's output does not depend on the thread count
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "sdf/baked.hpp"
+#include "sdf/brickmap.hpp"
+#include "sdf/mesh.hpp"
+#include "sdf/sampler.hpp"
+#include "sdf/sdf.hpp"
+
+namespace {
+
+// SDFs that return the exact Euclidean distance, against which the
+// conservative structures can be compared directly
+const char* const kExactSDFs[] = {"Sphere", "Torus"};
+
+// Allowance for float rounding when comparing against an exact distance
+constexpr float kTolerance = 1e-5f;
+
+int g_failures = 0;
+
+void fail(const std::string& check, const std::string& message) {
+    std::cout << "FAIL " << check << ": " << message << "\n";
+    ++g_failures;
+}
+
+std::vector<glm::vec3> randomPoints(size_t count, float extent, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> coord(-extent, extent);
+    std::vector<glm::vec3> points(count);
+    for (glm::vec3& p : points) {
+        p = glm::vec3(coord(rng), coord(rng), coord(rng));
+    }
+    return points;
+}
+
+// Bitwise equality, treating any two NaNs as equal
+bool same(float a, float b) {
+    return std::memcmp(&a, &b, sizeof(float)) == 0 || (std::isnan(a) && std::isnan(b));
+}
+
+std::vector<float> times(const sdf::Handle& sdf) {
+    return sdf.animated ? std::vector<float>{0.0f, 0.7f, 3.1f} : std::vector<float>{0.0f};
+}
+
+// Single-point, SoA and parallel evaluation give the same values. The
+// fast-math build only approximates the single-point path, so there the
+// check is skipped for SDFs with an error bound.
+void checkEvaluationPaths() {
+    const unsigned previous = sdf::getThreadCount();
+    sdf::setThreadCount(3);
+    const std::vector<glm::vec3> points = randomPoints(4099, 1.3f, 1);
+    std::vector<float> x(points.size()), y(points.size()), z(points.size());
+    for (size_t i = 0; i < points.size(); ++i) {
+        x[i] = points[i].x;
+        y[i] = points[i].y;
+        z[i] = points[i].z;
+    }
+
+    std::vector<float> soa(points.size()), parallel(points.size());
+    for (const std::string& name : sdf::getAvailableSDFs()) {
+        const sdf::Handle sdf = sdf::resolve(name);
+        if (sdf.errorBound > 0.0f) continue;
+        const float time = sdf.animated ? 0.7f : 0.0f;
+
+        sdf::evaluate(sdf, x.data(), y.data(), z.data(), soa.data(), points.size(), time);
+        sdf::evaluateParallel(sdf, points.data(), parallel.data(), points.size(), time);
+        for (size_t i = 0; i < points.size(); ++i) {
+            const float single = sdf::evaluate(sdf, points[i], time);
+            if (!same(single, soa[i]) || !same(single, parallel[i])) {
+                fail("evaluation paths", name + ": single " + std::to_string(single) +
+                     ", SoA " + std::to_string(soa[i]) + ", parallel " + std::to_string(parallel[i]));
+                break;
+            }
+        }
+    }
+    sdf::setThreadCount(previous);
+}
+
+// Values and gradients are finite at and well beyond the [-1, 1]^3 domain
+void checkFiniteGradients() {
+    for (float extent : {1.0f, 2.0f}) {
+        const std::vector<glm::vec3> points = randomPoints(8192, extent, 2);
+        std::vector<float> values(points.size());
+        std::vector<glm::vec3> gradients(points.size());
+        for (const std::string& name : sdf::getAvailableSDFs()) {
+            const sdf::Handle sdf = sdf::resolve(name);
+            sdf::evaluateWithGradient(sdf, points.data(), values.data(), gradients.data(), points.size());
+            for (size_t i = 0; i < points.size(); ++i) {
+                const glm::vec3& g = gradients[i];
+                if (!std::isfinite(values[i]) || !std::isfinite(g.x) || !std::isfinite(g.y) ||
+                    !std::isfinite(g.z)) {
+                    fail("finite gradients", name + " within extent " + std::to_string(extent));
+                    break;
+                }
+            }
+        }
+    }
+}
+
+// Every point with a distance of at most 0 lies inside the bounding volume
+void checkBounds() {
+    const std::vector<glm::vec3> points = randomPoints(20000, 1.6f, 3);
+    std::vector<float> values(points.size());
+    for (const std::string& name : sdf::getAvailableSDFs()) {
+        const sdf::Handle sdf = sdf::resolve(name);
+        if (!sdf.bounds.bounded) continue;
+        for (float time : times(sdf)) {
+            sdf::evaluateParallel(sdf, points.data(), values.data(), points.size(), time);
+            for (size_t i = 0; i < points.size(); ++i) {
+                if (values[i] <= 0.0f && sdf::boundDistance(sdf.bounds, points[i]) > 0.0f) {
+                    fail("bounds", name + " has an inside point outside its bounding volume");
+                    break;
+                }
+            }
+        }
+    }
+}
+
+// |conservative| <= |exact| with the same sign, allowing for rounding
+bool conservative(float value, float exact) {
+    if (std::abs(value) > std::abs(exact) + kTolerance) return false;
+    return value == 0.0f || std::abs(exact) <= kTolerance || (value < 0.0f) == (exact < 0.0f);
+}
+
+// Baked grid queries, in and around the grid, and brick map nodes, stored
+// or not, stay within the exact distance
+void checkConservativeStructures() {
+    const glm::vec3 low(-1.0f), high(1.0f);
+    const std::vector<glm::vec3> points = randomPoints(20000, 1.3f, 4);
+    std::vector<float> queried(points.size());
+    for (const char* name : kExactSDFs) {
+        const sdf::Handle sdf = sdf::resolve(name);
+
+        const sdf::BakedGrid grid = sdf::BakedGrid::bake(sdf, glm::uvec3(24), low, high);
+        grid.queryParallel(points.data(), queried.data(), points.size());
+        for (size_t i = 0; i < points.size(); ++i) {
+            const float exact = sdf::evaluate(sdf, points[i]);
+            if (!conservative(queried[i], exact)) {
+                fail("baked grid", std::string(name) + ": " + std::to_string(queried[i]) +
+                     " against " + std::to_string(exact));
+                break;
+            }
+        }
+
+        const glm::uvec3 dims(65);
+        std::vector<float> exact(static_cast<size_t>(dims.x) * dims.y * dims.z);
+        sdf::evaluateGrid(sdf, dims, low, high, exact.data());
+        const sdf::BrickMap map = sdf::BrickMap::build(sdf, dims, low, high, 0.05f);
+        bool ok = true;
+        for (uint32_t k = 0; k < dims.z && ok; ++k) {
+            for (uint32_t j = 0; j < dims.y && ok; ++j) {
+                for (uint32_t i = 0; i < dims.x && ok; ++i) {
+                    const float e = exact[i + dims.x * (j + dims.y * static_cast<size_t>(k))];
+                    const float v = map.value(i, j, k);
+                    ok = map.isActive(i, j, k) ? same(v, e) : conservative(v, e);
+                }
+            }
+        }
+        if (!ok) {
+            fail("brick map", std::string(name) + " has a node above its exact distance");
+        }
+    }
+}
+
+// Edges used by one triangle only; 0 for a closed mesh
+size_t boundaryEdges(const sdf::Mesh& mesh) {
+    std::map<std::pair<uint32_t, uint32_t>, int> uses;
+    for (const glm::uvec3& t : mesh.triangles) {
+        const uint32_t v[3] = {t.x, t.y, t.z};
+        for (int e = 0; e < 3; ++e) {
+            const uint32_t a = v[e], b = v[(e + 1) % 3];
+            ++uses[{std::min(a, b), std::max(a, b)}];
+        }
+    }
+    return std::count_if(uses.begin(), uses.end(), [](const auto& use) { return use.second == 1; });
+}
+
+// Shapes that lie inside the grid give closed meshes with both extractors
+void checkClosedMeshes() {
+    for (const char* name : kExactSDFs) {
+        const sdf::Handle sdf = sdf::resolve(name);
+        const glm::vec3 low = sdf.bounds.boxLow - 0.1f;
+        const glm::vec3 high = sdf.bounds.boxHigh + 0.1f;
+
+        const sdf::Mesh cubes = sdf::extractMesh(sdf, glm::uvec3(48), low, high);
+        if (cubes.triangles.empty() || boundaryEdges(cubes) != 0) {
+            fail("closed meshes", std::string(name) + ": marching cubes mesh is open");
+        }
+
+        sdf::DualContourOptions options;
+        options.maxDepth = 6;
+        const float size = glm::max(glm::max(high.x - low.x, high.y - low.y), high.z - low.z);
+        const sdf::Mesh dual = sdf::dualContour(sdf, low, size, options);
+        if (dual.triangles.empty() || boundaryEdges(dual) != 0) {
+            fail("closed meshes", std::string(name) + ": dual contouring mesh is open");
+        }
+    }
+}
+
+// The same samples, in the same order, on one thread and on several
+void checkSamplerDeterminism() {
+    struct Sample {
+        glm::vec3 point;
+        float value;
+    };
+
+    const auto sample = [](const sdf::Handle& sdf, const sdf::SamplerOptions& options, unsigned threads) {
+        sdf::setThreadCount(threads);
+        std::vector<Sample> samples;
+        sdf::generateSamples(sdf, 5000, options,
+            [&](size_t, const glm::vec3* points, const float* values, size_t count) {
+                for (size_t i = 0; i < count; ++i) samples.push_back({points[i], values[i]});
+            });
+        return samples;
+    };
+
+    const unsigned previous = sdf::getThreadCount();
+    const sdf::Handle sdf = sdf::resolve("Torus");
+    for (sdf::SampleDistribution distribution :
+         {sdf::SampleDistribution::Uniform, sdf::SampleDistribution::NearSurface, sdf::SampleDistribution::Band}) {
+        sdf::SamplerOptions options;
+        options.distribution = distribution;
+        options.chunkSize = 1024;
+        const std::vector<Sample> one = sample(sdf, options, 1);
+        const std::vector<Sample> many = sample(sdf, options, 3);
+        const bool equal = one.size() == many.size() &&
+            std::equal(one.begin(), one.end(), many.begin(), [](const Sample& a, const Sample& b) {
+                return same(a.point.x, b.point.x) && same(a.point.y, b.point.y) &&
+                       same(a.point.z, b.point.z) && same(a.value, b.value);
+            });
+        if (!equal) {
+            fail("sampler determinism", "distribution " + std::to_string(static_cast<int>(distribution)) +
+                 " differs between 1 and 3 threads");
+        }
+    }
+    sdf::setThreadCount(previous);
+}
+
+} // namespace
+
+int main() {
+    const std::pair<const char*, void (*)()> checks[] = {
+        {"evaluation paths", checkEvaluationPaths},
+        {"finite gradients", checkFiniteGradients},
+        {"bounds", checkBounds},
+        {"conservative structures", checkConservativeStructures},
+        {"closed meshes", checkClosedMeshes},
+        {"sampler determinism", checkSamplerDeterminism},
+    };
+
+    for (const auto& check : checks) {
+        const int before = g_failures;
+        check.second();
+        std::cout << (g_failures == before ? "ok   " : "FAIL ") << check.first << "\n";
+    }
+    return g_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,100 @@
+#include "sdf/trace.hpp"
+#include "parallel.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace sdf {
+
+namespace {
+
+// Rays per packet, which is also the unit of parallel work
+constexpr size_t kPacketSize = 1024;
+
+// March one packet of at most kPacketSize rays to completion
+void tracePacket(
+    const Handle& sdf,
+    const glm::vec3* origins,
+    const glm::vec3* directions,
+    size_t count,
+    float tMax,
+    float* outT,
+    uint32_t* outSteps,
+    const TraceOptions& options,
+    float time,
+    uint32_t seed
+) {
+    // Per-ray state, indexed by ray
+    float t[kPacketSize];
+    uint32_t steps[kPacketSize];
+    // Per-step batch, indexed by position in the active list
+    uint32_t active[kPacketSize];
+    float xs[kPacketSize], ys[kPacketSize], zs[kPacketSize], phi[kPacketSize];
+
+    for (size_t i = 0; i < count; ++i) {
+        t[i] = 0.0f;
+        steps[i] = 0;
+        active[i] = static_cast<uint32_t>(i);
+    }
+
+    const float miss = std::numeric_limits<float>::infinity();
+    size_t live = count;
+    while (live > 0) {
+        for (size_t a = 0; a < live; ++a) {
+            const uint32_t i = active[a];
+            const glm::vec3 p = origins[i] + t[i] * directions[i];
+            xs[a] = p.x;
+            ys[a] = p.y;
+            zs[a] = p.z;
+        }
+        evaluate(sdf, xs, ys, zs, phi, live, time, seed);
+
+        // Retire finished rays and compact the rest to the front
+        size_t kept = 0;
+        for (size_t a = 0; a < live; ++a) {
+            const uint32_t i = active[a];
+            ++steps[i];
+            if (phi[a] < options.epsilon) {
+                outT[i] = t[i];
+                continue;
+            }
+            t[i] += phi[a];
+            if (t[i] > tMax || steps[i] >= options.maxSteps) {
+                outT[i] = miss;
+                continue;
+            }
+            active[kept++] = i;
+        }
+        live = kept;
+    }
+
+    if (outSteps) {
+        std::copy(steps, steps + count, outSteps);
+    }
+}
+
+} // namespace
+
+void trace(
+    const Handle& sdf,
+    const glm::vec3* origins,
+    const glm::vec3* directions,
+    size_t count,
+    float tMax,
+    float* outT,
+    uint32_t* outSteps,
+    const TraceOptions& options,
+    float time,
+    uint32_t seed
+) {
+    detail::parallelFor(count, kPacketSize, [&](size_t begin, size_t end) {
+        // Nested calls may receive the whole range at once
+        for (size_t b = begin; b < end; b += kPacketSize) {
+            const size_t n = std::min(kPacketSize, end - b);
+            tracePacket(sdf, origins + b, directions + b, n, tMax, outT + b,
+                        outSteps ? outSteps + b : nullptr, options, time, seed);
+        }
+    });
+}
+
+} // namespace sdf